@@ -4,28 +4,7 @@
 #include <fstream>
 #include <iomanip>
 #include <cmath>
-
-// 读取PCM文件（int16格式）
-std::vector<spx_int16_t> read_pcm_file_int16(const std::string& filename) {
-    std::ifstream file(filename, std::ios::binary);
-    if (!file.is_open()) {
-        std::cerr << "❌ 错误：无法打开文件 " << filename << std::endl;
-        return {};
-    }
-    file.seekg(0, std::ios::end);
-    std::streamsize file_size = file.tellg();
-    file.seekg(0, std::ios::beg);
-    size_t num_samples = file_size / sizeof(spx_int16_t);
-    std::vector<spx_int16_t> audio_data(num_samples);
-    file.read(reinterpret_cast<char*>(audio_data.data()), file_size);
-    file.close();
-    std::cout << "✅ 成功读取PCM文件: " << filename << std::endl;
-    std::cout << "   文件大小: " << file_size << " 字节" << std::endl;
-    std::cout << "   样本数量: " << num_samples << std::endl;
-    std::cout << "   时长: " << std::fixed << std::setprecision(2)
-              << (static_cast<double>(num_samples) / 48000.0) << " 秒" << std::endl;
-    return audio_data;
-}
+#include "util/AudioFile.h"
 
 // 计算音频的RMS值
 double calculate_rms(const std::vector<spx_int16_t>& audio_data) {
@@ -123,7 +102,11 @@ int main() {
     
     // 步骤1: 读取PCM文件
     std::cout << "\n步骤1: 读取PCM文件..." << std::endl;
-    auto input_audio = read_pcm_file_int16("res/noise_16k_mono_s16le.pcm");
+    // WAV或16kHz单声道s16原始PCM，采样率不同时重采样到16kHz
+    const srv::AudioFile::Format raw_format{16000, 1, srv::AudioFile::SampleFormat::S16};
+    srv::MonoAudio loaded = srv::load_audio_mono("res/noise_16k_mono_s16le.pcm", 16000, &raw_format);
+    srv::print_audio_info("res/noise_16k_mono_s16le.pcm", loaded);
+    auto input_audio = std::move(loaded.samples);
     
     if (input_audio.empty()) {
         std::cerr << "❌ 无法读取PCM文件，请确保 res/noise_16k_mono_s16le.pcm 存在" << std::endl;
@@ -0,0 +1,209 @@
+// 二阶节级联EQ测试：频段精度、SIMD与标量级联的速度和误差、分块一致性，以及与FFT类EQ引擎的延迟/开销对比
+// 用法: biquad_eq_bench [--fft-wisdom FILE] [音频秒数，默认30]
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <iomanip>
+#include <chrono>
+#include <functional>
+#include "util/BiquadEqualizer.h"
+#include "util/Equalizer.h"
+#include "util/FFTPlanRegistry.h"
+#include "util/PartitionedEqualizer.h"
+
+namespace {
+
+// 标量参考实现：逐声道、逐节TDF-II
+template <typename T>
+class ScalarCascade {
+private:
+    int channels_;
+    std::vector<T> coeffs_;     // 每节b0 b1 b2 a1 a2
+    std::vector<T> state_;      // 每声道每节s1 s2
+
+public:
+    ScalarCascade(const std::vector<srv::BiquadEqualizer::Section>& sections, double sample_rate, int channels)
+        : channels_(channels) {
+        for (const auto& section : sections) {
+            double c[5];
+            srv::BiquadEqualizer::compute_coefficients(section, sample_rate, c);
+            coeffs_.insert(coeffs_.end(), c, c + 5);
+        }
+        state_.assign(sections.size() * 2 * channels, T(0));
+    }
+
+    void process(const float* input, float* output, size_t frames) {
+        const size_t sections = coeffs_.size() / 5;
+        for (size_t t = 0; t < frames; ++t) {
+            for (int ch = 0; ch < channels_; ++ch) {
+                T x = input[t * channels_ + ch];
+                T* s = &state_[ch * sections * 2];
+                for (size_t k = 0; k < sections; ++k) {
+                    const T* c = &coeffs_[k * 5];
+                    const T y = c[0] * x + s[2 * k];
+                    s[2 * k] = c[1] * x - c[3] * y + s[2 * k + 1];
+                    s[2 * k + 1] = c[2] * x - c[4] * y;
+                    x = y;
+                }
+                output[t * channels_ + ch] = static_cast<float>(x);
+            }
+        }
+    }
+};
+
+std::vector<float> make_noise(size_t count, unsigned seed) {
+    std::vector<float> audio(count);
+    std::mt19937 gen(seed);
+    std::normal_distribution<float> dist(0.0f, 0.1f);
+    for (auto& v : audio) {
+        v = dist(gen);
+    }
+    return audio;
+}
+
+// 多次运行取最快一次（秒）
+double best_of(int runs, const std::function<void()>& fn) {
+    double best = 1e30;
+    for (int r = 0; r < runs; ++r) {
+        auto start = std::chrono::steady_clock::now();
+        fn();
+        best = std::min(best, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+    }
+    return best;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    srv::FFTPlanRegistry::instance().init(srv::FFTPlanRegistry::take_wisdom_arg(argc, argv));
+    const int sample_rate = 48000;
+    int seconds = 30;
+    if (argc > 1) {
+        seconds = std::max(1, std::atoi(argv[1]));
+    }
+    const size_t frames = static_cast<size_t>(sample_rate) * seconds;
+    bool all_ok = true;
+
+    std::cout << "=== 二阶节级联EQ测试 ===" << std::endl;
+    std::cout << "音频: " << seconds << " 秒, " << sample_rate << " Hz, SIMD: " << srv::kernels::get_isa_name()
+              << std::endl;
+
+    // 1. 各预设在频段中心处的增益误差
+    std::cout << "\n频段中心增益误差（设定值 vs 级联响应）:" << std::endl;
+    {
+        srv::BiquadEqualizer eq;
+        eq.init(1, sample_rate);
+        double worst = 0.0;
+        for (const auto& name : srv::Equalizer::getPresetNames()) {
+            const std::vector<float> preset = srv::Equalizer::createPreset(name);
+            eq.setEQdB(preset);
+            const auto freqs = srv::Equalizer::calculateFreqs(preset.size());
+            double max_error = 0.0;
+            for (size_t i = 0; i < freqs.size(); ++i) {
+                max_error = std::max(max_error, std::abs(eq.get_response_db(freqs[i]) - preset[i]));
+            }
+            worst = std::max(worst, max_error);
+            std::cout << "  " << std::left << std::setw(16) << name << std::right << std::fixed
+                      << std::setprecision(3) << max_error << " dB" << std::endl;
+        }
+        const bool ok = worst < 0.1;
+        all_ok = all_ok && ok;
+        std::cout << "  " << (ok ? "✅" : "❌") << " 最大误差 " << worst << " dB" << std::endl;
+    }
+
+    // 2. SIMD级联与标量级联：速度和误差（以double标量为准）
+    std::cout << "\nSIMD与标量级联（vocal_boost + 40Hz高通，每声道每样本ns）:" << std::endl;
+    const std::vector<float> preset = srv::Equalizer::createPreset("vocal_boost");
+    double mono_ns = 0.0;
+    for (int channels : {1, 2, 4, 3}) {
+        srv::BiquadEqualizer eq;
+        eq.init(channels, sample_rate);
+        eq.setEQdB(preset);
+        eq.setHighPass(40.0f);
+        const std::vector<float> input = make_noise(frames * channels, 3);
+        std::vector<float> simd_out(input.size());
+        std::vector<float> scalar_out(input.size());
+        std::vector<float> exact_out(input.size());
+
+        const double simd_seconds = best_of(3, [&] {
+            eq.reset();
+            eq.process(input.data(), simd_out.data(), frames);
+        });
+        const double scalar_seconds = best_of(3, [&] {
+            ScalarCascade<float> reference(eq.get_sections(), sample_rate, channels);
+            reference.process(input.data(), scalar_out.data(), frames);
+        });
+        ScalarCascade<double> exact(eq.get_sections(), sample_rate, channels);
+        exact.process(input.data(), exact_out.data(), frames);
+
+        // 随机分块处理应与整段处理逐位相同
+        std::vector<float> chunked_out(input.size());
+        eq.reset();
+        std::mt19937 gen(9);
+        std::uniform_int_distribution<size_t> chunk(1, 700);
+        for (size_t pos = 0; pos < frames;) {
+            const size_t n = std::min(chunk(gen), frames - pos);
+            eq.process(&input[pos * channels], &chunked_out[pos * channels], n);
+            pos += n;
+        }
+
+        double max_diff = 0.0;
+        for (size_t i = 0; i < input.size(); ++i) {
+            max_diff = std::max(max_diff, static_cast<double>(std::abs(simd_out[i] - exact_out[i])));
+        }
+        const bool chunk_ok = chunked_out == simd_out;
+        const bool ok = chunk_ok && max_diff < 1e-4;
+        all_ok = all_ok && ok;
+
+        const double samples = static_cast<double>(input.size());
+        if (channels == 1) {
+            mono_ns = simd_seconds / samples * 1e9;
+        }
+        std::cout << "  " << channels << "声道: SIMD " << std::setprecision(2) << std::setw(6)
+                  << simd_seconds / samples * 1e9 << " ns, 标量 " << std::setw(6) << scalar_seconds / samples * 1e9
+                  << " ns, 加速 " << scalar_seconds / simd_seconds << "x, 与double差 " << std::scientific
+                  << std::setprecision(1) << max_diff << std::fixed << ", 分块" << (chunk_ok ? "一致" : "不一致")
+                  << (ok ? " ✅" : " ❌") << std::endl;
+    }
+
+    // 3. 与FFT类引擎对比（单声道）
+    std::cout << "\n单声道EQ引擎对比（vocal_boost）:" << std::endl;
+    {
+        const std::vector<float> input = make_noise(frames, 5);
+        std::vector<float> output(frames);
+        std::vector<float> tail(8192);
+
+        srv::Equalizer fft_eq;
+        fft_eq.init(10, sample_rate);
+        fft_eq.setEQdB(preset);
+        const double fft_seconds = best_of(3, [&] {
+            fft_eq.process(input.data(), output.data(), frames);
+            fft_eq.flush(tail.data());
+        });
+
+        srv::PartitionedEqualizer conv_eq;
+        conv_eq.init(6, 12, sample_rate);
+        conv_eq.setEQdB(preset);
+        const double conv_seconds = best_of(3, [&] {
+            conv_eq.process(input.data(), output.data(), frames);
+            conv_eq.flush(tail.data());
+        });
+
+        const double n = static_cast<double>(frames);
+        std::cout << std::setprecision(2);
+        std::cout << "  FFT重叠-相加(1024点)     延迟 " << std::setw(5) << fft_eq.get_latency() << " 样本, "
+                  << std::setw(6) << fft_seconds / n * 1e9 << " ns/样本" << std::endl;
+        std::cout << "  分割卷积(B=64, 4096抽头) 延迟 " << std::setw(5) << conv_eq.get_latency() << " 样本, "
+                  << std::setw(6) << conv_seconds / n * 1e9 << " ns/样本" << std::endl;
+        std::cout << "  二阶节级联(" << srv::kernels::get_isa_name() << ")        延迟 " << std::setw(5) << 0
+                  << " 样本, " << std::setw(6) << mono_ns << " ns/样本" << std::endl;
+    }
+
+    srv::FFTPlanRegistry::instance().save_wisdom();
+    std::cout << "\n" << (all_ok ? "✅ 二阶节级联EQ测试通过" : "❌ 二阶节级联EQ测试失败") << std::endl;
+    return all_ok ? 0 : 1;
+}
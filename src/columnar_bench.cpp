@@ -0,0 +1,137 @@
+// 逐帧结果写出性能测试：列式二进制（ColumnarWriter）vs iostream CSV，并测mmap读取扫描速度
+// 用法: columnar_bench [帧数=20000000] [工作目录=.]
+#include <iostream>
+#include <vector>
+#include <fstream>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <iomanip>
+#include <chrono>
+#include "util/ColumnarFile.h"
+
+// 合成逐帧特征：VAD概率、RMS、峰值和4个子带能量
+struct FrameFeatures {
+    float vad_prob;
+    float rms;
+    float peak;
+    float band_energy[4];
+};
+
+std::vector<FrameFeatures> generate_features(size_t count) {
+    std::vector<FrameFeatures> features(count);
+    std::mt19937 gen(37);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    for (auto& f : features) {
+        f.vad_prob = unit(gen);
+        f.rms = 3000.0f * unit(gen);
+        f.peak = f.rms * (1.5f + unit(gen));
+        for (float& e : f.band_energy) {
+            e = 1e6f * unit(gen);
+        }
+    }
+    return features;
+}
+
+int main(int argc, char** argv) {
+    const uint64_t total_frames = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 20000000ull;
+    const std::string dir = argc > 2 ? argv[2] : ".";
+    const std::string cols_path = dir + "/columnar_bench.cols";
+    const std::string csv_path = dir + "/columnar_bench.csv";
+    const double frame_rate = 100.0;
+
+    std::cout << "=== 逐帧结果写出性能测试 ===" << std::endl;
+    std::cout << "帧数: " << total_frames << " (" << std::fixed << std::setprecision(1)
+              << (total_frames / frame_rate / 3600.0) << " 小时 @10ms帧)" << std::endl;
+
+    // 特征循环复用，避免生成数据的开销计入写出时间
+    const auto features = generate_features(1 << 16);
+    const size_t mask = features.size() - 1;
+
+    // 列式二进制
+    std::vector<srv::ColumnSpec> columns = {
+        {"vad_prob", srv::ColumnType::FLOAT32},
+        {"rms", srv::ColumnType::FLOAT32},
+        {"peak", srv::ColumnType::FLOAT32},
+        {"band0", srv::ColumnType::FLOAT32},
+        {"band1", srv::ColumnType::FLOAT32},
+        {"band2", srv::ColumnType::FLOAT32},
+        {"band3", srv::ColumnType::FLOAT32},
+    };
+    srv::ColumnarWriter writer;
+    if (!writer.open(cols_path, columns, frame_rate)) {
+        return 1;
+    }
+    auto start = std::chrono::steady_clock::now();
+    for (uint64_t i = 0; i < total_frames; ++i) {
+        const FrameFeatures& f = features[i & mask];
+        writer.set(0, f.vad_prob);
+        writer.set(1, f.rms);
+        writer.set(2, f.peak);
+        for (int b = 0; b < 4; ++b) {
+            writer.set(3 + b, f.band_energy[b]);
+        }
+        writer.end_row();
+    }
+    writer.close();
+    double cols_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // iostream CSV（原save_vad_results的写法），只写前1/20的帧再按比例折算
+    const uint64_t csv_frames = std::max<uint64_t>(1, total_frames / 20);
+    std::ofstream csv(csv_path);
+    start = std::chrono::steady_clock::now();
+    csv << "Frame,VAD_Probability,RMS,Peak,Band0,Band1,Band2,Band3,Time(s)" << std::endl;
+    for (uint64_t i = 0; i < csv_frames; ++i) {
+        const FrameFeatures& f = features[i & mask];
+        csv << i << "," << std::fixed << std::setprecision(6) << f.vad_prob
+            << "," << std::setprecision(2) << f.rms << "," << f.peak;
+        for (int b = 0; b < 4; ++b) {
+            csv << "," << f.band_energy[b];
+        }
+        csv << "," << std::setprecision(3) << (i / frame_rate) << std::endl;
+    }
+    csv.close();
+    double csv_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // mmap读取：逐块扫描VAD概率列
+    srv::ColumnarReader reader;
+    if (!reader.open(cols_path)) {
+        return 1;
+    }
+    start = std::chrono::steady_clock::now();
+    double prob_sum = 0.0;
+    uint64_t scanned = 0;
+    for (uint64_t b = 0; b < reader.get_num_blocks(); ++b) {
+        size_t frames = 0;
+        const float* probs = static_cast<const float*>(reader.get_block_column(0, b, &frames));
+        for (size_t i = 0; i < frames; ++i) {
+            prob_sum += probs[i];
+        }
+        scanned += frames;
+    }
+    double read_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // 抽查写入的值
+    bool verified = reader.get_num_frames() == total_frames;
+    for (uint64_t i = 0; verified && i < total_frames; i += total_frames / 97 + 1) {
+        const FrameFeatures& f = features[i & mask];
+        verified = reader.get_value(0, i) == f.vad_prob && reader.get_value(6, i) == f.band_energy[3];
+    }
+
+    std::cout << "\n列式二进制写出: " << std::setprecision(3) << cols_seconds << " s, "
+              << std::setprecision(1) << (total_frames / cols_seconds / 1e6) << " M帧/秒" << std::endl;
+    std::cout << "iostream CSV写出: " << std::setprecision(3) << csv_seconds << " s (" << csv_frames << " 帧), "
+              << std::setprecision(2) << (csv_frames / csv_seconds / 1e6) << " M帧/秒" << std::endl;
+    std::cout << "写出加速比: " << std::setprecision(1)
+              << ((csv_seconds / csv_frames) / (cols_seconds / total_frames)) << "x" << std::endl;
+    std::cout << "mmap扫描一列: " << std::setprecision(3) << read_seconds << " s, "
+              << std::setprecision(1) << (scanned / read_seconds / 1e6) << " M帧/秒 (均值 "
+              << std::setprecision(4) << (prob_sum / std::max<uint64_t>(1, scanned)) << ")" << std::endl;
+    std::cout << (verified ? "✅ 读回数据一致" : "❌ 读回数据不一致") << std::endl;
+
+    std::remove(cols_path.c_str());
+    std::remove(csv_path.c_str());
+    return verified ? 0 : 1;
+}
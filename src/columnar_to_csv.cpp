@@ -0,0 +1,62 @@
+// 列式结果文件转CSV，供人工查看或导入表格工具
+// 用法: columnar_to_csv <输入.cols> [输出.csv]，不指定输出时写到标准输出
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include "util/ColumnarFile.h"
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::cerr << "用法: " << argv[0] << " <输入.cols> [输出.csv]" << std::endl;
+        return 1;
+    }
+
+    srv::ColumnarReader reader;
+    if (!reader.open(argv[1])) {
+        std::cerr << "❌ 无法读取列式文件 " << argv[1] << std::endl;
+        return 1;
+    }
+    if (!reader.is_complete()) {
+        std::cerr << "⚠️ 文件未正常关闭，只恢复了 " << reader.get_num_frames() << " 帧" << std::endl;
+    }
+
+    std::ofstream file;
+    if (argc >= 3) {
+        file.open(argv[2]);
+        if (!file.is_open()) {
+            std::cerr << "❌ 无法创建文件 " << argv[2] << std::endl;
+            return 1;
+        }
+    }
+    std::ostream& out = argc >= 3 ? static_cast<std::ostream&>(file) : std::cout;
+
+    const auto& columns = reader.get_columns();
+    out << "Frame,Time(s)";
+    for (const auto& column : columns) {
+        out << "," << column.name;
+    }
+    out << "\n";
+
+    // 浮点列保留6位小数，整数列原样输出
+    const double frame_rate = reader.get_frame_rate();
+    std::vector<int> precision(columns.size());
+    for (size_t c = 0; c < columns.size(); ++c) {
+        bool is_float = columns[c].type == srv::ColumnType::FLOAT32 || columns[c].type == srv::ColumnType::FLOAT64;
+        precision[c] = is_float ? 6 : 0;
+    }
+    out << std::fixed;
+    for (uint64_t frame = 0; frame < reader.get_num_frames(); ++frame) {
+        out << frame << "," << std::setprecision(3) << (frame / frame_rate);
+        for (size_t c = 0; c < columns.size(); ++c) {
+            out << "," << std::setprecision(precision[c]) << reader.get_value(c, frame);
+        }
+        out << "\n";
+    }
+
+    if (argc >= 3) {
+        std::cerr << "✅ 已转换 " << reader.get_num_frames() << " 帧到 " << argv[2] << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,833 @@
+// 串联处理命令行工具：从stdin读取原始PCM或WAV，依次经过各处理级，处理结果写到stdout
+// 按块流式处理，内存占用与输入时长无关，可直接接在采集工具后面
+// 用法: dspctl [选项] 处理级... < 输入 > 输出
+//   cat in.pcm | dspctl --in-rate 16000 ans agc resample=48000 rnnoise eq=vocal_boost --out-wav > out.wav
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "util/ANS.h"
+#include "util/AudioFile.h"
+#include "util/BiquadEqualizer.h"
+#include "util/DSPKernels.h"
+#include "util/Equalizer.h"
+#include "util/FFTPlanRegistry.h"
+#include "util/PartitionedEqualizer.h"
+#include "util/ProcessStats.h"
+#include "util/RNNoise.h"
+#include "util/Resampler.h"
+#include "util/VAD.h"
+
+using srv::AudioFile;
+
+namespace {
+
+constexpr size_t kBlockFrames = 4096;      // 每次从stdin读取的帧数
+constexpr uint64_t kUnknownSize = ~0ull;
+
+uint16_t get_u16(const uint8_t* p) { return static_cast<uint16_t>(p[0] | (p[1] << 8)); }
+uint32_t get_u32(const uint8_t* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) | (static_cast<uint32_t>(p[2]) << 16) |
+           (static_cast<uint32_t>(p[3]) << 24);
+}
+uint64_t get_u64(const uint8_t* p) { return get_u32(p) | (static_cast<uint64_t>(get_u32(p + 4)) << 32); }
+
+void put_u16(uint8_t* p, uint16_t v) {
+    p[0] = static_cast<uint8_t>(v);
+    p[1] = static_cast<uint8_t>(v >> 8);
+}
+void put_u32(uint8_t* p, uint32_t v) {
+    for (int i = 0; i < 4; ++i) p[i] = static_cast<uint8_t>(v >> (8 * i));
+}
+
+// 从stdin读满count字节（管道可能分多次返回），返回实际读到的字节数
+size_t read_exact(uint8_t* out, size_t count) {
+    size_t total = 0;
+    while (total < count) {
+        size_t n = std::fread(out + total, 1, count - total, stdin);
+        if (n == 0) break;
+        total += n;
+    }
+    return total;
+}
+
+// stdin输入：自动识别WAV头（RIFF/RF64），否则按命令行给出的格式当作原始PCM；输出单声道s16
+class InputStream {
+private:
+    AudioFile::Format format_;
+    size_t frame_bytes_;
+    uint64_t data_remaining_;           // WAV数据块剩余字节，流式写出的WAV长度未知时为kUnknownSize
+    bool is_wav_;
+    std::vector<uint8_t> bytes_;        // 原始字节（含上次不足一帧的残留）
+    size_t pending_;
+    std::vector<float> float_buffer_;
+    std::vector<int16_t> s16_buffer_;
+
+public:
+    InputStream() : format_{48000, 1, AudioFile::SampleFormat::S16}, frame_bytes_(2), data_remaining_(kUnknownSize),
+                    is_wav_(false), pending_(0) {}
+
+    bool open(const AudioFile::Format& raw_format) {
+        format_ = raw_format;
+        uint8_t header[12];
+        size_t n = read_exact(header, sizeof(header));
+        if (n == sizeof(header) && (std::memcmp(header, "RIFF", 4) == 0 || std::memcmp(header, "RF64", 4) == 0) &&
+            std::memcmp(header + 8, "WAVE", 4) == 0) {
+            if (!parse_wav(std::memcmp(header, "RF64", 4) == 0)) {
+                return false;
+            }
+            is_wav_ = true;
+        }
+        const size_t sample_bytes = AudioFile::get_sample_size(format_.sample_format);
+        if (format_.sample_rate <= 0 || format_.channels <= 0 || sample_bytes == 0) {
+            std::cerr << "dspctl: invalid input format" << std::endl;
+            return false;
+        }
+        frame_bytes_ = sample_bytes * format_.channels;
+        bytes_.resize(kBlockFrames * frame_bytes_ + sizeof(header));
+        float_buffer_.resize(kBlockFrames * format_.channels);
+        s16_buffer_.resize(kBlockFrames * format_.channels);
+        if (!is_wav_) {
+            // 不是WAV头，已读的字节就是样本数据
+            std::memcpy(bytes_.data(), header, n);
+            pending_ = n;
+        }
+        return true;
+    }
+
+    // 逐块解析WAV头直到data块，不回退（stdin不可seek）
+    bool parse_wav(bool rf64) {
+        uint64_t ds64_data_size = 0;
+        bool have_fmt = false;
+        std::vector<uint8_t> body;
+        uint8_t chunk[8];
+        while (read_exact(chunk, 8) == 8) {
+            uint64_t chunk_size = get_u32(chunk + 4);
+            if (std::memcmp(chunk, "data", 4) == 0) {
+                if (!have_fmt) {
+                    std::cerr << "dspctl: WAV data chunk before fmt" << std::endl;
+                    return false;
+                }
+                if (rf64 && chunk_size == 0xFFFFFFFFull) {
+                    chunk_size = ds64_data_size;
+                }
+                // 边采集边写出的WAV常把长度写成0或0xFFFFFFFF，此时读到EOF为止
+                data_remaining_ = (chunk_size == 0 || chunk_size == 0xFFFFFFFFull) ? kUnknownSize : chunk_size;
+                return true;
+            }
+            body.resize(static_cast<size_t>(chunk_size + (chunk_size & 1)));
+            if (read_exact(body.data(), body.size()) != body.size()) {
+                break;
+            }
+            if (std::memcmp(chunk, "ds64", 4) == 0 && chunk_size >= 24) {
+                ds64_data_size = get_u64(body.data() + 8);
+            } else if (std::memcmp(chunk, "fmt ", 4) == 0 && chunk_size >= 16) {
+                uint16_t tag = get_u16(body.data());
+                const uint16_t bits = get_u16(body.data() + 14);
+                if (tag == 0xFFFE && chunk_size >= 40) {
+                    tag = get_u16(body.data() + 24);
+                }
+                if (tag == 1 && bits == 16) {
+                    format_.sample_format = AudioFile::SampleFormat::S16;
+                } else if (tag == 1 && bits == 24) {
+                    format_.sample_format = AudioFile::SampleFormat::S24;
+                } else if (tag == 1 && bits == 32) {
+                    format_.sample_format = AudioFile::SampleFormat::S32;
+                } else if (tag == 3 && bits == 32) {
+                    format_.sample_format = AudioFile::SampleFormat::F32;
+                } else {
+                    std::cerr << "dspctl: unsupported WAV format tag=" << tag << " bits=" << bits << std::endl;
+                    return false;
+                }
+                format_.channels = get_u16(body.data() + 2);
+                format_.sample_rate = static_cast<int>(get_u32(body.data() + 4));
+                have_fmt = true;
+            }
+        }
+        std::cerr << "dspctl: WAV header truncated" << std::endl;
+        return false;
+    }
+
+    /**
+     * 读取最多kBlockFrames帧，混音为单声道s16
+     * @return 帧数，0表示输入结束
+     */
+    size_t read(std::vector<int16_t>& mono) {
+        size_t want = kBlockFrames * frame_bytes_ - pending_;
+        if (data_remaining_ != kUnknownSize) {
+            want = static_cast<size_t>(std::min<uint64_t>(want, data_remaining_));
+        }
+        size_t n = read_exact(bytes_.data() + pending_, want);
+        if (data_remaining_ != kUnknownSize) {
+            data_remaining_ -= n;
+        }
+        const size_t total = pending_ + n;
+        const size_t frames = total / frame_bytes_;
+        const size_t samples = frames * format_.channels;
+
+        switch (format_.sample_format) {
+            case AudioFile::SampleFormat::S16:
+                std::memcpy(s16_buffer_.data(), bytes_.data(), samples * sizeof(int16_t));
+                break;
+            case AudioFile::SampleFormat::S24:
+                srv::kernels::s24_to_f32(bytes_.data(), float_buffer_.data(), samples, 1.0f / 8388608.0f);
+                srv::kernels::f32_to_s16(float_buffer_.data(), s16_buffer_.data(), samples, 32768.0f);
+                break;
+            case AudioFile::SampleFormat::S32:
+                srv::kernels::s32_to_f32(bytes_.data(), float_buffer_.data(), samples, 1.0f / 2147483648.0f);
+                srv::kernels::f32_to_s16(float_buffer_.data(), s16_buffer_.data(), samples, 32768.0f);
+                break;
+            case AudioFile::SampleFormat::F32:
+                std::memcpy(float_buffer_.data(), bytes_.data(), samples * sizeof(float));
+                srv::kernels::f32_to_s16(float_buffer_.data(), s16_buffer_.data(), samples, 32768.0f);
+                break;
+        }
+
+        // 不足一帧的字节留到下次
+        pending_ = total - frames * frame_bytes_;
+        std::memmove(bytes_.data(), bytes_.data() + frames * frame_bytes_, pending_);
+
+        mono.resize(frames);
+        const int channels = format_.channels;
+        for (size_t i = 0; i < frames; ++i) {
+            int32_t sum = 0;
+            for (int c = 0; c < channels; ++c) {
+                sum += s16_buffer_[i * channels + c];
+            }
+            mono[i] = static_cast<int16_t>(sum / channels);
+        }
+        return frames;
+    }
+
+    const AudioFile::Format& get_format() const { return format_; }
+    bool is_wav() const { return is_wav_; }
+};
+
+// stdout输出：单声道s16原始PCM或WAV。WAV头先写未知长度，stdout是普通文件时结束后回填
+class OutputStream {
+private:
+    bool wav_;
+    int sample_rate_;
+    uint64_t samples_written_;
+
+    // 长度按64位计算，超过4GB时两个长度字段都钳到0xFFFFFFFF（即未知长度）；
+    // 44字节头没有预留ds64块，流式输出无法改写成RF64
+    void write_header(uint64_t data_bytes) {
+        const uint64_t kUnknown = 0xFFFFFFFFull;
+        uint8_t header[44];
+        std::memcpy(header, "RIFF", 4);
+        put_u32(header + 4, static_cast<uint32_t>(std::min(data_bytes + 36, kUnknown)));
+        std::memcpy(header + 8, "WAVEfmt ", 8);
+        put_u32(header + 16, 16);
+        put_u16(header + 20, 1);
+        put_u16(header + 22, 1);
+        put_u32(header + 24, static_cast<uint32_t>(sample_rate_));
+        put_u32(header + 28, static_cast<uint32_t>(sample_rate_) * 2);
+        put_u16(header + 32, 2);
+        put_u16(header + 34, 16);
+        std::memcpy(header + 36, "data", 4);
+        put_u32(header + 40, static_cast<uint32_t>(std::min(data_bytes, kUnknown)));
+        std::fwrite(header, 1, sizeof(header), stdout);
+    }
+
+public:
+    OutputStream() : wav_(false), sample_rate_(0), samples_written_(0) {}
+
+    bool open(int sample_rate, bool wav) {
+        sample_rate_ = sample_rate;
+        wav_ = wav;
+        static char buffer[1 << 16];
+        std::setvbuf(stdout, buffer, _IOFBF, sizeof(buffer));
+        if (wav_) {
+            write_header(0xFFFFFFFFull);
+        }
+        return !std::ferror(stdout);
+    }
+
+    bool write(const int16_t* samples, size_t count) {
+        if (count == 0) {
+            return true;
+        }
+        samples_written_ += count;
+        return std::fwrite(samples, sizeof(int16_t), count, stdout) == count;
+    }
+
+    bool close() {
+        if (wav_ && std::fflush(stdout) == 0 && std::fseek(stdout, 0, SEEK_SET) == 0) {
+            // 管道不可seek，保持未知长度（多数播放器会读到EOF）
+            write_header(samples_written_ * 2);
+            std::fseek(stdout, 0, SEEK_END);
+        }
+        return std::fflush(stdout) == 0;
+    }
+
+    uint64_t get_samples_written() const { return samples_written_; }
+};
+
+// 处理级：单声道s16流式输入，输出追加到out（可以有延迟，flush后输出总长度由各级自己保证）
+class Stage {
+public:
+    virtual ~Stage() = default;
+    virtual bool init(int sample_rate) = 0;
+    virtual int get_output_rate() const = 0;
+    virtual void process(const int16_t* input, size_t count, std::vector<int16_t>& out) = 0;
+    virtual void flush(std::vector<int16_t>& out) = 0;
+    virtual std::string name() const = 0;
+};
+
+// 按10ms帧处理的级：凑满一帧后就地处理，末尾补零，输出与输入等长
+class FrameStage : public Stage {
+protected:
+    int sample_rate_;
+    size_t frame_size_;
+    std::vector<int16_t> frame_;
+    size_t fill_;
+    uint64_t input_count_;
+    uint64_t output_count_;
+    size_t skip_;               // 处理器固有延迟，丢弃开头这么多输出样本
+
+    virtual bool init_frame() = 0;
+    virtual void process_frame(int16_t* frame) = 0;
+
+    void emit(std::vector<int16_t>& out) {
+        process_frame(frame_.data());
+        const size_t drop = std::min(skip_, frame_size_);
+        skip_ -= drop;
+        out.insert(out.end(), frame_.begin() + drop, frame_.end());
+        output_count_ += frame_size_ - drop;
+        fill_ = 0;
+    }
+
+public:
+    FrameStage() : sample_rate_(0), frame_size_(0), fill_(0), input_count_(0), output_count_(0), skip_(0) {}
+
+    bool init(int sample_rate) override {
+        sample_rate_ = sample_rate;
+        frame_size_ = static_cast<size_t>(sample_rate / 100);
+        frame_.assign(frame_size_, 0);
+        return frame_size_ > 0 && init_frame();
+    }
+
+    int get_output_rate() const override { return sample_rate_; }
+
+    void process(const int16_t* input, size_t count, std::vector<int16_t>& out) override {
+        input_count_ += count;
+        while (count > 0) {
+            const size_t take = std::min(count, frame_size_ - fill_);
+            std::copy(input, input + take, frame_.begin() + fill_);
+            fill_ += take;
+            input += take;
+            count -= take;
+            if (fill_ == frame_size_) {
+                emit(out);
+            }
+        }
+    }
+
+    void flush(std::vector<int16_t>& out) override {
+        while (output_count_ < input_count_) {
+            std::fill(frame_.begin() + fill_, frame_.end(), 0);
+            emit(out);
+        }
+        out.resize(out.size() - static_cast<size_t>(output_count_ - input_count_));
+        output_count_ = input_count_;
+    }
+};
+
+class ResampleStage : public Stage {
+private:
+    int target_rate_;
+    int input_rate_;
+    srv::Resampler resampler_;
+    std::vector<int16_t> tail_;
+    uint64_t input_count_;
+    uint64_t output_count_;
+
+public:
+    explicit ResampleStage(int target_rate)
+        : target_rate_(target_rate), input_rate_(0), input_count_(0), output_count_(0) {}
+
+    bool init(int sample_rate) override {
+        input_rate_ = sample_rate;
+        if (target_rate_ <= 0) {
+            std::cerr << "dspctl: invalid resample rate" << std::endl;
+            return false;
+        }
+        if (input_rate_ == target_rate_) {
+            return true;
+        }
+        if (!resampler_.init(input_rate_, target_rate_, 1)) {
+            return false;
+        }
+        // reset跳过滤波器起始的零延迟，输出与输入对齐
+        resampler_.reset();
+        tail_.assign(static_cast<size_t>(resampler_.get_input_latency()), 0);
+        return true;
+    }
+
+    int get_output_rate() const override { return target_rate_; }
+
+    void process(const int16_t* input, size_t count, std::vector<int16_t>& out) override {
+        if (input_rate_ == target_rate_) {
+            out.insert(out.end(), input, input + count);
+            return;
+        }
+        input_count_ += count;
+        output_count_ += resampler_.process(input, count, out);
+    }
+
+    void flush(std::vector<int16_t>& out) override {
+        if (input_rate_ == target_rate_) {
+            return;
+        }
+        // 补零冲出内部缓存的样本，总长度截到输入时长对应的样本数
+        output_count_ += resampler_.process(tail_.data(), tail_.size(), out);
+        const uint64_t expected = input_count_ * static_cast<uint64_t>(target_rate_) / input_rate_;
+        if (output_count_ > expected) {
+            out.resize(out.size() - static_cast<size_t>(std::min<uint64_t>(output_count_ - expected, out.size())));
+            output_count_ = expected;
+        }
+    }
+
+    std::string name() const override { return "resample=" + std::to_string(target_rate_); }
+};
+
+// 语音检测：输出Audacity标签（起点秒<TAB>终点秒<TAB>speech），gate模式下静音帧置零
+class VadStage : public FrameStage {
+private:
+    srv::VAD vad_;
+    bool gate_;
+    std::string label_path_;
+    std::ofstream label_file_;
+    std::ostream* labels_;
+    std::vector<int16_t> scratch_;      // VAD会改写输入帧，检测用副本
+    uint64_t frame_index_;
+    bool in_speech_;
+    uint64_t speech_start_;
+
+    void write_label(uint64_t end_frame) {
+        const double frame_seconds = static_cast<double>(frame_size_) / sample_rate_;
+        *labels_ << std::fixed << std::setprecision(3) << speech_start_ * frame_seconds << "\t"
+                 << end_frame * frame_seconds << "\tspeech\n";
+    }
+
+protected:
+    bool init_frame() override {
+        if (!vad_.init(sample_rate_, static_cast<int>(frame_size_))) {
+            return false;
+        }
+        scratch_.assign(frame_size_, 0);
+        labels_ = &std::cerr;
+        if (!label_path_.empty()) {
+            label_file_.open(label_path_);
+            if (!label_file_) {
+                std::cerr << "dspctl: cannot open label file " << label_path_ << std::endl;
+                return false;
+            }
+            labels_ = &label_file_;
+        }
+        return true;
+    }
+
+    void process_frame(int16_t* frame) override {
+        std::copy(frame, frame + frame_size_, scratch_.begin());
+        const bool speech = vad_.detect_voice_activity(scratch_.data(), static_cast<int>(frame_size_)) == 1;
+        if (speech && !in_speech_) {
+            speech_start_ = frame_index_;
+        } else if (!speech && in_speech_) {
+            write_label(frame_index_);
+        }
+        in_speech_ = speech;
+        if (!speech && gate_) {
+            std::fill(frame, frame + frame_size_, 0);
+        }
+        ++frame_index_;
+    }
+
+public:
+    VadStage(bool gate, const std::string& label_path)
+        : gate_(gate), label_path_(label_path), labels_(nullptr), frame_index_(0), in_speech_(false),
+          speech_start_(0) {}
+
+    void flush(std::vector<int16_t>& out) override {
+        FrameStage::flush(out);
+        if (in_speech_) {
+            write_label(frame_index_);
+            in_speech_ = false;
+        }
+        labels_->flush();
+    }
+
+    std::string name() const override { return gate_ ? "gate" : "vad"; }
+};
+
+// 噪声抑制（agc模式下关闭降噪只做自动增益）
+class AnsStage : public FrameStage {
+private:
+    srv::ANS ans_;
+    bool agc_;
+    int level_;
+
+protected:
+    bool init_frame() override {
+        if (!ans_.init(sample_rate_, static_cast<int>(frame_size_))) {
+            return false;
+        }
+        if (agc_) {
+            ans_.set_noise_suppress_params(0, 0, 0);
+            ans_.set_noise_suppress_enabled(false);
+            ans_.set_agc_params(level_, 32768, 32768, 32768);
+            ans_.set_agc_enabled(true);
+        } else {
+            ans_.set_noise_suppress_params(level_, -40, -15);
+            ans_.set_agc_enabled(false);
+        }
+        return true;
+    }
+
+    void process_frame(int16_t* frame) override {
+        std::vector<spx_int16_t> result = ans_.process_frame(frame, static_cast<int>(frame_size_));
+        if (result.size() == frame_size_) {
+            std::copy(result.begin(), result.end(), frame);
+        }
+    }
+
+public:
+    AnsStage(bool agc, int level) : agc_(agc), level_(level) {}
+    std::string name() const override { return (agc_ ? "agc=" : "ans=") + std::to_string(level_); }
+};
+
+class RNNoiseStage : public FrameStage {
+private:
+    srv::RNNoise rnnoise_;
+
+protected:
+    bool init_frame() override {
+        if (sample_rate_ != srv::RNNoise::get_sample_rate()) {
+            std::cerr << "dspctl: rnnoise needs " << srv::RNNoise::get_sample_rate()
+                      << " Hz input, add resample=48000 before it" << std::endl;
+            return false;
+        }
+        // 与rnnoise_test一致丢弃第一帧输出，补偿一帧延迟
+        skip_ = frame_size_;
+        return rnnoise_.init();
+    }
+
+    void process_frame(int16_t* frame) override { rnnoise_.process_frame(frame, frame); }
+
+public:
+    std::string name() const override { return "rnnoise"; }
+};
+
+// 均衡器引擎：按延迟预算选择
+enum class EqEngine {
+    FFT,        // FFT重叠-相加，1024点，延迟1023样本
+    CONV,       // 均匀分割卷积，B=128，延迟127样本
+    BIQUAD      // 二阶节级联，零延迟
+};
+
+class EqStage : public Stage {
+private:
+    std::string spec_;
+    std::vector<float> db_values_;
+    EqEngine engine_;
+    srv::Equalizer eq_;
+    srv::PartitionedEqualizer conv_eq_;
+    srv::BiquadEqualizer biquad_eq_;
+    int sample_rate_;
+
+public:
+    EqStage(const std::string& spec, const std::vector<float>& db_values, EqEngine engine)
+        : spec_(spec), db_values_(db_values), engine_(engine), sample_rate_(0) {}
+
+    bool init(int sample_rate) override {
+        sample_rate_ = sample_rate;
+        switch (engine_) {
+        case EqEngine::FFT:
+            if (!eq_.init(10, sample_rate)) {
+                return false;
+            }
+            eq_.setEQdB(db_values_);
+            break;
+        case EqEngine::CONV:
+            if (!conv_eq_.init(7, 12, sample_rate)) {
+                return false;
+            }
+            conv_eq_.setEQdB(db_values_);
+            break;
+        case EqEngine::BIQUAD:
+            if (!biquad_eq_.init(1, sample_rate)) {
+                return false;
+            }
+            biquad_eq_.setEQdB(db_values_);
+            break;
+        }
+        return true;
+    }
+
+    int get_output_rate() const override { return sample_rate_; }
+    void process(const int16_t* input, size_t count, std::vector<int16_t>& out) override {
+        switch (engine_) {
+        case EqEngine::FFT: eq_.process(input, count, out); break;
+        case EqEngine::CONV: conv_eq_.process(input, count, out); break;
+        case EqEngine::BIQUAD: biquad_eq_.process(input, count, out); break;
+        }
+    }
+    void flush(std::vector<int16_t>& out) override {
+        switch (engine_) {
+        case EqEngine::FFT: eq_.flush(out); break;
+        case EqEngine::CONV: conv_eq_.flush(out); break;
+        case EqEngine::BIQUAD: biquad_eq_.flush(out); break;
+        }
+    }
+    std::string name() const override { return "eq=" + spec_; }
+};
+
+bool parse_int(const std::string& text, int& value) {
+    char* end = nullptr;
+    long v = std::strtol(text.c_str(), &end, 10);
+    if (text.empty() || *end != '\0') {
+        return false;
+    }
+    value = static_cast<int>(v);
+    return true;
+}
+
+// 预设名或逗号分隔的dB值
+bool parse_eq(const std::string& spec, std::vector<float>& db_values) {
+    std::vector<std::string> names = srv::Equalizer::getPresetNames();
+    if (std::find(names.begin(), names.end(), spec) != names.end()) {
+        db_values = srv::Equalizer::createPreset(spec);
+        return true;
+    }
+    db_values.clear();
+    std::stringstream ss(spec);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        char* end = nullptr;
+        float v = std::strtof(item.c_str(), &end);
+        if (item.empty() || *end != '\0') {
+            return false;
+        }
+        db_values.push_back(v);
+    }
+    return db_values.size() >= 2;
+}
+
+std::unique_ptr<Stage> make_stage(const std::string& spec, EqEngine eq_engine) {
+    const size_t eq_pos = spec.find('=');
+    const std::string name = spec.substr(0, eq_pos);
+    const bool has_arg = eq_pos != std::string::npos;
+    const std::string arg = has_arg ? spec.substr(eq_pos + 1) : "";
+    int value = 0;
+
+    if (name == "resample" && parse_int(arg, value)) {
+        return std::unique_ptr<Stage>(new ResampleStage(value));
+    }
+    if (name == "vad") {
+        return std::unique_ptr<Stage>(new VadStage(false, arg));
+    }
+    if (name == "gate") {
+        return std::unique_ptr<Stage>(new VadStage(true, arg));
+    }
+    if (name == "ans" && (!has_arg || parse_int(arg, value))) {
+        return std::unique_ptr<Stage>(new AnsStage(false, has_arg ? value : -25));
+    }
+    if (name == "agc" && (!has_arg || parse_int(arg, value))) {
+        return std::unique_ptr<Stage>(new AnsStage(true, has_arg ? value : 8000));
+    }
+    if (name == "rnnoise" && !has_arg) {
+        return std::unique_ptr<Stage>(new RNNoiseStage());
+    }
+    std::vector<float> db_values;
+    if (name == "eq" && parse_eq(arg, db_values)) {
+        return std::unique_ptr<Stage>(new EqStage(arg, db_values, eq_engine));
+    }
+    return nullptr;
+}
+
+void print_usage() {
+    std::cerr << "用法: dspctl [选项] 处理级... < 输入 > 输出\n"
+              << "输入为WAV时自动识别格式，否则按以下选项解析原始PCM（多声道混音为单声道）:\n"
+              << "  --in-format s16|s24|s32|f32   样本格式（默认s16）\n"
+              << "  --in-rate N                   采样率（默认48000）\n"
+              << "  --in-channels N               声道数（默认1）\n"
+              << "输出为单声道s16:\n"
+              << "  --out-wav                     输出WAV（默认原始PCM）\n"
+              << "  -q                            不输出统计信息\n"
+              << "FFT规划（eq）:\n"
+              << "  --fft-wisdom FILE             启动时加载FFTW wisdom，结束时写回\n"
+              << "  --fft-planner estimate|measure|patient  规划精度（默认measure）\n"
+              << "均衡器引擎（作用于其后的eq级）:\n"
+              << "  --eq-engine fft|conv|biquad   fft延迟1023样本（默认），conv延迟127样本，biquad零延迟\n"
+              << "处理级（按顺序串联）:\n"
+              << "  resample=RATE                 重采样\n"
+              << "  vad[=FILE]                    语音检测，Audacity标签写到FILE（默认stderr），音频不变\n"
+              << "  gate[=FILE]                   语音检测并把非语音帧置零\n"
+              << "  ans[=dB]                      speex降噪（默认-25）\n"
+              << "  agc[=LEVEL]                   speex自动增益（默认8000）\n"
+              << "  rnnoise                       RNNoise降噪（需要48000Hz）\n"
+              << "  eq=PRESET|dB1,dB2,...         均衡器，预设:";
+    for (const auto& name : srv::Equalizer::getPresetNames()) {
+        std::cerr << " " << name;
+    }
+    std::cerr << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    // stdout只留给音频数据，各处理类打到std::cout的提示信息改走stderr
+    std::cout.rdbuf(std::cerr.rdbuf());
+
+    AudioFile::Format raw_format{48000, 1, AudioFile::SampleFormat::S16};
+    bool out_wav = false;
+    bool quiet = false;
+    std::string wisdom_path;
+    unsigned planner_flags = FFTW_MEASURE;
+    EqEngine eq_engine = EqEngine::FFT;
+    std::vector<std::unique_ptr<Stage>> stages;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        const bool has_value = i + 1 < argc;
+        if (arg == "-h" || arg == "--help") {
+            print_usage();
+            return 0;
+        } else if (arg == "--in-format" && has_value) {
+            std::string fmt = argv[++i];
+            if (fmt == "s16") raw_format.sample_format = AudioFile::SampleFormat::S16;
+            else if (fmt == "s24") raw_format.sample_format = AudioFile::SampleFormat::S24;
+            else if (fmt == "s32") raw_format.sample_format = AudioFile::SampleFormat::S32;
+            else if (fmt == "f32") raw_format.sample_format = AudioFile::SampleFormat::F32;
+            else {
+                std::cerr << "dspctl: unknown sample format " << fmt << std::endl;
+                return 1;
+            }
+        } else if (arg == "--in-rate" && has_value) {
+            raw_format.sample_rate = std::atoi(argv[++i]);
+        } else if (arg == "--in-channels" && has_value) {
+            raw_format.channels = std::atoi(argv[++i]);
+        } else if (arg == "--fft-wisdom" && has_value) {
+            wisdom_path = argv[++i];
+        } else if (arg == "--fft-planner" && has_value) {
+            std::string planner = argv[++i];
+            if (planner == "estimate") planner_flags = FFTW_ESTIMATE;
+            else if (planner == "measure") planner_flags = FFTW_MEASURE;
+            else if (planner == "patient") planner_flags = FFTW_PATIENT;
+            else {
+                std::cerr << "dspctl: unknown planner " << planner << std::endl;
+                return 1;
+            }
+        } else if (arg == "--eq-engine" && has_value) {
+            std::string engine = argv[++i];
+            if (engine == "fft") eq_engine = EqEngine::FFT;
+            else if (engine == "conv") eq_engine = EqEngine::CONV;
+            else if (engine == "biquad") eq_engine = EqEngine::BIQUAD;
+            else {
+                std::cerr << "dspctl: unknown eq engine " << engine << std::endl;
+                return 1;
+            }
+        } else if (arg == "--out-wav") {
+            out_wav = true;
+        } else if (arg == "-q") {
+            quiet = true;
+        } else {
+            std::unique_ptr<Stage> stage = make_stage(arg, eq_engine);
+            if (!stage) {
+                std::cerr << "dspctl: unknown stage or option " << arg << std::endl;
+                print_usage();
+                return 1;
+            }
+            stages.push_back(std::move(stage));
+        }
+    }
+
+    srv::FFTPlanRegistry& plans = srv::FFTPlanRegistry::instance();
+    plans.init(wisdom_path, planner_flags);
+
+    InputStream input;
+    if (!input.open(raw_format)) {
+        return 1;
+    }
+    const AudioFile::Format& format = input.get_format();
+    int rate = format.sample_rate;
+    for (auto& stage : stages) {
+        if (!stage->init(rate)) {
+            std::cerr << "dspctl: " << stage->name() << " init failed at " << rate << " Hz" << std::endl;
+            return 1;
+        }
+        rate = stage->get_output_rate();
+    }
+
+    OutputStream output;
+    if (!output.open(rate, out_wav)) {
+        return 1;
+    }
+
+    // buffers[k]是第k级的输入，每块复用，稳定后不再分配
+    std::vector<std::vector<int16_t>> buffers(stages.size() + 1);
+    bool ok = true;
+    auto run_from = [&](size_t first) {
+        for (size_t k = first; k < stages.size(); ++k) {
+            buffers[k + 1].clear();
+            stages[k]->process(buffers[k].data(), buffers[k].size(), buffers[k + 1]);
+        }
+        const std::vector<int16_t>& result = buffers[stages.size()];
+        ok = output.write(result.data(), result.size()) && ok;
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    uint64_t frames_in = 0;
+    while (ok) {
+        size_t frames = input.read(buffers[0]);
+        if (frames == 0) {
+            break;
+        }
+        frames_in += frames;
+        run_from(0);
+    }
+    // 逐级冲出：第k级的剩余样本还要经过后面各级
+    for (size_t k = 0; ok && k < stages.size(); ++k) {
+        buffers[k + 1].clear();
+        stages[k]->flush(buffers[k + 1]);
+        run_from(k + 1);
+    }
+    ok = output.close() && ok;
+    plans.save_wisdom();
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    if (!ok) {
+        std::cerr << "dspctl: write failed" << std::endl;
+        return 1;
+    }
+    if (!quiet) {
+        const double audio_seconds = static_cast<double>(frames_in) / format.sample_rate;
+        std::cerr << "dspctl: " << (input.is_wav() ? "WAV " : "PCM ") << AudioFile::get_format_name(format.sample_format)
+                  << " " << format.sample_rate << " Hz " << format.channels << "ch";
+        for (const auto& stage : stages) {
+            std::cerr << " -> " << stage->name();
+        }
+        std::cerr << " -> s16 " << rate << " Hz" << std::endl;
+        std::cerr << std::fixed << std::setprecision(2) << "  输入 " << audio_seconds << " 秒，输出 "
+                  << output.get_samples_written() << " 样本，耗时 " << std::setprecision(3) << seconds << " 秒 ("
+                  << std::setprecision(1) << (seconds > 0 ? audio_seconds / seconds : 0.0) << "x 实时)，峰值内存 "
+                  << (srv::ProcessStats::get_peak_rss_bytes() / (1024.0 * 1024.0)) << " MB" << std::endl;
+        if (plans.get_plan_count() > 0) {
+            std::cerr << std::setprecision(3) << "  FFT规划 " << plans.get_plan_count() << " 个计划，耗时 "
+                      << plans.get_planning_seconds() << " 秒" << (plans.is_wisdom_loaded() ? "（已加载wisdom）" : "")
+                      << std::endl;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,150 @@
+// 能量静音检测性能测试：逐样本重算窗口的原实现 vs EnergyVAD流式实现，校验静音段边界完全一致
+// 用法: energy_vad_bench [16k单声道s16le PCM文件]，不指定文件时生成1小时合成音频
+#include <iostream>
+#include <vector>
+#include <cmath>
+#include <cstdlib>
+#include <algorithm>
+#include <random>
+#include <string>
+#include <iomanip>
+#include <chrono>
+#include "util/AudioFile.h"
+#include "util/EnergyVAD.h"
+#include "util/DSPKernels.h"
+
+// 生成合成音频：随机长度的语音段、背景噪声段和数字静音段交替出现
+std::vector<short> generate_audio(int duration_s, int sample_rate) {
+    std::vector<short> audio(static_cast<size_t>(duration_s) * sample_rate, 0);
+    std::mt19937 gen(31);
+    std::uniform_int_distribution<int> segment_ms(50, 3000);
+    std::uniform_int_distribution<int> kind_dist(0, 2);
+    std::normal_distribution<double> noise_dist(0.0, 1.0);
+
+    size_t i = 0;
+    while (i < audio.size()) {
+        size_t length = std::min(audio.size() - i, static_cast<size_t>(segment_ms(gen)) * sample_rate / 1000);
+        int kind = kind_dist(gen);
+        for (size_t k = 0; k < length; ++k, ++i) {
+            double t = static_cast<double>(i) / sample_rate;
+            double value = 0.0;
+            if (kind == 0) {
+                double envelope = 0.5 + 0.5 * std::sin(2.0 * M_PI * 4.0 * t);
+                value = 3000.0 * envelope * std::sin(2.0 * M_PI * 180.0 * t) + 100.0 * noise_dist(gen);
+            } else if (kind == 1) {
+                // 平均幅度在门限附近的噪声
+                value = 125.0 * noise_dist(gen);
+            }
+            audio[i] = static_cast<short>(std::max(-32768.0, std::min(32767.0, value)));
+        }
+    }
+    return audio;
+}
+
+// 原实现：每个样本重新累加整个窗口
+std::vector<srv::EnergyVAD::Segment> detect_legacy(const std::vector<short>& audio_data, int threshold,
+                                                   int window_size, size_t min_silence_duration) {
+    std::vector<srv::EnergyVAD::Segment> segments;
+    bool in_silence = false;
+    size_t silence_start_sample = 0;
+
+    for (size_t i = 0; i < audio_data.size(); ++i) {
+        double window_energy = 0.0;
+        int window_count = 0;
+        for (int j = 0; j < window_size && (i + j) < audio_data.size(); ++j) {
+            window_energy += std::abs(audio_data[i + j]);
+            window_count++;
+        }
+        double avg_amplitude = window_energy / window_count;
+        bool is_silent = avg_amplitude <= threshold;
+
+        if (is_silent && !in_silence) {
+            in_silence = true;
+            silence_start_sample = i;
+        } else if (!is_silent && in_silence) {
+            if (i - silence_start_sample >= min_silence_duration) {
+                segments.push_back({silence_start_sample, i});
+            }
+            in_silence = false;
+        }
+    }
+    if (in_silence && audio_data.size() - silence_start_sample >= min_silence_duration) {
+        segments.push_back({silence_start_sample, audio_data.size()});
+    }
+    return segments;
+}
+
+bool same_segments(const std::vector<srv::EnergyVAD::Segment>& a, const std::vector<srv::EnergyVAD::Segment>& b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (a[i].start_sample != b[i].start_sample || a[i].end_sample != b[i].end_sample) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    std::cout << "=== 能量静音检测性能测试 ===" << std::endl;
+    const int sample_rate = 16000;
+    const int threshold = 100;
+    const int window_size = 160;
+    const size_t min_silence = 160;
+
+    std::vector<short> audio;
+    if (argc > 1) {
+        const srv::AudioFile::Format raw_format{sample_rate, 1, srv::AudioFile::SampleFormat::S16};
+        srv::MonoAudio loaded = srv::load_audio_mono(argv[1], sample_rate, &raw_format);
+        if (!srv::print_audio_info(argv[1], loaded) || loaded.samples.empty()) {
+            return 1;
+        }
+        audio = std::move(loaded.samples);
+    } else {
+        std::cout << "生成1小时合成音频..." << std::endl;
+        audio = generate_audio(3600, sample_rate);
+    }
+    double audio_seconds = static_cast<double>(audio.size()) / sample_rate;
+    std::cout << "音频时长: " << std::fixed << std::setprecision(1) << audio_seconds << "s, 指令集: "
+              << srv::kernels::get_isa_name() << std::endl;
+
+    // 原实现
+    auto start = std::chrono::steady_clock::now();
+    auto legacy = detect_legacy(audio, threshold, window_size, min_silence);
+    double legacy_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // 流式实现，整块输入
+    srv::EnergyVAD detector;
+    detector.init(threshold, window_size, min_silence);
+    start = std::chrono::steady_clock::now();
+    detector.process(audio.data(), audio.size());
+    detector.finish();
+    double stream_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    auto streamed = detector.get_segments();
+
+    // 流式实现，随机大小分块输入，结果应与整块一致
+    srv::EnergyVAD chunked;
+    chunked.init(threshold, window_size, min_silence);
+    std::mt19937 gen(5);
+    std::uniform_int_distribution<size_t> chunk_dist(1, 4000);
+    for (size_t pos = 0; pos < audio.size();) {
+        size_t n = std::min(audio.size() - pos, chunk_dist(gen));
+        chunked.process(audio.data() + pos, n);
+        pos += n;
+    }
+    chunked.finish();
+
+    std::cout << "\n静音段数: 原实现 " << legacy.size() << ", 流式 " << streamed.size() << std::endl;
+    std::cout << "边界一致 (整块): " << (same_segments(legacy, streamed) ? "✅" : "❌") << std::endl;
+    std::cout << "边界一致 (分块): " << (same_segments(legacy, chunked.get_segments()) ? "✅" : "❌") << std::endl;
+    std::cout << "逐样本细化步占比: " << std::setprecision(2) << (100.0 * detector.get_refined_ratio()) << "%" << std::endl;
+    std::cout << "\n原实现:   " << std::setprecision(3) << (legacy_s * 1000.0) << " ms ("
+              << std::setprecision(2) << (legacy_s * 1e9 / audio.size()) << " ns/样本)" << std::endl;
+    std::cout << "流式实现: " << std::setprecision(3) << (stream_s * 1000.0) << " ms ("
+              << std::setprecision(2) << (stream_s * 1e9 / audio.size()) << " ns/样本)" << std::endl;
+    std::cout << "加速比: " << std::setprecision(1) << (legacy_s / (stream_s + 1e-12)) << "x" << std::endl;
+
+    std::cout << "\n=== 测试完成 ===" << std::endl;
+    return same_segments(legacy, streamed) && same_segments(legacy, chunked.get_segments()) ? 0 : 1;
+}
@@ -0,0 +1,174 @@
+// EQ实数FFT性能测试：对比改动前的复数FFT重叠-相加实现与srv::Equalizer的r2c/c2r实现
+// 用法: eq_fft_bench [音频秒数，默认60]
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <iomanip>
+#include <chrono>
+#include <functional>
+#include <fftw3.h>
+#include "util/DSPKernels.h"
+#include "util/Equalizer.h"
+
+namespace {
+
+// 改动前的实现：实信号放进复数FFT（虚部置零），正负频率分别乘增益
+class ComplexFFTEqualizer {
+private:
+    int fft_size_;
+    fftwf_plan fft_plan_forward_;
+    fftwf_plan fft_plan_backward_;
+    fftwf_complex* fft_buffer_;
+    std::vector<float> window_;
+    std::vector<float> eq_response_;
+    std::vector<float> overlap_buffer_;
+    std::vector<float> input_buffer_;
+    std::vector<float> output_buffer_;
+
+public:
+    ComplexFFTEqualizer(int fft_bits, const std::vector<float>& response)
+        : fft_size_(1 << fft_bits), eq_response_(response.begin(), response.begin() + (1 << fft_bits) / 2) {
+        fft_buffer_ = fftwf_alloc_complex(fft_size_);
+        fft_plan_forward_ = fftwf_plan_dft_1d(fft_size_, fft_buffer_, fft_buffer_, FFTW_FORWARD, FFTW_ESTIMATE);
+        fft_plan_backward_ = fftwf_plan_dft_1d(fft_size_, fft_buffer_, fft_buffer_, FFTW_BACKWARD, FFTW_ESTIMATE);
+        window_.resize(fft_size_);
+        for (int i = 0; i < fft_size_; ++i) {
+            window_[i] = 0.5f - 0.5f * cos(2.0f * M_PI * i / (fft_size_ - 1));
+        }
+        overlap_buffer_.assign(fft_size_ / 2, 0.0f);
+        input_buffer_.assign(fft_size_, 0.0f);
+        output_buffer_.assign(fft_size_ / 2, 0.0f);
+    }
+
+    ~ComplexFFTEqualizer() {
+        fftwf_destroy_plan(fft_plan_forward_);
+        fftwf_destroy_plan(fft_plan_backward_);
+        fftwf_free(fft_buffer_);
+    }
+
+    std::vector<short> processAudio(const std::vector<short>& input) {
+        std::vector<short> output;
+        output.reserve(input.size());
+        std::fill(overlap_buffer_.begin(), overlap_buffer_.end(), 0.0f);
+        const int hop_size = fft_size_ / 2;
+
+        for (size_t i = 0; i < input.size(); i += hop_size) {
+            const size_t available = std::min(static_cast<size_t>(fft_size_), input.size() - i);
+            srv::kernels::s16_to_f32(&input[i], input_buffer_.data(), available, 1.0f / 32768.0f);
+            std::fill(input_buffer_.begin() + available, input_buffer_.end(), 0.0f);
+
+            for (int j = 0; j < fft_size_; ++j) {
+                fft_buffer_[j][0] = input_buffer_[j] * window_[j];
+                fft_buffer_[j][1] = 0.0f;
+            }
+            fftwf_execute(fft_plan_forward_);
+            for (int j = 0; j < fft_size_ / 2; ++j) {
+                float coeff = eq_response_[j];
+                fft_buffer_[j][0] *= coeff;
+                fft_buffer_[j][1] *= coeff;
+                if (j > 0) {
+                    fft_buffer_[fft_size_ - j][0] *= coeff;
+                    fft_buffer_[fft_size_ - j][1] *= coeff;
+                }
+            }
+            fftwf_execute(fft_plan_backward_);
+            for (int j = 0; j < hop_size; ++j) {
+                output_buffer_[j] = fft_buffer_[j][0] / fft_size_ + overlap_buffer_[j];
+                overlap_buffer_[j] = fft_buffer_[j + hop_size][0] / fft_size_;
+            }
+
+            const size_t valid = std::min(static_cast<size_t>(hop_size), input.size() - i);
+            const size_t written = output.size();
+            output.resize(written + valid);
+            srv::kernels::f32_to_s16(output_buffer_.data(), &output[written], valid, 32768.0f);
+        }
+        return output;
+    }
+};
+
+// 语音频段的几个正弦加白噪声
+std::vector<short> make_input(int sample_rate, int seconds) {
+    std::vector<short> audio(static_cast<size_t>(sample_rate) * seconds);
+    std::mt19937 gen(11);
+    std::normal_distribution<float> noise(0.0f, 800.0f);
+    const float tones[] = {180.0f, 440.0f, 1250.0f, 3100.0f, 7900.0f};
+    for (size_t i = 0; i < audio.size(); ++i) {
+        float t = static_cast<float>(i) / sample_rate;
+        float v = noise(gen);
+        for (float f : tones) {
+            v += 2500.0f * std::sin(2.0f * static_cast<float>(M_PI) * f * t);
+        }
+        audio[i] = static_cast<short>(std::max(-32768.0f, std::min(32767.0f, v)));
+    }
+    return audio;
+}
+
+// 多次运行取最快一次（秒）
+double best_of(int runs, const std::function<void()>& fn) {
+    double best = 1e30;
+    for (int r = 0; r < runs; ++r) {
+        auto start = std::chrono::steady_clock::now();
+        fn();
+        best = std::min(best, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+    }
+    return best;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const int sample_rate = 48000;
+    int seconds = 60;
+    if (argc > 1) {
+        seconds = std::max(1, std::atoi(argv[1]));
+    }
+
+    std::cout << "=== EQ实数FFT性能测试 ===" << std::endl;
+    std::cout << "音频: " << seconds << " 秒, " << sample_rate << " Hz, 预设vocal_boost" << std::endl;
+    std::vector<short> input = make_input(sample_rate, seconds);
+    const std::vector<float> preset = srv::Equalizer::createPreset("vocal_boost");
+
+    bool all_ok = true;
+    for (int fft_bits : {10, 12}) {
+        const int fft_size = 1 << fft_bits;
+        srv::Equalizer eq;
+        if (!eq.init(fft_bits, sample_rate)) {
+            return 1;
+        }
+        eq.setEQdB(preset);
+        ComplexFFTEqualizer reference(fft_bits, eq.get_response());
+
+        std::vector<short> complex_out;
+        std::vector<short> real_out;
+        const double complex_seconds = best_of(3, [&] { complex_out = reference.processAudio(input); });
+        const double real_seconds = best_of(3, [&] { real_out = eq.processAudio(input); });
+
+        int max_diff = 0;
+        for (size_t i = 0; i < input.size(); ++i) {
+            max_diff = std::max(max_diff, std::abs(complex_out[i] - real_out[i]));
+        }
+        const bool ok = complex_out.size() == real_out.size() && max_diff <= 2;
+        all_ok = all_ok && ok;
+
+        const double frames = std::ceil(static_cast<double>(input.size()) / (fft_size / 2));
+        std::cout << "\nFFT " << fft_size << "点 (fft_bits=" << fft_bits << "):" << std::endl;
+        std::cout << std::fixed << std::setprecision(2);
+        std::cout << "  复数FFT: " << std::setw(8) << complex_seconds * 1000.0 << " ms, "
+                  << std::setw(6) << complex_seconds / frames * 1e6 << " us/帧, FFT缓冲区 "
+                  << fft_size * sizeof(fftwf_complex) / 1024.0 << " KB" << std::endl;
+        std::cout << "  实数FFT: " << std::setw(8) << real_seconds * 1000.0 << " ms, "
+                  << std::setw(6) << real_seconds / frames * 1e6 << " us/帧, FFT缓冲区 "
+                  << (fft_size / 2 + 1) * sizeof(fftwf_complex) / 1024.0 << " KB"
+                  << std::endl;
+        std::cout << "  加速比: " << complex_seconds / real_seconds << "x, 实时倍数 " << std::setprecision(0)
+                  << seconds / real_seconds << "x" << std::endl;
+        std::cout << "  " << (ok ? "✅" : "❌") << " 最大样本差异: " << max_diff << " LSB" << std::endl;
+    }
+
+    std::cout << "\n" << (all_ok ? "✅ 实数FFT与复数FFT结果一致" : "❌ 结果差异超出舍入误差") << std::endl;
+    return all_ok ? 0 : 1;
+}
@@ -0,0 +1,151 @@
+// FFT计划注册表测试：规划精度对规划耗时/变换速度的影响，多线程并发创建EQ实例时共享计划，wisdom重启加速
+// 用法: fft_plan_bench [wisdom文件，默认fft_plan_wisdom.dat]
+//       连续运行两次，第二次加载wisdom后规划耗时接近0
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <string>
+#include <iomanip>
+#include <chrono>
+#include <thread>
+#include <fftw3.h>
+#include "util/Equalizer.h"
+#include "util/FFTPlanRegistry.h"
+
+namespace {
+
+double seconds_since(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+struct PlannerResult {
+    double plan_seconds;
+    double exec_us;     // 一次r2c+c2r的耗时（微秒）
+};
+
+// 直接调用FFTW（不经过注册表），每次先清空wisdom，测冷启动规划耗时
+PlannerResult measure_planner(int size, unsigned flags) {
+    fftwf_forget_wisdom();
+    float* real = fftwf_alloc_real(2 * (size / 2 + 1));
+    fftwf_complex* spectrum = fftwf_alloc_complex(size / 2 + 1);
+
+    auto start = std::chrono::steady_clock::now();
+    fftwf_plan forward = fftwf_plan_dft_r2c_1d(size, real, spectrum, flags);
+    fftwf_plan backward = fftwf_plan_dft_c2r_1d(size, spectrum, real, flags);
+    PlannerResult result;
+    result.plan_seconds = seconds_since(start);
+
+    std::mt19937 gen(3);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    for (int i = 0; i < size; ++i) {
+        real[i] = dist(gen);
+    }
+    const float scale = 1.0f / size;
+    int reps = 0;
+    start = std::chrono::steady_clock::now();
+    double elapsed = 0.0;
+    do {
+        for (int k = 0; k < 64; ++k) {
+            fftwf_execute(forward);
+            fftwf_execute(backward);
+            real[0] *= scale;   // 防止数值增长
+        }
+        reps += 64;
+        elapsed = seconds_since(start);
+    } while (elapsed < 0.2);
+    result.exec_us = elapsed / reps * 1e6;
+
+    fftwf_destroy_plan(forward);
+    fftwf_destroy_plan(backward);
+    fftwf_free(real);
+    fftwf_free(spectrum);
+    return result;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const std::string wisdom_path = argc > 1 ? argv[1] : "fft_plan_wisdom.dat";
+
+    std::cout << "=== FFT计划注册表测试 ===" << std::endl;
+    std::cout << "\n规划精度对比（r2c+c2r，冷启动无wisdom）:" << std::endl;
+    std::cout << std::setw(8) << "点数" << std::setw(12) << "规划" << std::setw(12) << "规划(ms)"
+              << std::setw(14) << "变换(us)" << std::endl;
+    const std::pair<const char*, unsigned> planners[] = {
+        {"ESTIMATE", FFTW_ESTIMATE}, {"MEASURE", FFTW_MEASURE}, {"PATIENT", FFTW_PATIENT}};
+    for (int size : {1024, 4096}) {
+        double estimate_us = 0.0;
+        for (const auto& planner : planners) {
+            PlannerResult result = measure_planner(size, planner.second);
+            if (planner.second == FFTW_ESTIMATE) {
+                estimate_us = result.exec_us;
+            }
+            std::cout << std::fixed << std::setw(8) << size << std::setw(12) << planner.first << std::setw(12)
+                      << std::setprecision(2) << result.plan_seconds * 1000.0 << std::setw(12)
+                      << std::setprecision(2) << result.exec_us << "  (" << std::setprecision(2)
+                      << estimate_us / result.exec_us << "x)" << std::endl;
+        }
+    }
+    fftwf_forget_wisdom();
+
+    // 多线程同时创建EQ实例：规划在注册表内串行化，同类变换只规划一次
+    srv::FFTPlanRegistry& registry = srv::FFTPlanRegistry::instance();
+    auto start = std::chrono::steady_clock::now();
+    if (!registry.init(wisdom_path, FFTW_MEASURE)) {
+        std::cerr << "⚠️  wisdom文件无法解析，将重新规划" << std::endl;
+    }
+    const double load_seconds = seconds_since(start);
+
+    const int thread_count = 8;
+    const int sample_rate = 48000;
+    std::vector<short> input(sample_rate * 2);
+    std::mt19937 gen(5);
+    std::uniform_int_distribution<int> dist(-12000, 12000);
+    for (auto& v : input) {
+        v = static_cast<short>(dist(gen));
+    }
+
+    std::vector<std::vector<short>> outputs(thread_count * 2);
+    std::vector<std::thread> threads;
+    start = std::chrono::steady_clock::now();
+    for (int t = 0; t < thread_count; ++t) {
+        threads.emplace_back([&, t] {
+            int index = t * 2;
+            for (int fft_bits : {10, 12}) {
+                srv::Equalizer eq;
+                if (!eq.init(fft_bits, sample_rate)) {
+                    return;
+                }
+                eq.setEQdB(srv::Equalizer::createPreset("vocal_boost"));
+                outputs[index++] = eq.processAudio(input);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    const double run_seconds = seconds_since(start);
+
+    bool consistent = true;
+    for (int t = 1; t < thread_count; ++t) {
+        consistent = consistent && outputs[t * 2] == outputs[0] && outputs[t * 2 + 1] == outputs[1];
+    }
+    consistent = consistent && outputs[0].size() == input.size() && outputs[1].size() == input.size();
+
+    std::cout << "\n注册表（FFTW_MEASURE，" << thread_count << "个线程各创建fft_bits=10/12两个EQ）:" << std::endl;
+    std::cout << std::setprecision(3);
+    std::cout << "  wisdom: " << wisdom_path << (registry.is_wisdom_loaded() ? "（已加载）" : "（未找到，本次生成）")
+              << "，加载耗时 " << load_seconds * 1000.0 << " ms" << std::endl;
+    std::cout << "  计划请求: " << registry.get_lookup_count() << " 次，实际规划: " << registry.get_plan_count()
+              << " 个" << std::endl;
+    std::cout << "  规划耗时: " << registry.get_planning_seconds() * 1000.0 << " ms" << std::endl;
+    std::cout << "  创建+处理总耗时: " << run_seconds * 1000.0 << " ms" << std::endl;
+    std::cout << "  " << (consistent ? "✅ 各线程输出一致" : "❌ 各线程输出不一致") << std::endl;
+
+    if (!registry.save_wisdom()) {
+        return 1;
+    }
+    return consistent ? 0 : 1;
+}
@@ -4,31 +4,11 @@
 #include <fstream>
 #include <iomanip>
 #include <cmath>
+#include <algorithm>
 #include <fftw3.h>
-
-// 读取PCM文件
-std::vector<short> read_pcm_file_int16(const std::string& filename) {
-    std::ifstream file(filename, std::ios::binary);
-    if (!file.is_open()) {
-        std::cerr << "❌ 无法打开文件: " << filename << std::endl;
-        return {};
-    }
-    
-    file.seekg(0, std::ios::end);
-    size_t file_size = file.tellg();
-    file.seekg(0, std::ios::beg);
-    
-    size_t num_samples = file_size / sizeof(short);
-    std::vector<short> audio_data(num_samples);
-    file.read(reinterpret_cast<char*>(audio_data.data()), file_size);
-    
-    std::cout << "✅ 成功读取PCM文件: " << filename << std::endl;
-    std::cout << "   文件大小: " << file_size << " 字节" << std::endl;
-    std::cout << "   样本数量: " << num_samples << std::endl;
-    std::cout << "   时长: " << std::fixed << std::setprecision(2) << (num_samples / 48000.0) << " 秒" << std::endl;
-    
-    return audio_data;
-}
+#include "util/AudioFile.h"
+#include "util/DSPKernels.h"
+#include "util/FFTPlanRegistry.h"
 
 class FrequencyAnalyzer {
 private:
@@ -37,6 +17,7 @@ private:
     fftwf_plan fft_plan_;
     fftwf_complex* fft_buffer_;
     std::vector<float> window_;
+    std::vector<float> input_buffer_;
     
 public:
     FrequencyAnalyzer(int fft_size = 1024, double sample_rate = 48000.0) 
@@ -55,18 +36,19 @@ public:
         // 分配FFT缓冲区
         fft_buffer_ = fftwf_alloc_complex(fft_size_);
         
-        // 创建FFT计划
-        fft_plan_ = fftwf_plan_dft_1d(fft_size_, fft_buffer_, fft_buffer_, FFTW_FORWARD, FFTW_ESTIMATE);
+        // 从注册表取共享的FFT计划
+        fft_plan_ = srv::FFTPlanRegistry::instance().get_dft(fft_size_, FFTW_FORWARD, fft_buffer_, fft_buffer_);
         
         // 初始化窗口函数
         window_.resize(fft_size_);
         for (int i = 0; i < fft_size_; ++i) {
             window_[i] = 0.54f - 0.46f * std::cos(2.0f * M_PI * i / (fft_size_ - 1));
         }
+        
+        input_buffer_.resize(fft_size_, 0.0f);
     }
     
     void cleanup() {
-        if (fft_plan_) fftwf_destroy_plan(fft_plan_);
         if (fft_buffer_) fftwf_free(fft_buffer_);
     }
     
@@ -90,17 +72,19 @@ public:
         std::vector<float> spectrum(fft_size_ / 2);
         
         // 填充输入缓冲区
+        const size_t available = start_sample < audio_data.size()
+            ? std::min(static_cast<size_t>(fft_size_), audio_data.size() - start_sample) : 0;
+        if (available > 0) {
+            srv::kernels::s16_to_f32(&audio_data[start_sample], input_buffer_.data(), available, 1.0f / 32768.0f);
+        }
+        std::fill(input_buffer_.begin() + available, input_buffer_.end(), 0.0f);
         for (int i = 0; i < fft_size_; ++i) {
-            if (start_sample + i < audio_data.size()) {
-                fft_buffer_[i][0] = static_cast<float>(audio_data[start_sample + i]) / 32767.0f * window_[i];
-            } else {
-                fft_buffer_[i][0] = 0.0f;
-            }
+            fft_buffer_[i][0] = input_buffer_[i] * window_[i];
             fft_buffer_[i][1] = 0.0f;
         }
         
         // 执行FFT
-        fftwf_execute(fft_plan_);
+        fftwf_execute_dft(fft_plan_, fft_buffer_, fft_buffer_);
         
         // 计算功率谱
         for (int i = 0; i < fft_size_ / 2; ++i) {
@@ -229,13 +213,19 @@ public:
     }
 };
 
-int main() {
+int main(int argc, char** argv) {
     std::cout << "=== PCM音频频率分析 ===" << std::endl;
     std::cout << "分析PCM数据如何映射到频段" << std::endl;
     
+    srv::FFTPlanRegistry::instance().init(srv::FFTPlanRegistry::take_wisdom_arg(argc, argv));
+    
     // 读取音频文件
     std::cout << "\n步骤1: 读取音频文件..." << std::endl;
-    auto input_audio = read_pcm_file_int16("res/48000_1_s16le.pcm");
+    // WAV或48kHz单声道s16原始PCM，采样率不同时重采样到48kHz
+    const srv::AudioFile::Format raw_format{48000, 1, srv::AudioFile::SampleFormat::S16};
+    srv::MonoAudio loaded = srv::load_audio_mono("res/48000_1_s16le.pcm", 48000, &raw_format);
+    srv::print_audio_info("res/48000_1_s16le.pcm", loaded);
+    auto input_audio = std::move(loaded.samples);
     
     if (input_audio.empty()) {
         std::cerr << "❌ 无法读取音频文件" << std::endl;
@@ -258,5 +248,6 @@ int main() {
     std::cout << "3. EQ频段通过FFT bin来影响特定频率范围" << std::endl;
     std::cout << "4. 调整某个频段的dB值会影响该频段附近的频率" << std::endl;
     
+    srv::FFTPlanRegistry::instance().save_wisdom();
     return 0;
 } 
\ No newline at end of file
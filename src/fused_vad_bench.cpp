@@ -0,0 +1,140 @@
+// 分级融合VAD测试：统计各级判决占比，对比始终调用RNNoise的CPU开销和判决一致性
+// 用法: fused_vad_bench [WAV或16k单声道s16le PCM文件 ...]
+// WAV可直接读取，采样率不同时自动重采样
+#include <iostream>
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include <random>
+#include <string>
+#include <iomanip>
+#include "util/AudioFile.h"
+#include "util/FusedVAD.h"
+#include "util/RNNoise.h"
+#include "util/Resampler.h"
+#include "util/VADSmoother.h"
+#include "util/ProcessStats.h"
+
+// 生成合成语料：每10秒中4秒类语音信号（含弱音节），其余为背景噪声和闭麦静音
+std::vector<short> generate_corpus(int duration_s, int sample_rate) {
+    std::vector<short> audio(static_cast<size_t>(duration_s) * sample_rate, 0);
+    std::mt19937 gen(11);
+    std::normal_distribution<double> noise_dist(0.0, 1.0);
+
+    for (size_t i = 0; i < audio.size(); ++i) {
+        double t = static_cast<double>(i) / sample_rate;
+        double phase_in_cycle = std::fmod(t, 10.0);
+        double value = 0.0;
+        if (phase_in_cycle < 4.0) {
+            // 音节包络调制的谐波，后半段电平降低制造模糊帧
+            double level = phase_in_cycle < 2.0 ? 4000.0 : 800.0;
+            double envelope = 0.5 + 0.5 * std::sin(2.0 * M_PI * 4.0 * t);
+            double f0 = 140.0 + 30.0 * std::sin(2.0 * M_PI * 0.7 * t);
+            for (int h = 1; h <= 8; ++h) {
+                value += std::sin(2.0 * M_PI * f0 * h * t) / h;
+            }
+            value = level * envelope * value + 200.0 * noise_dist(gen);
+        } else if (phase_in_cycle < 7.0) {
+            // 背景噪声
+            value = 300.0 * noise_dist(gen);
+        } else {
+            // 闭麦后的极低电平抖动
+            value = 2.0 * noise_dist(gen);
+        }
+        audio[i] = static_cast<short>(std::max(-32768.0, std::min(32767.0, value)));
+    }
+    return audio;
+}
+
+void run_comparison(const std::string& name, const std::vector<short>& audio, int sample_rate) {
+    const int frame_size = sample_rate / 100;
+    const size_t num_frames = audio.size() / frame_size;
+    if (num_frames == 0) {
+        return;
+    }
+
+    std::vector<bool> fused_decisions(num_frames);
+    std::vector<bool> rnnoise_decisions(num_frames);
+
+    // 分级融合VAD
+    srv::FusedVAD fused;
+    if (!fused.init(sample_rate, frame_size)) {
+        return;
+    }
+    double cpu_start = srv::ProcessStats::get_thread_cpu_seconds();
+    for (size_t f = 0; f < num_frames; ++f) {
+        fused_decisions[f] = fused.process_frame(&audio[f * frame_size]);
+    }
+    double cpu_fused = srv::ProcessStats::get_thread_cpu_seconds() - cpu_start;
+
+    // 基线：每帧都重采样并调用RNNoise，使用相同的平滑参数
+    srv::Resampler resampler;
+    srv::RNNoise rnnoise;
+    srv::VADSmoother smoother;
+    resampler.init(sample_rate, srv::RNNoise::get_sample_rate(), 1, SPEEX_RESAMPLER_QUALITY_VOIP);
+    rnnoise.init();
+    smoother.init();
+    std::vector<float> input(frame_size);
+    std::vector<float> fifo;
+    float scratch[srv::RNNoise::FRAME_SIZE];
+    float prob = 0.0f;
+    cpu_start = srv::ProcessStats::get_thread_cpu_seconds();
+    for (size_t f = 0; f < num_frames; ++f) {
+        for (int j = 0; j < frame_size; ++j) {
+            input[j] = audio[f * frame_size + j];
+        }
+        resampler.process(input.data(), input.size(), fifo);
+        size_t consumed = 0;
+        while (fifo.size() - consumed >= static_cast<size_t>(srv::RNNoise::FRAME_SIZE)) {
+            prob = rnnoise.process_frame(scratch, &fifo[consumed]);
+            consumed += srv::RNNoise::FRAME_SIZE;
+        }
+        fifo.erase(fifo.begin(), fifo.begin() + consumed);
+        rnnoise_decisions[f] = smoother.update(prob > 0.5f);
+    }
+    double cpu_rnnoise = srv::ProcessStats::get_thread_cpu_seconds() - cpu_start;
+
+    size_t agree = 0;
+    for (size_t f = 0; f < num_frames; ++f) {
+        if (fused_decisions[f] == rnnoise_decisions[f]) {
+            agree++;
+        }
+    }
+
+    double audio_seconds = static_cast<double>(num_frames) * frame_size / sample_rate;
+    uint64_t total = fused.get_total_frames();
+    std::cout << "\n" << name << " (" << std::fixed << std::setprecision(1) << audio_seconds << "s):" << std::endl;
+    std::cout << "  能量级判决: " << std::setprecision(1)
+              << (100.0 * fused.get_tier_frames(srv::FusedVAD::Tier::ENERGY) / total) << "%" << std::endl;
+    std::cout << "  Speex级判决: "
+              << (100.0 * fused.get_tier_frames(srv::FusedVAD::Tier::SPEEX) / total) << "%" << std::endl;
+    std::cout << "  RNNoise级判决: "
+              << (100.0 * fused.get_tier_frames(srv::FusedVAD::Tier::RNNOISE) / total) << "%"
+              << " (RNNoise实际推理 " << fused.get_rnnoise_runs() << " 帧，含回放和保温)" << std::endl;
+    std::cout << "  CPU/路 (融合): " << std::setprecision(3) << (cpu_fused * 1000.0 / audio_seconds)
+              << " ms/音频秒, 单核可承载 " << std::setprecision(0) << (audio_seconds / (cpu_fused + 1e-12)) << " 路" << std::endl;
+    std::cout << "  CPU/路 (始终RNNoise): " << std::setprecision(3) << (cpu_rnnoise * 1000.0 / audio_seconds)
+              << " ms/音频秒, 单核可承载 " << std::setprecision(0) << (audio_seconds / (cpu_rnnoise + 1e-12)) << " 路" << std::endl;
+    std::cout << "  CPU节省: " << std::setprecision(1) << (100.0 * (1.0 - cpu_fused / (cpu_rnnoise + 1e-12))) << "%" << std::endl;
+    std::cout << "  平滑后判决一致率: " << std::setprecision(2) << (100.0 * agree / num_frames) << "%" << std::endl;
+}
+
+int main(int argc, char** argv) {
+    std::cout << "=== 分级融合VAD测试 ===" << std::endl;
+    const int sample_rate = 16000;
+
+    // WAV或16kHz单声道s16原始PCM，采样率不同时重采样到16kHz
+    const srv::AudioFile::Format raw_format{sample_rate, 1, srv::AudioFile::SampleFormat::S16};
+    for (int i = 1; i < argc; ++i) {
+        srv::MonoAudio loaded = srv::load_audio_mono(argv[i], sample_rate, &raw_format);
+        if (srv::print_audio_info(argv[i], loaded) && !loaded.samples.empty()) {
+            run_comparison(argv[i], loaded.samples, sample_rate);
+        }
+    }
+
+    auto corpus = generate_corpus(120, sample_rate);
+    run_comparison("合成语料 (40%语音)", corpus, sample_rate);
+
+    std::cout << "\n=== 测试完成 ===" << std::endl;
+    return 0;
+}
@@ -0,0 +1,218 @@
+// 格式转换/交织内核性能测试：逐个指令集运行同一组内核，与标量实现逐位比对结果
+// 用法: kernels_bench [样本数，默认1048576]
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <iomanip>
+#include <chrono>
+#include <functional>
+#include "util/DSPKernels.h"
+
+using srv::kernels::Isa;
+
+namespace {
+
+struct BenchInput {
+    std::vector<int16_t> s16;
+    std::vector<float> f32;         // 含越界值、NaN和恰好x.5的值，覆盖饱和与舍入
+    std::vector<uint8_t> s24;
+    std::vector<uint8_t> s32;
+};
+
+BenchInput make_input(size_t count) {
+    BenchInput input;
+    std::mt19937 gen(7);
+    std::uniform_int_distribution<int> s16_dist(-32768, 32767);
+    std::uniform_real_distribution<float> f32_dist(-1.2f, 1.2f);
+    std::uniform_int_distribution<int32_t> s32_dist(INT32_MIN, INT32_MAX);
+
+    input.s16.resize(count);
+    input.f32.resize(count);
+    input.s24.resize(count * 3);
+    input.s32.resize(count * 4);
+    for (size_t i = 0; i < count; ++i) {
+        input.s16[i] = static_cast<int16_t>(s16_dist(gen));
+        input.f32[i] = f32_dist(gen);
+        if (i % 997 == 0) input.f32[i] = std::nanf("");
+        if (i % 991 == 0) input.f32[i] = (static_cast<float>(i % 64) - 32.0f + 0.5f) / 32768.0f;
+        int32_t v = s32_dist(gen);
+        std::memcpy(&input.s32[4 * i], &v, 4);
+        input.s24[3 * i] = static_cast<uint8_t>(v >> 8);
+        input.s24[3 * i + 1] = static_cast<uint8_t>(v >> 16);
+        input.s24[3 * i + 2] = static_cast<uint8_t>(v >> 24);
+    }
+    return input;
+}
+
+// 返回每秒处理的百万样本数
+double measure(const std::function<void()>& fn, size_t samples) {
+    fn();   // 预热
+    int reps = 0;
+    auto start = std::chrono::steady_clock::now();
+    double elapsed = 0.0;
+    do {
+        fn();
+        ++reps;
+        elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    } while (elapsed < 0.2);
+    return static_cast<double>(samples) * reps / elapsed / 1e6;
+}
+
+template <typename T>
+bool same_bits(const std::vector<T>& a, const std::vector<T>& b) {
+    return a.size() == b.size() && std::memcmp(a.data(), b.data(), a.size() * sizeof(T)) == 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t count = 1 << 20;
+    if (argc > 1) {
+        count = static_cast<size_t>(std::strtoull(argv[1], nullptr, 10));
+    }
+    // 不是8的倍数，覆盖各SIMD版本的尾部处理
+    count += 5;
+
+    std::cout << "=== 格式转换/交织内核性能测试 ===" << std::endl;
+    std::cout << "样本数: " << count << std::endl;
+    std::cout << "自动选择的指令集: " << srv::kernels::get_isa_name(srv::kernels::get_active_isa()) << std::endl;
+    const Isa best = srv::kernels::get_active_isa();
+
+    BenchInput input = make_input(count);
+    const int channel_counts[] = {2, 4, 6, 8};
+
+    // 标量结果作为基准
+    struct Outputs {
+        std::vector<float> s16_f32, s24_f32, s32_f32;
+        std::vector<int16_t> f32_s16, dither;
+        std::vector<std::vector<float>> planar_f32;     // 每种声道数的拆分结果
+        std::vector<std::vector<int16_t>> planar_s16;
+    };
+
+    auto run_all = [&](Outputs& out, bool timed, std::vector<double>& rates) {
+        out.s16_f32.assign(count, 0.0f);
+        out.s24_f32.assign(count, 0.0f);
+        out.s32_f32.assign(count, 0.0f);
+        out.f32_s16.assign(count, 0);
+        out.dither.assign(count, 0);
+        auto record = [&](const std::function<void()>& fn) {
+            if (timed) {
+                rates.push_back(measure(fn, count));
+            } else {
+                fn();
+            }
+        };
+
+        record([&] { srv::kernels::s16_to_f32(input.s16.data(), out.s16_f32.data(), count, 1.0f / 32768.0f); });
+        record([&] { srv::kernels::f32_to_s16(input.f32.data(), out.f32_s16.data(), count, 32768.0f); });
+        record([&] {
+            srv::kernels::DitherState state;
+            srv::kernels::init_dither(&state, 1);
+            srv::kernels::f32_to_s16_dither(input.f32.data(), out.dither.data(), count, 32768.0f, &state);
+        });
+        record([&] { srv::kernels::s24_to_f32(input.s24.data(), out.s24_f32.data(), count, 1.0f / 8388608.0f); });
+        record([&] { srv::kernels::s32_to_f32(input.s32.data(), out.s32_f32.data(), count, 1.0f / 2147483648.0f); });
+
+        out.planar_f32.clear();
+        out.planar_s16.clear();
+        for (int channels : channel_counts) {
+            const size_t frames = count / channels;
+            std::vector<float> planar_f32(frames * channels);
+            std::vector<int16_t> planar_s16(frames * channels);
+            std::vector<float*> f32_ptrs(channels);
+            std::vector<int16_t*> s16_ptrs(channels);
+            for (int c = 0; c < channels; ++c) {
+                f32_ptrs[c] = planar_f32.data() + c * frames;
+                s16_ptrs[c] = planar_s16.data() + c * frames;
+            }
+            std::vector<float> back_f32(frames * channels);
+            std::vector<int16_t> back_s16(frames * channels);
+            record([&] { srv::kernels::deinterleave_f32(out.s16_f32.data(), f32_ptrs.data(), frames, channels); });
+            record([&] {
+                srv::kernels::interleave_f32(f32_ptrs.data(), back_f32.data(), frames, channels);
+            });
+            record([&] { srv::kernels::deinterleave_s16(input.s16.data(), s16_ptrs.data(), frames, channels); });
+            record([&] {
+                srv::kernels::interleave_s16(s16_ptrs.data(), back_s16.data(), frames, channels);
+            });
+            out.planar_f32.push_back(planar_f32);
+            out.planar_s16.push_back(planar_s16);
+            // 拆分后再交织必须还原输入
+            if (!std::equal(back_f32.begin(), back_f32.end(), out.s16_f32.begin()) ||
+                !std::equal(back_s16.begin(), back_s16.end(), input.s16.begin())) {
+                std::cerr << "❌ " << channels << "声道交织往返结果不一致" << std::endl;
+            }
+        }
+    };
+
+    const char* names[] = {"s16→f32", "f32→s16", "f32→s16+抖动", "s24→f32", "s32→f32"};
+    std::vector<std::string> row_names(names, names + 5);
+    for (int channels : channel_counts) {
+        row_names.push_back("拆分f32 " + std::to_string(channels) + "ch");
+        row_names.push_back("交织f32 " + std::to_string(channels) + "ch");
+        row_names.push_back("拆分s16 " + std::to_string(channels) + "ch");
+        row_names.push_back("交织s16 " + std::to_string(channels) + "ch");
+    }
+
+    srv::kernels::set_active_isa(Isa::SCALAR);
+    Outputs reference;
+    std::vector<double> unused;
+    run_all(reference, false, unused);
+
+    const Isa all_isas[] = {Isa::SCALAR, Isa::SSE2, Isa::SSE41, Isa::AVX2, Isa::NEON};
+    std::vector<Isa> isas;
+    std::vector<std::vector<double>> table;
+    bool all_match = true;
+    for (Isa isa : all_isas) {
+        if (!srv::kernels::set_active_isa(isa)) {
+            continue;
+        }
+        Outputs out;
+        std::vector<double> rates;
+        run_all(out, true, rates);
+        bool match = same_bits(out.s16_f32, reference.s16_f32) && same_bits(out.f32_s16, reference.f32_s16) &&
+                     same_bits(out.dither, reference.dither) && same_bits(out.s24_f32, reference.s24_f32) &&
+                     same_bits(out.s32_f32, reference.s32_f32);
+        for (size_t k = 0; k < out.planar_f32.size(); ++k) {
+            match = match && same_bits(out.planar_f32[k], reference.planar_f32[k]) &&
+                    same_bits(out.planar_s16[k], reference.planar_s16[k]);
+        }
+        std::cout << (match ? "✅ " : "❌ ") << srv::kernels::get_isa_name(isa)
+                  << (match ? " 与标量结果逐位一致" : " 与标量结果不一致") << std::endl;
+        all_match = all_match && match;
+        isas.push_back(isa);
+        table.push_back(rates);
+    }
+    srv::kernels::set_active_isa(best);
+
+    std::cout << "\n吞吐量（百万样本/秒）:" << std::endl;
+    std::cout << std::left << std::setw(18) << "内核";
+    for (Isa isa : isas) {
+        std::cout << std::right << std::setw(10) << srv::kernels::get_isa_name(isa);
+    }
+    std::cout << std::right << std::setw(10) << "加速比" << std::endl;
+    std::cout << std::fixed << std::setprecision(0);
+    for (size_t r = 0; r < row_names.size(); ++r) {
+        // 中文字符按两列宽对齐
+        std::string name = row_names[r];
+        size_t width = 0;
+        for (size_t k = 0; k < name.size(); ++k) {
+            unsigned char c = static_cast<unsigned char>(name[k]);
+            if ((c & 0xC0) != 0x80) width += (c >= 0xE0) ? 2 : 1;
+        }
+        std::cout << name << std::string(width < 18 ? 18 - width : 1, ' ');
+        for (size_t k = 0; k < isas.size(); ++k) {
+            std::cout << std::setw(10) << table[k][r];
+        }
+        std::cout << std::setw(9) << std::setprecision(1) << (table.back()[r] / table.front()[r]) << "x"
+                  << std::setprecision(0) << std::endl;
+    }
+
+    std::cout << "\n" << (all_match ? "✅ 所有指令集结果一致" : "❌ 存在不一致的结果") << std::endl;
+    return all_match ? 0 : 1;
+}
@@ -0,0 +1,146 @@
+// 并行VAD测试：res/*.wav拼接到1小时，对比顺序与多线程分块检测的耗时和静音段边界一致性
+// 用法: parallel_vad_bench [wav文件 ...]，默认res/sp01_car_sn15.wav res/sp02_airport_sn15.wav
+#include <iostream>
+#include <vector>
+#include <cstring>
+#include <cstdint>
+#include <algorithm>
+#include <string>
+#include <iomanip>
+#include <chrono>
+#include <thread>
+#include "util/AudioFile.h"
+#include "util/ParallelVAD.h"
+#include "util/Resampler.h"
+#include "util/RNNoise.h"
+
+// 静音段转为逐样本标签后比较，返回标签一致的样本比例
+double label_agreement(const std::vector<srv::ParallelVAD::Range>& a,
+                       const std::vector<srv::ParallelVAD::Range>& b, size_t total) {
+    std::vector<uint8_t> la(total, 0);
+    std::vector<uint8_t> lb(total, 0);
+    for (const auto& r : a) std::fill(la.begin() + r.start_sample, la.begin() + r.end_sample, 1);
+    for (const auto& r : b) std::fill(lb.begin() + r.start_sample, lb.begin() + r.end_sample, 1);
+    size_t same = 0;
+    for (size_t i = 0; i < total; ++i) {
+        same += la[i] == lb[i];
+    }
+    return static_cast<double>(same) / std::max<size_t>(1, total);
+}
+
+// 参照结果中的边界（起点和终点）有多少在容差内能在并行结果中找到
+double boundary_agreement(const std::vector<srv::ParallelVAD::Range>& reference,
+                          const std::vector<srv::ParallelVAD::Range>& test, uint64_t tolerance) {
+    std::vector<uint64_t> ref_edges;
+    std::vector<uint64_t> test_edges;
+    for (const auto& r : reference) {
+        ref_edges.push_back(r.start_sample);
+        ref_edges.push_back(r.end_sample);
+    }
+    for (const auto& r : test) {
+        test_edges.push_back(r.start_sample);
+        test_edges.push_back(r.end_sample);
+    }
+    if (ref_edges.empty()) {
+        return test_edges.empty() ? 1.0 : 0.0;
+    }
+    size_t matched = 0;
+    for (uint64_t edge : ref_edges) {
+        auto it = std::lower_bound(test_edges.begin(), test_edges.end(), edge > tolerance ? edge - tolerance : 0);
+        if (it != test_edges.end() && *it <= edge + tolerance) {
+            matched++;
+        }
+    }
+    return static_cast<double>(matched) / ref_edges.size();
+}
+
+void run_detector(const std::string& name, srv::ParallelVAD::Detector detector,
+                  const std::vector<short>& audio, int sample_rate) {
+    std::cout << "\n--- " << name << " (" << sample_rate << " Hz) ---" << std::endl;
+    srv::ParallelVAD vad;
+    if (!vad.init(detector, sample_rate, 1, 1000, 100)) {
+        return;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    auto serial = vad.detect_serial(audio);
+    double serial_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "顺序: " << std::fixed << std::setprecision(2) << serial_s << "s, 静音段 " << serial.size() << std::endl;
+
+    const int max_threads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    std::vector<int> thread_counts;
+    for (int n = 1; n < max_threads; n *= 2) {
+        thread_counts.push_back(n);
+    }
+    thread_counts.push_back(max_threads);
+
+    const uint64_t tolerance = static_cast<uint64_t>(vad.get_frame_size());
+    std::cout << "线程 | 耗时(s) | 加速比 | 静音段 | 标签一致 | 边界一致(±1帧)" << std::endl;
+    for (int n : thread_counts) {
+        vad.set_num_threads(n);
+        start = std::chrono::steady_clock::now();
+        auto parallel = vad.detect(audio);
+        double parallel_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << std::setw(4) << n << " | " << std::setw(7) << std::setprecision(2) << parallel_s
+                  << " | " << std::setw(5) << std::setprecision(2) << (serial_s / parallel_s) << "x"
+                  << " | " << std::setw(6) << parallel.size()
+                  << " | " << std::setw(7) << std::setprecision(3) << (100.0 * label_agreement(serial, parallel, audio.size())) << "%"
+                  << " | " << std::setprecision(2) << (100.0 * boundary_agreement(serial, parallel, tolerance)) << "%" << std::endl;
+    }
+}
+
+int main(int argc, char** argv) {
+    std::cout << "=== 并行VAD测试 ===" << std::endl;
+    std::vector<std::string> files;
+    for (int i = 1; i < argc; ++i) {
+        files.push_back(argv[i]);
+    }
+    if (files.empty()) {
+        files = {"res/sp01_car_sn15.wav", "res/sp02_airport_sn15.wav"};
+    }
+
+    // 读取并拼接
+    int sample_rate = 0;
+    std::vector<short> clip;
+    for (const auto& f : files) {
+        int rate = 0;
+        auto audio = srv::load_audio_mono_s16(f, 0, nullptr, &rate);
+        if (audio.empty()) {
+            std::cerr << "❌ 错误：无法读取音频文件 " << f << std::endl;
+            continue;
+        }
+        if (sample_rate != 0 && rate != sample_rate) {
+            std::cerr << "⚠️  跳过采样率不同的文件 " << f << std::endl;
+            continue;
+        }
+        sample_rate = rate;
+        clip.insert(clip.end(), audio.begin(), audio.end());
+    }
+    if (clip.empty()) {
+        std::cerr << "❌ 没有可用的输入" << std::endl;
+        return 1;
+    }
+
+    const size_t target = static_cast<size_t>(sample_rate) * 3600;
+    std::vector<short> corpus;
+    corpus.reserve(target);
+    while (corpus.size() < target) {
+        corpus.insert(corpus.end(), clip.begin(), clip.begin() + std::min(clip.size(), target - corpus.size()));
+    }
+    std::cout << "语料: " << files.size() << " 个文件拼接到 " << (corpus.size() / sample_rate) << "s @ "
+              << sample_rate << " Hz, 核心数: " << std::thread::hardware_concurrency() << std::endl;
+
+    run_detector("Speex VAD", srv::ParallelVAD::Detector::SPEEX, corpus, sample_rate);
+
+    // RNNoise需要48kHz，先整体重采样（不计入耗时）
+    srv::Resampler resampler;
+    std::vector<short> corpus_48k;
+    if (resampler.init(sample_rate, srv::RNNoise::get_sample_rate())) {
+        corpus_48k.reserve(corpus.size() * srv::RNNoise::get_sample_rate() / sample_rate + 1024);
+        resampler.process(corpus.data(), corpus.size(), corpus_48k);
+        run_detector("RNNoise VAD", srv::ParallelVAD::Detector::RNNOISE, corpus_48k, srv::RNNoise::get_sample_rate());
+    }
+
+    std::cout << "\n=== 测试完成 ===" << std::endl;
+    return 0;
+}
@@ -0,0 +1,191 @@
+// 分割卷积EQ测试：相同频率分辨率下，对比FFT重叠-相加均衡器与均匀分割卷积均衡器的延迟和CPU开销，
+// 以及最小相位/线性相位FIR和预设切换（FIR缓存）的开销
+// 用法: partitioned_eq_bench [--fft-wisdom FILE] [音频秒数，默认60]
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <iomanip>
+#include <chrono>
+#include <functional>
+#include "util/Equalizer.h"
+#include "util/FFTPlanRegistry.h"
+#include "util/PartitionedEqualizer.h"
+
+namespace {
+
+// 语音频段的几个正弦加白噪声
+std::vector<short> make_input(int sample_rate, int seconds) {
+    std::vector<short> audio(static_cast<size_t>(sample_rate) * seconds);
+    std::mt19937 gen(11);
+    std::normal_distribution<float> noise(0.0f, 800.0f);
+    const float tones[] = {180.0f, 440.0f, 1250.0f, 3100.0f, 7900.0f};
+    for (size_t i = 0; i < audio.size(); ++i) {
+        float t = static_cast<float>(i) / sample_rate;
+        float v = noise(gen);
+        for (float f : tones) {
+            v += 2500.0f * std::sin(2.0f * static_cast<float>(M_PI) * f * t);
+        }
+        audio[i] = static_cast<short>(std::max(-32768.0f, std::min(32767.0f, v)));
+    }
+    return audio;
+}
+
+// 多次运行取最快一次（秒）
+double best_of(int runs, const std::function<void()>& fn) {
+    double best = 1e30;
+    for (int r = 0; r < runs; ++r) {
+        auto start = std::chrono::steady_clock::now();
+        fn();
+        best = std::min(best, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+    }
+    return best;
+}
+
+// 冲激响应在freq处的幅度（dB）
+double response_db(const std::vector<float>& impulse, double freq, double sample_rate) {
+    double re = 0.0;
+    double im = 0.0;
+    for (size_t n = 0; n < impulse.size(); ++n) {
+        const double phase = -2.0 * M_PI * freq * n / sample_rate;
+        re += impulse[n] * std::cos(phase);
+        im += impulse[n] * std::sin(phase);
+    }
+    return 10.0 * std::log10(std::max(re * re + im * im, 1e-20));
+}
+
+// 用流式接口测冲激响应：随机长度分块送入，验证分块与延迟处理正确
+std::vector<float> measure_impulse(srv::PartitionedEqualizer& eq) {
+    const size_t latency = eq.get_latency();
+    const size_t length = eq.get_filter_length() + latency;
+    std::vector<float> input(length, 0.0f);
+    std::vector<float> output(length + latency, 0.0f);
+    input[0] = 1.0f;
+    eq.reset();
+    std::mt19937 gen(7);
+    std::uniform_int_distribution<size_t> chunk(1, 300);
+    size_t pos = 0;
+    while (pos < length) {
+        const size_t n = std::min(chunk(gen), length - pos);
+        eq.process(&input[pos], &output[pos], n);
+        pos += n;
+    }
+    eq.flush(&output[length]);
+    return std::vector<float>(output.begin() + latency, output.begin() + latency + eq.get_filter_length());
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    srv::FFTPlanRegistry::instance().init(srv::FFTPlanRegistry::take_wisdom_arg(argc, argv));
+    const int sample_rate = 48000;
+    int seconds = 60;
+    if (argc > 1) {
+        seconds = std::max(1, std::atoi(argv[1]));
+    }
+
+    std::cout << "=== 分割卷积EQ测试 ===" << std::endl;
+    std::cout << "音频: " << seconds << " 秒, " << sample_rate << " Hz, 预设vocal_boost" << std::endl;
+    const std::vector<short> input = make_input(sample_rate, seconds);
+    const std::vector<float> preset = srv::Equalizer::createPreset("vocal_boost");
+    const std::vector<float> freqs = srv::Equalizer::calculateFreqs(preset.size());
+    const double samples = static_cast<double>(input.size());
+
+    bool all_ok = true;
+    for (int fft_bits : {10, 12}) {
+        const int length = 1 << fft_bits;
+        std::cout << "\n频率分辨率 " << std::fixed << std::setprecision(1)
+                  << static_cast<double>(sample_rate) / length << " Hz（" << length << "点）:" << std::endl;
+        std::cout << std::setw(22) << "引擎" << std::setw(12) << "延迟(样本)" << std::setw(10) << "延迟(ms)"
+                  << std::setw(12) << "ns/样本" << std::setw(12) << "实时倍数" << std::setw(14) << "频段误差(dB)"
+                  << std::endl;
+
+        srv::Equalizer fft_eq;
+        if (!fft_eq.init(fft_bits, sample_rate)) {
+            return 1;
+        }
+        fft_eq.setEQdB(preset);
+        std::vector<short> fft_out;
+        const double fft_seconds = best_of(3, [&] { fft_out = fft_eq.processAudio(input); });
+        std::cout << std::setw(22) << "FFT重叠-相加" << std::setw(12) << fft_eq.get_latency() << std::setw(10)
+                  << std::setprecision(2) << fft_eq.get_latency() * 1000.0 / sample_rate << std::setw(12)
+                  << std::setprecision(1) << fft_seconds / samples * 1e9 << std::setw(12) << std::setprecision(0)
+                  << seconds / fft_seconds << std::setw(14) << "-" << std::endl;
+
+        const std::pair<int, srv::FIRDesigner::Phase> configs[] = {
+            {6, srv::FIRDesigner::Phase::MINIMUM},
+            {7, srv::FIRDesigner::Phase::MINIMUM},
+            {7, srv::FIRDesigner::Phase::LINEAR}};
+        for (const auto& config : configs) {
+            srv::PartitionedEqualizer conv_eq;
+            if (!conv_eq.init(config.first, fft_bits, sample_rate, config.second)) {
+                return 1;
+            }
+            conv_eq.setEQdB(preset);
+            std::vector<short> conv_out;
+            const double conv_seconds = best_of(3, [&] { conv_out = conv_eq.processAudio(input); });
+
+            // 各频段中心频率处的实际增益与设定值比较
+            const std::vector<float> impulse = measure_impulse(conv_eq);
+            double max_error = 0.0;
+            for (size_t i = 0; i < freqs.size(); ++i) {
+                max_error = std::max(max_error, std::abs(response_db(impulse, freqs[i], sample_rate) - preset[i]));
+            }
+            const bool ok = conv_out.size() == input.size() && max_error < 0.5;
+            all_ok = all_ok && ok;
+
+            // 线性相位的延迟加上FIR群延迟
+            const size_t latency = conv_eq.get_latency() + conv_eq.get_group_delay();
+            const std::string name = (config.second == srv::FIRDesigner::Phase::LINEAR ? "线性相位 B=" : "最小相位 B=") +
+                                     std::to_string(conv_eq.get_block_size());
+            std::cout << std::setw(22) << name << std::setw(12) << latency << std::setw(10)
+                      << std::setprecision(2) << latency * 1000.0 / sample_rate << std::setw(12)
+                      << std::setprecision(1) << conv_seconds / samples * 1e9 << std::setw(12)
+                      << std::setprecision(0) << seconds / conv_seconds << std::setw(12) << std::setprecision(2)
+                      << max_error << (ok ? " ✅" : " ❌") << std::endl;
+        }
+    }
+
+    // 预设切换：第一轮每个预设都要设计FIR和分段FFT，第二轮全部命中缓存
+    srv::PartitionedEqualizer switch_eq;
+    if (!switch_eq.init(7, 12, sample_rate, srv::FIRDesigner::Phase::LINEAR)) {
+        return 1;
+    }
+    const std::vector<std::string> names = srv::Equalizer::getPresetNames();
+    std::vector<std::vector<float>> presets;
+    for (const auto& name : names) {
+        presets.push_back(srv::Equalizer::createPreset(name));
+    }
+    double pass_seconds[2] = {0.0, 0.0};
+    std::vector<std::vector<float>> first_kernels;
+    bool same_kernels = true;
+    for (int pass = 0; pass < 2; ++pass) {
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < presets.size(); ++i) {
+            switch_eq.setEQdB(presets[i]);
+            if (pass == 0) {
+                first_kernels.push_back(switch_eq.get_kernel());
+            } else {
+                same_kernels = same_kernels && switch_eq.get_kernel() == first_kernels[i];
+            }
+        }
+        pass_seconds[pass] = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+    const srv::FIRDesigner& designer = switch_eq.get_designer();
+    std::cout << "\n预设切换（线性相位，4096点FIR，B=128，" << presets.size() << "个预设）:" << std::endl;
+    std::cout << std::setprecision(1);
+    std::cout << "  首次设计: " << pass_seconds[0] / presets.size() * 1e6 << " us/次" << std::endl;
+    std::cout << "  命中缓存: " << pass_seconds[1] / presets.size() * 1e6 << " us/次" << std::endl;
+    std::cout << "  设计次数 " << designer.get_design_count() << "，缓存命中 " << designer.get_cache_hits()
+              << "，缓存预设 " << designer.get_cache_size() << " 个" << std::endl;
+    const bool cache_ok = same_kernels && designer.get_design_count() == presets.size();
+    all_ok = all_ok && cache_ok;
+    std::cout << "  " << (cache_ok ? "✅ 缓存结果与首次设计一致" : "❌ 缓存结果不一致") << std::endl;
+
+    srv::FFTPlanRegistry::instance().save_wisdom();
+    std::cout << "\n" << (all_ok ? "✅ 分割卷积EQ频段增益与设定一致" : "❌ 分割卷积EQ频段增益偏差过大") << std::endl;
+    return all_ok ? 0 : 1;
+}
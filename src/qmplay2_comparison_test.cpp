@@ -4,31 +4,11 @@
 #include <fstream>
 #include <iomanip>
 #include <cmath>
+#include <algorithm>
 #include <fftw3.h>
-
-// 读取PCM文件
-std::vector<short> read_pcm_file_int16(const std::string& filename) {
-    std::ifstream file(filename, std::ios::binary);
-    if (!file.is_open()) {
-        std::cerr << "❌ 无法打开文件: " << filename << std::endl;
-        return {};
-    }
-    
-    file.seekg(0, std::ios::end);
-    size_t file_size = file.tellg();
-    file.seekg(0, std::ios::beg);
-    
-    size_t num_samples = file_size / sizeof(short);
-    std::vector<short> audio_data(num_samples);
-    file.read(reinterpret_cast<char*>(audio_data.data()), file_size);
-    
-    std::cout << "✅ 成功读取PCM文件: " << filename << std::endl;
-    std::cout << "   文件大小: " << file_size << " 字节" << std::endl;
-    std::cout << "   样本数量: " << num_samples << std::endl;
-    std::cout << "   时长: " << std::fixed << std::setprecision(2) << (num_samples / 48000.0) << " 秒" << std::endl;
-    
-    return audio_data;
-}
+#include "util/AudioFile.h"
+#include "util/DSPKernels.h"
+#include "util/FFTPlanRegistry.h"
 
 // 保存PCM文件
 bool save_pcm_file_int16(const std::vector<short>& audio_data, const std::string& filename) {
@@ -71,12 +51,14 @@ private:
     
     fftwf_plan fft_plan_forward_;
     fftwf_plan fft_plan_backward_;
-    fftwf_complex* fft_buffer_;
+    fftwf_complex* fft_spectrum_;   // 实数FFT只保留N/2+1个非负频点
+    float* fft_real_;               // 原位变换，与fft_spectrum_共用内存
     
     std::vector<float> window_;
     std::vector<float> eq_response_;
     std::vector<float> overlap_buffer_;
     std::vector<float> input_buffer_;
+    std::vector<float> output_buffer_;
     
 public:
     QMPlay2StyleEqualizer() : fft_size_(4096), sample_rate_(48000), preamp_(1.0f) {
@@ -89,11 +71,12 @@ public:
     
     void init() {
         // 分配FFT缓冲区
-        fft_buffer_ = fftwf_alloc_complex(fft_size_);
+        fft_spectrum_ = fftwf_alloc_complex(fft_size_ / 2 + 1);
+        fft_real_ = reinterpret_cast<float*>(fft_spectrum_);
         
-        // 创建FFT计划
-        fft_plan_forward_ = fftwf_plan_dft_1d(fft_size_, fft_buffer_, fft_buffer_, FFTW_FORWARD, FFTW_ESTIMATE);
-        fft_plan_backward_ = fftwf_plan_dft_1d(fft_size_, fft_buffer_, fft_buffer_, FFTW_BACKWARD, FFTW_ESTIMATE);
+        // 从注册表取共享的FFT计划（r2c/c2r实数FFT）
+        fft_plan_forward_ = srv::FFTPlanRegistry::instance().get_r2c(fft_size_, fft_real_, fft_spectrum_);
+        fft_plan_backward_ = srv::FFTPlanRegistry::instance().get_c2r(fft_size_, fft_spectrum_, fft_real_);
         
         // 初始化窗口函数（Hann窗口）
         window_.resize(fft_size_);
@@ -101,20 +84,21 @@ public:
             window_[i] = 0.5f * (1.0f - std::cos(2.0f * M_PI * i / (fft_size_ - 1)));
         }
         
-        // 初始化EQ响应
-        eq_response_.resize(fft_size_ / 2, 1.0f);
+        // 初始化EQ响应（含奈奎斯特频点）
+        eq_response_.resize(fft_size_ / 2 + 1, 1.0f);
         
         // 初始化重叠缓冲区
         overlap_buffer_.resize(fft_size_ / 2, 0.0f);
         
         // 初始化输入缓冲区
         input_buffer_.resize(fft_size_, 0.0f);
+        
+        // 初始化输出缓冲区
+        output_buffer_.resize(fft_size_ / 2, 0.0f);
     }
     
     void cleanup() {
-        if (fft_plan_forward_) fftwf_destroy_plan(fft_plan_forward_);
-        if (fft_plan_backward_) fftwf_destroy_plan(fft_plan_backward_);
-        if (fft_buffer_) fftwf_free(fft_buffer_);
+        if (fft_spectrum_) fftwf_free(fft_spectrum_);
     }
     
     // QMPlay2风格的余弦插值函数
@@ -152,10 +136,10 @@ public:
         std::fill(eq_response_.begin(), eq_response_.end(), 1.0f);
         
         // 计算每个FFT bin的增益（使用QMPlay2的余弦插值）
-        std::vector<float> gains(fft_size_ / 2);
+        std::vector<float> gains(fft_size_ / 2 + 1);
         const int maxHz = sample_rate_ / 2;
         
-        for (int i = 0; i < fft_size_ / 2; ++i) {
+        for (int i = 0; i <= fft_size_ / 2; ++i) {
             const float freq = (i + 1) * maxHz / (fft_size_ / 2);
             
             // 找到对应的EQ频段
@@ -176,7 +160,7 @@ public:
         }
         
         // 应用增益
-        for (int i = 0; i < fft_size_ / 2; ++i) {
+        for (int i = 0; i <= fft_size_ / 2; ++i) {
             eq_response_[i] = gains[i] * preamp_;
         }
     }
@@ -195,53 +179,41 @@ public:
         
         for (size_t i = 0; i < input.size(); i += hop_size) {
             // 填充输入缓冲区
-            for (int j = 0; j < fft_size_; ++j) {
-                if (i + j < input.size()) {
-                    input_buffer_[j] = static_cast<float>(input[i + j]) / 32767.0f;
-                } else {
-                    input_buffer_[j] = 0.0f;
-                }
-            }
+            const size_t available = std::min(static_cast<size_t>(fft_size_), input.size() - i);
+            srv::kernels::s16_to_f32(&input[i], input_buffer_.data(), available, 1.0f / 32768.0f);
+            std::fill(input_buffer_.begin() + available, input_buffer_.end(), 0.0f);
             
             // 应用窗口函数
             for (int j = 0; j < fft_size_; ++j) {
-                fft_buffer_[j][0] = input_buffer_[j] * window_[j];
-                fft_buffer_[j][1] = 0.0f;
+                fft_real_[j] = input_buffer_[j] * window_[j];
             }
             
             // 执行FFT
-            fftwf_execute(fft_plan_forward_);
+            fftwf_execute_dft_r2c(fft_plan_forward_, fft_real_, fft_spectrum_);
             
-            // 应用EQ响应
-            for (int j = 0; j < fft_size_ / 2; ++j) {
+            // 应用EQ响应（共轭对称的负频率不再单独处理）
+            for (int j = 0; j <= fft_size_ / 2; ++j) {
                 float coeff = eq_response_[j];
-                fft_buffer_[j][0] *= coeff;
-                fft_buffer_[j][1] *= coeff;
-                
-                // 处理负频率（共轭对称）
-                if (j > 0) {
-                    fft_buffer_[fft_size_ - j][0] *= coeff;
-                    fft_buffer_[fft_size_ - j][1] *= coeff;
-                }
+                fft_spectrum_[j][0] *= coeff;
+                fft_spectrum_[j][1] *= coeff;
             }
             
             // 执行IFFT
-            fftwf_execute(fft_plan_backward_);
+            fftwf_execute_dft_c2r(fft_plan_backward_, fft_spectrum_, fft_real_);
             
             // 重叠-相加
             for (int j = 0; j < hop_size; ++j) {
-                if (i + j < input.size()) {
-                    float sample = fft_buffer_[j][0] / fft_size_;
-                    sample += overlap_buffer_[j];
-                    
-                    // 限制范围并转换回short
-                    sample = std::max(-1.0f, std::min(1.0f, sample));
-                    output.push_back(static_cast<short>(sample * 32767.0f));
-                }
+                output_buffer_[j] = fft_real_[j] / fft_size_ + overlap_buffer_[j];
                 
                 // 保存重叠部分
-                overlap_buffer_[j] = fft_buffer_[j + hop_size][0] / fft_size_;
+                overlap_buffer_[j] = fft_real_[j + hop_size] / fft_size_;
             }
+            
+            // 转换回short（四舍五入并饱和）
+            const size_t valid = std::min(static_cast<size_t>(hop_size), input.size() - i);
+            const size_t written = output.size();
+            output.resize(written + valid);
+            srv::kernels::f32_to_s16(output_buffer_.data(), &output[written], valid, 32768.0f);
         }
         
         return output;
@@ -294,10 +266,12 @@ std::vector<int> createQMPlay2Preset(const std::string& preset_name) {
     return sliders;
 }
 
-int main() {
+int main(int argc, char** argv) {
     std::cout << "=== QMPlay2风格EQ对比测试 ===" << std::endl;
     std::cout << "测试与QMPlay2相似的效果" << std::endl;
     
+    srv::FFTPlanRegistry::instance().init(srv::FFTPlanRegistry::take_wisdom_arg(argc, argv));
+    
     // 配置参数（与QMPlay2一致）
     double sample_rate = 48000.0;
     int fft_bits = 10;  // 1024点FFT
@@ -310,7 +284,11 @@ int main() {
     
     // 读取音频文件
     std::cout << "\n步骤1: 读取音频文件..." << std::endl;
-    auto input_audio = read_pcm_file_int16("res/48000_1_s16le.pcm");
+    // WAV或48kHz单声道s16原始PCM，采样率不同时重采样到48kHz
+    const srv::AudioFile::Format raw_format{48000, 1, srv::AudioFile::SampleFormat::S16};
+    srv::MonoAudio loaded = srv::load_audio_mono("res/48000_1_s16le.pcm", 48000, &raw_format);
+    srv::print_audio_info("res/48000_1_s16le.pcm", loaded);
+    auto input_audio = std::move(loaded.samples);
     
     if (input_audio.empty()) {
         std::cerr << "❌ 无法读取音频文件" << std::endl;
@@ -404,5 +382,6 @@ int main() {
     std::cout << "  - 预设值参考QMPlay2的实际设置" << std::endl;
     std::cout << "  - 技术参数与QMPlay2完全一致" << std::endl;
     
+    srv::FFTPlanRegistry::instance().save_wisdom();
     return 0;
 } 
\ No newline at end of file
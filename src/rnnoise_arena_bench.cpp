@@ -0,0 +1,213 @@
+// RNNoise内存池性能测试：对比内存池放置与每流malloc(rnnoise_create)的
+// 会话创建延迟、重置延迟以及多流轮询处理时的缓存/TLB表现
+// 用法: rnnoise_arena_bench [流数量] [轮数] [hugepage(0/1)]
+#include <iostream>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <string>
+#include <cstring>
+#include <iomanip>
+#include "util/RNNoiseArena.h"
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// 硬件计数器（仅Linux，macOS请使用Instruments的Counters模板）
+class HardwareCounters {
+private:
+    int tlb_fd_;
+    int cache_fd_;
+
+#ifdef __linux__
+    static int open_counter(uint32_t type, uint64_t config) {
+        struct perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = type;
+        attr.config = config;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        return static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+    }
+#endif
+
+public:
+    HardwareCounters() : tlb_fd_(-1), cache_fd_(-1) {
+#ifdef __linux__
+        tlb_fd_ = open_counter(PERF_TYPE_HW_CACHE,
+                               PERF_COUNT_HW_CACHE_DTLB |
+                               (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                               (PERF_COUNT_HW_CACHE_RESULT_MISS << 16));
+        cache_fd_ = open_counter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+#endif
+    }
+
+    ~HardwareCounters() {
+#ifdef __linux__
+        if (tlb_fd_ >= 0) close(tlb_fd_);
+        if (cache_fd_ >= 0) close(cache_fd_);
+#endif
+    }
+
+    bool available() const { return tlb_fd_ >= 0 || cache_fd_ >= 0; }
+
+    void start() {
+#ifdef __linux__
+        for (int fd : {tlb_fd_, cache_fd_}) {
+            if (fd >= 0) {
+                ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+                ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+            }
+        }
+#endif
+    }
+
+    // 返回 <dTLB miss, cache miss>，不可用时为-1
+    std::pair<long long, long long> stop() {
+        long long values[2] = {-1, -1};
+#ifdef __linux__
+        int fds[2] = {tlb_fd_, cache_fd_};
+        for (int i = 0; i < 2; ++i) {
+            if (fds[i] >= 0) {
+                ioctl(fds[i], PERF_EVENT_IOC_DISABLE, 0);
+                long long value = 0;
+                if (read(fds[i], &value, sizeof(value)) == sizeof(value)) {
+                    values[i] = value;
+                }
+            }
+        }
+#endif
+        return {values[0], values[1]};
+    }
+};
+
+double elapsed_ns(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+}
+
+// 所有状态轮询各处理一帧，模拟大量并发会话
+void run_round_robin(const std::vector<DenoiseState*>& states, int rounds, const std::vector<float>& frame,
+                     const std::string& label, HardwareCounters& counters) {
+    std::vector<float> out(frame.size());
+    counters.start();
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; ++r) {
+        for (DenoiseState* st : states) {
+            rnnoise_process_frame(st, out.data(), frame.data());
+        }
+    }
+    double ns = elapsed_ns(start);
+    auto misses = counters.stop();
+
+    double frames = static_cast<double>(states.size()) * rounds;
+    std::cout << label << ":" << std::endl;
+    std::cout << "  每帧耗时: " << std::fixed << std::setprecision(1) << (ns / frames) << " ns" << std::endl;
+    if (misses.first >= 0) {
+        std::cout << "  dTLB miss/帧: " << std::fixed << std::setprecision(2) << (misses.first / frames) << std::endl;
+    }
+    if (misses.second >= 0) {
+        std::cout << "  cache miss/帧: " << std::fixed << std::setprecision(2) << (misses.second / frames) << std::endl;
+    }
+}
+
+int main(int argc, char** argv) {
+    std::cout << "=== RNNoise内存池性能测试 ===" << std::endl;
+
+    int num_streams = argc > 1 ? std::stoi(argv[1]) : 4096;
+    int rounds = argc > 2 ? std::stoi(argv[2]) : 5;
+    bool use_huge_pages = argc > 3 && std::stoi(argv[3]) != 0;
+
+    std::cout << "流数量: " << num_streams << std::endl;
+    std::cout << "轮询轮数: " << rounds << std::endl;
+    std::cout << "DenoiseState大小: " << rnnoise_get_size() << " 字节" << std::endl;
+
+    HardwareCounters counters;
+    if (!counters.available()) {
+        std::cout << "⚠️  硬件计数器不可用，只输出耗时（macOS可用Instruments的Counters模板采集TLB/cache miss）" << std::endl;
+    }
+
+    std::mt19937 gen(42);
+    std::normal_distribution<float> noise_dist(0.0f, 1000.0f);
+    std::vector<float> frame(rnnoise_get_frame_size());
+    for (auto& sample : frame) {
+        sample = noise_dist(gen);
+    }
+
+    // 1. malloc-per-stream
+    std::cout << "\n--- malloc-per-stream (rnnoise_create) ---" << std::endl;
+    std::vector<DenoiseState*> heap_states(num_streams);
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < num_streams; ++i) {
+        heap_states[i] = rnnoise_create(NULL);
+    }
+    std::cout << "创建延迟: " << std::fixed << std::setprecision(1)
+              << (elapsed_ns(start) / num_streams) << " ns/会话" << std::endl;
+
+    run_round_robin(heap_states, rounds, frame, "轮询处理", counters);
+
+    // 会话重建：销毁后重新创建
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < num_streams; ++i) {
+        rnnoise_destroy(heap_states[i]);
+        heap_states[i] = rnnoise_create(NULL);
+    }
+    std::cout << "重建延迟(destroy+create): " << std::fixed << std::setprecision(1)
+              << (elapsed_ns(start) / num_streams) << " ns/会话" << std::endl;
+
+    for (DenoiseState* st : heap_states) {
+        rnnoise_destroy(st);
+    }
+    heap_states.clear();
+
+    // 2. 内存池
+    std::cout << "\n--- 内存池 (RNNoiseArena, hugepage=" << (use_huge_pages ? "on" : "off") << ") ---" << std::endl;
+    srv::RNNoiseArena arena;
+    start = std::chrono::steady_clock::now();
+    if (!arena.init(static_cast<size_t>(num_streams), use_huge_pages) ||
+        !arena.reserve(static_cast<size_t>(num_streams))) {
+        std::cerr << "❌ 内存池初始化失败" << std::endl;
+        return 1;
+    }
+    std::cout << "预分配耗时: " << std::fixed << std::setprecision(3)
+              << (elapsed_ns(start) / 1e6) << " ms (容量 " << arena.get_capacity()
+              << ", 槽位 " << arena.get_slot_size() << " 字节, 大页slab "
+              << arena.get_huge_page_slab_count() << ")" << std::endl;
+
+    std::vector<DenoiseState*> arena_states(num_streams);
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < num_streams; ++i) {
+        arena_states[i] = arena.acquire();
+    }
+    std::cout << "创建延迟(acquire): " << std::fixed << std::setprecision(1)
+              << (elapsed_ns(start) / num_streams) << " ns/会话" << std::endl;
+
+    run_round_robin(arena_states, rounds, frame, "轮询处理", counters);
+
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < num_streams; ++i) {
+        arena.reset(arena_states[i]);
+    }
+    std::cout << "原地重置延迟(reset): " << std::fixed << std::setprecision(1)
+              << (elapsed_ns(start) / num_streams) << " ns/会话" << std::endl;
+
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < num_streams; ++i) {
+        arena.release(arena_states[i]);
+        arena_states[i] = arena.acquire();
+    }
+    std::cout << "重建延迟(release+acquire): " << std::fixed << std::setprecision(1)
+              << (elapsed_ns(start) / num_streams) << " ns/会话" << std::endl;
+
+    for (DenoiseState* st : arena_states) {
+        arena.release(st);
+    }
+
+    std::cout << "\n=== 测试完成 ===" << std::endl;
+    return 0;
+}
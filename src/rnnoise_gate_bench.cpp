@@ -0,0 +1,117 @@
+// RNNoise能量预门限测试：对比始终推理与门限跳过推理的CPU耗时和VAD一致性
+// 用法: rnnoise_gate_bench [WAV或48k单声道s16le PCM文件 ...]
+// WAV可直接读取，采样率不同时自动重采样
+#include <iostream>
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include <random>
+#include <string>
+#include <iomanip>
+#include "util/AudioFile.h"
+#include "util/RNNoise.h"
+#include "util/RNNoiseGate.h"
+#include "util/ProcessStats.h"
+
+// 生成以静音为主的合成语料：每10秒中3秒类语音信号，7秒闭麦（数字静音或极低电平抖动）
+std::vector<short> generate_muted_corpus(int duration_s) {
+    const int sample_rate = 48000;
+    std::vector<short> audio(static_cast<size_t>(duration_s) * sample_rate, 0);
+    std::mt19937 gen(7);
+    std::normal_distribution<double> noise_dist(0.0, 1.0);
+
+    for (size_t i = 0; i < audio.size(); ++i) {
+        double t = static_cast<double>(i) / sample_rate;
+        double phase_in_cycle = std::fmod(t, 10.0);
+        double value = 0.0;
+        if (phase_in_cycle < 3.0) {
+            // 音节包络调制的谐波 + 背景噪声
+            double envelope = 0.5 + 0.5 * std::sin(2.0 * M_PI * 4.0 * t);
+            double f0 = 140.0 + 30.0 * std::sin(2.0 * M_PI * 0.7 * t);
+            for (int h = 1; h <= 8; ++h) {
+                value += std::sin(2.0 * M_PI * f0 * h * t) / h;
+            }
+            value = 4000.0 * envelope * value + 300.0 * noise_dist(gen);
+        } else if (phase_in_cycle >= 8.0) {
+            // 闭麦后的极低电平抖动
+            value = 2.0 * noise_dist(gen);
+        }
+        audio[i] = static_cast<short>(std::max(-32768.0, std::min(32767.0, value)));
+    }
+    return audio;
+}
+
+void run_comparison(const std::string& name, const std::vector<short>& audio, float floor_dbfs) {
+    const int frame_size = srv::RNNoise::FRAME_SIZE;
+    const size_t num_frames = audio.size() / frame_size;
+    if (num_frames == 0) {
+        return;
+    }
+
+    std::vector<float> frame(frame_size);
+    std::vector<float> probs_full(num_frames);
+    std::vector<float> probs_gated(num_frames);
+
+    // 始终推理
+    srv::RNNoise rnnoise;
+    rnnoise.init();
+    double cpu_start = srv::ProcessStats::get_thread_cpu_seconds();
+    for (size_t f = 0; f < num_frames; ++f) {
+        for (int j = 0; j < frame_size; ++j) {
+            frame[j] = audio[f * frame_size + j];
+        }
+        probs_full[f] = rnnoise.process_frame(frame.data(), frame.data());
+    }
+    double cpu_full = srv::ProcessStats::get_thread_cpu_seconds() - cpu_start;
+
+    // 门限跳过推理
+    srv::RNNoiseGate gate;
+    gate.init(floor_dbfs);
+    cpu_start = srv::ProcessStats::get_thread_cpu_seconds();
+    for (size_t f = 0; f < num_frames; ++f) {
+        for (int j = 0; j < frame_size; ++j) {
+            frame[j] = audio[f * frame_size + j];
+        }
+        probs_gated[f] = gate.process_frame(frame.data(), frame.data());
+    }
+    double cpu_gated = srv::ProcessStats::get_thread_cpu_seconds() - cpu_start;
+
+    // VAD判决一致性（0.5阈值）
+    size_t agree = 0;
+    for (size_t f = 0; f < num_frames; ++f) {
+        if ((probs_full[f] > 0.5f) == (probs_gated[f] > 0.5f)) {
+            agree++;
+        }
+    }
+
+    double audio_seconds = static_cast<double>(num_frames) * frame_size / 48000.0;
+    std::cout << "\n" << name << " (" << std::fixed << std::setprecision(1) << audio_seconds << "s):" << std::endl;
+    std::cout << "  跳过推理帧: " << gate.get_bypassed_frames() << "/" << num_frames << " ("
+              << std::setprecision(1) << (100.0 * gate.get_bypassed_frames() / num_frames) << "%)"
+              << ", 回放预热帧: " << gate.get_replayed_frames() << std::endl;
+    std::cout << "  CPU (始终推理): " << std::setprecision(3) << (cpu_full * 1000.0) << " ms" << std::endl;
+    std::cout << "  CPU (能量门限): " << std::setprecision(3) << (cpu_gated * 1000.0) << " ms" << std::endl;
+    std::cout << "  CPU节省: " << std::setprecision(1) << (100.0 * (1.0 - cpu_gated / (cpu_full + 1e-12))) << "%" << std::endl;
+    std::cout << "  VAD判决一致率: " << std::setprecision(2) << (100.0 * agree / num_frames) << "%" << std::endl;
+}
+
+int main(int argc, char** argv) {
+    std::cout << "=== RNNoise能量预门限测试 ===" << std::endl;
+    const float floor_dbfs = -60.0f;
+    std::cout << "门限: " << floor_dbfs << " dBFS" << std::endl;
+
+    // WAV或48kHz单声道s16原始PCM，采样率不同时重采样到48kHz
+    const srv::AudioFile::Format raw_format{48000, 1, srv::AudioFile::SampleFormat::S16};
+    for (int i = 1; i < argc; ++i) {
+        srv::MonoAudio loaded = srv::load_audio_mono(argv[i], 48000, &raw_format);
+        if (srv::print_audio_info(argv[i], loaded) && !loaded.samples.empty()) {
+            run_comparison(argv[i], loaded.samples, floor_dbfs);
+        }
+    }
+
+    auto corpus = generate_muted_corpus(120);
+    run_comparison("合成闭麦语料 (70%静音)", corpus, floor_dbfs);
+
+    std::cout << "\n=== 测试完成 ===" << std::endl;
+    return 0;
+}
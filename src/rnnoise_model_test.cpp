@@ -0,0 +1,127 @@
+// RNNoise共享权重测试：对比mmap共享权重与每个流私有权重的内存占用，并演示模型热更新
+// 用法: rnnoise_model_test [weights_blob.bin] [流数量]
+#include <iostream>
+#include <vector>
+#include <memory>
+#include <random>
+#include <string>
+#include <iomanip>
+#include "util/RNNoise.h"
+#include "util/RNNoiseModel.h"
+#include "util/ProcessStats.h"
+
+// 生成一帧白噪声（int16量纲）
+std::vector<float> generate_noise_frame(std::mt19937& gen) {
+    std::normal_distribution<float> noise_dist(0.0f, 1000.0f);
+    std::vector<float> frame(srv::RNNoise::FRAME_SIZE);
+    for (auto& sample : frame) {
+        sample = noise_dist(gen);
+    }
+    return frame;
+}
+
+// 每个流处理若干帧，保证状态和权重页都被实际访问
+void run_streams(std::vector<std::unique_ptr<srv::RNNoise>>& streams, int frames) {
+    std::mt19937 gen(42);
+    auto frame = generate_noise_frame(gen);
+    std::vector<float> out(frame.size());
+    for (int f = 0; f < frames; ++f) {
+        for (auto& stream : streams) {
+            stream->process_frame(out.data(), frame.data());
+        }
+    }
+}
+
+void print_rss(const std::string& label, size_t rss_before, size_t rss_after, int num_streams) {
+    double delta_mb = (static_cast<double>(rss_after) - static_cast<double>(rss_before)) / (1024.0 * 1024.0);
+    double per_stream_kb = (static_cast<double>(rss_after) - static_cast<double>(rss_before)) / 1024.0 / num_streams;
+    std::cout << label << ":" << std::endl;
+    std::cout << "  RSS增量: " << std::fixed << std::setprecision(2) << delta_mb << " MB" << std::endl;
+    std::cout << "  每流RSS: " << std::fixed << std::setprecision(1) << per_stream_kb << " KB" << std::endl;
+}
+
+int main(int argc, char** argv) {
+    std::cout << "=== RNNoise共享权重测试 ===" << std::endl;
+
+    std::string weights_file = argc > 1 ? argv[1] : "weights_blob.bin";
+    int num_streams = argc > 2 ? std::stoi(argv[2]) : 200;
+    const int warmup_frames = 5;
+
+    std::cout << "权重文件: " << weights_file << std::endl;
+    std::cout << "流数量: " << num_streams << std::endl;
+    std::cout << "DenoiseState大小: " << rnnoise_get_size() << " 字节" << std::endl;
+
+    // 测试1: 内置模型（权重在可执行文件的只读段中，天然共享）
+    {
+        size_t rss_before = srv::ProcessStats::get_current_rss_bytes();
+        std::vector<std::unique_ptr<srv::RNNoise>> streams;
+        for (int i = 0; i < num_streams; ++i) {
+            streams.emplace_back(new srv::RNNoise());
+            streams.back()->init();
+        }
+        run_streams(streams, warmup_frames);
+        print_rss("\n内置模型", rss_before, srv::ProcessStats::get_current_rss_bytes(), num_streams);
+    }
+
+    auto& registry = srv::RNNoiseModelRegistry::instance();
+    if (!registry.publish("default", weights_file)) {
+        std::cerr << "❌ 无法加载权重文件，跳过共享/私有权重对比" << std::endl;
+        std::cout << "权重文件可通过rnnoise源码中的 download_model.sh 下载并解压得到" << std::endl;
+        return 1;
+    }
+
+    // 测试2: 共享权重（一份mmap，所有流引用）
+    {
+        size_t rss_before = srv::ProcessStats::get_current_rss_bytes();
+        std::vector<std::unique_ptr<srv::RNNoise>> streams;
+        for (int i = 0; i < num_streams; ++i) {
+            streams.emplace_back(new srv::RNNoise());
+            streams.back()->init("default");
+        }
+        run_streams(streams, warmup_frames);
+        print_rss("\n共享权重 (mmap)", rss_before, srv::ProcessStats::get_current_rss_bytes(), num_streams);
+        std::cout << "  模型引用计数: " << registry.get_use_count("default") << std::endl;
+
+        // 热更新：发布新版本，正在运行的流在下一帧边界切换，不中断
+        std::cout << "\n热更新测试:" << std::endl;
+        auto old_model = registry.acquire("default");
+        std::weak_ptr<srv::RNNoiseModel> old_model_ref = old_model;
+        old_model.reset();
+
+        registry.publish("default", weights_file);
+        std::cout << "  发布后旧版本是否仍被引用: " << (old_model_ref.expired() ? "否" : "是") << std::endl;
+
+        run_streams(streams, 1);
+        int swapped = 0;
+        for (const auto& stream : streams) {
+            if (stream->get_model_swap_count() > 0) {
+                swapped++;
+            }
+        }
+        std::cout << "  已切换到版本 " << registry.get_version("default") << " 的流: "
+                  << swapped << "/" << num_streams << std::endl;
+        std::cout << "  旧版本是否已卸载: " << (old_model_ref.expired() ? "是" : "否") << std::endl;
+    }
+
+    // 测试3: 私有权重（每个流各自读入一份拷贝）
+    {
+        size_t rss_before = srv::ProcessStats::get_current_rss_bytes();
+        std::vector<std::unique_ptr<srv::RNNoise>> streams;
+        for (int i = 0; i < num_streams; ++i) {
+            auto model = srv::RNNoiseModel::load_private(weights_file);
+            if (!model) {
+                std::cerr << "❌ 私有权重加载失败" << std::endl;
+                return 1;
+            }
+            streams.emplace_back(new srv::RNNoise());
+            streams.back()->init(model);
+        }
+        run_streams(streams, warmup_frames);
+        print_rss("\n私有权重 (每流一份)", rss_before, srv::ProcessStats::get_current_rss_bytes(), num_streams);
+    }
+
+    std::cout << "\n峰值RSS: " << std::fixed << std::setprecision(2)
+              << (srv::ProcessStats::get_peak_rss_bytes() / (1024.0 * 1024.0)) << " MB" << std::endl;
+    std::cout << "\n=== 测试完成 ===" << std::endl;
+    return 0;
+}
@@ -0,0 +1,122 @@
+// RNNoise离线并行降噪测试：对比不同线程数的加速比，以及不同预热时长下与顺序处理结果的差异
+// 用法: rnnoise_parallel_test [48k单声道s16le PCM文件] [重复次数]
+#include <iostream>
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <iomanip>
+#include "util/AudioFile.h"
+#include "util/RNNoiseParallel.h"
+
+// 与顺序处理结果的差异
+struct ResidualStats {
+    double rms_diff;
+    double max_diff;
+    double snr_db;  // 顺序输出能量 / 差异能量
+};
+
+ResidualStats compare_outputs(const std::vector<short>& reference, const std::vector<short>& output) {
+    double diff_energy = 0.0;
+    double ref_energy = 0.0;
+    double max_diff = 0.0;
+    size_t n = std::min(reference.size(), output.size());
+    for (size_t i = 0; i < n; ++i) {
+        double d = static_cast<double>(reference[i]) - output[i];
+        diff_energy += d * d;
+        ref_energy += static_cast<double>(reference[i]) * reference[i];
+        max_diff = std::max(max_diff, std::abs(d));
+    }
+    ResidualStats stats;
+    stats.rms_diff = n > 0 ? std::sqrt(diff_energy / n) : 0.0;
+    stats.max_diff = max_diff;
+    stats.snr_db = 10.0 * std::log10((ref_energy + 1e-10) / (diff_energy + 1e-10));
+    return stats;
+}
+
+double time_process(const srv::RNNoiseParallel& processor, const std::vector<short>& input,
+                    std::vector<short>& output) {
+    auto start = std::chrono::steady_clock::now();
+    output = processor.process(input);
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char** argv) {
+    std::cout << "=== RNNoise离线并行降噪测试 ===" << std::endl;
+
+    std::string input_file = argc > 1 ? argv[1] : "res/noise_48k_mono_s16le.pcm";
+    int repeat = argc > 2 ? std::stoi(argv[2]) : 1;
+
+    // WAV或48kHz单声道s16原始PCM，采样率不同时重采样到48kHz
+    const srv::AudioFile::Format raw_format{48000, 1, srv::AudioFile::SampleFormat::S16};
+    srv::MonoAudio loaded = srv::load_audio_mono(input_file, 48000, &raw_format);
+    srv::print_audio_info(input_file, loaded);
+    const std::vector<short> audio = std::move(loaded.samples);
+    if (audio.empty()) {
+        std::cout << "请使用以下命令转换你的WAV文件：" << std::endl;
+        std::cout << "ffmpeg -i res/your_audio.wav -f s16le -ar 48000 -ac 1 res/noise_48k_mono_s16le.pcm" << std::endl;
+        return 1;
+    }
+
+    // 重复拼接以模拟长录音
+    std::vector<short> input;
+    input.reserve(audio.size() * repeat);
+    for (int i = 0; i < repeat; ++i) {
+        input.insert(input.end(), audio.begin(), audio.end());
+    }
+    double duration = input.size() / 48000.0;
+    std::cout << "测试音频时长: " << std::fixed << std::setprecision(1) << duration << " 秒" << std::endl;
+
+    // 顺序处理基准
+    srv::RNNoiseParallel sequential;
+    sequential.init(1, 0, 0);
+    std::vector<short> reference;
+    double sequential_time = time_process(sequential, input, reference);
+    std::cout << "\n顺序处理: " << std::fixed << std::setprecision(3) << sequential_time << " 秒 ("
+              << std::setprecision(1) << (duration / sequential_time) << "x 实时)" << std::endl;
+
+    // 加速比 vs 线程数：1, 2, 4, ... 直到核心数
+    int max_threads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    std::vector<int> thread_counts;
+    for (int threads = 1; threads < max_threads; threads *= 2) {
+        thread_counts.push_back(threads);
+    }
+    thread_counts.push_back(max_threads);
+
+    std::cout << "\n=== 加速比 (预热500ms, 交叉淡化10ms) ===" << std::endl;
+    std::cout << std::setw(8) << "线程数" << std::setw(12) << "耗时(s)" << std::setw(10) << "加速比"
+              << std::setw(14) << "差异SNR(dB)" << std::endl;
+    for (int threads : thread_counts) {
+        srv::RNNoiseParallel parallel;
+        parallel.init(threads, 500, 10);
+        std::vector<short> output;
+        double t = time_process(parallel, input, output);
+        ResidualStats stats = compare_outputs(reference, output);
+        std::cout << std::setw(8) << threads
+                  << std::setw(12) << std::fixed << std::setprecision(3) << t
+                  << std::setw(10) << std::fixed << std::setprecision(2) << (sequential_time / t)
+                  << std::setw(14) << std::fixed << std::setprecision(1) << stats.snr_db << std::endl;
+    }
+
+    // 预热时长对质量/速度的影响
+    std::cout << "\n=== 预热时长 vs 差异 (线程数 " << max_threads << ") ===" << std::endl;
+    std::cout << std::setw(10) << "预热(ms)" << std::setw(12) << "耗时(s)" << std::setw(12) << "RMS差异"
+              << std::setw(12) << "最大差异" << std::setw(14) << "差异SNR(dB)" << std::endl;
+    for (int preroll_ms : {0, 100, 250, 500, 1000, 2000}) {
+        srv::RNNoiseParallel parallel;
+        parallel.init(max_threads, preroll_ms, 10);
+        std::vector<short> output;
+        double t = time_process(parallel, input, output);
+        ResidualStats stats = compare_outputs(reference, output);
+        std::cout << std::setw(10) << preroll_ms
+                  << std::setw(12) << std::fixed << std::setprecision(3) << t
+                  << std::setw(12) << std::fixed << std::setprecision(2) << stats.rms_diff
+                  << std::setw(12) << std::fixed << std::setprecision(0) << stats.max_diff
+                  << std::setw(14) << std::fixed << std::setprecision(1) << stats.snr_db << std::endl;
+    }
+
+    std::cout << "\n=== 测试完成 ===" << std::endl;
+    return 0;
+}
@@ -3,34 +3,15 @@
 #include <fstream>
 #include <cmath>
 #include <iomanip>
+#include <string>
+#include "util/RNNoiseParallel.h"
+#include "util/AudioFile.h"
 
 // RNNoise头文件
 extern "C" {
     #include "rnnoise.h"
 }
 
-// 读取PCM文件（int16格式）
-std::vector<short> read_pcm_file_int16(const std::string& filename) {
-    std::ifstream file(filename, std::ios::binary);
-    if (!file.is_open()) {
-        std::cerr << "❌ 错误：无法打开文件 " << filename << std::endl;
-        return {};
-    }
-    file.seekg(0, std::ios::end);
-    std::streamsize file_size = file.tellg();
-    file.seekg(0, std::ios::beg);
-    size_t num_samples = file_size / sizeof(short);
-    std::vector<short> audio_data(num_samples);
-    file.read(reinterpret_cast<char*>(audio_data.data()), file_size);
-    file.close();
-    std::cout << "✅ 成功读取PCM文件: " << filename << std::endl;
-    std::cout << "   文件大小: " << file_size << " 字节" << std::endl;
-    std::cout << "   样本数量: " << num_samples << std::endl;
-    std::cout << "   时长: " << std::fixed << std::setprecision(2)
-              << (static_cast<double>(num_samples) / 48000.0) << " 秒" << std::endl;
-    return audio_data;
-}
-
 // 保存PCM文件（int16格式）
 bool save_pcm_file_int16(const std::vector<short>& audio_data, const std::string& filename) {
     std::ofstream file(filename, std::ios::binary);
@@ -118,9 +99,39 @@ std::vector<short> process_audio_with_rnnoise_int16(const std::vector<short>& in
     return output_audio;
 }
 
-int main() {
+// 离线并行模式：按块多核处理，输出同样跳过第一帧以与顺序处理对齐
+std::vector<short> process_audio_with_rnnoise_parallel(const std::vector<short>& input_audio,
+                                                       int num_threads, int preroll_ms) {
+    srv::RNNoiseParallel parallel;
+    if (!parallel.init(num_threads, preroll_ms)) {
+        return input_audio;
+    }
+    std::cout << "离线并行模式: 线程数 " << parallel.get_num_threads()
+              << ", 预热 " << preroll_ms << "ms" << std::endl;
+
+    auto output_audio = parallel.process(input_audio);
+    const size_t frame_size = 480;
+    if (output_audio.size() >= frame_size) {
+        output_audio.erase(output_audio.begin(), output_audio.begin() + frame_size);
+    }
+    return output_audio;
+}
+
+int main(int argc, char** argv) {
     std::cout << "=== RNNoise降噪测试（int16格式）===" << std::endl;
     int sample_rate = 48000; // RNNoise推荐48kHz
+
+    // 可选参数: --threads N（0为全部核心）--preroll-ms M，指定后使用离线并行模式
+    int num_threads = -1;
+    int preroll_ms = 500;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string arg = argv[i];
+        if (arg == "--threads") {
+            num_threads = std::stoi(argv[i + 1]);
+        } else if (arg == "--preroll-ms") {
+            preroll_ms = std::stoi(argv[i + 1]);
+        }
+    }
     
     // 尝试多个可能的文件路径
     std::vector<std::string> possible_files = {
@@ -134,8 +145,12 @@ int main() {
     std::vector<short> noise_data;
     std::string found_file;
     
+    // WAV或48kHz单声道s16原始PCM，采样率不同时重采样到48kHz
+    const srv::AudioFile::Format raw_format{48000, 1, srv::AudioFile::SampleFormat::S16};
     for (const auto& file : possible_files) {
-        noise_data = read_pcm_file_int16(file);
+        srv::MonoAudio loaded = srv::load_audio_mono(file, 48000, &raw_format);
+        srv::print_audio_info(file, loaded);
+        noise_data = std::move(loaded.samples);
         if (!noise_data.empty()) {
             found_file = file;
             break;
@@ -162,7 +177,9 @@ int main() {
     std::cout << "  RMS: " << std::fixed << std::setprecision(4) << input_rms << std::endl;
     std::cout << "  峰值: " << input_peak << std::endl;
     
-    auto processed_audio = process_audio_with_rnnoise_int16(noise_data, sample_rate);
+    auto processed_audio = num_threads >= 0
+        ? process_audio_with_rnnoise_parallel(noise_data, num_threads, preroll_ms)
+        : process_audio_with_rnnoise_int16(noise_data, sample_rate);
     
     double output_rms = calculate_rms_int16(processed_audio);
     short output_peak = calculate_peak_int16(processed_audio);
@@ -4,33 +4,10 @@
 #include <cmath>
 #include <iomanip>
 #include <string>
-
-// RNNoise头文件
-extern "C" {
-    #include "rnnoise.h"
-}
-
-// 读取PCM文件（int16格式）
-std::vector<short> read_pcm_file_int16(const std::string& filename) {
-    std::ifstream file(filename, std::ios::binary);
-    if (!file.is_open()) {
-        std::cerr << "❌ 错误：无法打开文件 " << filename << std::endl;
-        return {};
-    }
-    file.seekg(0, std::ios::end);
-    std::streamsize file_size = file.tellg();
-    file.seekg(0, std::ios::beg);
-    size_t num_samples = file_size / sizeof(short);
-    std::vector<short> audio_data(num_samples);
-    file.read(reinterpret_cast<char*>(audio_data.data()), file_size);
-    file.close();
-    std::cout << "✅ 成功读取PCM文件: " << filename << std::endl;
-    std::cout << "   文件大小: " << file_size << " 字节" << std::endl;
-    std::cout << "   样本数量: " << num_samples << std::endl;
-    std::cout << "   时长: " << std::fixed << std::setprecision(2)
-              << (static_cast<double>(num_samples) / 48000.0) << " 秒" << std::endl;
-    return audio_data;
-}
+#include "util/RNNoiseGate.h"
+#include "util/StreamingStats.h"
+#include "util/ColumnarFile.h"
+#include "util/AudioFile.h"
 
 // 计算音频帧的RMS值
 double calculate_frame_rms(const std::vector<float>& frame) {
@@ -52,14 +29,70 @@ float calculate_frame_peak(const std::vector<float>& frame) {
     return max_peak;
 }
 
-// 使用RNNoise进行VAD检测
-std::vector<std::pair<float, double>> process_vad_with_rnnoise(const std::vector<short>& input_audio) {
-    std::vector<std::pair<float, double>> vad_results; // <VAD概率, RMS值>
-    
-    DenoiseState *st = rnnoise_create(NULL);
-    if (!st) {
+// VAD结果的流式汇总：只保留常量大小的统计量，不随帧数增长
+struct VADSummary {
+    srv::StreamingStats prob_stats;
+    srv::StreamingStats rms_stats;
+    std::vector<float> thresholds = {0.1f, 0.2f, 0.3f, 0.4f, 0.5f, 0.6f, 0.7f, 0.8f, 0.9f};
+    std::vector<uint64_t> threshold_counts = std::vector<uint64_t>(9, 0);
+    uint64_t voice_frames = 0;
+    uint64_t silence_frames = 0;
+
+    bool init() {
+        // RMS直方图覆盖int16量纲，每箱32个量化级
+        return prob_stats.init(0.0, 1.0, 100) && rms_stats.init(0.0, 32768.0, 1024);
+    }
+
+    void add(float vad_prob, double rms) {
+        prob_stats.add(vad_prob);
+        rms_stats.add(rms);
+
+        // 阈值统计（使用0.5作为默认阈值）
+        if (vad_prob > 0.5f) {
+            voice_frames++;
+        } else {
+            silence_frames++;
+        }
+
+        // 不同阈值统计
+        for (size_t i = 0; i < thresholds.size(); ++i) {
+            if (vad_prob > thresholds[i]) {
+                threshold_counts[i]++;
+            }
+        }
+    }
+};
+
+// 创建VAD结果文件（列式二进制，每帧: VAD概率、RMS、峰值）
+bool open_vad_results(srv::ColumnarWriter& writer, const std::string& filename) {
+    const std::vector<srv::ColumnSpec> columns = {
+        {"vad_prob", srv::ColumnType::FLOAT32},
+        {"rms", srv::ColumnType::FLOAT32},
+        {"peak", srv::ColumnType::FLOAT32},
+    };
+    if (!writer.open(filename, columns, 48000.0 / 480.0)) { // 每帧10ms
+        std::cerr << "❌ 无法创建文件 " << filename << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// 追加一帧VAD结果
+void save_vad_result(srv::ColumnarWriter& writer, float vad_prob, double rms, float peak) {
+    writer.set(0, vad_prob);
+    writer.set(1, rms);
+    writer.set(2, peak);
+    writer.end_row();
+}
+
+// 使用RNNoise进行VAD检测（前置能量门限，低于floor_dbfs的帧跳过推理）
+// 每帧结果直接写入文件并累加到汇总统计，内存占用与音频时长无关
+bool process_vad_with_rnnoise(const std::vector<short>& input_audio, float floor_dbfs,
+                              VADSummary& summary, srv::ColumnarWriter& results_writer) {
+    srv::RNNoiseGate gate;
+    if (!gate.init(floor_dbfs)) {
         std::cerr << "❌ RNNoise初始化失败" << std::endl;
-        return vad_results;
+        return false;
     }
     
     const int frame_size = 480; // RNNoise固定帧长
@@ -68,25 +101,26 @@ std::vector<std::pair<float, double>> process_vad_with_rnnoise(const std::vector
     std::cout << "开始VAD分析，帧大小: " << frame_size << " 样本" << std::endl;
     std::cout << "总帧数: " << (input_audio.size() / frame_size) << std::endl;
     
+    std::vector<float> float_frame(frame_size, 0.0f);
     for (size_t i = 0; i < input_audio.size(); i += frame_size) {
-        // 创建当前帧
-        std::vector<float> float_frame(frame_size, 0.0f);
-        for (int j = 0; j < frame_size && (i + j) < input_audio.size(); ++j) {
-            float_frame[j] = static_cast<float>(input_audio[i + j]);
+        // 创建当前帧（末尾不足一帧补零）
+        for (int j = 0; j < frame_size; ++j) {
+            float_frame[j] = (i + j) < input_audio.size() ? static_cast<float>(input_audio[i + j]) : 0.0f;
         }
         
-        // 计算当前帧的RMS值
+        // 计算当前帧的RMS值和峰值
         double frame_rms = calculate_frame_rms(float_frame);
+        float frame_peak = calculate_frame_peak(float_frame);
         
         // RNNoise处理（获取VAD概率）
-        float vad_prob = rnnoise_process_frame(st, float_frame.data(), float_frame.data());
+        float vad_prob = gate.process_frame(float_frame.data(), float_frame.data());
         
-        // 保存结果
-        vad_results.push_back({vad_prob, frame_rms});
+        // 汇总并保存结果
+        summary.add(vad_prob, frame_rms);
+        save_vad_result(results_writer, vad_prob, frame_rms, frame_peak);
         
         // 每10帧输出一次详细信息
         if ((i / frame_size) % 10 == 0) {
-            float frame_peak = calculate_frame_peak(float_frame);
             std::cout << "帧 " << std::setw(4) << (i / frame_size) 
                       << " | VAD概率: " << std::fixed << std::setprecision(3) << vad_prob
                       << " | RMS: " << std::fixed << std::setprecision(1) << frame_rms
@@ -96,116 +130,68 @@ std::vector<std::pair<float, double>> process_vad_with_rnnoise(const std::vector
         }
     }
     
-    rnnoise_destroy(st);
-    return vad_results;
+    std::cout << "能量门限: " << floor_dbfs << " dBFS, 跳过推理 " << gate.get_bypassed_frames()
+              << "/" << gate.get_total_frames() << " 帧, 回放预热 " << gate.get_replayed_frames() << " 帧" << std::endl;
+    return true;
 }
 
 // 分析VAD结果
-void analyze_vad_results(const std::vector<std::pair<float, double>>& vad_results) {
-    if (vad_results.empty()) {
+void analyze_vad_results(const VADSummary& summary) {
+    uint64_t total_frames = summary.prob_stats.get_count();
+    if (total_frames == 0) {
         std::cerr << "❌ 没有VAD结果可分析" << std::endl;
         return;
     }
     
     std::cout << "\n=== VAD分析结果 ===" << std::endl;
     
-    // 统计信息
-    int total_frames = vad_results.size();
-    int voice_frames = 0;
-    int silence_frames = 0;
-    float max_vad_prob = 0.0f;
-    float min_vad_prob = 1.0f;
-    double avg_vad_prob = 0.0;
-    double avg_rms = 0.0;
-    
-    // 不同阈值下的统计
-    std::vector<float> thresholds = {0.1f, 0.2f, 0.3f, 0.4f, 0.5f, 0.6f, 0.7f, 0.8f, 0.9f};
-    std::vector<int> threshold_counts(thresholds.size(), 0);
-    
-    for (const auto& result : vad_results) {
-        float vad_prob = result.first;
-        double rms = result.second;
-        
-        // 基本统计
-        avg_vad_prob += vad_prob;
-        avg_rms += rms;
-        max_vad_prob = std::max(max_vad_prob, vad_prob);
-        min_vad_prob = std::min(min_vad_prob, vad_prob);
-        
-        // 阈值统计（使用0.5作为默认阈值）
-        if (vad_prob > 0.5f) {
-            voice_frames++;
-        } else {
-            silence_frames++;
-        }
-        
-        // 不同阈值统计
-        for (size_t i = 0; i < thresholds.size(); ++i) {
-            if (vad_prob > thresholds[i]) {
-                threshold_counts[i]++;
-            }
-        }
-    }
-    
-    avg_vad_prob /= total_frames;
-    avg_rms /= total_frames;
-    
     // 输出统计结果
+    const auto& prob = summary.prob_stats;
+    const auto& rms = summary.rms_stats;
     std::cout << "总帧数: " << total_frames << std::endl;
     std::cout << "总时长: " << std::fixed << std::setprecision(2) 
               << (static_cast<double>(total_frames) * 480.0 / 48000.0) << " 秒" << std::endl;
     std::cout << "\nVAD概率统计:" << std::endl;
-    std::cout << "  最大值: " << std::fixed << std::setprecision(3) << max_vad_prob << std::endl;
-    std::cout << "  最小值: " << std::fixed << std::setprecision(3) << min_vad_prob << std::endl;
-    std::cout << "  平均值: " << std::fixed << std::setprecision(3) << avg_vad_prob << std::endl;
+    std::cout << "  最大值: " << std::fixed << std::setprecision(3) << prob.get_max() << std::endl;
+    std::cout << "  最小值: " << std::fixed << std::setprecision(3) << prob.get_min() << std::endl;
+    std::cout << "  平均值: " << std::fixed << std::setprecision(3) << prob.get_mean() << std::endl;
+    std::cout << "  标准差: " << std::fixed << std::setprecision(3) << prob.get_stddev() << std::endl;
+    std::cout << "  中位数: " << std::fixed << std::setprecision(3) << prob.get_quantile(0.5)
+              << " | P90: " << prob.get_quantile(0.9) << " | P99: " << prob.get_quantile(0.99) << std::endl;
     std::cout << "\nRMS统计:" << std::endl;
-    std::cout << "  平均值: " << std::fixed << std::setprecision(1) << avg_rms << std::endl;
+    std::cout << "  平均值: " << std::fixed << std::setprecision(1) << rms.get_mean() << std::endl;
+    std::cout << "  标准差: " << std::fixed << std::setprecision(1) << rms.get_stddev() << std::endl;
+    std::cout << "  范围: " << std::fixed << std::setprecision(1) << rms.get_min() << " - " << rms.get_max() << std::endl;
+    std::cout << "  中位数: " << std::fixed << std::setprecision(1) << rms.get_quantile(0.5)
+              << " | P90: " << rms.get_quantile(0.9) << " | P99: " << rms.get_quantile(0.99) << std::endl;
     
     std::cout << "\n不同阈值下的语音帧比例:" << std::endl;
-    for (size_t i = 0; i < thresholds.size(); ++i) {
-        double percentage = (static_cast<double>(threshold_counts[i]) / total_frames) * 100.0;
-        std::cout << "  VAD > " << std::fixed << std::setprecision(1) << thresholds[i] 
-                  << ": " << std::setw(4) << threshold_counts[i] << " 帧 (" 
+    for (size_t i = 0; i < summary.thresholds.size(); ++i) {
+        double percentage = (static_cast<double>(summary.threshold_counts[i]) / total_frames) * 100.0;
+        std::cout << "  VAD > " << std::fixed << std::setprecision(1) << summary.thresholds[i] 
+                  << ": " << std::setw(4) << summary.threshold_counts[i] << " 帧 (" 
                   << std::fixed << std::setprecision(1) << percentage << "%)" << std::endl;
     }
     
     std::cout << "\n默认阈值(0.5)分析:" << std::endl;
-    double voice_percentage = (static_cast<double>(voice_frames) / total_frames) * 100.0;
-    double silence_percentage = (static_cast<double>(silence_frames) / total_frames) * 100.0;
-    std::cout << "  语音帧: " << voice_frames << " (" << std::fixed << std::setprecision(1) 
+    double voice_percentage = (static_cast<double>(summary.voice_frames) / total_frames) * 100.0;
+    double silence_percentage = (static_cast<double>(summary.silence_frames) / total_frames) * 100.0;
+    std::cout << "  语音帧: " << summary.voice_frames << " (" << std::fixed << std::setprecision(1) 
               << voice_percentage << "%)" << std::endl;
-    std::cout << "  静音帧: " << silence_frames << " (" << std::fixed << std::setprecision(1) 
+    std::cout << "  静音帧: " << summary.silence_frames << " (" << std::fixed << std::setprecision(1) 
               << silence_percentage << "%)" << std::endl;
 }
 
-// 保存VAD结果到文件
-bool save_vad_results(const std::vector<std::pair<float, double>>& vad_results, 
-                     const std::string& filename) {
-    std::ofstream file(filename);
-    if (!file.is_open()) {
-        std::cerr << "❌ 无法创建文件 " << filename << std::endl;
-        return false;
-    }
-    
-    file << "Frame,VAD_Probability,RMS,Time(s)" << std::endl;
-    
-    for (size_t i = 0; i < vad_results.size(); ++i) {
-        float vad_prob = vad_results[i].first;
-        double rms = vad_results[i].second;
-        double time = static_cast<double>(i) * 480.0 / 48000.0; // 每帧10ms
-        
-        file << i << "," << std::fixed << std::setprecision(6) << vad_prob 
-             << "," << std::fixed << std::setprecision(2) << rms 
-             << "," << std::fixed << std::setprecision(3) << time << std::endl;
-    }
-    
-    file.close();
-    std::cout << "✅ VAD结果已保存到: " << filename << std::endl;
-    return true;
-}
-
-int main() {
+int main(int argc, char** argv) {
     std::cout << "=== RNNoise VAD测试 ===" << std::endl;
+
+    // 可选参数: --floor-dbfs X，峰值低于X dBFS的帧跳过RNNoise推理
+    float floor_dbfs = -60.0f;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (std::string(argv[i]) == "--floor-dbfs") {
+            floor_dbfs = std::stof(argv[i + 1]);
+        }
+    }
     
     // 尝试多个可能的文件路径
     std::vector<std::string> possible_files = {
@@ -218,8 +204,12 @@ int main() {
     std::vector<short> audio_data;
     std::string found_file;
     
+    // WAV或48kHz单声道s16原始PCM，采样率不同时重采样到48kHz
+    const srv::AudioFile::Format raw_format{48000, 1, srv::AudioFile::SampleFormat::S16};
     for (const auto& file : possible_files) {
-        audio_data = read_pcm_file_int16(file);
+        srv::MonoAudio loaded = srv::load_audio_mono(file, 48000, &raw_format);
+        srv::print_audio_info(file, loaded);
+        audio_data = std::move(loaded.samples);
         if (!audio_data.empty()) {
             found_file = file;
             break;
@@ -245,24 +235,26 @@ int main() {
         std::cout << "音频时长: " << std::fixed << std::setprecision(2) << duration << " 秒" << std::endl;
     }
     
-    // 进行VAD分析
+    // 进行VAD分析（逐帧写入结果文件并累加统计）
     std::cout << "\n=== 开始VAD分析 ===" << std::endl;
-    auto vad_results = process_vad_with_rnnoise(audio_data);
-    
-    if (vad_results.empty()) {
+    const std::string results_filename = "rnnoise_vad_results.cols";
+    srv::ColumnarWriter results_writer;
+    VADSummary summary;
+    if (!open_vad_results(results_writer, results_filename) || !summary.init() ||
+        !process_vad_with_rnnoise(audio_data, floor_dbfs, summary, results_writer)) {
         std::cerr << "❌ VAD分析失败" << std::endl;
         return 1;
     }
+    results_writer.close();
+    std::cout << "✅ VAD结果已保存到: " << results_filename << std::endl;
     
     // 分析结果
-    analyze_vad_results(vad_results);
-    
-    // 保存结果
-    save_vad_results(vad_results, "rnnoise_vad_results.csv");
+    analyze_vad_results(summary);
     
     std::cout << "\n=== 测试完成 ===" << std::endl;
-    std::cout << "VAD结果已保存到 rnnoise_vad_results.csv" << std::endl;
-    std::cout << "你可以用Excel或其他工具查看详细的VAD概率变化" << std::endl;
+    std::cout << "VAD结果已保存到 " << results_filename << std::endl;
+    std::cout << "可用 columnar_to_csv " << results_filename << " rnnoise_vad_results.csv 转成CSV，"
+              << "再用Excel或其他工具查看详细的VAD概率变化" << std::endl;
     
     return 0;
 }
\ No newline at end of file
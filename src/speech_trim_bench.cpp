@@ -0,0 +1,172 @@
+// 语音段裁剪输出性能测试：SpeechTrimmer（内存映射 + copy_file_range）vs 逐段读入缓冲再写出，参考顺序拷贝带宽
+// 用法: speech_trim_bench [输入大小MB=256] [工作目录=.]
+#include <iostream>
+#include <vector>
+#include <fstream>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <algorithm>
+#include <random>
+#include <string>
+#include <iomanip>
+#include <chrono>
+#include "util/SpeechTrimmer.h"
+
+// 生成合成PCM文件和静音段：随机长度的语音/静音交替，约70%为语音
+std::vector<srv::SpeechTrimmer::Range> generate_input(const std::string& path, size_t size_mb,
+                                                       int sample_rate, uint64_t* total_frames) {
+    std::vector<srv::SpeechTrimmer::Range> silence;
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    std::mt19937 gen(33);
+    std::uniform_int_distribution<int> speech_ms(300, 5000);
+    std::uniform_int_distribution<int> silence_ms(100, 2000);
+    std::uniform_int_distribution<int> sample_dist(-8000, 8000);
+
+    const uint64_t frames = static_cast<uint64_t>(size_mb) * 1024 * 1024 / sizeof(int16_t);
+    std::vector<int16_t> block;
+    uint64_t pos = 0;
+    bool speech = true;
+    while (pos < frames) {
+        uint64_t length = static_cast<uint64_t>(speech ? speech_ms(gen) : silence_ms(gen)) * sample_rate / 1000;
+        length = std::min(length, frames - pos);
+        block.resize(length);
+        for (auto& s : block) {
+            s = speech ? static_cast<int16_t>(sample_dist(gen)) : 0;
+        }
+        file.write(reinterpret_cast<const char*>(block.data()), block.size() * sizeof(int16_t));
+        if (!speech) {
+            silence.push_back({pos, pos + length});
+        }
+        pos += length;
+        speech = !speech;
+    }
+    *total_frames = frames;
+    return silence;
+}
+
+// 对照：逐段读入缓冲、加淡变后写出
+bool trim_buffered(const std::string& input_path, const std::string& output_path,
+                   const std::vector<srv::SpeechTrimmer::Range>& speech, uint64_t total_frames, int fade_frames) {
+    std::ifstream in(input_path, std::ios::binary);
+    std::ofstream out(output_path, std::ios::binary | std::ios::trunc);
+    if (!in.is_open() || !out.is_open()) {
+        return false;
+    }
+    std::vector<int16_t> buffer;
+    for (const auto& r : speech) {
+        uint64_t length = r.end_sample - r.start_sample;
+        buffer.resize(length);
+        in.seekg(static_cast<std::streamoff>(r.start_sample * sizeof(int16_t)));
+        in.read(reinterpret_cast<char*>(buffer.data()), length * sizeof(int16_t));
+        uint64_t fade = std::min<uint64_t>(fade_frames, length / 2);
+        uint64_t fade_in = r.start_sample > 0 ? fade : 0;
+        uint64_t fade_out = r.end_sample < total_frames ? fade : 0;
+        for (uint64_t k = 0; k < fade_in; ++k) {
+            buffer[k] = static_cast<int16_t>(buffer[k] * ((k + 0.5f) / fade_in));
+        }
+        for (uint64_t k = 0; k < fade_out; ++k) {
+            uint64_t i = length - fade_out + k;
+            buffer[i] = static_cast<int16_t>(buffer[i] * (1.0f - (k + 0.5f) / fade_out));
+        }
+        out.write(reinterpret_cast<const char*>(buffer.data()), length * sizeof(int16_t));
+    }
+    return out.good();
+}
+
+// 参考带宽：1MB缓冲顺序拷贝整个文件
+double copy_bandwidth(const std::string& input_path, const std::string& output_path) {
+    auto start = std::chrono::steady_clock::now();
+    std::FILE* in = std::fopen(input_path.c_str(), "rb");
+    std::FILE* out = std::fopen(output_path.c_str(), "wb");
+    if (!in || !out) {
+        if (in) std::fclose(in);
+        if (out) std::fclose(out);
+        return 0.0;
+    }
+    std::vector<char> buffer(1 << 20);
+    size_t total = 0;
+    size_t n = 0;
+    while ((n = std::fread(buffer.data(), 1, buffer.size(), in)) > 0) {
+        std::fwrite(buffer.data(), 1, n, out);
+        total += n;
+    }
+    std::fclose(in);
+    std::fclose(out);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return total / (1024.0 * 1024.0) / seconds;
+}
+
+bool same_file(const std::string& a, const std::string& b) {
+    std::ifstream fa(a, std::ios::binary);
+    std::ifstream fb(b, std::ios::binary);
+    std::vector<char> ba(1 << 20);
+    std::vector<char> bb(1 << 20);
+    while (fa && fb) {
+        fa.read(ba.data(), ba.size());
+        fb.read(bb.data(), bb.size());
+        if (fa.gcount() != fb.gcount() || !std::equal(ba.begin(), ba.begin() + fa.gcount(), bb.begin())) {
+            return false;
+        }
+    }
+    return fa.eof() && fb.eof();
+}
+
+int main(int argc, char** argv) {
+    std::cout << "=== 语音段裁剪输出性能测试 ===" << std::endl;
+    const size_t size_mb = argc > 1 ? static_cast<size_t>(std::atoi(argv[1])) : 256;
+    const std::string dir = argc > 2 ? argv[2] : ".";
+    const int sample_rate = 16000;
+    const int fade_ms = 5;
+
+    const std::string input_path = dir + "/trim_bench_input.pcm";
+    const std::string trimmed_path = dir + "/trim_bench_trimmed.pcm";
+    const std::string buffered_path = dir + "/trim_bench_buffered.pcm";
+    const std::string copy_path = dir + "/trim_bench_copy.pcm";
+    const std::string map_path = dir + "/trim_bench_trimmed.map.csv";
+
+    std::cout << "生成 " << size_mb << "MB 输入文件..." << std::endl;
+    uint64_t total_frames = 0;
+    auto silence = generate_input(input_path, size_mb, sample_rate, &total_frames);
+    auto speech = srv::SpeechTrimmer::invert(silence, total_frames);
+    std::cout << "语音段: " << speech.size() << ", 静音段: " << silence.size() << std::endl;
+
+    double reference_mbps = copy_bandwidth(input_path, copy_path);
+
+    srv::SpeechTrimmer trimmer;
+    trimmer.init(sample_rate, 1, fade_ms);
+    if (!trimmer.trim(input_path, trimmed_path, speech)) {
+        std::cerr << "❌ 裁剪失败" << std::endl;
+        return 1;
+    }
+    trimmer.write_offset_map(map_path);
+
+    auto start = std::chrono::steady_clock::now();
+    trim_buffered(input_path, buffered_path, speech, total_frames, sample_rate * fade_ms / 1000);
+    double buffered_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    double buffered_mbps = trimmer.get_bytes_written() / (1024.0 * 1024.0) / buffered_s;
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "\n输出: " << (trimmer.get_bytes_written() / (1024.0 * 1024.0)) << "MB, 其中零拷贝 "
+              << (100.0 * trimmer.get_bytes_zero_copy() / std::max<uint64_t>(1, trimmer.get_bytes_written())) << "%" << std::endl;
+    std::cout << "顺序拷贝参考带宽: " << reference_mbps << " MB/s" << std::endl;
+    std::cout << "SpeechTrimmer:     " << trimmer.get_throughput_mbps() << " MB/s ("
+              << (100.0 * trimmer.get_throughput_mbps() / reference_mbps) << "% 参考带宽)" << std::endl;
+    std::cout << "缓冲读写:          " << buffered_mbps << " MB/s" << std::endl;
+    std::cout << "输出一致: " << (same_file(trimmed_path, buffered_path) ? "✅" : "❌") << std::endl;
+
+    // 偏移映射校验：输出中每段起点映射回原始语音段起点
+    bool map_ok = true;
+    for (const auto& entry : trimmer.get_offset_map()) {
+        map_ok = map_ok && trimmer.output_to_input(entry.output_frame) == entry.input_frame;
+    }
+    std::cout << "偏移映射: " << (map_ok ? "✅" : "❌") << " (" << map_path << ")" << std::endl;
+
+    std::remove(input_path.c_str());
+    std::remove(trimmed_path.c_str());
+    std::remove(buffered_path.c_str());
+    std::remove(copy_path.c_str());
+
+    std::cout << "\n=== 测试完成 ===" << std::endl;
+    return 0;
+}
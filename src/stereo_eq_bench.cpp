@@ -0,0 +1,142 @@
+// 立体声EQ测试：一次复数FFT同时处理左右声道（StereoEqualizer）与两个独立的单声道Equalizer对比速度和输出
+// 用法: stereo_eq_bench [--fft-wisdom FILE] [音频秒数，默认60]
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <iomanip>
+#include <chrono>
+#include <functional>
+#include "util/DSPKernels.h"
+#include "util/Equalizer.h"
+#include "util/FFTPlanRegistry.h"
+#include "util/StereoEqualizer.h"
+
+namespace {
+
+// 左右声道内容不同的交织立体声：各自的正弦加白噪声
+std::vector<float> make_stereo(size_t frames, int sample_rate) {
+    std::vector<float> audio(2 * frames);
+    std::mt19937 gen(21);
+    std::normal_distribution<float> noise(0.0f, 0.03f);
+    for (size_t i = 0; i < frames; ++i) {
+        const float t = static_cast<float>(i) / sample_rate;
+        audio[2 * i] = 0.2f * std::sin(2.0f * static_cast<float>(M_PI) * 220.0f * t) + noise(gen);
+        audio[2 * i + 1] = 0.2f * std::sin(2.0f * static_cast<float>(M_PI) * 3150.0f * t) + noise(gen);
+    }
+    return audio;
+}
+
+// 多次运行取最快一次（秒）
+double best_of(int runs, const std::function<void()>& fn) {
+    double best = 1e30;
+    for (int r = 0; r < runs; ++r) {
+        auto start = std::chrono::steady_clock::now();
+        fn();
+        best = std::min(best, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+    }
+    return best;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    srv::FFTPlanRegistry::instance().init(srv::FFTPlanRegistry::take_wisdom_arg(argc, argv));
+    const int sample_rate = 48000;
+    int seconds = 60;
+    if (argc > 1) {
+        seconds = std::max(1, std::atoi(argv[1]));
+    }
+    const size_t frames = static_cast<size_t>(sample_rate) * seconds;
+    const std::vector<float> preset = srv::Equalizer::createPreset("vocal_boost");
+    const std::vector<float> input = make_stereo(frames, sample_rate);
+    const double n = static_cast<double>(frames);
+    bool all_ok = true;
+
+    std::cout << "=== 立体声EQ测试 ===" << std::endl;
+    std::cout << "音频: " << seconds << " 秒立体声, " << sample_rate << " Hz, 预设vocal_boost" << std::endl;
+
+    for (int fft_bits : {10, 12}) {
+        const int fft_size = 1 << fft_bits;
+        std::cout << "\nFFT " << fft_size << "点（每帧ns = 每对左右样本）:" << std::endl;
+
+        srv::Equalizer left_eq;
+        srv::Equalizer right_eq;
+        srv::StereoEqualizer stereo_eq;
+        if (!left_eq.init(fft_bits, sample_rate) || !right_eq.init(fft_bits, sample_rate) ||
+            !stereo_eq.init(fft_bits, sample_rate)) {
+            return 1;
+        }
+        left_eq.setEQdB(preset);
+        right_eq.setEQdB(preset);
+        stereo_eq.setEQdB(preset);
+        const size_t latency = stereo_eq.get_latency();
+
+        // 两个独立实例：输入先拆成平面，处理后再交织
+        std::vector<float> left(frames + latency);
+        std::vector<float> right(frames + latency);
+        std::vector<float> pair_out(2 * (frames + latency));
+        float* planes[2] = {left.data(), right.data()};
+        const double split_seconds = best_of(3, [&] {
+            srv::kernels::deinterleave_f32(input.data(), planes, frames, 2);
+            left_eq.process(left.data(), left.data(), frames);
+            left_eq.flush(left.data() + frames);
+            right_eq.process(right.data(), right.data(), frames);
+            right_eq.flush(right.data() + frames);
+            const float* const const_planes[2] = {left.data(), right.data()};
+            srv::kernels::interleave_f32(const_planes, pair_out.data(), frames + latency, 2);
+        });
+        // 只算两个实例本身（平面输入输出）
+        const double pair_seconds = best_of(3, [&] {
+            left_eq.process(left.data(), left.data(), frames);
+            left_eq.flush(left.data() + frames);
+            right_eq.process(right.data(), right.data(), frames);
+            right_eq.flush(right.data() + frames);
+        });
+
+        std::vector<float> stereo_out(2 * (frames + latency));
+        const double stereo_seconds = best_of(3, [&] {
+            stereo_eq.process(input.data(), stereo_out.data(), frames);
+            stereo_eq.flush(stereo_out.data() + 2 * frames);
+        });
+
+        // 与两个独立实例的输出比较（浮点舍入误差内）
+        double max_diff = 0.0;
+        for (size_t i = 0; i < stereo_out.size(); ++i) {
+            max_diff = std::max(max_diff, static_cast<double>(std::abs(stereo_out[i] - pair_out[i])));
+        }
+
+        // 随机分块的short接口与整段处理相同，总输出与输入等长
+        std::vector<short> input_s16(input.size());
+        srv::kernels::f32_to_s16(input.data(), input_s16.data(), input.size(), 32768.0f);
+        const std::vector<short> whole = stereo_eq.processAudio(input_s16);
+        std::vector<short> chunked;
+        std::mt19937 gen(5);
+        std::uniform_int_distribution<size_t> chunk(1, 3000);
+        for (size_t pos = 0; pos < frames;) {
+            const size_t take = std::min(chunk(gen), frames - pos);
+            stereo_eq.process(&input_s16[2 * pos], take, chunked);
+            pos += take;
+        }
+        stereo_eq.flush(chunked);
+        const bool stream_ok = chunked == whole && whole.size() == input_s16.size();
+
+        const bool ok = max_diff < 1e-5 && stream_ok;
+        all_ok = all_ok && ok;
+        std::cout << std::fixed << std::setprecision(2);
+        std::cout << "  两个实例（平面）          " << std::setw(7) << pair_seconds / n * 1e9 << " ns/帧" << std::endl;
+        std::cout << "  两个实例（含拆分/交织）   " << std::setw(7) << split_seconds / n * 1e9 << " ns/帧" << std::endl;
+        std::cout << "  一次复数FFT（交织）       " << std::setw(7) << stereo_seconds / n * 1e9 << " ns/帧, 加速 "
+                  << pair_seconds / stereo_seconds << "x / " << split_seconds / stereo_seconds << "x" << std::endl;
+        std::cout << "  与两个实例最大差 " << std::scientific << std::setprecision(1) << max_diff << std::fixed
+                  << ", 分块short接口" << (stream_ok ? "一致" : "不一致") << (ok ? " ✅" : " ❌") << std::endl;
+    }
+
+    srv::FFTPlanRegistry::instance().save_wisdom();
+    std::cout << "\n" << (all_ok ? "✅ 立体声EQ输出与两个单声道实例一致" : "❌ 立体声EQ输出与两个单声道实例不一致")
+              << std::endl;
+    return all_ok ? 0 : 1;
+}
@@ -0,0 +1,101 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include "util/ProcessStats.h"
+#include "util/RNNoise.h"
+#include "util/StreamPipeline.h"
+
+// 流式降噪：任意时长的WAV/PCM文件经RNNoise处理后写出WAV，内存占用与文件时长无关
+// 用法: stream_denoise [输入文件] [输出WAV] [--bypass]
+int main(int argc, char** argv) {
+    std::string input_path = "res/sp01_car_sn15.wav";
+    std::string output_path = "stream_denoise_output.wav";
+    bool bypass = false;
+    std::vector<std::string> positional;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--bypass") {
+            bypass = true;
+        } else {
+            positional.push_back(arg);
+        }
+    }
+    if (positional.size() > 0) input_path = positional[0];
+    if (positional.size() > 1) output_path = positional[1];
+
+    std::cout << "=== 流式降噪（RNNoise）===" << std::endl;
+    std::cout << "输入: " << input_path << std::endl;
+    std::cout << "输出: " << output_path << std::endl;
+    if (bypass) {
+        std::cout << "模式: 直通（只测读写开销）" << std::endl;
+    }
+
+    srv::RNNoise rnnoise;
+    if (!bypass && !rnnoise.init()) {
+        std::cerr << "❌ RNNoise初始化失败" << std::endl;
+        return 1;
+    }
+
+    // RNNoise固定48kHz单声道10ms帧，混音和重采样在读线程完成
+    srv::StreamPipeline pipeline;
+    if (!pipeline.init(srv::RNNoise::FRAME_SIZE, srv::RNNoise::get_sample_rate(), true)) {
+        return 1;
+    }
+
+    // 原始PCM没有格式说明文件时按48kHz单声道s16处理
+    const srv::AudioFile::Format raw_format{48000, 1, srv::AudioFile::SampleFormat::S16};
+    std::vector<short> frame(srv::RNNoise::FRAME_SIZE, 0);
+    bool first_frame = true;
+    uint64_t voice_frames = 0;
+    uint64_t total_frames = 0;
+
+    bool ok = pipeline.run(input_path, output_path, [&](int16_t* samples, size_t frames) -> size_t {
+        if (bypass) {
+            return frames;
+        }
+        // 最后一块不足一帧时补零处理，只写出有效部分
+        std::copy(samples, samples + frames, frame.begin());
+        std::fill(frame.begin() + frames, frame.end(), 0);
+        float vad_prob = rnnoise.process_frame(frame.data(), frame.data());
+        std::copy(frame.begin(), frame.begin() + frames, samples);
+        ++total_frames;
+        if (vad_prob > 0.5f) {
+            ++voice_frames;
+        }
+        // 与rnnoise_test一致跳过第一帧输出
+        if (first_frame) {
+            first_frame = false;
+            return 0;
+        }
+        return frames;
+    }, &raw_format);
+
+    if (!ok) {
+        std::cerr << "❌ 处理失败" << std::endl;
+        return 1;
+    }
+
+    const double audio_seconds = static_cast<double>(pipeline.get_frames_in()) / pipeline.get_sample_rate();
+    const double total_seconds = pipeline.get_total_seconds();
+    std::cout << "✅ 处理完成" << std::endl;
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "  音频时长: " << audio_seconds << " 秒 (" << pipeline.get_sample_rate() << " Hz, "
+              << pipeline.get_channels() << " 声道)" << std::endl;
+    std::cout << "  输入/输出帧: " << pipeline.get_frames_in() << " / " << pipeline.get_frames_out() << std::endl;
+    if (!bypass && total_frames > 0) {
+        std::cout << "  语音帧比例: " << (100.0 * voice_frames / total_frames) << "%" << std::endl;
+    }
+    std::cout << "  总耗时: " << std::setprecision(3) << total_seconds << " 秒，"
+              << std::setprecision(1) << (total_seconds > 0 ? audio_seconds / total_seconds : 0.0) << "x 实时"
+              << std::endl;
+    std::cout << std::setprecision(3);
+    std::cout << "  处理耗时: " << pipeline.get_process_seconds() << " 秒" << std::endl;
+    std::cout << "  等待读取: " << pipeline.get_reader_wait_seconds() << " 秒" << std::endl;
+    std::cout << "  等待写盘: " << pipeline.get_writer_wait_seconds() << " 秒" << std::endl;
+    std::cout << "  峰值内存: " << std::setprecision(1)
+              << (srv::ProcessStats::get_peak_rss_bytes() / (1024.0 * 1024.0)) << " MB" << std::endl;
+    std::cout << "\n播放命令:" << std::endl;
+    std::cout << "  ffplay -nodisp -autoexit " << output_path << std::endl;
+    return 0;
+}
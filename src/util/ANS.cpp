@@ -85,11 +85,8 @@ std::vector<spx_int16_t> ANS::process_frame(const spx_int16_t* audio_frame, int
         
         // 使用speex预处理器进行噪声抑制
         // 注意：speex_preprocess_run会修改输入的音频数据
-        int result = speex_preprocess_run(preprocess_state_, output_frame.data());
-        
-        if (result != 0) {
-            std::cerr << "ANS process warning: speex_preprocess_run returned " << result << std::endl;
-        }
+        // 返回值是VAD判决（未启用VAD时恒为1），不是错误码，逐帧流式处理时不能当警告输出
+        speex_preprocess_run(preprocess_state_, output_frame.data());
         
         return output_frame;
     } catch (const std::exception& e) {
@@ -0,0 +1,458 @@
+#include "AudioFile.h"
+#include "Resampler.h"
+#include "DSPKernels.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace srv {
+
+namespace {
+
+const uint16_t kWaveFormatPcm = 0x0001;
+const uint16_t kWaveFormatFloat = 0x0003;
+const uint16_t kWaveFormatExtensible = 0xFFFE;
+
+uint16_t get_u16(const uint8_t* p) {
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+uint32_t get_u32(const uint8_t* p) {
+    uint32_t value = 0;
+    for (int i = 0; i < 4; ++i) {
+        value |= static_cast<uint32_t>(p[i]) << (8 * i);
+    }
+    return value;
+}
+
+uint64_t get_u64(const uint8_t* p) {
+    uint64_t value = 0;
+    for (int i = 0; i < 8; ++i) {
+        value |= static_cast<uint64_t>(p[i]) << (8 * i);
+    }
+    return value;
+}
+
+// 24位小端打包样本符号扩展到32位（值在高24位）
+inline int32_t load_s24(const uint8_t* p) {
+    return static_cast<int32_t>((static_cast<uint32_t>(p[0]) << 8) | (static_cast<uint32_t>(p[1]) << 16) |
+                                (static_cast<uint32_t>(p[2]) << 24));
+}
+
+inline int32_t load_s32(const uint8_t* p) {
+    int32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+} // namespace
+
+AudioFile::AudioFile()
+    : map_(nullptr)
+    , map_size_(0)
+    , data_offset_(0)
+    , num_frames_(0)
+    , format_{0, 0, SampleFormat::S16}
+    , bytes_per_sample_(0)
+    , bytes_per_frame_(0)
+    , is_wav_(false) {
+}
+
+AudioFile::~AudioFile() {
+    close();
+}
+
+size_t AudioFile::get_sample_size(SampleFormat format) {
+    switch (format) {
+    case SampleFormat::S16:
+        return 2;
+    case SampleFormat::S24:
+        return 3;
+    case SampleFormat::S32:
+    case SampleFormat::F32:
+        return 4;
+    }
+    return 0;
+}
+
+const char* AudioFile::get_format_name(SampleFormat format) {
+    switch (format) {
+    case SampleFormat::S16:
+        return "s16";
+    case SampleFormat::S24:
+        return "s24";
+    case SampleFormat::S32:
+        return "s32";
+    case SampleFormat::F32:
+        return "f32";
+    }
+    return "unknown";
+}
+
+void AudioFile::close() {
+    if (map_) {
+        munmap(const_cast<uint8_t*>(map_), map_size_);
+        map_ = nullptr;
+    }
+    map_size_ = 0;
+    data_offset_ = 0;
+    num_frames_ = 0;
+    is_wav_ = false;
+}
+
+bool AudioFile::open(const std::string& path, const Format* raw_format) {
+    close();
+
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "AudioFile open failed: cannot open " << path << std::endl;
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        std::cerr << "AudioFile open failed: empty file " << path << std::endl;
+        ::close(fd);
+        return false;
+    }
+    map_size_ = static_cast<size_t>(st.st_size);
+    void* mapped = mmap(nullptr, map_size_, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) {
+        std::cerr << "AudioFile open failed: mmap error " << path << std::endl;
+        map_size_ = 0;
+        return false;
+    }
+    map_ = static_cast<const uint8_t*>(mapped);
+    madvise(mapped, map_size_, MADV_SEQUENTIAL);
+    path_ = path;
+
+    const bool riff = map_size_ >= 12 && (std::memcmp(map_, "RIFF", 4) == 0 || std::memcmp(map_, "RF64", 4) == 0) &&
+                      std::memcmp(map_ + 8, "WAVE", 4) == 0;
+    if (riff) {
+        if (!parse_wav()) {
+            close();
+            return false;
+        }
+        is_wav_ = true;
+    } else {
+        // 说明文件存在就以它为准，内容无效时报错而不是退回raw_format按错误的格式解码
+        Format format;
+        const std::string sidecar_path = path + ".fmt";
+        struct stat sidecar_st;
+        if (stat(sidecar_path.c_str(), &sidecar_st) == 0) {
+            if (!read_sidecar(sidecar_path, format)) {
+                std::cerr << "AudioFile open failed: invalid format file " << sidecar_path << std::endl;
+                close();
+                return false;
+            }
+        } else if (raw_format) {
+            format = *raw_format;
+        } else {
+            std::cerr << "AudioFile open failed: unknown format for raw PCM " << path << std::endl;
+            close();
+            return false;
+        }
+        format_ = format;
+        data_offset_ = 0;
+    }
+
+    bytes_per_sample_ = get_sample_size(format_.sample_format);
+    if (format_.sample_rate <= 0 || format_.channels <= 0 || bytes_per_sample_ == 0) {
+        std::cerr << "AudioFile open failed: invalid format " << path << std::endl;
+        close();
+        return false;
+    }
+    bytes_per_frame_ = bytes_per_sample_ * format_.channels;
+    if (!is_wav_) {
+        num_frames_ = (map_size_ - data_offset_) / bytes_per_frame_;
+    }
+    return true;
+}
+
+bool AudioFile::parse_wav() {
+    const bool rf64 = std::memcmp(map_, "RF64", 4) == 0;
+    uint64_t ds64_data_size = 0;
+    bool have_fmt = false;
+
+    size_t pos = 12;
+    while (pos + 8 <= map_size_) {
+        const uint8_t* chunk = map_ + pos;
+        uint64_t chunk_size = get_u32(chunk + 4);
+        const size_t body = pos + 8;
+
+        if (std::memcmp(chunk, "ds64", 4) == 0 && body + 24 <= map_size_) {
+            // RF64: riffSize(8) dataSize(8) sampleCount(8)
+            ds64_data_size = get_u64(map_ + body + 8);
+        } else if (std::memcmp(chunk, "fmt ", 4) == 0 && body + 16 <= map_size_) {
+            uint16_t tag = get_u16(map_ + body);
+            const uint16_t channels = get_u16(map_ + body + 2);
+            const uint32_t rate = get_u32(map_ + body + 4);
+            const uint16_t bits = get_u16(map_ + body + 14);
+            if (tag == kWaveFormatExtensible && chunk_size >= 40 && body + 26 <= map_size_) {
+                // 子格式GUID的前两个字节即格式标签
+                tag = get_u16(map_ + body + 24);
+            }
+            if (tag == kWaveFormatPcm && bits == 16) {
+                format_.sample_format = SampleFormat::S16;
+            } else if (tag == kWaveFormatPcm && bits == 24) {
+                format_.sample_format = SampleFormat::S24;
+            } else if (tag == kWaveFormatPcm && bits == 32) {
+                format_.sample_format = SampleFormat::S32;
+            } else if (tag == kWaveFormatFloat && bits == 32) {
+                format_.sample_format = SampleFormat::F32;
+            } else {
+                std::cerr << "AudioFile open failed: unsupported WAV format tag=" << tag << " bits=" << bits
+                          << " " << path_ << std::endl;
+                return false;
+            }
+            format_.sample_rate = static_cast<int>(rate);
+            format_.channels = channels;
+            have_fmt = true;
+        } else if (std::memcmp(chunk, "data", 4) == 0) {
+            if (!have_fmt) {
+                std::cerr << "AudioFile open failed: data chunk before fmt " << path_ << std::endl;
+                return false;
+            }
+            if (rf64 && chunk_size == 0xFFFFFFFFull) {
+                chunk_size = ds64_data_size;
+            }
+            // 写入中断的文件按实际长度截断
+            chunk_size = std::min<uint64_t>(chunk_size, map_size_ - body);
+            const size_t frame_bytes = get_sample_size(format_.sample_format) * format_.channels;
+            data_offset_ = body;
+            num_frames_ = frame_bytes ? chunk_size / frame_bytes : 0;
+            return true;
+        }
+        pos = body + chunk_size + (chunk_size & 1);
+    }
+
+    std::cerr << "AudioFile open failed: no data chunk " << path_ << std::endl;
+    return false;
+}
+
+bool AudioFile::read_sidecar(const std::string& sidecar_path, Format& format) const {
+    std::ifstream file(sidecar_path);
+    if (!file.is_open()) {
+        return false;
+    }
+    format = Format{0, 1, SampleFormat::S16};
+    std::string line;
+    while (std::getline(file, line)) {
+        size_t eq = line.find('=');
+        if (eq == std::string::npos) {
+            continue;
+        }
+        std::string key = line.substr(0, eq);
+        std::string value = line.substr(eq + 1);
+        if (key == "sample_rate") {
+            format.sample_rate = std::atoi(value.c_str());
+        } else if (key == "channels") {
+            format.channels = std::atoi(value.c_str());
+        } else if (key == "format") {
+            if (value == "s16") {
+                format.sample_format = SampleFormat::S16;
+            } else if (value == "s24") {
+                format.sample_format = SampleFormat::S24;
+            } else if (value == "s32") {
+                format.sample_format = SampleFormat::S32;
+            } else if (value == "f32") {
+                format.sample_format = SampleFormat::F32;
+            } else {
+                std::cerr << "AudioFile: unknown format in " << sidecar_path << ": " << value << std::endl;
+                return false;
+            }
+        }
+    }
+    return format.sample_rate > 0 && format.channels > 0;
+}
+
+bool AudioFile::write_sidecar(const std::string& pcm_path, const Format& format) {
+    std::ofstream file(pcm_path + ".fmt");
+    if (!file.is_open()) {
+        std::cerr << "AudioFile: cannot create " << pcm_path << ".fmt" << std::endl;
+        return false;
+    }
+    file << "sample_rate=" << format.sample_rate << "\n"
+         << "channels=" << format.channels << "\n"
+         << "format=" << get_format_name(format.sample_format) << "\n";
+    return static_cast<bool>(file);
+}
+
+AudioFile::View AudioFile::get_frames(uint64_t start_frame, size_t frames) const {
+    View view{nullptr, 0, start_frame};
+    if (!map_ || start_frame >= num_frames_) {
+        return view;
+    }
+    view.frames = static_cast<size_t>(std::min<uint64_t>(frames, num_frames_ - start_frame));
+    view.data = map_ + data_offset_ + start_frame * bytes_per_frame_;
+    prefetch(start_frame + view.frames, view.frames);
+    return view;
+}
+
+void AudioFile::prefetch(uint64_t start_frame, size_t frames) const {
+    if (!map_ || start_frame >= num_frames_ || frames == 0) {
+        return;
+    }
+    frames = static_cast<size_t>(std::min<uint64_t>(frames, num_frames_ - start_frame));
+    // madvise要求起始地址页对齐
+    const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    size_t begin = data_offset_ + start_frame * bytes_per_frame_;
+    size_t end = begin + frames * bytes_per_frame_;
+    begin -= begin % page;
+    madvise(const_cast<uint8_t*>(map_) + begin, end - begin, MADV_WILLNEED);
+}
+
+void AudioFile::release(uint64_t start_frame, size_t frames) const {
+    if (!map_ || start_frame >= num_frames_ || frames == 0) {
+        return;
+    }
+    frames = static_cast<size_t>(std::min<uint64_t>(frames, num_frames_ - start_frame));
+    // 只丢弃完全落在范围内的页，不影响相邻数据
+    const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    size_t begin = data_offset_ + start_frame * bytes_per_frame_;
+    size_t end = begin + frames * bytes_per_frame_;
+    begin = (begin + page - 1) / page * page;
+    end -= end % page;
+    if (end > begin) {
+        madvise(const_cast<uint8_t*>(map_) + begin, end - begin, MADV_DONTNEED);
+    }
+}
+
+size_t AudioFile::read_s16(uint64_t start_frame, size_t frames, int16_t* out) const {
+    View view = get_frames(start_frame, frames);
+    const size_t count = view.frames * format_.channels;
+    const uint8_t* p = view.data;
+    switch (format_.sample_format) {
+    case SampleFormat::S16:
+        std::memcpy(out, p, count * sizeof(int16_t));
+        break;
+    case SampleFormat::S24:
+        for (size_t i = 0; i < count; ++i) {
+            out[i] = static_cast<int16_t>(load_s24(p + 3 * i) >> 16);
+        }
+        break;
+    case SampleFormat::S32:
+        for (size_t i = 0; i < count; ++i) {
+            out[i] = static_cast<int16_t>(load_s32(p + 4 * i) >> 16);
+        }
+        break;
+    case SampleFormat::F32: {
+        // fmt块为18字节时数据只按2字节对齐，不能直接当float数组读，分块复制到对齐缓冲区再转换
+        const size_t kBlock = 256;
+        float block[kBlock];
+        for (size_t i = 0; i < count; i += kBlock) {
+            const size_t n = std::min(kBlock, count - i);
+            std::memcpy(block, p + i * sizeof(float), n * sizeof(float));
+            kernels::f32_to_s16(block, out + i, n, 32768.0f);
+        }
+        break;
+    }
+    }
+    return view.frames;
+}
+
+size_t AudioFile::read_float(uint64_t start_frame, size_t frames, float* out) const {
+    View view = get_frames(start_frame, frames);
+    const size_t count = view.frames * format_.channels;
+    const uint8_t* p = view.data;
+    switch (format_.sample_format) {
+    case SampleFormat::S16:
+        kernels::s16_to_f32(reinterpret_cast<const int16_t*>(p), out, count, 1.0f / 32768.0f);
+        break;
+    case SampleFormat::S24:
+        kernels::s24_to_f32(p, out, count, 1.0f / 8388608.0f);
+        break;
+    case SampleFormat::S32:
+        kernels::s32_to_f32(p, out, count, 1.0f / 2147483648.0f);
+        break;
+    case SampleFormat::F32:
+        std::memcpy(out, p, count * sizeof(float));
+        break;
+    }
+    return view.frames;
+}
+
+MonoAudio load_audio_mono(const std::string& path, int target_rate, const AudioFile::Format* raw_format) {
+    MonoAudio audio{{}, 0, {0, 0, AudioFile::SampleFormat::S16}, false};
+    AudioFile file;
+    if (!file.open(path, raw_format)) {
+        return audio;
+    }
+    audio.source_format = file.get_format();
+    audio.is_wav = file.is_wav();
+
+    // 分块转换，多声道取平均
+    std::vector<int16_t>& mono = audio.samples;
+    const int channels = file.get_channels();
+    const size_t block_frames = 65536;
+    std::vector<int16_t> block(block_frames * channels);
+    mono.reserve(static_cast<size_t>(file.get_num_frames()));
+    for (uint64_t start = 0; start < file.get_num_frames(); start += block_frames) {
+        size_t frames = file.read_s16(start, block_frames, block.data());
+        for (size_t i = 0; i < frames; ++i) {
+            int32_t sum = 0;
+            for (int c = 0; c < channels; ++c) {
+                sum += block[i * channels + c];
+            }
+            mono.push_back(static_cast<int16_t>(sum / channels));
+        }
+    }
+
+    int rate = file.get_sample_rate();
+    if (target_rate > 0 && target_rate != rate && !mono.empty()) {
+        Resampler resampler;
+        if (!resampler.init(rate, target_rate)) {
+            mono.clear();
+            return audio;
+        }
+        // reset跳过滤波器起始的零延迟，输出与输入对齐；末尾补零冲出内部缓存的样本
+        resampler.reset();
+        std::vector<int16_t> resampled;
+        resampled.reserve(mono.size() * static_cast<size_t>(target_rate) / rate + 1);
+        resampler.process(mono.data(), mono.size(), resampled);
+        std::vector<int16_t> tail(static_cast<size_t>(resampler.get_input_latency()), 0);
+        resampler.process(tail.data(), tail.size(), resampled);
+        resampled.resize(static_cast<size_t>(static_cast<uint64_t>(mono.size()) * target_rate / rate));
+        mono.swap(resampled);
+        rate = target_rate;
+    }
+    audio.sample_rate = rate;
+    return audio;
+}
+
+bool print_audio_info(const std::string& path, const MonoAudio& audio) {
+    if (audio.sample_rate == 0) {
+        std::cerr << "❌ 错误：无法打开文件 " << path << std::endl;
+        return false;
+    }
+    const AudioFile::Format& format = audio.source_format;
+    std::cout << "✅ 成功读取音频文件: " << path << std::endl;
+    std::cout << "   格式: " << (audio.is_wav ? "WAV " : "PCM ") << format.sample_rate << " Hz, " << format.channels
+              << " 声道, " << AudioFile::get_format_name(format.sample_format) << std::endl;
+    if (format.sample_rate != audio.sample_rate) {
+        std::cout << "   已重采样: " << format.sample_rate << " Hz → " << audio.sample_rate << " Hz" << std::endl;
+    }
+    std::cout << "   样本数量: " << audio.samples.size() << std::endl;
+    std::cout << "   时长: " << std::fixed << std::setprecision(2)
+              << (static_cast<double>(audio.samples.size()) / audio.sample_rate) << " 秒" << std::endl;
+    return true;
+}
+
+std::vector<int16_t> load_audio_mono_s16(const std::string& path, int target_rate, const AudioFile::Format* raw_format,
+                                         int* sample_rate) {
+    MonoAudio audio = load_audio_mono(path, target_rate, raw_format);
+    if (sample_rate && audio.sample_rate > 0) {
+        *sample_rate = audio.sample_rate;
+    }
+    return std::move(audio.samples);
+}
+
+} // namespace srv
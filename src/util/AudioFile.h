@@ -0,0 +1,175 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// 内存映射音频文件读取：WAV (RIFF/RF64, PCM s16/s24/s32, float32) 和带格式说明文件的原始PCM，按帧零拷贝访问
+namespace srv {
+
+class AudioFile {
+public:
+    // 样本格式（均为小端）
+    enum class SampleFormat {
+        S16,
+        S24,    // 3字节打包
+        S32,
+        F32
+    };
+
+    // 音频格式
+    struct Format {
+        int sample_rate;
+        int channels;
+        SampleFormat sample_format;
+    };
+
+    // 一段连续帧的零拷贝视图（交织存放）
+    struct View {
+        const uint8_t* data;    // 指向第一帧的第一个样本
+        size_t frames;          // 帧数（可能少于请求值）
+        uint64_t start_frame;
+    };
+
+private:
+    const uint8_t* map_;
+    size_t map_size_;
+    size_t data_offset_;        // 样本数据在文件中的偏移
+    uint64_t num_frames_;
+    Format format_;
+    size_t bytes_per_sample_;
+    size_t bytes_per_frame_;
+    bool is_wav_;
+    std::string path_;
+
+    bool parse_wav();
+    bool read_sidecar(const std::string& sidecar_path, Format& format) const;
+
+public:
+    AudioFile();
+    ~AudioFile();
+
+    AudioFile(const AudioFile&) = delete;
+    AudioFile& operator=(const AudioFile&) = delete;
+
+    /**
+     * 打开并映射音频文件
+     * 以RIFF/RF64开头的文件按WAV解析；其余按原始PCM处理，格式依次取自
+     * "<path>.fmt" 说明文件、raw_format参数，两者都没有则失败；说明文件存在但内容无效时也失败
+     * @param path 文件路径
+     * @param raw_format 原始PCM的默认格式，可为空
+     * @return 是否成功
+     */
+    bool open(const std::string& path, const Format* raw_format = nullptr);
+
+    /**
+     * 解除映射
+     */
+    void close();
+
+    /**
+     * 写出原始PCM的格式说明文件 "<pcm_path>.fmt"
+     * 内容为 sample_rate=、channels=、format=(s16/s24/s32/f32) 三行
+     * @param pcm_path PCM文件路径
+     * @param format 格式
+     * @return 是否成功
+     */
+    static bool write_sidecar(const std::string& pcm_path, const Format& format);
+
+    /**
+     * 获取样本格式的字节数
+     */
+    static size_t get_sample_size(SampleFormat format);
+
+    /**
+     * 获取样本格式名称（s16等）
+     */
+    static const char* get_format_name(SampleFormat format);
+
+    /**
+     * 获取一段帧的零拷贝视图，并提示内核预读其后同样长度的数据
+     * @param start_frame 起始帧
+     * @param frames 帧数
+     * @return 视图，越界部分被截断
+     */
+    View get_frames(uint64_t start_frame, size_t frames) const;
+
+    /**
+     * 提示内核预读一段帧 (MADV_WILLNEED)
+     */
+    void prefetch(uint64_t start_frame, size_t frames) const;
+
+    /**
+     * 提示内核已用完一段帧，可丢弃其页缓存映射 (MADV_DONTNEED)，顺序处理超大文件时保持RSS稳定
+     */
+    void release(uint64_t start_frame, size_t frames) const;
+
+    /**
+     * 读取一段帧并转换为int16（交织），高位宽格式截断低位，浮点饱和
+     * @param start_frame 起始帧
+     * @param frames 帧数
+     * @param out 输出，至少frames*channels个样本
+     * @return 实际读取的帧数
+     */
+    size_t read_s16(uint64_t start_frame, size_t frames, int16_t* out) const;
+
+    /**
+     * 读取一段帧并转换为float（交织），整数格式归一化到[-1, 1)
+     * @param start_frame 起始帧
+     * @param frames 帧数
+     * @param out 输出，至少frames*channels个样本
+     * @return 实际读取的帧数
+     */
+    size_t read_float(uint64_t start_frame, size_t frames, float* out) const;
+
+    bool is_open() const { return map_ != nullptr; }
+    bool is_wav() const { return is_wav_; }
+    const Format& get_format() const { return format_; }
+    int get_sample_rate() const { return format_.sample_rate; }
+    int get_channels() const { return format_.channels; }
+    SampleFormat get_sample_format() const { return format_.sample_format; }
+    size_t get_bytes_per_frame() const { return bytes_per_frame_; }
+    uint64_t get_num_frames() const { return num_frames_; }
+    double get_duration_seconds() const {
+        return format_.sample_rate > 0 ? static_cast<double>(num_frames_) / format_.sample_rate : 0.0;
+    }
+    const std::string& get_path() const { return path_; }
+};
+
+// 单声道读取结果：样本和源文件格式一起返回，调用方不必为了打印格式再打开一次文件
+struct MonoAudio {
+    std::vector<int16_t> samples;       // 单声道样本（已重采样）
+    int sample_rate;                    // samples的采样率，读取失败时为0
+    AudioFile::Format source_format;    // 源文件格式
+    bool is_wav;
+};
+
+/**
+ * 读取音频为单声道int16（多声道取平均），采样率不同时重采样到target_rate，文件只映射、解析一次
+ * @param path 文件路径（WAV或带格式说明/默认格式的原始PCM）
+ * @param target_rate 目标采样率，0表示保持原采样率
+ * @param raw_format 原始PCM的默认格式，可为空
+ * @return 读取结果，失败时sample_rate为0、samples为空
+ */
+MonoAudio load_audio_mono(const std::string& path, int target_rate = 0, const AudioFile::Format* raw_format = nullptr);
+
+/**
+ * 打印读取结果（示例程序用）：源格式、是否重采样、样本数和时长；读取失败时打印错误
+ * @return 是否读取成功
+ */
+bool print_audio_info(const std::string& path, const MonoAudio& audio);
+
+/**
+ * 读取音频为单声道int16（多声道取平均），采样率不同时重采样到target_rate
+ * 供示例程序直接读取res目录下的WAV，不再需要先用ffmpeg转换
+ * @param path 文件路径（WAV或带格式说明/默认格式的原始PCM）
+ * @param target_rate 目标采样率，0表示保持原采样率
+ * @param raw_format 原始PCM的默认格式，可为空
+ * @param sample_rate 输出实际采样率，可为空
+ * @return 样本，失败返回空
+ */
+std::vector<int16_t> load_audio_mono_s16(const std::string& path, int target_rate = 0,
+                                         const AudioFile::Format* raw_format = nullptr,
+                                         int* sample_rate = nullptr);
+
+} // namespace srv
@@ -0,0 +1,419 @@
+#include "BiquadEqualizer.h"
+#include "Equalizer.h"
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <iostream>
+
+namespace srv {
+
+namespace {
+
+// 高斯消元（列主元）解n阶线性方程组 a*x = b，a按行存放，奇异时返回false
+bool solve_linear(std::vector<double> a, std::vector<double> b, std::vector<double>& x) {
+    const size_t n = b.size();
+    for (size_t col = 0; col < n; ++col) {
+        size_t pivot = col;
+        for (size_t row = col + 1; row < n; ++row) {
+            if (std::abs(a[row * n + col]) > std::abs(a[pivot * n + col])) {
+                pivot = row;
+            }
+        }
+        if (std::abs(a[pivot * n + col]) < 1e-12) {
+            return false;
+        }
+        if (pivot != col) {
+            for (size_t k = 0; k < n; ++k) {
+                std::swap(a[col * n + k], a[pivot * n + k]);
+            }
+            std::swap(b[col], b[pivot]);
+        }
+        for (size_t row = col + 1; row < n; ++row) {
+            const double factor = a[row * n + col] / a[col * n + col];
+            for (size_t k = col; k < n; ++k) {
+                a[row * n + k] -= factor * a[col * n + k];
+            }
+            b[row] -= factor * b[col];
+        }
+    }
+    x.assign(n, 0.0);
+    for (size_t row = n; row-- > 0;) {
+        double sum = b[row];
+        for (size_t k = row + 1; k < n; ++k) {
+            sum -= a[row * n + k] * x[k];
+        }
+        x[row] = sum / a[row * n + row];
+    }
+    return true;
+}
+
+} // namespace
+
+BiquadEqualizer::BiquadEqualizer()
+    : channels_(0)
+    , lane_channels_(1)
+    , channel_groups_(0)
+    , depth_(4)
+    , sample_rate_(48000.0)
+    , preamp_(1.0f)
+    , applied_preamp_(1.0f)
+    , highpass_freq_(0.0f)
+    , lowpass_freq_(0.0f)
+    , section_groups_(0)
+    , is_initialized_(false) {
+}
+
+bool BiquadEqualizer::init(int channels, double sample_rate) {
+    is_initialized_ = false;
+    if (channels < 1 || channels > 8 || sample_rate <= 0.0) {
+        std::cerr << "BiquadEqualizer init failed: invalid parameters" << std::endl;
+        return false;
+    }
+    channels_ = channels;
+    sample_rate_ = sample_rate;
+
+    // 1/2声道用流水线把剩下的SIMD通道分给后面的二阶节，3声道以上每组4个声道各占一条通道
+    lane_channels_ = channels == 1 ? 1 : channels == 2 ? 2 : 4;
+    channel_groups_ = (channels + lane_channels_ - 1) / lane_channels_;
+    depth_ = 4 / lane_channels_;
+
+    band_sections_.clear();
+    highpass_freq_ = 0.0f;
+    lowpass_freq_ = 0.0f;
+    scratch_.assign(kChunkFrames * lane_channels_, 0.0f);
+    convert_buffer_.assign(kChunkFrames * channels_, 0.0f);
+    lanes_.clear();
+    build_lanes();
+    is_initialized_ = true;
+    return true;
+}
+
+void BiquadEqualizer::compute_coefficients(const Section& section, double sample_rate, double* coeffs) {
+    // RBJ Audio EQ Cookbook，输出b0 b1 b2 a1 a2（已除以a0）
+    const double w0 = 2.0 * M_PI * section.freq / sample_rate;
+    const double cos_w = std::cos(w0);
+    const double alpha = std::sin(w0) / (2.0 * section.q);
+    const double A = std::pow(10.0, section.gain_db / 40.0);
+    const double sqrt_a2 = 2.0 * std::sqrt(A) * alpha;
+    double b0 = 1.0, b1 = 0.0, b2 = 0.0, a0 = 1.0, a1 = 0.0, a2 = 0.0;
+
+    switch (section.type) {
+        case SectionType::PEAKING:
+            b0 = 1.0 + alpha * A;
+            b1 = -2.0 * cos_w;
+            b2 = 1.0 - alpha * A;
+            a0 = 1.0 + alpha / A;
+            a1 = -2.0 * cos_w;
+            a2 = 1.0 - alpha / A;
+            break;
+        case SectionType::LOW_SHELF:
+            b0 = A * ((A + 1.0) - (A - 1.0) * cos_w + sqrt_a2);
+            b1 = 2.0 * A * ((A - 1.0) - (A + 1.0) * cos_w);
+            b2 = A * ((A + 1.0) - (A - 1.0) * cos_w - sqrt_a2);
+            a0 = (A + 1.0) + (A - 1.0) * cos_w + sqrt_a2;
+            a1 = -2.0 * ((A - 1.0) + (A + 1.0) * cos_w);
+            a2 = (A + 1.0) + (A - 1.0) * cos_w - sqrt_a2;
+            break;
+        case SectionType::HIGH_SHELF:
+            b0 = A * ((A + 1.0) + (A - 1.0) * cos_w + sqrt_a2);
+            b1 = -2.0 * A * ((A - 1.0) + (A + 1.0) * cos_w);
+            b2 = A * ((A + 1.0) + (A - 1.0) * cos_w - sqrt_a2);
+            a0 = (A + 1.0) - (A - 1.0) * cos_w + sqrt_a2;
+            a1 = 2.0 * ((A - 1.0) - (A + 1.0) * cos_w);
+            a2 = (A + 1.0) - (A - 1.0) * cos_w - sqrt_a2;
+            break;
+        case SectionType::HIGH_PASS:
+            b0 = (1.0 + cos_w) / 2.0;
+            b1 = -(1.0 + cos_w);
+            b2 = b0;
+            a0 = 1.0 + alpha;
+            a1 = -2.0 * cos_w;
+            a2 = 1.0 - alpha;
+            break;
+        case SectionType::LOW_PASS:
+            b0 = (1.0 - cos_w) / 2.0;
+            b1 = 1.0 - cos_w;
+            b2 = b0;
+            a0 = 1.0 + alpha;
+            a1 = -2.0 * cos_w;
+            a2 = 1.0 - alpha;
+            break;
+    }
+    coeffs[0] = b0 / a0;
+    coeffs[1] = b1 / a0;
+    coeffs[2] = b2 / a0;
+    coeffs[3] = a1 / a0;
+    coeffs[4] = a2 / a0;
+}
+
+double BiquadEqualizer::section_response_db(const Section& section, double sample_rate, double freq) {
+    double c[5];
+    compute_coefficients(section, sample_rate, c);
+    const std::complex<double> z1 = std::polar(1.0, -2.0 * M_PI * freq / sample_rate);
+    const std::complex<double> z2 = z1 * z1;
+    const std::complex<double> h = (c[0] + c[1] * z1 + c[2] * z2) / (1.0 + c[3] * z1 + c[4] * z2);
+    return 20.0 * std::log10(std::max(std::abs(h), 1e-12));
+}
+
+void BiquadEqualizer::setEQdB(const std::vector<float>& db_values) {
+    if (!is_initialized_ || db_values.size() < 2) {
+        return;
+    }
+    // 只保留能实现的频段（低于0.45倍采样率）
+    const auto all_freqs = Equalizer::calculateFreqs(db_values.size());
+    std::vector<double> freqs;
+    std::vector<double> targets;
+    for (size_t i = 0; i < all_freqs.size(); ++i) {
+        if (all_freqs[i] < 0.45 * sample_rate_) {
+            freqs.push_back(all_freqs[i]);
+            targets.push_back(db_values[i]);
+        }
+    }
+    const size_t n = freqs.size();
+    if (n == 0) {
+        return;
+    }
+
+    // 首尾频段用搁架（频段范围外保持边界增益，与Equalizer::interpolateGain一致），中间用峰值
+    // 峰值滤波器带宽取相邻频段间距；搁架转折频率向内移半个频段，端点频段上已接近满增益，
+    // 否则转折点处只有一半增益，大幅度的端点设定会超出增益范围
+    const double ratio = all_freqs.size() > 1 ? all_freqs[1] / all_freqs[0] : 2.0;
+    const double peak_q = std::sqrt(ratio) / (ratio - 1.0);
+    band_sections_.assign(n, Section{SectionType::PEAKING, 0.0, peak_q, 0.0});
+    for (size_t i = 0; i < n; ++i) {
+        band_sections_[i].freq = freqs[i];
+        if (n > 1 && i == 0) {
+            band_sections_[i].type = SectionType::LOW_SHELF;
+            band_sections_[i].freq = freqs[i] * std::sqrt(ratio);
+            band_sections_[i].q = M_SQRT1_2;
+        } else if (n > 1 && i == n - 1) {
+            band_sections_[i].type = SectionType::HIGH_SHELF;
+            band_sections_[i].freq = freqs[i] / std::sqrt(ratio);
+            band_sections_[i].q = M_SQRT1_2;
+        }
+    }
+
+    // 交互矩阵：第j节取参考增益时在第i个频段中心的响应（按dB线性化），解出使各中心等于目标的增益
+    // dB响应对增益不完全线性，再用实际响应的残差迭代修正，残差小于0.01dB时停止
+    const double reference_db = 6.0;
+    std::vector<double> matrix(n * n);
+    for (size_t j = 0; j < n; ++j) {
+        Section probe = band_sections_[j];
+        probe.gain_db = reference_db;
+        for (size_t i = 0; i < n; ++i) {
+            matrix[i * n + j] = section_response_db(probe, sample_rate_, freqs[i]) / reference_db;
+        }
+    }
+    std::vector<double> gains(n, 0.0);
+    std::vector<double> residual = targets;
+    for (int iteration = 0; iteration < 8; ++iteration) {
+        std::vector<double> delta;
+        if (!solve_linear(matrix, residual, delta)) {
+            // 矩阵奇异（频段过密）时退回直接使用设定值
+            for (size_t i = 0; i < n; ++i) {
+                gains[i] = targets[i];
+            }
+            break;
+        }
+        for (size_t j = 0; j < n; ++j) {
+            gains[j] = std::max(-kMaxSectionGain, std::min(kMaxSectionGain, gains[j] + delta[j]));
+            band_sections_[j].gain_db = gains[j];
+        }
+        for (size_t i = 0; i < n; ++i) {
+            double response = 0.0;
+            for (const auto& section : band_sections_) {
+                response += section_response_db(section, sample_rate_, freqs[i]);
+            }
+            residual[i] = targets[i] - response;
+        }
+        double worst = 0.0;
+        for (double r : residual) {
+            worst = std::max(worst, std::abs(r));
+        }
+        if (worst < 0.01) {
+            break;
+        }
+    }
+    for (size_t j = 0; j < n; ++j) {
+        band_sections_[j].gain_db = gains[j];
+    }
+    build_lanes();
+}
+
+void BiquadEqualizer::setPreamp(float preamp) {
+    preamp_ = preamp;
+}
+
+void BiquadEqualizer::setHighPass(float freq) {
+    if (!is_initialized_) {
+        return;
+    }
+    highpass_freq_ = freq > 0.0f && freq < 0.45 * sample_rate_ ? freq : 0.0f;
+    build_lanes();
+}
+
+void BiquadEqualizer::setLowPass(float freq) {
+    if (!is_initialized_) {
+        return;
+    }
+    lowpass_freq_ = freq > 0.0f && freq < 0.45 * sample_rate_ ? freq : 0.0f;
+    build_lanes();
+}
+
+void BiquadEqualizer::build_lanes() {
+    sections_.clear();
+    if (highpass_freq_ > 0.0f) {
+        sections_.push_back(Section{SectionType::HIGH_PASS, highpass_freq_, M_SQRT1_2, 0.0});
+    }
+    sections_.insert(sections_.end(), band_sections_.begin(), band_sections_.end());
+    if (lowpass_freq_ > 0.0f) {
+        sections_.push_back(Section{SectionType::LOW_PASS, lowpass_freq_, M_SQRT1_2, 0.0});
+    }
+
+    // 不足一组的流水级补直通节（b0=1），预放大并入第一节的分子
+    const size_t section_count = std::max<size_t>(sections_.size(), 1);
+    const size_t groups = (section_count + depth_ - 1) / depth_;
+    std::vector<kernels::BiquadLanes> lanes(groups * channel_groups_);
+    for (size_t g = 0; g < groups; ++g) {
+        for (int l = 0; l < 4; ++l) {
+            const size_t index = g * depth_ + l / lane_channels_;
+            double c[5] = {1.0, 0.0, 0.0, 0.0, 0.0};
+            if (index < sections_.size()) {
+                compute_coefficients(sections_[index], sample_rate_, c);
+            }
+            if (index == 0) {
+                for (int k = 0; k < 3; ++k) {
+                    c[k] *= preamp_;
+                }
+            }
+            for (int cg = 0; cg < channel_groups_; ++cg) {
+                kernels::BiquadLanes& lane = lanes[cg * groups + g];
+                lane.b0[l] = static_cast<float>(c[0]);
+                lane.b1[l] = static_cast<float>(c[1]);
+                lane.b2[l] = static_cast<float>(c[2]);
+                lane.a1[l] = static_cast<float>(c[3]);
+                lane.a2[l] = static_cast<float>(c[4]);
+                lane.s1[l] = 0.0f;
+                lane.s2[l] = 0.0f;
+            }
+        }
+    }
+
+    // 节数不变时保留滤波器状态，运行中改EQ不会产生咔嗒声
+    if (lanes.size() == lanes_.size()) {
+        for (size_t i = 0; i < lanes.size(); ++i) {
+            std::copy(lanes_[i].s1, lanes_[i].s1 + 4, lanes[i].s1);
+            std::copy(lanes_[i].s2, lanes_[i].s2 + 4, lanes[i].s2);
+        }
+    }
+    lanes_.swap(lanes);
+    section_groups_ = groups;
+    applied_preamp_ = preamp_;
+}
+
+void BiquadEqualizer::flush_denormals() {
+    // 输入静音后状态指数衰减，进入非规格化数会大幅变慢；每块结束时把极小的状态清零
+    for (auto& lane : lanes_) {
+        for (int l = 0; l < 4; ++l) {
+            if (std::abs(lane.s1[l]) < 1e-15f) lane.s1[l] = 0.0f;
+            if (std::abs(lane.s2[l]) < 1e-15f) lane.s2[l] = 0.0f;
+        }
+    }
+}
+
+void BiquadEqualizer::process(const float* input, float* output, size_t frames) {
+    if (!is_initialized_) {
+        std::fill(output, output + frames * channels_, 0.0f);
+        return;
+    }
+    while (frames > 0) {
+        const size_t n = std::min(frames, kChunkFrames);
+        if (channels_ == lane_channels_) {
+            // 1/2/4声道：交织布局正好是内核要的布局，直接在输出上原位处理
+            if (output != input) {
+                std::copy(input, input + n * channels_, output);
+            }
+            kernels::biquad_cascade(lanes_.data(), section_groups_, output, n, lane_channels_);
+        } else {
+            for (int cg = 0; cg < channel_groups_; ++cg) {
+                const int first = cg * lane_channels_;
+                const int count = std::min(lane_channels_, channels_ - first);
+                for (size_t t = 0; t < n; ++t) {
+                    for (int c = 0; c < lane_channels_; ++c) {
+                        scratch_[t * lane_channels_ + c] = c < count ? input[t * channels_ + first + c] : 0.0f;
+                    }
+                }
+                kernels::biquad_cascade(&lanes_[cg * section_groups_], section_groups_, scratch_.data(), n,
+                                        lane_channels_);
+                for (size_t t = 0; t < n; ++t) {
+                    for (int c = 0; c < count; ++c) {
+                        output[t * channels_ + first + c] = scratch_[t * lane_channels_ + c];
+                    }
+                }
+            }
+        }
+        flush_denormals();
+        input += n * channels_;
+        output += n * channels_;
+        frames -= n;
+    }
+}
+
+void BiquadEqualizer::process(const short* input, size_t frames, std::vector<short>& output) {
+    if (!is_initialized_) {
+        return;
+    }
+    while (frames > 0) {
+        const size_t n = std::min(frames, kChunkFrames);
+        const size_t samples = n * channels_;
+        kernels::s16_to_f32(input, convert_buffer_.data(), samples, 1.0f / 32768.0f);
+        process(convert_buffer_.data(), convert_buffer_.data(), n);
+        const size_t written = output.size();
+        output.resize(written + samples);
+        kernels::f32_to_s16(convert_buffer_.data(), output.data() + written, samples, 32768.0f);
+        input += samples;
+        frames -= n;
+    }
+}
+
+size_t BiquadEqualizer::flush(float* output) {
+    (void)output;
+    reset();
+    return 0;
+}
+
+void BiquadEqualizer::flush(std::vector<short>& output) {
+    (void)output;
+    reset();
+}
+
+void BiquadEqualizer::reset() {
+    for (auto& lane : lanes_) {
+        std::fill(lane.s1, lane.s1 + 4, 0.0f);
+        std::fill(lane.s2, lane.s2 + 4, 0.0f);
+    }
+}
+
+std::vector<short> BiquadEqualizer::processAudio(const std::vector<short>& input) {
+    std::vector<short> output;
+    if (!is_initialized_) {
+        return output;
+    }
+    output.reserve(input.size());
+    reset();
+    const size_t frames = input.size() / channels_;
+    process(input.data(), frames, output);
+    // 末尾不足一帧的样本原样输出，保证输出与输入等长
+    output.insert(output.end(), input.begin() + frames * channels_, input.end());
+    return output;
+}
+
+double BiquadEqualizer::get_response_db(double freq) const {
+    double response = 20.0 * std::log10(std::max(static_cast<double>(std::abs(applied_preamp_)), 1e-12));
+    for (const auto& section : sections_) {
+        response += section_response_db(section, sample_rate_, freq);
+    }
+    return response;
+}
+
+} // namespace srv
@@ -0,0 +1,144 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+#include "DSPKernels.h"
+
+// 二阶节级联参数均衡器：零延迟，频段布局与Equalizer相同（首尾频段为搁架，中间为峰值），可选高通/低通
+// 多声道时各声道占用不同的SIMD通道，串联的二阶节按流水线错开一个样本并行（见kernels::biquad_cascade）
+namespace srv {
+
+class BiquadEqualizer {
+public:
+    enum class SectionType {
+        PEAKING,
+        LOW_SHELF,
+        HIGH_SHELF,
+        HIGH_PASS,
+        LOW_PASS
+    };
+
+    // 一个二阶节的参数（RBJ Audio EQ Cookbook）
+    struct Section {
+        SectionType type;
+        double freq;
+        double q;
+        double gain_db;     // 峰值/搁架增益，高通/低通不用
+    };
+
+private:
+    static const size_t kChunkFrames = 256;
+    // 单节增益上限（dB）：相邻频段设定相差很大时，搁架要靠更大的增益加上相邻峰值的反向增益才能实现
+    static constexpr double kMaxSectionGain = 42.0;
+
+    int channels_;
+    int lane_channels_;     // 每组SIMD通道容纳的声道数（1、2或4）
+    int channel_groups_;    // 声道分组数
+    int depth_;             // 每组内串联的流水级数（4/lane_channels_）
+    double sample_rate_;
+    float preamp_;
+    float applied_preamp_;  // 已并入系数的预放大
+    float highpass_freq_;
+    float lowpass_freq_;
+
+    // 频段对应的二阶节（setEQdB求解），以及加上高通/低通后的全部二阶节
+    std::vector<Section> band_sections_;
+    std::vector<Section> sections_;
+
+    // channel_groups_ * section_groups_组SIMD二阶节（系数+状态）
+    std::vector<kernels::BiquadLanes> lanes_;
+    size_t section_groups_;
+
+    // 声道数不是1/2/4时按组拆出的样本，short接口的格式转换缓冲区
+    std::vector<float> scratch_;
+    std::vector<float> convert_buffer_;
+
+    bool is_initialized_;
+
+    void build_lanes();
+    void flush_denormals();
+
+public:
+    BiquadEqualizer();
+
+    /**
+     * 初始化（EQ为平坦）
+     * @param channels 声道数（1-8），交织输入
+     * @param sample_rate 采样率
+     * @return 是否初始化成功
+     */
+    bool init(int channels = 1, double sample_rate = 48000.0);
+
+    /**
+     * 设置EQ频段dB值（频段布局与Equalizer::calculateFreqs相同）
+     * 各节增益按频段中心处的级联响应求解（相邻峰值滤波器的裙边会叠加），使各频段中心的增益等于设定值
+     * 高于0.45倍采样率的频段无法实现，忽略
+     */
+    void setEQdB(const std::vector<float>& db_values);
+
+    // 设置预放大，下一次setEQdB/setHighPass/setLowPass时生效
+    void setPreamp(float preamp);
+
+    /**
+     * 高通/低通（二阶Butterworth），freq为0时关闭
+     */
+    void setHighPass(float freq);
+    void setLowPass(float freq);
+
+    /**
+     * 流式处理（实时接口）：无延迟，稳态不分配内存，input和output可以是同一块内存
+     * @param input 交织输入（-1.0到1.0）
+     * @param output 交织输出
+     * @param frames 帧数
+     */
+    void process(const float* input, float* output, size_t frames);
+
+    /**
+     * 流式处理（short接口），输出追加到output末尾，与输入等长
+     */
+    void process(const short* input, size_t frames, std::vector<short>& output);
+
+    /**
+     * 与其他EQ引擎接口一致：没有延迟，不输出样本，只清空状态
+     */
+    size_t flush(float* output);
+    void flush(std::vector<short>& output);
+
+    /**
+     * 清空滤波器状态（保留EQ设置）
+     */
+    void reset();
+
+    /**
+     * 延迟（样本数），恒为0
+     */
+    size_t get_latency() const { return 0; }
+
+    /**
+     * 处理整段音频（交织），输出与输入等长，处理前清空状态
+     * 样本数不是声道数的整数倍时，末尾不足一帧的样本不经过滤波原样输出
+     */
+    std::vector<short> processAudio(const std::vector<short>& input);
+
+    /**
+     * 当前级联在freq处的幅度响应（dB，含预放大）
+     */
+    double get_response_db(double freq) const;
+
+    /**
+     * 二阶节系数（RBJ Audio EQ Cookbook）
+     * @param coeffs 输出b0 b1 b2 a1 a2（已除以a0）
+     */
+    static void compute_coefficients(const Section& section, double sample_rate, double* coeffs);
+
+    /**
+     * 单个二阶节在freq处的幅度响应（dB）
+     */
+    static double section_response_db(const Section& section, double sample_rate, double freq);
+
+    const std::vector<Section>& get_sections() const { return sections_; }
+    bool is_initialized() const { return is_initialized_; }
+    int get_channels() const { return channels_; }
+    double get_sample_rate() const { return sample_rate_; }
+};
+
+} // namespace srv
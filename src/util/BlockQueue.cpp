@@ -0,0 +1,141 @@
+#include "BlockQueue.h"
+#include <chrono>
+#include <iostream>
+
+namespace srv {
+
+namespace {
+
+double seconds_since(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+BlockQueue::BlockQueue()
+    : full_head_(0),
+      closed_(false),
+      aborted_(false),
+      producer_wait_seconds_(0.0),
+      consumer_wait_seconds_(0.0),
+      is_initialized_(false) {}
+
+bool BlockQueue::init(int num_buffers, size_t capacity) {
+    if (num_buffers < 1 || capacity == 0) {
+        std::cerr << "BlockQueue init failed: invalid parameters" << std::endl;
+        return false;
+    }
+    buffers_.assign(static_cast<size_t>(num_buffers), Buffer());
+    for (auto& buffer : buffers_) {
+        buffer.reserve(capacity);
+    }
+    free_.reserve(buffers_.size());
+    full_.reserve(buffers_.size());
+    is_initialized_ = true;
+    reset();
+    return true;
+}
+
+BlockQueue::Buffer* BlockQueue::acquire_free() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (free_.empty() && !aborted_) {
+        auto start = std::chrono::steady_clock::now();
+        cond_.wait(lock, [this] { return !free_.empty() || aborted_; });
+        producer_wait_seconds_ += seconds_since(start);
+    }
+    if (aborted_) {
+        return nullptr;
+    }
+    Buffer* buffer = free_.back();
+    free_.pop_back();
+    buffer->clear();
+    return buffer;
+}
+
+void BlockQueue::submit(Buffer* buffer) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        // full_容量等于缓冲区总数，头部已取走的部分先压缩掉，保证push_back不重新分配
+        if (full_head_ > 0 && full_.size() == full_.capacity()) {
+            full_.erase(full_.begin(), full_.begin() + static_cast<std::ptrdiff_t>(full_head_));
+            full_head_ = 0;
+        }
+        full_.push_back(buffer);
+    }
+    cond_.notify_all();
+}
+
+BlockQueue::Buffer* BlockQueue::acquire_full() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto ready = [this] { return full_head_ < full_.size() || closed_ || aborted_; };
+    if (!ready()) {
+        auto start = std::chrono::steady_clock::now();
+        cond_.wait(lock, ready);
+        consumer_wait_seconds_ += seconds_since(start);
+    }
+    if (aborted_ || full_head_ >= full_.size()) {
+        return nullptr;
+    }
+    Buffer* buffer = full_[full_head_++];
+    if (full_head_ == full_.size()) {
+        full_.clear();
+        full_head_ = 0;
+    }
+    return buffer;
+}
+
+void BlockQueue::recycle(Buffer* buffer) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        free_.push_back(buffer);
+    }
+    cond_.notify_all();
+}
+
+void BlockQueue::close() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        closed_ = true;
+    }
+    cond_.notify_all();
+}
+
+void BlockQueue::abort() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        aborted_ = true;
+    }
+    cond_.notify_all();
+}
+
+void BlockQueue::reset() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    free_.clear();
+    full_.clear();
+    full_head_ = 0;
+    for (auto& buffer : buffers_) {
+        buffer.clear();
+        free_.push_back(&buffer);
+    }
+    closed_ = false;
+    aborted_ = false;
+    producer_wait_seconds_ = 0.0;
+    consumer_wait_seconds_ = 0.0;
+}
+
+bool BlockQueue::is_aborted() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return aborted_;
+}
+
+double BlockQueue::get_producer_wait_seconds() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return producer_wait_seconds_;
+}
+
+double BlockQueue::get_consumer_wait_seconds() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return consumer_wait_seconds_;
+}
+
+} // namespace srv
@@ -0,0 +1,94 @@
+#pragma once
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+// 线程间的有界缓冲区交换：固定数量的缓冲区在生产者和消费者之间轮转，运行期间不再分配内存
+namespace srv {
+
+class BlockQueue {
+public:
+    using Buffer = std::vector<int16_t>;
+
+private:
+    std::vector<Buffer> buffers_;
+    std::vector<Buffer*> free_;     // 空闲缓冲区（栈）
+    std::vector<Buffer*> full_;     // 已填充待消费的缓冲区（按提交顺序）
+    size_t full_head_;
+    std::mutex mutex_;
+    std::condition_variable cond_;
+    bool closed_;                   // 生产者已结束，取完full_后消费者收到nullptr
+    bool aborted_;                  // 任一方出错，双方立即收到nullptr
+    double producer_wait_seconds_;
+    double consumer_wait_seconds_;
+    bool is_initialized_;
+
+public:
+    BlockQueue();
+    ~BlockQueue() = default;
+
+    BlockQueue(const BlockQueue&) = delete;
+    BlockQueue& operator=(const BlockQueue&) = delete;
+
+    /**
+     * 初始化
+     * @param num_buffers 缓冲区数量（2为双缓冲）
+     * @param capacity 每个缓冲区预留的样本数
+     * @return 是否初始化成功
+     */
+    bool init(int num_buffers, size_t capacity);
+
+    /**
+     * 生产者取一个空闲缓冲区（内容已清空），没有空闲时阻塞
+     * @return 缓冲区，已中止时返回nullptr
+     */
+    Buffer* acquire_free();
+
+    /**
+     * 生产者提交填充好的缓冲区
+     */
+    void submit(Buffer* buffer);
+
+    /**
+     * 消费者按提交顺序取一个已填充的缓冲区，没有时阻塞
+     * @return 缓冲区，生产者已结束且全部取完或已中止时返回nullptr
+     */
+    Buffer* acquire_full();
+
+    /**
+     * 消费者归还用完的缓冲区
+     */
+    void recycle(Buffer* buffer);
+
+    /**
+     * 生产者结束（已提交的缓冲区仍会被消费）
+     */
+    void close();
+
+    /**
+     * 中止交换，唤醒所有等待方
+     */
+    void abort();
+
+    /**
+     * 恢复到初始状态（所有缓冲区空闲），调用时不能有线程在使用
+     */
+    void reset();
+
+    bool is_initialized() const { return is_initialized_; }
+    bool is_aborted();
+
+    /**
+     * 生产者等待空闲缓冲区的累计时间（秒），反映消费者跟不上
+     */
+    double get_producer_wait_seconds();
+
+    /**
+     * 消费者等待数据的累计时间（秒），反映生产者跟不上
+     */
+    double get_consumer_wait_seconds();
+};
+
+} // namespace srv
@@ -0,0 +1,413 @@
+#include "ColumnarFile.h"
+#include <algorithm>
+#include <iostream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace srv {
+
+namespace {
+
+const char kMagic[8] = {'S', 'R', 'V', 'C', 'O', 'L', 'S', '1'};
+const uint32_t kVersion = 1;
+const size_t kFixedHeaderSize = 64;
+const size_t kColumnDescSize = 32;
+const size_t kMaxNameLength = 23;
+// 写入方未正常关闭时头部保留的总帧数
+const uint64_t kIncompleteFrames = ~0ull;
+
+// 头部: magic(8) version(4) num_columns(4) block_frames(4) header_size(4)
+//       num_frames(8) frame_rate(8, IEEE754) reserved(24)
+// 列描述: name(24, 以0填充) type(1) width(1) reserved(6)
+
+void put_u32(uint8_t* p, uint32_t value) {
+    for (int i = 0; i < 4; ++i) {
+        p[i] = static_cast<uint8_t>(value >> (8 * i));
+    }
+}
+
+void put_u64(uint8_t* p, uint64_t value) {
+    for (int i = 0; i < 8; ++i) {
+        p[i] = static_cast<uint8_t>(value >> (8 * i));
+    }
+}
+
+uint32_t get_u32(const uint8_t* p) {
+    uint32_t value = 0;
+    for (int i = 0; i < 4; ++i) {
+        value |= static_cast<uint32_t>(p[i]) << (8 * i);
+    }
+    return value;
+}
+
+uint64_t get_u64(const uint8_t* p) {
+    uint64_t value = 0;
+    for (int i = 0; i < 8; ++i) {
+        value |= static_cast<uint64_t>(p[i]) << (8 * i);
+    }
+    return value;
+}
+
+// 列数据直接按内存布局写出，只支持小端主机
+bool is_little_endian() {
+    const uint16_t probe = 1;
+    uint8_t first;
+    std::memcpy(&first, &probe, 1);
+    return first == 1;
+}
+
+size_t header_size_for(size_t num_columns) {
+    size_t size = kFixedHeaderSize + num_columns * kColumnDescSize;
+    return (size + 63) / 64 * 64;
+}
+
+template <typename T>
+T load(const uint8_t* p) {
+    T value;
+    std::memcpy(&value, p, sizeof(T));
+    return value;
+}
+
+double load_as_double(ColumnType type, const uint8_t* p) {
+    switch (type) {
+    case ColumnType::FLOAT32:
+        return load<float>(p);
+    case ColumnType::FLOAT64:
+        return load<double>(p);
+    case ColumnType::INT16:
+        return load<int16_t>(p);
+    case ColumnType::INT32:
+        return load<int32_t>(p);
+    case ColumnType::UINT8:
+        return *p;
+    }
+    return 0.0;
+}
+
+} // namespace
+
+size_t column_type_width(ColumnType type) {
+    switch (type) {
+    case ColumnType::FLOAT32:
+        return 4;
+    case ColumnType::FLOAT64:
+        return 8;
+    case ColumnType::INT16:
+        return 2;
+    case ColumnType::INT32:
+        return 4;
+    case ColumnType::UINT8:
+        return 1;
+    }
+    return 0;
+}
+
+const char* column_type_name(ColumnType type) {
+    switch (type) {
+    case ColumnType::FLOAT32:
+        return "float32";
+    case ColumnType::FLOAT64:
+        return "float64";
+    case ColumnType::INT16:
+        return "int16";
+    case ColumnType::INT32:
+        return "int32";
+    case ColumnType::UINT8:
+        return "uint8";
+    }
+    return "unknown";
+}
+
+ColumnarWriter::ColumnarWriter()
+    : block_frames_(0)
+    , row_(0)
+    , frames_written_(0)
+    , frame_rate_(0.0)
+    , is_open_(false) {
+}
+
+ColumnarWriter::~ColumnarWriter() {
+    if (is_open_) {
+        close();
+    }
+}
+
+bool ColumnarWriter::open(const std::string& path, const std::vector<ColumnSpec>& columns, double frame_rate,
+                          uint32_t block_frames) {
+    if (is_open_) {
+        close();
+    }
+
+    // 参数验证
+    if (columns.empty() || block_frames == 0 || block_frames % 8 != 0 || !(frame_rate > 0.0)) {
+        std::cerr << "ColumnarWriter open failed: invalid parameters" << std::endl;
+        return false;
+    }
+    for (const auto& column : columns) {
+        if (column.name.empty() || column.name.size() > kMaxNameLength || column_type_width(column.type) == 0) {
+            std::cerr << "ColumnarWriter open failed: invalid column " << column.name << std::endl;
+            return false;
+        }
+    }
+    if (!is_little_endian()) {
+        std::cerr << "ColumnarWriter open failed: big-endian host not supported" << std::endl;
+        return false;
+    }
+
+    file_.open(path, std::ios::binary | std::ios::trunc);
+    if (!file_.is_open()) {
+        std::cerr << "ColumnarWriter open failed: cannot create " << path << std::endl;
+        return false;
+    }
+
+    path_ = path;
+    columns_ = columns;
+    block_frames_ = block_frames;
+    frame_rate_ = frame_rate;
+    widths_.clear();
+    column_offsets_.clear();
+    size_t offset = 0;
+    for (const auto& column : columns_) {
+        widths_.push_back(column_type_width(column.type));
+        column_offsets_.push_back(offset);
+        offset += widths_.back() * block_frames_;
+    }
+    block_.assign(offset, 0);
+    row_ = 0;
+    frames_written_ = 0;
+
+    if (!write_header(kIncompleteFrames)) {
+        file_.close();
+        return false;
+    }
+    is_open_ = true;
+    return true;
+}
+
+bool ColumnarWriter::write_header(uint64_t num_frames) {
+    const size_t header_size = header_size_for(columns_.size());
+    std::vector<uint8_t> header(header_size, 0);
+    std::memcpy(header.data(), kMagic, sizeof(kMagic));
+    put_u32(&header[8], kVersion);
+    put_u32(&header[12], static_cast<uint32_t>(columns_.size()));
+    put_u32(&header[16], block_frames_);
+    put_u32(&header[20], static_cast<uint32_t>(header_size));
+    put_u64(&header[24], num_frames);
+    uint64_t rate_bits;
+    std::memcpy(&rate_bits, &frame_rate_, sizeof(rate_bits));
+    put_u64(&header[32], rate_bits);
+
+    for (size_t i = 0; i < columns_.size(); ++i) {
+        uint8_t* desc = &header[kFixedHeaderSize + i * kColumnDescSize];
+        std::memcpy(desc, columns_[i].name.data(), columns_[i].name.size());
+        desc[24] = static_cast<uint8_t>(columns_[i].type);
+        desc[25] = static_cast<uint8_t>(widths_[i]);
+    }
+
+    file_.seekp(0);
+    file_.write(reinterpret_cast<const char*>(header.data()), static_cast<std::streamsize>(header.size()));
+    file_.flush();
+    if (!file_) {
+        std::cerr << "ColumnarWriter failed: cannot write header " << path_ << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool ColumnarWriter::flush_block(size_t frames) {
+    row_ = 0;
+    if (frames == 0) {
+        return true;
+    }
+    if (frames == block_frames_) {
+        // 整块写出后立即落到文件，异常退出时读取方能恢复出已完成的块
+        file_.write(reinterpret_cast<const char*>(block_.data()), static_cast<std::streamsize>(block_.size()));
+        file_.flush();
+    } else {
+        // 最后一块只写实际帧数，各列依次紧凑存放
+        for (size_t c = 0; c < columns_.size(); ++c) {
+            file_.write(reinterpret_cast<const char*>(block_.data() + column_offsets_[c]),
+                        static_cast<std::streamsize>(frames * widths_[c]));
+        }
+    }
+    if (!file_) {
+        std::cerr << "ColumnarWriter failed: write error " << path_ << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool ColumnarWriter::close() {
+    if (!is_open_) {
+        return false;
+    }
+    is_open_ = false;
+    bool ok = flush_block(row_) && write_header(frames_written_);
+    file_.close();
+    return ok && !file_.fail();
+}
+
+ColumnarReader::ColumnarReader()
+    : data_(nullptr)
+    , file_size_(0)
+    , header_size_(0)
+    , row_bytes_(0)
+    , block_frames_(0)
+    , num_frames_(0)
+    , frame_rate_(0.0)
+    , complete_(false) {
+}
+
+ColumnarReader::~ColumnarReader() {
+    close();
+}
+
+void ColumnarReader::close() {
+    if (data_) {
+        munmap(const_cast<uint8_t*>(data_), file_size_);
+        data_ = nullptr;
+    }
+    file_size_ = 0;
+    columns_.clear();
+    widths_.clear();
+    num_frames_ = 0;
+}
+
+bool ColumnarReader::open(const std::string& path) {
+    close();
+
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "ColumnarReader open failed: cannot open " << path << std::endl;
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(kFixedHeaderSize)) {
+        std::cerr << "ColumnarReader open failed: file too small " << path << std::endl;
+        ::close(fd);
+        return false;
+    }
+    file_size_ = static_cast<size_t>(st.st_size);
+    void* mapped = mmap(nullptr, file_size_, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) {
+        std::cerr << "ColumnarReader open failed: mmap error " << path << std::endl;
+        file_size_ = 0;
+        return false;
+    }
+    data_ = static_cast<const uint8_t*>(mapped);
+    madvise(mapped, file_size_, MADV_SEQUENTIAL);
+
+    const uint32_t num_columns = get_u32(data_ + 12);
+    block_frames_ = get_u32(data_ + 16);
+    header_size_ = get_u32(data_ + 20);
+    if (std::memcmp(data_, kMagic, sizeof(kMagic)) != 0 || get_u32(data_ + 8) != kVersion ||
+        num_columns == 0 || block_frames_ == 0 || block_frames_ % 8 != 0 ||
+        header_size_ != header_size_for(num_columns) || header_size_ > file_size_ || !is_little_endian()) {
+        std::cerr << "ColumnarReader open failed: invalid header " << path << std::endl;
+        close();
+        return false;
+    }
+
+    row_bytes_ = 0;
+    for (uint32_t i = 0; i < num_columns; ++i) {
+        const uint8_t* desc = data_ + kFixedHeaderSize + i * kColumnDescSize;
+        ColumnSpec spec;
+        spec.name.assign(reinterpret_cast<const char*>(desc), strnlen(reinterpret_cast<const char*>(desc), 24));
+        spec.type = static_cast<ColumnType>(desc[24]);
+        size_t width = column_type_width(spec.type);
+        if (width == 0 || width != desc[25]) {
+            std::cerr << "ColumnarReader open failed: invalid column " << spec.name << std::endl;
+            close();
+            return false;
+        }
+        columns_.push_back(spec);
+        widths_.push_back(width);
+        row_bytes_ += width;
+    }
+
+    uint64_t rate_bits = get_u64(data_ + 32);
+    std::memcpy(&frame_rate_, &rate_bits, sizeof(frame_rate_));
+
+    const uint64_t payload = file_size_ - header_size_;
+    const uint64_t block_bytes = static_cast<uint64_t>(row_bytes_) * block_frames_;
+    num_frames_ = get_u64(data_ + 24);
+    complete_ = num_frames_ != kIncompleteFrames;
+    if (!complete_) {
+        // 只恢复已完整写出的块
+        num_frames_ = payload / block_bytes * block_frames_;
+    }
+
+    const uint64_t full_blocks = num_frames_ / block_frames_;
+    const uint64_t expected = full_blocks * block_bytes + (num_frames_ - full_blocks * block_frames_) * row_bytes_;
+    if (expected > payload) {
+        std::cerr << "ColumnarReader open failed: truncated file " << path << std::endl;
+        close();
+        return false;
+    }
+    return true;
+}
+
+int ColumnarReader::find_column(const std::string& name) const {
+    for (size_t i = 0; i < columns_.size(); ++i) {
+        if (columns_[i].name == name) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+const void* ColumnarReader::get_block_column(size_t column, uint64_t block, size_t* frames) const {
+    if (!data_ || column >= columns_.size() || block >= get_num_blocks()) {
+        *frames = 0;
+        return nullptr;
+    }
+    const uint64_t first = block * block_frames_;
+    const size_t n = static_cast<size_t>(std::min<uint64_t>(block_frames_, num_frames_ - first));
+    // 块内各列按实际帧数依次存放（完整块即block_frames）
+    size_t offset = 0;
+    for (size_t c = 0; c < column; ++c) {
+        offset += widths_[c] * n;
+    }
+    *frames = n;
+    return data_ + header_size_ + block * row_bytes_ * block_frames_ + offset;
+}
+
+double ColumnarReader::get_value(size_t column, uint64_t frame) const {
+    if (frame >= num_frames_) {
+        return 0.0;
+    }
+    size_t frames = 0;
+    const uint8_t* p = static_cast<const uint8_t*>(get_block_column(column, frame / block_frames_, &frames));
+    if (!p) {
+        return 0.0;
+    }
+    return load_as_double(columns_[column].type, p + (frame % block_frames_) * widths_[column]);
+}
+
+bool ColumnarReader::read_column(size_t column, std::vector<float>& out) const {
+    out.clear();
+    if (!data_ || column >= columns_.size()) {
+        return false;
+    }
+    out.reserve(static_cast<size_t>(num_frames_));
+    const ColumnType type = columns_[column].type;
+    for (uint64_t b = 0; b < get_num_blocks(); ++b) {
+        size_t frames = 0;
+        const uint8_t* p = static_cast<const uint8_t*>(get_block_column(column, b, &frames));
+        if (type == ColumnType::FLOAT32) {
+            const size_t old_size = out.size();
+            out.resize(old_size + frames);
+            std::memcpy(out.data() + old_size, p, frames * sizeof(float));
+        } else {
+            for (size_t i = 0; i < frames; ++i) {
+                out.push_back(static_cast<float>(load_as_double(type, p + i * widths_[column])));
+            }
+        }
+    }
+    return true;
+}
+
+} // namespace srv
@@ -0,0 +1,213 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// 逐帧结果的列式二进制文件：分块缓冲写入定宽小端列，mmap零拷贝读取
+namespace srv {
+
+// 列数据类型（枚举值写入文件，不可改动）
+enum class ColumnType : uint8_t {
+    FLOAT32 = 1,
+    FLOAT64 = 2,
+    INT16 = 3,
+    INT32 = 4,
+    UINT8 = 5
+};
+
+// 列描述
+struct ColumnSpec {
+    std::string name;   // 列名，最长23字节
+    ColumnType type;
+};
+
+/**
+ * 获取列类型的字节宽度
+ */
+size_t column_type_width(ColumnType type);
+
+/**
+ * 获取列类型名称（float32等）
+ */
+const char* column_type_name(ColumnType type);
+
+// 文件布局:
+//   头部(64字节) + 列描述(每列32字节)，补齐到64字节
+//   数据按块存放，每块block_frames帧，块内各列连续存放；最后一块只存实际帧数
+class ColumnarWriter {
+private:
+    std::ofstream file_;
+    std::string path_;
+    std::vector<ColumnSpec> columns_;
+    std::vector<size_t> widths_;
+    std::vector<size_t> column_offsets_;  // 各列在块缓冲中的起始偏移
+    std::vector<uint8_t> block_;
+    uint32_t block_frames_;
+    size_t row_;                          // 当前块内的行号
+    uint64_t frames_written_;
+    double frame_rate_;
+    bool is_open_;
+
+    bool write_header(uint64_t num_frames);
+    bool flush_block(size_t frames);
+
+public:
+    ColumnarWriter();
+    ~ColumnarWriter();
+
+    ColumnarWriter(const ColumnarWriter&) = delete;
+    ColumnarWriter& operator=(const ColumnarWriter&) = delete;
+
+    /**
+     * 创建文件并写入头部
+     * @param path 输出路径
+     * @param columns 列描述
+     * @param frame_rate 帧率 (帧/秒)，用于换算时间
+     * @param block_frames 每块帧数，必须是8的倍数
+     * @return 是否成功
+     */
+    bool open(const std::string& path, const std::vector<ColumnSpec>& columns, double frame_rate,
+              uint32_t block_frames = 4096);
+
+    /**
+     * 设置当前行某列的值（按列类型转换存储）
+     * @param column 列下标
+     * @param value 值
+     */
+    void set(size_t column, double value) {
+        uint8_t* dst = block_.data() + column_offsets_[column] + row_ * widths_[column];
+        switch (columns_[column].type) {
+        case ColumnType::FLOAT32: {
+            float v = static_cast<float>(value);
+            std::memcpy(dst, &v, sizeof(v));
+            break;
+        }
+        case ColumnType::FLOAT64:
+            std::memcpy(dst, &value, sizeof(value));
+            break;
+        case ColumnType::INT16: {
+            int16_t v = static_cast<int16_t>(value);
+            std::memcpy(dst, &v, sizeof(v));
+            break;
+        }
+        case ColumnType::INT32: {
+            int32_t v = static_cast<int32_t>(value);
+            std::memcpy(dst, &v, sizeof(v));
+            break;
+        }
+        case ColumnType::UINT8:
+            *dst = static_cast<uint8_t>(value);
+            break;
+        }
+    }
+
+    /**
+     * 结束当前行，块写满时整块写出
+     * @return 写出是否成功
+     */
+    bool end_row() {
+        frames_written_++;
+        if (++row_ == block_frames_) {
+            return flush_block(row_);
+        }
+        return true;
+    }
+
+    /**
+     * 写出剩余数据并回填总帧数
+     * @return 是否成功
+     */
+    bool close();
+
+    bool is_open() const { return is_open_; }
+    uint64_t get_frames_written() const { return frames_written_; }
+    const std::string& get_path() const { return path_; }
+};
+
+class ColumnarReader {
+private:
+    const uint8_t* data_;
+    size_t file_size_;
+    size_t header_size_;
+    std::vector<ColumnSpec> columns_;
+    std::vector<size_t> widths_;
+    size_t row_bytes_;                    // 所有列一帧的字节数
+    uint32_t block_frames_;
+    uint64_t num_frames_;
+    double frame_rate_;
+    bool complete_;
+
+public:
+    ColumnarReader();
+    ~ColumnarReader();
+
+    ColumnarReader(const ColumnarReader&) = delete;
+    ColumnarReader& operator=(const ColumnarReader&) = delete;
+
+    /**
+     * 映射文件并校验头部
+     * 写入方未正常关闭时按文件大小恢复出完整的块
+     * @param path 文件路径
+     * @return 是否成功
+     */
+    bool open(const std::string& path);
+
+    /**
+     * 解除映射
+     */
+    void close();
+
+    bool is_open() const { return data_ != nullptr; }
+    uint64_t get_num_frames() const { return num_frames_; }
+    double get_frame_rate() const { return frame_rate_; }
+    uint32_t get_block_frames() const { return block_frames_; }
+    const std::vector<ColumnSpec>& get_columns() const { return columns_; }
+
+    /**
+     * 文件是否由写入方正常关闭
+     */
+    bool is_complete() const { return complete_; }
+
+    /**
+     * 按列名查找列下标
+     * @return 列下标，不存在返回-1
+     */
+    int find_column(const std::string& name) const;
+
+    /**
+     * 获取块数
+     */
+    uint64_t get_num_blocks() const {
+        return block_frames_ ? (num_frames_ + block_frames_ - 1) / block_frames_ : 0;
+    }
+
+    /**
+     * 零拷贝获取某块中一列的连续数据
+     * @param column 列下标
+     * @param block 块下标
+     * @param frames 输出该块的帧数
+     * @return 数据指针，按列类型解释
+     */
+    const void* get_block_column(size_t column, uint64_t block, size_t* frames) const;
+
+    /**
+     * 随机读取单个值（转换为double）
+     * @param column 列下标
+     * @param frame 帧下标
+     * @return 值
+     */
+    double get_value(size_t column, uint64_t frame) const;
+
+    /**
+     * 读取一整列（转换为float）
+     * @param column 列下标
+     * @param out 输出
+     * @return 是否成功
+     */
+    bool read_column(size_t column, std::vector<float>& out) const;
+};
+
+} // namespace srv
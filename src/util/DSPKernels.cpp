@@ -0,0 +1,1162 @@
+#include "DSPKernels.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+
+#if defined(__aarch64__) || defined(__ARM_NEON)
+#define SRV_KERNELS_NEON 1
+#include <arm_neon.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#define SRV_KERNELS_SSE2 1
+#include <emmintrin.h>
+#endif
+
+// 格式转换内核的NEON版本用到vcvtnq/vminnmq，只在AArch64上启用
+#if defined(__aarch64__)
+#define SRV_KERNELS_NEON64 1
+#endif
+
+// x86上用target属性编译SSE4.1/AVX2版本，运行时按CPU选择，基线编译选项不变
+#if defined(SRV_KERNELS_SSE2) && defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SRV_KERNELS_X86_DISPATCH 1
+#include <immintrin.h>
+#define SRV_TARGET_SSE41 __attribute__((target("sse4.1")))
+#define SRV_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+namespace srv {
+namespace kernels {
+
+#if defined(SRV_KERNELS_SSE2)
+namespace {
+
+inline float horizontal_max(__m128 v) {
+    __m128 shuf = _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1));
+    __m128 m = _mm_max_ps(v, shuf);
+    shuf = _mm_movehl_ps(shuf, m);
+    m = _mm_max_ss(m, shuf);
+    return _mm_cvtss_f32(m);
+}
+
+inline float horizontal_sum(__m128 v) {
+    __m128 shuf = _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1));
+    __m128 s = _mm_add_ps(v, shuf);
+    shuf = _mm_movehl_ps(shuf, s);
+    s = _mm_add_ss(s, shuf);
+    return _mm_cvtss_f32(s);
+}
+
+} // namespace
+#endif
+
+void peak_and_energy(const float* samples, size_t count, float* peak, float* energy) {
+    size_t i = 0;
+    float max_value = 0.0f;
+    float sum = 0.0f;
+
+#if defined(SRV_KERNELS_NEON)
+    float32x4_t vmax0 = vdupq_n_f32(0.0f);
+    float32x4_t vmax1 = vdupq_n_f32(0.0f);
+    float32x4_t vsum0 = vdupq_n_f32(0.0f);
+    float32x4_t vsum1 = vdupq_n_f32(0.0f);
+    for (; i + 8 <= count; i += 8) {
+        float32x4_t a = vld1q_f32(samples + i);
+        float32x4_t b = vld1q_f32(samples + i + 4);
+        vmax0 = vmaxq_f32(vmax0, vabsq_f32(a));
+        vmax1 = vmaxq_f32(vmax1, vabsq_f32(b));
+        vsum0 = vmlaq_f32(vsum0, a, a);
+        vsum1 = vmlaq_f32(vsum1, b, b);
+    }
+    float32x4_t vmax = vmaxq_f32(vmax0, vmax1);
+    float32x4_t vsum = vaddq_f32(vsum0, vsum1);
+#if defined(__aarch64__)
+    max_value = vmaxvq_f32(vmax);
+    sum = vaddvq_f32(vsum);
+#else
+    float lanes[4];
+    vst1q_f32(lanes, vmax);
+    max_value = std::max(std::max(lanes[0], lanes[1]), std::max(lanes[2], lanes[3]));
+    vst1q_f32(lanes, vsum);
+    sum = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+#endif
+#elif defined(SRV_KERNELS_SSE2)
+    const __m128 abs_mask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+    __m128 vmax0 = _mm_setzero_ps();
+    __m128 vmax1 = _mm_setzero_ps();
+    __m128 vsum0 = _mm_setzero_ps();
+    __m128 vsum1 = _mm_setzero_ps();
+    for (; i + 8 <= count; i += 8) {
+        __m128 a = _mm_loadu_ps(samples + i);
+        __m128 b = _mm_loadu_ps(samples + i + 4);
+        vmax0 = _mm_max_ps(vmax0, _mm_and_ps(a, abs_mask));
+        vmax1 = _mm_max_ps(vmax1, _mm_and_ps(b, abs_mask));
+        vsum0 = _mm_add_ps(vsum0, _mm_mul_ps(a, a));
+        vsum1 = _mm_add_ps(vsum1, _mm_mul_ps(b, b));
+    }
+    max_value = horizontal_max(_mm_max_ps(vmax0, vmax1));
+    sum = horizontal_sum(_mm_add_ps(vsum0, vsum1));
+#endif
+
+    // 剩余样本（以及无SIMD时的全部样本）
+    for (; i < count; ++i) {
+        float v = samples[i];
+        max_value = std::max(max_value, std::fabs(v));
+        sum += v * v;
+    }
+
+    *peak = max_value;
+    *energy = sum;
+}
+
+float peak_abs(const float* samples, size_t count) {
+    float peak = 0.0f;
+    float energy = 0.0f;
+    peak_and_energy(samples, count, &peak, &energy);
+    return peak;
+}
+
+float sum_squares(const float* samples, size_t count) {
+    float peak = 0.0f;
+    float energy = 0.0f;
+    peak_and_energy(samples, count, &peak, &energy);
+    return energy;
+}
+
+uint64_t sum_abs_s16(const int16_t* samples, size_t count) {
+    // 32位累加器每条通道最多累加chunk/4个不超过32768的值，分块合并到64位避免溢出
+    const size_t chunk = 8192;
+    size_t i = 0;
+    uint64_t total = 0;
+
+#if defined(SRV_KERNELS_NEON)
+    const int16x4_t zero = vdup_n_s16(0);
+    while (i + 8 <= count) {
+        size_t chunk_end = std::min(count, i + chunk);
+        int32x4_t acc0 = vdupq_n_s32(0);
+        int32x4_t acc1 = vdupq_n_s32(0);
+        for (; i + 8 <= chunk_end; i += 8) {
+            int16x8_t v = vld1q_s16(samples + i);
+            acc0 = vabal_s16(acc0, vget_low_s16(v), zero);
+            acc1 = vabal_s16(acc1, vget_high_s16(v), zero);
+        }
+        uint32x4_t acc = vaddq_u32(vreinterpretq_u32_s32(acc0), vreinterpretq_u32_s32(acc1));
+        uint64x2_t wide = vpaddlq_u32(acc);
+        total += vgetq_lane_u64(wide, 0) + vgetq_lane_u64(wide, 1);
+    }
+#elif defined(SRV_KERNELS_SSE2)
+    while (i + 8 <= count) {
+        size_t chunk_end = std::min(count, i + chunk);
+        __m128i acc = _mm_setzero_si128();
+        for (; i + 8 <= chunk_end; i += 8) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(samples + i));
+            // 符号扩展到32位
+            __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16);
+            __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16);
+            // SSE2没有_mm_abs_epi32: |x| = (x ^ s) - s, s = x >> 31
+            __m128i sign_lo = _mm_srai_epi32(lo, 31);
+            __m128i sign_hi = _mm_srai_epi32(hi, 31);
+            lo = _mm_sub_epi32(_mm_xor_si128(lo, sign_lo), sign_lo);
+            hi = _mm_sub_epi32(_mm_xor_si128(hi, sign_hi), sign_hi);
+            acc = _mm_add_epi32(acc, _mm_add_epi32(lo, hi));
+        }
+        alignas(16) uint32_t lanes[4];
+        _mm_store_si128(reinterpret_cast<__m128i*>(lanes), acc);
+        total += static_cast<uint64_t>(lanes[0]) + lanes[1] + lanes[2] + lanes[3];
+    }
+#endif
+
+    for (; i < count; ++i) {
+        int v = samples[i];
+        total += static_cast<uint64_t>(v < 0 ? -v : v);
+    }
+    return total;
+}
+
+namespace {
+
+// 一批最多串联的组数（每组在循环中占3个SIMD寄存器：输出和两个状态）
+const int kBiquadBatch = 4;
+
+// 流水线的一步（标量）：只计算流水级[k_begin, k_end)，x为空表示输入已结束
+// 第k级第c个声道在pipe中的下标为k*channels+c，第k级的输入是第k-1级上一步的输出
+void biquad_step_scalar(BiquadLanes* groups, float* pipe, const float* x, int channels, int group_count,
+                        int k_begin, int k_end) {
+    const int lanes = 4 * group_count;
+    float v[4 * kBiquadBatch];
+    for (int i = 0; i < lanes; ++i) {
+        v[i] = i < channels ? (x ? x[i] : 0.0f) : pipe[i - channels];
+    }
+    for (int i = 0; i < lanes; ++i) {
+        const int k = i / channels;
+        if (k < k_begin || k >= k_end) {
+            pipe[i] = 0.0f;
+            continue;
+        }
+        BiquadLanes& g = groups[i / 4];
+        const int l = i % 4;
+        const float y = g.b0[l] * v[i] + g.s1[l];
+        g.s1[l] = g.b1[l] * v[i] - g.a1[l] * y + g.s2[l];
+        g.s2[l] = g.b2[l] * v[i] - g.a2[l] * y;
+        pipe[i] = y;
+    }
+}
+
+// 所有流水级都有样本的稳态部分：第t步输入样本t，输出样本t-(级数-1)
+// 每组的输入只依赖上一步的输出，G组的计算互相独立，可以同时在流水线里执行
+template <int CH, int G>
+size_t biquad_steady(BiquadLanes* groups, float* pipe, float* samples, size_t t, size_t frames) {
+    const size_t ramp = static_cast<size_t>(G * (4 / CH) - 1);
+#if defined(SRV_KERNELS_SSE2)
+    __m128 s1[G], s2[G], p[G];
+    for (int g = 0; g < G; ++g) {
+        s1[g] = _mm_loadu_ps(groups[g].s1);
+        s2[g] = _mm_loadu_ps(groups[g].s2);
+        p[g] = _mm_loadu_ps(pipe + 4 * g);
+    }
+    for (; t < frames; ++t) {
+        const float* x = samples + t * CH;
+        // 上一级的最后CH条通道，第0组为输入样本
+        __m128 prev;
+        if constexpr (CH == 1) {
+            prev = _mm_set1_ps(x[0]);
+        } else if constexpr (CH == 2) {
+            prev = _mm_castpd_ps(_mm_load1_pd(reinterpret_cast<const double*>(x)));
+        } else {
+            prev = _mm_loadu_ps(x);
+        }
+        for (int g = 0; g < G; ++g) {
+            __m128 v;
+            if constexpr (CH == 1) {
+                v = _mm_move_ss(_mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(p[g]), 4)),
+                                _mm_shuffle_ps(prev, prev, _MM_SHUFFLE(3, 3, 3, 3)));
+            } else if constexpr (CH == 2) {
+                v = _mm_shuffle_ps(prev, p[g], _MM_SHUFFLE(1, 0, 3, 2));
+            } else {
+                v = prev;
+            }
+            prev = p[g];
+            const BiquadLanes& c = groups[g];
+            const __m128 y = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(c.b0), v), s1[g]);
+            s1[g] = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(_mm_loadu_ps(c.b1), v), _mm_mul_ps(_mm_loadu_ps(c.a1), y)), s2[g]);
+            s2[g] = _mm_sub_ps(_mm_mul_ps(_mm_loadu_ps(c.b2), v), _mm_mul_ps(_mm_loadu_ps(c.a2), y));
+            p[g] = y;
+        }
+        float* out = samples + (t - ramp) * CH;
+        if constexpr (CH == 1) {
+            _mm_store_ss(out, _mm_shuffle_ps(p[G - 1], p[G - 1], _MM_SHUFFLE(3, 3, 3, 3)));
+        } else if constexpr (CH == 2) {
+            _mm_storeh_pi(reinterpret_cast<__m64*>(out), p[G - 1]);
+        } else {
+            _mm_storeu_ps(out, p[G - 1]);
+        }
+    }
+    for (int g = 0; g < G; ++g) {
+        _mm_storeu_ps(groups[g].s1, s1[g]);
+        _mm_storeu_ps(groups[g].s2, s2[g]);
+        _mm_storeu_ps(pipe + 4 * g, p[g]);
+    }
+#elif defined(SRV_KERNELS_NEON)
+    float32x4_t s1[G], s2[G], p[G];
+    for (int g = 0; g < G; ++g) {
+        s1[g] = vld1q_f32(groups[g].s1);
+        s2[g] = vld1q_f32(groups[g].s2);
+        p[g] = vld1q_f32(pipe + 4 * g);
+    }
+    for (; t < frames; ++t) {
+        const float* x = samples + t * CH;
+        float32x4_t prev;
+        if constexpr (CH == 1) {
+            prev = vdupq_n_f32(x[0]);
+        } else if constexpr (CH == 2) {
+            const float32x2_t pair = vld1_f32(x);
+            prev = vcombine_f32(pair, pair);
+        } else {
+            prev = vld1q_f32(x);
+        }
+        for (int g = 0; g < G; ++g) {
+            float32x4_t v;
+            if constexpr (CH == 1) {
+                v = vextq_f32(prev, p[g], 3);
+            } else if constexpr (CH == 2) {
+                v = vextq_f32(prev, p[g], 2);
+            } else {
+                v = prev;
+            }
+            prev = p[g];
+            const BiquadLanes& c = groups[g];
+            const float32x4_t y = vmlaq_f32(s1[g], vld1q_f32(c.b0), v);
+            s1[g] = vaddq_f32(vmlsq_f32(vmulq_f32(vld1q_f32(c.b1), v), vld1q_f32(c.a1), y), s2[g]);
+            s2[g] = vmlsq_f32(vmulq_f32(vld1q_f32(c.b2), v), vld1q_f32(c.a2), y);
+            p[g] = y;
+        }
+        float* out = samples + (t - ramp) * CH;
+        if constexpr (CH == 1) {
+            vst1q_lane_f32(out, p[G - 1], 3);
+        } else if constexpr (CH == 2) {
+            vst1_f32(out, vget_high_f32(p[G - 1]));
+        } else {
+            vst1q_f32(out, p[G - 1]);
+        }
+    }
+    for (int g = 0; g < G; ++g) {
+        vst1q_f32(groups[g].s1, s1[g]);
+        vst1q_f32(groups[g].s2, s2[g]);
+        vst1q_f32(pipe + 4 * g, p[g]);
+    }
+#else
+    for (; t < frames; ++t) {
+        biquad_step_scalar(groups, pipe, samples + t * CH, CH, G, 0, G * (4 / CH));
+        std::memcpy(samples + (t - ramp) * CH, pipe + ramp * CH, CH * sizeof(float));
+    }
+#endif
+    return t;
+}
+
+// G组二阶节串成一条G*(4/CH)级的流水线处理一遍样本
+template <int CH, int G>
+void biquad_batch(BiquadLanes* groups, float* samples, size_t frames) {
+    const int stages = G * (4 / CH);
+    const size_t ramp = static_cast<size_t>(stages - 1);
+    const size_t steps = frames + ramp;
+    float pipe[4 * kBiquadBatch] = {};
+
+    // 流水线两端只有部分流水级有样本，用标量逐级计算；最后一级有样本时写出
+    auto masked_step = [&](size_t t) {
+        const int k_begin = t >= frames ? static_cast<int>(t - frames + 1) : 0;
+        const int k_end = static_cast<int>(std::min<size_t>(stages, t + 1));
+        biquad_step_scalar(groups, pipe, t < frames ? samples + t * CH : nullptr, CH, G, k_begin, k_end);
+        if (t >= ramp) {
+            std::memcpy(samples + (t - ramp) * CH, pipe + ramp * CH, CH * sizeof(float));
+        }
+    };
+
+    size_t t = 0;
+    for (; t < std::min(ramp, steps); ++t) {
+        masked_step(t);
+    }
+    t = biquad_steady<CH, G>(groups, pipe, samples, t, frames);
+    for (; t < steps; ++t) {
+        masked_step(t);
+    }
+}
+
+template <int CH>
+void biquad_cascade_fixed(BiquadLanes* groups, size_t group_count, float* samples, size_t frames) {
+    // 每kBiquadBatch组一批，批与批之间按顺序处理
+    for (size_t i = 0; i < group_count; i += kBiquadBatch) {
+        switch (std::min<size_t>(group_count - i, kBiquadBatch)) {
+        case 1: biquad_batch<CH, 1>(groups + i, samples, frames); break;
+        case 2: biquad_batch<CH, 2>(groups + i, samples, frames); break;
+        case 3: biquad_batch<CH, 3>(groups + i, samples, frames); break;
+        default: biquad_batch<CH, 4>(groups + i, samples, frames); break;
+        }
+    }
+}
+
+} // namespace
+
+void biquad_cascade(BiquadLanes* groups, size_t group_count, float* samples, size_t frames, int channels) {
+    if (frames == 0) {
+        return;
+    }
+    switch (channels) {
+    case 1: biquad_cascade_fixed<1>(groups, group_count, samples, frames); break;
+    case 2: biquad_cascade_fixed<2>(groups, group_count, samples, frames); break;
+    case 4: biquad_cascade_fixed<4>(groups, group_count, samples, frames); break;
+    default: break;
+    }
+}
+
+const char* get_isa_name() {
+#if defined(SRV_KERNELS_NEON)
+    return "NEON";
+#elif defined(SRV_KERNELS_SSE2)
+    return "SSE2";
+#else
+    return "scalar";
+#endif
+}
+
+// ---------------------------------------------------------------------------
+// 格式转换与声道交织（运行时分发）
+// ---------------------------------------------------------------------------
+
+namespace {
+
+// 与SIMD的min/max语义一致：比较失败（NaN）时取常量，保证各指令集逐位一致
+inline int16_t saturate_round_s16(float v) {
+    v = v < 32767.0f ? v : 32767.0f;
+    v = v > -32768.0f ? v : -32768.0f;
+    return static_cast<int16_t>(std::lrintf(v));
+}
+
+inline uint32_t xorshift32(uint32_t x) {
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return x;
+}
+
+// 高低16位之差是两个均匀分布之差，得到(-1, 1)的三角分布
+inline float tpdf_from_bits(uint32_t x) {
+    return static_cast<float>(static_cast<int32_t>(x >> 16) - static_cast<int32_t>(x & 0xFFFFu)) *
+           (1.0f / 65536.0f);
+}
+
+inline int32_t load_s24_le(const uint8_t* p) {
+    return static_cast<int32_t>((static_cast<uint32_t>(p[0]) << 8) | (static_cast<uint32_t>(p[1]) << 16) |
+                                (static_cast<uint32_t>(p[2]) << 24)) >> 8;
+}
+
+inline int32_t load_s32_le(const uint8_t* p) {
+    int32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+// ---- 标量实现，也负责各SIMD版本的尾部 ----
+
+void s16_to_f32_scalar(const int16_t* in, float* out, size_t count, float scale) {
+    for (size_t i = 0; i < count; ++i) {
+        out[i] = static_cast<float>(in[i]) * scale;
+    }
+}
+
+void f32_to_s16_scalar(const float* in, int16_t* out, size_t count, float scale) {
+    for (size_t i = 0; i < count; ++i) {
+        out[i] = saturate_round_s16(in[i] * scale);
+    }
+}
+
+void f32_to_s16_dither_scalar_from(const float* in, int16_t* out, size_t begin, size_t count, float scale,
+                                   DitherState* state) {
+    for (size_t i = begin; i < count; ++i) {
+        uint32_t& lane = state->lanes[i & 7];
+        lane = xorshift32(lane);
+        out[i] = saturate_round_s16(in[i] * scale + tpdf_from_bits(lane));
+    }
+}
+
+void f32_to_s16_dither_scalar(const float* in, int16_t* out, size_t count, float scale, DitherState* state) {
+    f32_to_s16_dither_scalar_from(in, out, 0, count, scale, state);
+}
+
+void s24_to_f32_scalar(const uint8_t* in, float* out, size_t count, float scale) {
+    for (size_t i = 0; i < count; ++i) {
+        out[i] = static_cast<float>(load_s24_le(in + 3 * i)) * scale;
+    }
+}
+
+void s32_to_f32_scalar(const uint8_t* in, float* out, size_t count, float scale) {
+    for (size_t i = 0; i < count; ++i) {
+        out[i] = static_cast<float>(load_s32_le(in + 4 * i)) * scale;
+    }
+}
+
+// 声道数为编译期常量时编译器可以完全展开内层循环
+template <typename T, int C>
+void deinterleave_fixed(const T* in, T* const* out, size_t begin, size_t frames) {
+    for (size_t i = begin; i < frames; ++i) {
+        for (int c = 0; c < C; ++c) {
+            out[c][i] = in[i * C + c];
+        }
+    }
+}
+
+template <typename T, int C>
+void interleave_fixed(const T* const* in, T* out, size_t begin, size_t frames) {
+    for (size_t i = begin; i < frames; ++i) {
+        for (int c = 0; c < C; ++c) {
+            out[i * C + c] = in[c][i];
+        }
+    }
+}
+
+template <typename T>
+void deinterleave_from(const T* in, T* const* out, size_t begin, size_t frames, int channels) {
+    switch (channels) {
+    case 1: std::memcpy(out[0] + begin, in + begin, (frames - begin) * sizeof(T)); break;
+    case 2: deinterleave_fixed<T, 2>(in, out, begin, frames); break;
+    case 3: deinterleave_fixed<T, 3>(in, out, begin, frames); break;
+    case 4: deinterleave_fixed<T, 4>(in, out, begin, frames); break;
+    case 5: deinterleave_fixed<T, 5>(in, out, begin, frames); break;
+    case 6: deinterleave_fixed<T, 6>(in, out, begin, frames); break;
+    case 7: deinterleave_fixed<T, 7>(in, out, begin, frames); break;
+    case 8: deinterleave_fixed<T, 8>(in, out, begin, frames); break;
+    default:
+        for (size_t i = begin; i < frames; ++i) {
+            for (int c = 0; c < channels; ++c) {
+                out[c][i] = in[i * channels + c];
+            }
+        }
+        break;
+    }
+}
+
+template <typename T>
+void interleave_from(const T* const* in, T* out, size_t begin, size_t frames, int channels) {
+    switch (channels) {
+    case 1: std::memcpy(out + begin, in[0] + begin, (frames - begin) * sizeof(T)); break;
+    case 2: interleave_fixed<T, 2>(in, out, begin, frames); break;
+    case 3: interleave_fixed<T, 3>(in, out, begin, frames); break;
+    case 4: interleave_fixed<T, 4>(in, out, begin, frames); break;
+    case 5: interleave_fixed<T, 5>(in, out, begin, frames); break;
+    case 6: interleave_fixed<T, 6>(in, out, begin, frames); break;
+    case 7: interleave_fixed<T, 7>(in, out, begin, frames); break;
+    case 8: interleave_fixed<T, 8>(in, out, begin, frames); break;
+    default:
+        for (size_t i = begin; i < frames; ++i) {
+            for (int c = 0; c < channels; ++c) {
+                out[i * channels + c] = in[c][i];
+            }
+        }
+        break;
+    }
+}
+
+void deinterleave_f32_scalar(const float* in, float* const* out, size_t frames, int channels) {
+    deinterleave_from(in, out, 0, frames, channels);
+}
+
+void interleave_f32_scalar(const float* const* in, float* out, size_t frames, int channels) {
+    interleave_from(in, out, 0, frames, channels);
+}
+
+void deinterleave_s16_scalar(const int16_t* in, int16_t* const* out, size_t frames, int channels) {
+    deinterleave_from(in, out, 0, frames, channels);
+}
+
+void interleave_s16_scalar(const int16_t* const* in, int16_t* out, size_t frames, int channels) {
+    interleave_from(in, out, 0, frames, channels);
+}
+
+#if defined(SRV_KERNELS_SSE2)
+// ---- SSE2 ----
+
+void s16_to_f32_sse2(const int16_t* in, float* out, size_t count, float scale) {
+    const __m128 s = _mm_set1_ps(scale);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16);
+        __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16);
+        _mm_storeu_ps(out + i, _mm_mul_ps(_mm_cvtepi32_ps(lo), s));
+        _mm_storeu_ps(out + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(hi), s));
+    }
+    s16_to_f32_scalar(in + i, out + i, count - i, scale);
+}
+
+// 缩放并限幅后取整（MXCSR默认舍入为最近偶数，与lrintf一致）
+inline __m128i scale_clamp_round_sse2(__m128 v, __m128 s) {
+    v = _mm_mul_ps(v, s);
+    v = _mm_min_ps(v, _mm_set1_ps(32767.0f));
+    v = _mm_max_ps(v, _mm_set1_ps(-32768.0f));
+    return _mm_cvtps_epi32(v);
+}
+
+void f32_to_s16_sse2(const float* in, int16_t* out, size_t count, float scale) {
+    const __m128 s = _mm_set1_ps(scale);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m128i a = scale_clamp_round_sse2(_mm_loadu_ps(in + i), s);
+        __m128i b = scale_clamp_round_sse2(_mm_loadu_ps(in + i + 4), s);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_packs_epi32(a, b));
+    }
+    f32_to_s16_scalar(in + i, out + i, count - i, scale);
+}
+
+inline __m128i xorshift32_sse2(__m128i x) {
+    x = _mm_xor_si128(x, _mm_slli_epi32(x, 13));
+    x = _mm_xor_si128(x, _mm_srli_epi32(x, 17));
+    x = _mm_xor_si128(x, _mm_slli_epi32(x, 5));
+    return x;
+}
+
+inline __m128 tpdf_sse2(__m128i x) {
+    __m128i d = _mm_sub_epi32(_mm_srli_epi32(x, 16), _mm_and_si128(x, _mm_set1_epi32(0xFFFF)));
+    return _mm_mul_ps(_mm_cvtepi32_ps(d), _mm_set1_ps(1.0f / 65536.0f));
+}
+
+void f32_to_s16_dither_sse2(const float* in, int16_t* out, size_t count, float scale, DitherState* state) {
+    const __m128 s = _mm_set1_ps(scale);
+    __m128i lanes0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(state->lanes));
+    __m128i lanes1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(state->lanes + 4));
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        lanes0 = xorshift32_sse2(lanes0);
+        lanes1 = xorshift32_sse2(lanes1);
+        __m128 a = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(in + i), s), tpdf_sse2(lanes0));
+        __m128 b = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(in + i + 4), s), tpdf_sse2(lanes1));
+        const __m128 one = _mm_set1_ps(1.0f);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i),
+                         _mm_packs_epi32(scale_clamp_round_sse2(a, one), scale_clamp_round_sse2(b, one)));
+    }
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(state->lanes), lanes0);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(state->lanes + 4), lanes1);
+    f32_to_s16_dither_scalar_from(in, out, i, count, scale, state);
+}
+
+void s32_to_f32_sse2(const uint8_t* in, float* out, size_t count, float scale) {
+    const __m128 s = _mm_set1_ps(scale);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 4 * i));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 4 * i + 16));
+        _mm_storeu_ps(out + i, _mm_mul_ps(_mm_cvtepi32_ps(a), s));
+        _mm_storeu_ps(out + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(b), s));
+    }
+    s32_to_f32_scalar(in + 4 * i, out + i, count - i, scale);
+}
+
+// 双声道和四声道是最常见的布局，用shuffle/转置处理；其余声道数走展开的标量循环
+void deinterleave_f32_sse2(const float* in, float* const* out, size_t frames, int channels) {
+    size_t i = 0;
+    if (channels == 2) {
+        for (; i + 4 <= frames; i += 4) {
+            __m128 a = _mm_loadu_ps(in + 2 * i);
+            __m128 b = _mm_loadu_ps(in + 2 * i + 4);
+            _mm_storeu_ps(out[0] + i, _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)));
+            _mm_storeu_ps(out[1] + i, _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+        }
+    } else if (channels == 4) {
+        for (; i + 4 <= frames; i += 4) {
+            __m128 r0 = _mm_loadu_ps(in + 4 * i);
+            __m128 r1 = _mm_loadu_ps(in + 4 * i + 4);
+            __m128 r2 = _mm_loadu_ps(in + 4 * i + 8);
+            __m128 r3 = _mm_loadu_ps(in + 4 * i + 12);
+            _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+            _mm_storeu_ps(out[0] + i, r0);
+            _mm_storeu_ps(out[1] + i, r1);
+            _mm_storeu_ps(out[2] + i, r2);
+            _mm_storeu_ps(out[3] + i, r3);
+        }
+    }
+    deinterleave_from(in, out, i, frames, channels);
+}
+
+void interleave_f32_sse2(const float* const* in, float* out, size_t frames, int channels) {
+    size_t i = 0;
+    if (channels == 2) {
+        for (; i + 4 <= frames; i += 4) {
+            __m128 l = _mm_loadu_ps(in[0] + i);
+            __m128 r = _mm_loadu_ps(in[1] + i);
+            _mm_storeu_ps(out + 2 * i, _mm_unpacklo_ps(l, r));
+            _mm_storeu_ps(out + 2 * i + 4, _mm_unpackhi_ps(l, r));
+        }
+    } else if (channels == 4) {
+        for (; i + 4 <= frames; i += 4) {
+            __m128 r0 = _mm_loadu_ps(in[0] + i);
+            __m128 r1 = _mm_loadu_ps(in[1] + i);
+            __m128 r2 = _mm_loadu_ps(in[2] + i);
+            __m128 r3 = _mm_loadu_ps(in[3] + i);
+            _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+            _mm_storeu_ps(out + 4 * i, r0);
+            _mm_storeu_ps(out + 4 * i + 4, r1);
+            _mm_storeu_ps(out + 4 * i + 8, r2);
+            _mm_storeu_ps(out + 4 * i + 12, r3);
+        }
+    }
+    interleave_from(in, out, i, frames, channels);
+}
+
+void deinterleave_s16_sse2(const int16_t* in, int16_t* const* out, size_t frames, int channels) {
+    size_t i = 0;
+    if (channels == 2) {
+        for (; i + 8 <= frames; i += 8) {
+            __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 2 * i));
+            __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 2 * i + 8));
+            // 每个32位是一帧(L低16位, R高16位)：符号扩展后饱和打包，数值不变
+            __m128i l = _mm_packs_epi32(_mm_srai_epi32(_mm_slli_epi32(a, 16), 16),
+                                        _mm_srai_epi32(_mm_slli_epi32(b, 16), 16));
+            __m128i r = _mm_packs_epi32(_mm_srai_epi32(a, 16), _mm_srai_epi32(b, 16));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out[0] + i), l);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out[1] + i), r);
+        }
+    }
+    deinterleave_from(in, out, i, frames, channels);
+}
+
+void interleave_s16_sse2(const int16_t* const* in, int16_t* out, size_t frames, int channels) {
+    size_t i = 0;
+    if (channels == 2) {
+        for (; i + 8 <= frames; i += 8) {
+            __m128i l = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in[0] + i));
+            __m128i r = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in[1] + i));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 2 * i), _mm_unpacklo_epi16(l, r));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 2 * i + 8), _mm_unpackhi_epi16(l, r));
+        }
+    }
+    interleave_from(in, out, i, frames, channels);
+}
+#endif // SRV_KERNELS_SSE2
+
+#if defined(SRV_KERNELS_X86_DISPATCH)
+// ---- SSE4.1（含SSSE3的pshufb） ----
+
+SRV_TARGET_SSE41
+void s16_to_f32_sse41(const int16_t* in, float* out, size_t count, float scale) {
+    const __m128 s = _mm_set1_ps(scale);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        _mm_storeu_ps(out + i, _mm_mul_ps(_mm_cvtepi32_ps(_mm_cvtepi16_epi32(v)), s));
+        _mm_storeu_ps(out + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(_mm_cvtepi16_epi32(_mm_srli_si128(v, 8))), s));
+    }
+    s16_to_f32_scalar(in + i, out + i, count - i, scale);
+}
+
+SRV_TARGET_SSE41
+void s24_to_f32_sse41(const uint8_t* in, float* out, size_t count, float scale) {
+    const __m128 s = _mm_set1_ps(scale);
+    // 4个3字节样本放到32位的高24位，再算术右移8位完成符号扩展
+    const __m128i shuffle = _mm_setr_epi8(-1, 0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11);
+    size_t i = 0;
+    // 每次读16字节只用12字节，保证不越过输入末尾
+    for (; i + 6 <= count; i += 4) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 3 * i));
+        v = _mm_srai_epi32(_mm_shuffle_epi8(v, shuffle), 8);
+        _mm_storeu_ps(out + i, _mm_mul_ps(_mm_cvtepi32_ps(v), s));
+    }
+    s24_to_f32_scalar(in + 3 * i, out + i, count - i, scale);
+}
+
+// ---- AVX2 ----
+
+SRV_TARGET_AVX2
+void s16_to_f32_avx2(const int16_t* in, float* out, size_t count, float scale) {
+    const __m256 s = _mm256_set1_ps(scale);
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i + 8));
+        _mm256_storeu_ps(out + i, _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(a)), s));
+        _mm256_storeu_ps(out + i + 8, _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(b)), s));
+    }
+    s16_to_f32_scalar(in + i, out + i, count - i, scale);
+}
+
+SRV_TARGET_AVX2
+inline __m256i clamp_round_avx2(__m256 v) {
+    v = _mm256_min_ps(v, _mm256_set1_ps(32767.0f));
+    v = _mm256_max_ps(v, _mm256_set1_ps(-32768.0f));
+    return _mm256_cvtps_epi32(v);
+}
+
+// packs在每个128位通道内交错，需要再按64位重排回顺序
+SRV_TARGET_AVX2
+inline __m256i pack_s16_avx2(__m256i a, __m256i b) {
+    return _mm256_permute4x64_epi64(_mm256_packs_epi32(a, b), _MM_SHUFFLE(3, 1, 2, 0));
+}
+
+SRV_TARGET_AVX2
+void f32_to_s16_avx2(const float* in, int16_t* out, size_t count, float scale) {
+    const __m256 s = _mm256_set1_ps(scale);
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m256i a = clamp_round_avx2(_mm256_mul_ps(_mm256_loadu_ps(in + i), s));
+        __m256i b = clamp_round_avx2(_mm256_mul_ps(_mm256_loadu_ps(in + i + 8), s));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), pack_s16_avx2(a, b));
+    }
+    f32_to_s16_scalar(in + i, out + i, count - i, scale);
+}
+
+SRV_TARGET_AVX2
+void f32_to_s16_dither_avx2(const float* in, int16_t* out, size_t count, float scale, DitherState* state) {
+    const __m256 s = _mm256_set1_ps(scale);
+    const __m256i low_mask = _mm256_set1_epi32(0xFFFF);
+    const __m256 unit = _mm256_set1_ps(1.0f / 65536.0f);
+    __m256i lanes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(state->lanes));
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        lanes = _mm256_xor_si256(lanes, _mm256_slli_epi32(lanes, 13));
+        lanes = _mm256_xor_si256(lanes, _mm256_srli_epi32(lanes, 17));
+        lanes = _mm256_xor_si256(lanes, _mm256_slli_epi32(lanes, 5));
+        __m256i d = _mm256_sub_epi32(_mm256_srli_epi32(lanes, 16), _mm256_and_si256(lanes, low_mask));
+        __m256 v = _mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(in + i), s),
+                                 _mm256_mul_ps(_mm256_cvtepi32_ps(d), unit));
+        __m256i q = clamp_round_avx2(v);
+        __m128i packed = _mm_packs_epi32(_mm256_castsi256_si128(q), _mm256_extracti128_si256(q, 1));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), packed);
+    }
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(state->lanes), lanes);
+    f32_to_s16_dither_scalar_from(in, out, i, count, scale, state);
+}
+
+SRV_TARGET_AVX2
+void s24_to_f32_avx2(const uint8_t* in, float* out, size_t count, float scale) {
+    const __m256 s = _mm256_set1_ps(scale);
+    const __m256i shuffle = _mm256_setr_epi8(-1, 0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11,
+                                             -1, 0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11);
+    size_t i = 0;
+    // 两次16字节读取各用12字节，第二次读到3*i+28，保证不越过输入末尾
+    for (; i + 10 <= count; i += 8) {
+        __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 3 * i));
+        __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 3 * i + 12));
+        __m256i v = _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+        v = _mm256_srai_epi32(_mm256_shuffle_epi8(v, shuffle), 8);
+        _mm256_storeu_ps(out + i, _mm256_mul_ps(_mm256_cvtepi32_ps(v), s));
+    }
+    s24_to_f32_scalar(in + 3 * i, out + i, count - i, scale);
+}
+
+SRV_TARGET_AVX2
+void s32_to_f32_avx2(const uint8_t* in, float* out, size_t count, float scale) {
+    const __m256 s = _mm256_set1_ps(scale);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + 4 * i));
+        _mm256_storeu_ps(out + i, _mm256_mul_ps(_mm256_cvtepi32_ps(v), s));
+    }
+    s32_to_f32_scalar(in + 4 * i, out + i, count - i, scale);
+}
+#endif // SRV_KERNELS_X86_DISPATCH
+
+#if defined(SRV_KERNELS_NEON64)
+// ---- NEON (AArch64) ----
+
+void s16_to_f32_neon(const int16_t* in, float* out, size_t count, float scale) {
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        int16x8_t v = vld1q_s16(in + i);
+        vst1q_f32(out + i, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(v))), scale));
+        vst1q_f32(out + i + 4, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(v))), scale));
+    }
+    s16_to_f32_scalar(in + i, out + i, count - i, scale);
+}
+
+// vminnm/vmaxnm在一侧为NaN时返回另一侧，与标量实现的限幅语义一致
+inline int32x4_t clamp_round_neon(float32x4_t v) {
+    v = vminnmq_f32(v, vdupq_n_f32(32767.0f));
+    v = vmaxnmq_f32(v, vdupq_n_f32(-32768.0f));
+    return vcvtnq_s32_f32(v);
+}
+
+void f32_to_s16_neon(const float* in, int16_t* out, size_t count, float scale) {
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        int32x4_t a = clamp_round_neon(vmulq_n_f32(vld1q_f32(in + i), scale));
+        int32x4_t b = clamp_round_neon(vmulq_n_f32(vld1q_f32(in + i + 4), scale));
+        vst1q_s16(out + i, vcombine_s16(vqmovn_s32(a), vqmovn_s32(b)));
+    }
+    f32_to_s16_scalar(in + i, out + i, count - i, scale);
+}
+
+inline uint32x4_t xorshift32_neon(uint32x4_t x) {
+    x = veorq_u32(x, vshlq_n_u32(x, 13));
+    x = veorq_u32(x, vshrq_n_u32(x, 17));
+    x = veorq_u32(x, vshlq_n_u32(x, 5));
+    return x;
+}
+
+inline float32x4_t tpdf_neon(uint32x4_t x) {
+    int32x4_t d = vsubq_s32(vreinterpretq_s32_u32(vshrq_n_u32(x, 16)),
+                            vreinterpretq_s32_u32(vandq_u32(x, vdupq_n_u32(0xFFFF))));
+    return vmulq_n_f32(vcvtq_f32_s32(d), 1.0f / 65536.0f);
+}
+
+void f32_to_s16_dither_neon(const float* in, int16_t* out, size_t count, float scale, DitherState* state) {
+    uint32x4_t lanes0 = vld1q_u32(state->lanes);
+    uint32x4_t lanes1 = vld1q_u32(state->lanes + 4);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        lanes0 = xorshift32_neon(lanes0);
+        lanes1 = xorshift32_neon(lanes1);
+        float32x4_t a = vaddq_f32(vmulq_n_f32(vld1q_f32(in + i), scale), tpdf_neon(lanes0));
+        float32x4_t b = vaddq_f32(vmulq_n_f32(vld1q_f32(in + i + 4), scale), tpdf_neon(lanes1));
+        vst1q_s16(out + i, vcombine_s16(vqmovn_s32(clamp_round_neon(a)), vqmovn_s32(clamp_round_neon(b))));
+    }
+    vst1q_u32(state->lanes, lanes0);
+    vst1q_u32(state->lanes + 4, lanes1);
+    f32_to_s16_dither_scalar_from(in, out, i, count, scale, state);
+}
+
+void s24_to_f32_neon(const uint8_t* in, float* out, size_t count, float scale) {
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        // vld3按字节位置拆成三个平面：低/中/高字节各8个
+        uint8x8x3_t b = vld3_u8(in + 3 * i);
+        uint16x8_t low = vorrq_u16(vmovl_u8(b.val[0]), vshlq_n_u16(vmovl_u8(b.val[1]), 8));
+        int16x8_t high = vmovl_s8(vreinterpret_s8_u8(b.val[2]));
+        int32x4_t v0 = vorrq_s32(vshlq_n_s32(vmovl_s16(vget_low_s16(high)), 16),
+                                 vreinterpretq_s32_u32(vmovl_u16(vget_low_u16(low))));
+        int32x4_t v1 = vorrq_s32(vshlq_n_s32(vmovl_s16(vget_high_s16(high)), 16),
+                                 vreinterpretq_s32_u32(vmovl_u16(vget_high_u16(low))));
+        vst1q_f32(out + i, vmulq_n_f32(vcvtq_f32_s32(v0), scale));
+        vst1q_f32(out + i + 4, vmulq_n_f32(vcvtq_f32_s32(v1), scale));
+    }
+    s24_to_f32_scalar(in + 3 * i, out + i, count - i, scale);
+}
+
+void s32_to_f32_neon(const uint8_t* in, float* out, size_t count, float scale) {
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        int32x4_t v = vreinterpretq_s32_u8(vld1q_u8(in + 4 * i));
+        vst1q_f32(out + i, vmulq_n_f32(vcvtq_f32_s32(v), scale));
+    }
+    s32_to_f32_scalar(in + 4 * i, out + i, count - i, scale);
+}
+
+// vld2/vld3/vld4直接按2-4声道拆分，更多声道走展开的标量循环
+void deinterleave_f32_neon(const float* in, float* const* out, size_t frames, int channels) {
+    size_t i = 0;
+    if (channels == 2) {
+        for (; i + 4 <= frames; i += 4) {
+            float32x4x2_t v = vld2q_f32(in + 2 * i);
+            vst1q_f32(out[0] + i, v.val[0]);
+            vst1q_f32(out[1] + i, v.val[1]);
+        }
+    } else if (channels == 3) {
+        for (; i + 4 <= frames; i += 4) {
+            float32x4x3_t v = vld3q_f32(in + 3 * i);
+            for (int c = 0; c < 3; ++c) vst1q_f32(out[c] + i, v.val[c]);
+        }
+    } else if (channels == 4) {
+        for (; i + 4 <= frames; i += 4) {
+            float32x4x4_t v = vld4q_f32(in + 4 * i);
+            for (int c = 0; c < 4; ++c) vst1q_f32(out[c] + i, v.val[c]);
+        }
+    }
+    deinterleave_from(in, out, i, frames, channels);
+}
+
+void interleave_f32_neon(const float* const* in, float* out, size_t frames, int channels) {
+    size_t i = 0;
+    if (channels == 2) {
+        for (; i + 4 <= frames; i += 4) {
+            float32x4x2_t v = {{vld1q_f32(in[0] + i), vld1q_f32(in[1] + i)}};
+            vst2q_f32(out + 2 * i, v);
+        }
+    } else if (channels == 3) {
+        for (; i + 4 <= frames; i += 4) {
+            float32x4x3_t v = {{vld1q_f32(in[0] + i), vld1q_f32(in[1] + i), vld1q_f32(in[2] + i)}};
+            vst3q_f32(out + 3 * i, v);
+        }
+    } else if (channels == 4) {
+        for (; i + 4 <= frames; i += 4) {
+            float32x4x4_t v = {{vld1q_f32(in[0] + i), vld1q_f32(in[1] + i), vld1q_f32(in[2] + i),
+                                vld1q_f32(in[3] + i)}};
+            vst4q_f32(out + 4 * i, v);
+        }
+    }
+    interleave_from(in, out, i, frames, channels);
+}
+
+void deinterleave_s16_neon(const int16_t* in, int16_t* const* out, size_t frames, int channels) {
+    size_t i = 0;
+    if (channels == 2) {
+        for (; i + 8 <= frames; i += 8) {
+            int16x8x2_t v = vld2q_s16(in + 2 * i);
+            vst1q_s16(out[0] + i, v.val[0]);
+            vst1q_s16(out[1] + i, v.val[1]);
+        }
+    } else if (channels == 3) {
+        for (; i + 8 <= frames; i += 8) {
+            int16x8x3_t v = vld3q_s16(in + 3 * i);
+            for (int c = 0; c < 3; ++c) vst1q_s16(out[c] + i, v.val[c]);
+        }
+    } else if (channels == 4) {
+        for (; i + 8 <= frames; i += 8) {
+            int16x8x4_t v = vld4q_s16(in + 4 * i);
+            for (int c = 0; c < 4; ++c) vst1q_s16(out[c] + i, v.val[c]);
+        }
+    }
+    deinterleave_from(in, out, i, frames, channels);
+}
+
+void interleave_s16_neon(const int16_t* const* in, int16_t* out, size_t frames, int channels) {
+    size_t i = 0;
+    if (channels == 2) {
+        for (; i + 8 <= frames; i += 8) {
+            int16x8x2_t v = {{vld1q_s16(in[0] + i), vld1q_s16(in[1] + i)}};
+            vst2q_s16(out + 2 * i, v);
+        }
+    } else if (channels == 3) {
+        for (; i + 8 <= frames; i += 8) {
+            int16x8x3_t v = {{vld1q_s16(in[0] + i), vld1q_s16(in[1] + i), vld1q_s16(in[2] + i)}};
+            vst3q_s16(out + 3 * i, v);
+        }
+    } else if (channels == 4) {
+        for (; i + 8 <= frames; i += 8) {
+            int16x8x4_t v = {{vld1q_s16(in[0] + i), vld1q_s16(in[1] + i), vld1q_s16(in[2] + i),
+                              vld1q_s16(in[3] + i)}};
+            vst4q_s16(out + 4 * i, v);
+        }
+    }
+    interleave_from(in, out, i, frames, channels);
+}
+#endif // SRV_KERNELS_NEON64
+
+// ---- 分发表 ----
+
+struct KernelTable {
+    Isa isa;
+    void (*s16_to_f32)(const int16_t*, float*, size_t, float);
+    void (*f32_to_s16)(const float*, int16_t*, size_t, float);
+    void (*f32_to_s16_dither)(const float*, int16_t*, size_t, float, DitherState*);
+    void (*s24_to_f32)(const uint8_t*, float*, size_t, float);
+    void (*s32_to_f32)(const uint8_t*, float*, size_t, float);
+    void (*deinterleave_f32)(const float*, float* const*, size_t, int);
+    void (*interleave_f32)(const float* const*, float*, size_t, int);
+    void (*deinterleave_s16)(const int16_t*, int16_t* const*, size_t, int);
+    void (*interleave_s16)(const int16_t* const*, int16_t*, size_t, int);
+};
+
+const KernelTable kScalarTable = {
+    Isa::SCALAR, s16_to_f32_scalar, f32_to_s16_scalar, f32_to_s16_dither_scalar, s24_to_f32_scalar,
+    s32_to_f32_scalar, deinterleave_f32_scalar, interleave_f32_scalar, deinterleave_s16_scalar,
+    interleave_s16_scalar};
+
+#if defined(SRV_KERNELS_SSE2)
+// SSE2没有pshufb，24位解包用标量
+const KernelTable kSse2Table = {
+    Isa::SSE2, s16_to_f32_sse2, f32_to_s16_sse2, f32_to_s16_dither_sse2, s24_to_f32_scalar,
+    s32_to_f32_sse2, deinterleave_f32_sse2, interleave_f32_sse2, deinterleave_s16_sse2,
+    interleave_s16_sse2};
+#endif
+
+#if defined(SRV_KERNELS_X86_DISPATCH)
+const KernelTable kSse41Table = {
+    Isa::SSE41, s16_to_f32_sse41, f32_to_s16_sse2, f32_to_s16_dither_sse2, s24_to_f32_sse41,
+    s32_to_f32_sse2, deinterleave_f32_sse2, interleave_f32_sse2, deinterleave_s16_sse2,
+    interleave_s16_sse2};
+
+// 交织是纯访存操作，256位版本没有收益，沿用SSE2实现
+const KernelTable kAvx2Table = {
+    Isa::AVX2, s16_to_f32_avx2, f32_to_s16_avx2, f32_to_s16_dither_avx2, s24_to_f32_avx2,
+    s32_to_f32_avx2, deinterleave_f32_sse2, interleave_f32_sse2, deinterleave_s16_sse2,
+    interleave_s16_sse2};
+#endif
+
+#if defined(SRV_KERNELS_NEON64)
+const KernelTable kNeonTable = {
+    Isa::NEON, s16_to_f32_neon, f32_to_s16_neon, f32_to_s16_dither_neon, s24_to_f32_neon,
+    s32_to_f32_neon, deinterleave_f32_neon, interleave_f32_neon, deinterleave_s16_neon,
+    interleave_s16_neon};
+#endif
+
+const KernelTable* find_table(Isa isa) {
+    switch (isa) {
+    case Isa::SCALAR:
+        return &kScalarTable;
+#if defined(SRV_KERNELS_SSE2)
+    case Isa::SSE2:
+        return &kSse2Table;
+#endif
+#if defined(SRV_KERNELS_X86_DISPATCH)
+    case Isa::SSE41:
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("sse4.1") ? &kSse41Table : nullptr;
+    case Isa::AVX2:
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2") ? &kAvx2Table : nullptr;
+#endif
+#if defined(SRV_KERNELS_NEON64)
+    case Isa::NEON:
+        return &kNeonTable;
+#endif
+    default:
+        return nullptr;
+    }
+}
+
+const KernelTable* detect_best_table() {
+    const Isa order[] = {Isa::AVX2, Isa::SSE41, Isa::SSE2, Isa::NEON};
+    for (Isa isa : order) {
+        if (const KernelTable* table = find_table(isa)) {
+            return table;
+        }
+    }
+    return &kScalarTable;
+}
+
+std::atomic<const KernelTable*>& active_table() {
+    static std::atomic<const KernelTable*> table(detect_best_table());
+    return table;
+}
+
+inline const KernelTable& kernels() {
+    return *active_table().load(std::memory_order_relaxed);
+}
+
+} // namespace
+
+const char* get_isa_name(Isa isa) {
+    switch (isa) {
+    case Isa::SCALAR: return "scalar";
+    case Isa::SSE2: return "SSE2";
+    case Isa::SSE41: return "SSE4.1";
+    case Isa::AVX2: return "AVX2";
+    case Isa::NEON: return "NEON";
+    }
+    return "unknown";
+}
+
+Isa get_active_isa() {
+    return kernels().isa;
+}
+
+bool is_isa_supported(Isa isa) {
+    return find_table(isa) != nullptr;
+}
+
+bool set_active_isa(Isa isa) {
+    const KernelTable* table = find_table(isa);
+    if (!table) {
+        return false;
+    }
+    active_table().store(table, std::memory_order_relaxed);
+    return true;
+}
+
+void s16_to_f32(const int16_t* in, float* out, size_t count, float scale) {
+    kernels().s16_to_f32(in, out, count, scale);
+}
+
+void f32_to_s16(const float* in, int16_t* out, size_t count, float scale) {
+    kernels().f32_to_s16(in, out, count, scale);
+}
+
+void init_dither(DitherState* state, uint32_t seed) {
+    // splitmix32式打散种子，保证8条序列互不相同且非零（xorshift的零状态不会离开零）
+    uint32_t x = seed;
+    for (int i = 0; i < 8; ++i) {
+        x += 0x9E3779B9u;
+        uint32_t z = x;
+        z = (z ^ (z >> 16)) * 0x85EBCA6Bu;
+        z = (z ^ (z >> 13)) * 0xC2B2AE35u;
+        z ^= z >> 16;
+        state->lanes[i] = z ? z : 0x6D2B79F5u;
+    }
+}
+
+void f32_to_s16_dither(const float* in, int16_t* out, size_t count, float scale, DitherState* state) {
+    kernels().f32_to_s16_dither(in, out, count, scale, state);
+}
+
+void s24_to_f32(const uint8_t* in, float* out, size_t count, float scale) {
+    kernels().s24_to_f32(in, out, count, scale);
+}
+
+void s32_to_f32(const uint8_t* in, float* out, size_t count, float scale) {
+    kernels().s32_to_f32(in, out, count, scale);
+}
+
+void deinterleave_f32(const float* in, float* const* out, size_t frames, int channels) {
+    kernels().deinterleave_f32(in, out, frames, channels);
+}
+
+void deinterleave_s16(const int16_t* in, int16_t* const* out, size_t frames, int channels) {
+    kernels().deinterleave_s16(in, out, frames, channels);
+}
+
+void interleave_f32(const float* const* in, float* out, size_t frames, int channels) {
+    kernels().interleave_f32(in, out, frames, channels);
+}
+
+void interleave_s16(const int16_t* const* in, int16_t* out, size_t frames, int channels) {
+    kernels().interleave_s16(in, out, frames, channels);
+}
+
+} // namespace kernels
+} // namespace srv
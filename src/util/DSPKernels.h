@@ -0,0 +1,180 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// 常用的向量化音频计算内核（NEON / SSE2，其余平台退回标量实现）
+// 格式转换和声道交织内核在运行时按CPU选择指令集（AVX2 / SSE4.1 / SSE2 / NEON / 标量）
+namespace srv {
+namespace kernels {
+
+// 指令集
+enum class Isa {
+    SCALAR,
+    SSE2,
+    SSE41,
+    AVX2,
+    NEON
+};
+
+// TPDF抖动的随机数状态，8条独立的xorshift32序列，样本i使用第i%8条
+struct DitherState {
+    uint32_t lanes[8];
+};
+
+// 4条SIMD通道的转置直接II型(TDF-II)二阶节，每条通道一个独立的二阶节（系数已除以a0）
+// y = b0*x + s1;  s1 = b1*x - a1*y + s2;  s2 = b2*x - a2*y
+struct BiquadLanes {
+    float b0[4], b1[4], b2[4], a1[4], a2[4];
+    float s1[4], s2[4];
+};
+
+/**
+ * 计算绝对值峰值
+ * @param samples 样本
+ * @param count 样本数
+ * @return max(|x|)
+ */
+float peak_abs(const float* samples, size_t count);
+
+/**
+ * 计算平方和
+ * @param samples 样本
+ * @param count 样本数
+ * @return sum(x^2)
+ */
+float sum_squares(const float* samples, size_t count);
+
+/**
+ * 一次遍历同时计算峰值和平方和
+ * @param samples 样本
+ * @param count 样本数
+ * @param peak 输出max(|x|)
+ * @param energy 输出sum(x^2)
+ */
+void peak_and_energy(const float* samples, size_t count, float* peak, float* energy);
+
+/**
+ * 计算16位样本的绝对值之和（先扩展到32位再取绝对值，-32768不会溢出）
+ * @param samples 样本
+ * @param count 样本数
+ * @return sum(|x|)
+ */
+uint64_t sum_abs_s16(const int16_t* samples, size_t count);
+
+/**
+ * 获取当前编译使用的指令集名称（上面几个固定编译期指令集的内核）
+ */
+const char* get_isa_name();
+
+/**
+ * 获取指令集名称
+ */
+const char* get_isa_name(Isa isa);
+
+/**
+ * 获取格式转换/交织内核当前使用的指令集（首次调用时按CPU检测最优）
+ */
+Isa get_active_isa();
+
+/**
+ * 检查指令集在本机和本次编译中是否可用
+ */
+bool is_isa_supported(Isa isa);
+
+/**
+ * 强制格式转换/交织内核使用指定指令集，供测试和基准对比；不要在处理过程中切换
+ * @param isa 指令集
+ * @return 是否支持
+ */
+bool set_active_isa(Isa isa);
+
+/**
+ * int16转float: out = in * scale
+ * @param in 输入样本
+ * @param out 输出样本
+ * @param count 样本数
+ * @param scale 缩放系数，如1/32768归一化到[-1, 1)
+ */
+void s16_to_f32(const int16_t* in, float* out, size_t count, float scale);
+
+/**
+ * float转int16: out = sat(round(in * scale))
+ * 四舍五入到最近偶数，超出范围饱和到[-32768, 32767]，NaN输出32767；各指令集结果逐位一致
+ * @param in 输入样本
+ * @param out 输出样本
+ * @param count 样本数
+ * @param scale 缩放系数，如32768把[-1, 1)还原到int16
+ */
+void f32_to_s16(const float* in, int16_t* out, size_t count, float scale);
+
+/**
+ * 初始化抖动状态
+ * @param state 状态
+ * @param seed 种子
+ */
+void init_dither(DitherState* state, uint32_t seed);
+
+/**
+ * 带TPDF抖动的float转int16: out = sat(round(in * scale + d))，d为(-1, 1)LSB三角分布噪声
+ * 把高精度信号重新量化到16位时用，避免低电平信号的量化失真
+ * @param in 输入样本
+ * @param out 输出样本
+ * @param count 样本数
+ * @param scale 缩放系数
+ * @param state 抖动状态，连续调用时保持噪声序列不重复
+ */
+void f32_to_s16_dither(const float* in, int16_t* out, size_t count, float scale, DitherState* state);
+
+/**
+ * 解包24位小端打包样本（每样本3字节）: out = int24 * scale
+ * @param in 输入字节，无对齐要求
+ * @param out 输出样本
+ * @param count 样本数
+ * @param scale 缩放系数，如1/8388608归一化到[-1, 1)
+ */
+void s24_to_f32(const uint8_t* in, float* out, size_t count, float scale);
+
+/**
+ * 解包32位小端整数样本: out = int32 * scale
+ * @param in 输入字节，无对齐要求
+ * @param out 输出样本
+ * @param count 样本数
+ * @param scale 缩放系数，如1/2147483648归一化到[-1, 1)
+ */
+void s32_to_f32(const uint8_t* in, float* out, size_t count, float scale);
+
+/**
+ * 二阶节级联（原位，无额外延迟）
+ * 4条通道按 通道l = 声道c + channels*流水级k 排布：每组内4/channels级二阶节串联（1声道4级、2声道各2级、4声道各1级）
+ * 最多4组连成一条流水线，后一级比前一级错后一个样本，同一步里所有级并行计算，各组互不等待
+ * 每次调用开始和结束时补齐/排空流水线，输出与输入逐样本对齐
+ * @param groups 依次串联的各组二阶节（状态跨调用保留）
+ * @param group_count 组数
+ * @param samples 交织样本（每帧channels个），原位处理
+ * @param frames 帧数
+ * @param channels 1、2或4
+ */
+void biquad_cascade(BiquadLanes* groups, size_t group_count, float* samples, size_t frames, int channels);
+
+/**
+ * 交织样本拆分为各声道平面（2-8声道有专门实现，其余声道数走通用循环）
+ * @param in 交织输入（frames*channels个样本）
+ * @param out 各声道输出，out[c]至少frames个样本
+ * @param frames 帧数
+ * @param channels 声道数
+ */
+void deinterleave_f32(const float* in, float* const* out, size_t frames, int channels);
+void deinterleave_s16(const int16_t* in, int16_t* const* out, size_t frames, int channels);
+
+/**
+ * 各声道平面合并为交织样本
+ * @param in 各声道输入，in[c]至少frames个样本
+ * @param out 交织输出（frames*channels个样本）
+ * @param frames 帧数
+ * @param channels 声道数
+ */
+void interleave_f32(const float* const* in, float* out, size_t frames, int channels);
+void interleave_s16(const int16_t* const* in, int16_t* out, size_t frames, int channels);
+
+} // namespace kernels
+} // namespace srv
@@ -0,0 +1,167 @@
+#include "EnergyVAD.h"
+#include "DSPKernels.h"
+#include <algorithm>
+#include <iostream>
+
+namespace srv {
+
+namespace {
+
+inline int64_t abs_sample(int16_t v) {
+    return v < 0 ? -static_cast<int64_t>(v) : v;
+}
+
+} // namespace
+
+EnergyVAD::EnergyVAD()
+    : threshold_(100)
+    , window_size_(160)
+    , min_silence_samples_(160)
+    , hop_size_(40)
+    , is_initialized_(false)
+    , next_(0)
+    , window_sum_(0)
+    , window_valid_(false)
+    , in_silence_(false)
+    , silence_start_(0)
+    , silent_samples_(0)
+    , refined_hops_(0)
+    , total_hops_(0)
+    , finished_(false) {
+}
+
+bool EnergyVAD::init(int threshold, int window_size, size_t min_silence_samples) {
+    // 参数验证
+    if (window_size <= 0) {
+        std::cerr << "EnergyVAD init failed: invalid parameters" << std::endl;
+        return false;
+    }
+
+    threshold_ = threshold;
+    window_size_ = window_size;
+    min_silence_samples_ = min_silence_samples;
+    // 步长越大整步判决越省，但跨越语音边界的步需要逐样本细化，取窗口的1/4
+    hop_size_ = std::max(1, std::min(64, window_size / 4));
+    is_initialized_ = true;
+
+    reset();
+    return true;
+}
+
+void EnergyVAD::reset() {
+    buffer_.clear();
+    next_ = 0;
+    window_sum_ = 0;
+    window_valid_ = false;
+    in_silence_ = false;
+    silence_start_ = 0;
+    silent_samples_ = 0;
+    refined_hops_ = 0;
+    total_hops_ = 0;
+    finished_ = false;
+    segments_.clear();
+}
+
+void EnergyVAD::emit_run(size_t start, size_t length, bool is_silent) {
+    if (is_silent) {
+        if (!in_silence_) {
+            // 开始静音
+            in_silence_ = true;
+            silence_start_ = start;
+        }
+        silent_samples_ += length;
+    } else if (in_silence_) {
+        // 结束静音，检查持续时间
+        if (start - silence_start_ >= min_silence_samples_) {
+            segments_.push_back({silence_start_, start});
+        }
+        in_silence_ = false;
+    }
+}
+
+void EnergyVAD::decide_full_hops(size_t total) {
+    const size_t hop = static_cast<size_t>(hop_size_);
+    const size_t window = static_cast<size_t>(window_size_);
+    // 平均幅度<=门限 等价于 窗口和<=门限*样本数，整数比较与逐样本求平均的结果完全一致
+    const int64_t limit = static_cast<int64_t>(threshold_) * window_size_;
+    const int16_t* p = buffer_.data();
+
+    while (next_ + hop + window <= total) {
+        if (!window_valid_) {
+            window_sum_ = static_cast<int64_t>(kernels::sum_abs_s16(p, window));
+            window_valid_ = true;
+        }
+
+        // 本步内各窗口都落在[h, h+W+B)内，且都包含[h+B, h+W)，据此得到窗口和的上下界
+        const int64_t head = static_cast<int64_t>(kernels::sum_abs_s16(p, hop));
+        const int64_t tail = static_cast<int64_t>(kernels::sum_abs_s16(p + window, hop));
+        const int64_t upper = window_sum_ + tail;
+        const int64_t lower = window_sum_ - head;
+
+        total_hops_++;
+        if (upper <= limit) {
+            emit_run(next_, hop, true);
+        } else if (lower > limit) {
+            emit_run(next_, hop, false);
+        } else {
+            // 上下界跨越门限，逐样本滑动细化
+            refined_hops_++;
+            int64_t sum = window_sum_;
+            for (size_t k = 0; k < hop; ++k) {
+                emit_run(next_ + k, 1, sum <= limit);
+                sum += abs_sample(p[k + window]) - abs_sample(p[k]);
+            }
+        }
+
+        window_sum_ += tail - head;
+        p += hop;
+        next_ += hop;
+    }
+
+    buffer_.erase(buffer_.begin(), buffer_.begin() + (p - buffer_.data()));
+}
+
+void EnergyVAD::process(const int16_t* samples, size_t count) {
+    if (!is_initialized_) {
+        std::cerr << "EnergyVAD not initialized" << std::endl;
+        return;
+    }
+    if (finished_) {
+        std::cerr << "EnergyVAD process failed: already finished, call reset() first" << std::endl;
+        return;
+    }
+
+    buffer_.insert(buffer_.end(), samples, samples + count);
+    decide_full_hops(next_ + buffer_.size());
+}
+
+void EnergyVAD::finish() {
+    if (!is_initialized_ || finished_) {
+        return;
+    }
+
+    // 末尾不足一个窗口的位置，窗口收缩到文件末尾，按实际样本数求平均
+    const size_t window = static_cast<size_t>(window_size_);
+    const size_t remaining = buffer_.size();
+    const int16_t* p = buffer_.data();
+    int64_t sum = static_cast<int64_t>(kernels::sum_abs_s16(p, std::min(window, remaining)));
+    for (size_t k = 0; k < remaining; ++k) {
+        const int64_t count = static_cast<int64_t>(std::min(window, remaining - k));
+        emit_run(next_ + k, 1, sum <= static_cast<int64_t>(threshold_) * count);
+        sum -= abs_sample(p[k]);
+        if (k + window < remaining) {
+            sum += abs_sample(p[k + window]);
+        }
+    }
+    next_ += remaining;
+    buffer_.clear();
+
+    // 处理末尾的静音
+    if (in_silence_ && next_ - silence_start_ >= min_silence_samples_) {
+        segments_.push_back({silence_start_, next_});
+    }
+    in_silence_ = false;
+    finished_ = true;
+}
+
+} // namespace srv
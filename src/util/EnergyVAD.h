@@ -0,0 +1,106 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// 流式能量静音检测：逐样本滑动窗口平均幅度阈值判决，O(n)实现
+namespace srv {
+
+class EnergyVAD {
+public:
+    // 静音段（样本下标，左闭右开）
+    struct Segment {
+        size_t start_sample;
+        size_t end_sample;
+    };
+
+private:
+    int threshold_;              // 平均幅度门限（int16量纲），窗口平均幅度<=门限判为静音
+    int window_size_;            // 滑动窗口长度（样本数）
+    size_t min_silence_samples_; // 最短静音段长度
+    int hop_size_;               // 判决步长，window_size_的约数
+    bool is_initialized_;
+
+    // 尚未判决完的样本，buffer_[0]对应绝对下标next_
+    std::vector<int16_t> buffer_;
+    size_t next_;                // 下一个待判决样本的绝对下标
+    int64_t window_sum_;         // 以next_开头的完整窗口内|x|之和
+    bool window_valid_;
+
+    bool in_silence_;
+    size_t silence_start_;
+    uint64_t silent_samples_;
+    uint64_t refined_hops_;      // 需要逐样本细化的步数
+    uint64_t total_hops_;
+    bool finished_;
+
+    std::vector<Segment> segments_;
+
+    void emit_run(size_t start, size_t length, bool is_silent);
+    void decide_full_hops(size_t total);
+
+public:
+    EnergyVAD();
+    ~EnergyVAD() = default;
+
+    /**
+     * 初始化
+     * @param threshold 平均幅度门限（int16量纲）
+     * @param window_size 滑动窗口长度（样本数）
+     * @param min_silence_samples 最短静音段长度（样本数）
+     * @return 是否初始化成功
+     */
+    bool init(int threshold = 100, int window_size = 160, size_t min_silence_samples = 160);
+
+    /**
+     * 输入一块样本，判决结果在窗口右侧样本到达后产生
+     * @param samples 16位PCM样本
+     * @param count 样本数
+     */
+    void process(const int16_t* samples, size_t count);
+
+    /**
+     * 输入结束，按剩余样本数收缩末尾窗口完成判决
+     */
+    void finish();
+
+    /**
+     * 重置状态和结果
+     */
+    void reset();
+
+    /**
+     * 检查是否已初始化
+     */
+    bool is_initialized() const { return is_initialized_; }
+
+    /**
+     * 已检测到的静音段
+     */
+    const std::vector<Segment>& get_segments() const { return segments_; }
+
+    /**
+     * 清空已取走的静音段
+     */
+    void clear_segments() { segments_.clear(); }
+
+    /**
+     * 已判决的样本数
+     */
+    size_t get_decided_samples() const { return next_; }
+
+    /**
+     * 判为静音的样本数
+     */
+    uint64_t get_silent_samples() const { return silent_samples_; }
+
+    /**
+     * 逐样本细化的步数占比 (0-1)
+     */
+    double get_refined_ratio() const { return total_hops_ ? static_cast<double>(refined_hops_) / total_hops_ : 0.0; }
+
+    int get_hop_size() const { return hop_size_; }
+    int get_window_size() const { return window_size_; }
+};
+
+} // namespace srv
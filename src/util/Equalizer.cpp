@@ -0,0 +1,340 @@
+#include "Equalizer.h"
+#include "DSPKernels.h"
+#include "FFTPlanRegistry.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace srv {
+
+Equalizer::Equalizer()
+    : fft_bits_(0)
+    , fft_size_(0)
+    , sample_rate_(48000.0)
+    , preamp_(1.0f)
+    , fft_plan_forward_(nullptr)
+    , fft_plan_backward_(nullptr)
+    , fft_spectrum_(nullptr)
+    , fft_real_(nullptr)
+    , input_fill_(0)
+    , fifo_read_(0)
+    , fifo_count_(0)
+    , skip_(0)
+    , is_initialized_(false) {
+}
+
+Equalizer::~Equalizer() {
+    cleanup();
+}
+
+bool Equalizer::init(int fft_bits, double sample_rate) {
+    cleanup();
+    if (fft_bits < 4 || fft_bits > 20 || sample_rate <= 0.0) {
+        std::cerr << "Equalizer init failed: invalid parameters" << std::endl;
+        return false;
+    }
+    fft_bits_ = fft_bits;
+    fft_size_ = 1 << fft_bits;
+    sample_rate_ = sample_rate;
+
+    // 分配FFTW缓冲区
+    // 原位变换：实数样本和半谱共用一块N/2+1个复数的缓冲区
+    fft_spectrum_ = fftwf_alloc_complex(fft_size_ / 2 + 1);
+    fft_real_ = reinterpret_cast<float*>(fft_spectrum_);
+    if (!fft_spectrum_) {
+        std::cerr << "Equalizer init failed: cannot allocate FFT buffer" << std::endl;
+        cleanup();
+        return false;
+    }
+
+    // 从注册表取共享的FFTW计划（实数FFT，计算量和访存约为复数FFT的一半）
+    fft_plan_forward_ = FFTPlanRegistry::instance().get_r2c(fft_size_, fft_real_, fft_spectrum_);
+    fft_plan_backward_ = FFTPlanRegistry::instance().get_c2r(fft_size_, fft_spectrum_, fft_real_);
+    if (!fft_plan_forward_ || !fft_plan_backward_) {
+        std::cerr << "Equalizer init failed: cannot create FFT plan" << std::endl;
+        cleanup();
+        return false;
+    }
+
+    // 创建窗口函数（Hann窗口）
+    window_.resize(fft_size_);
+    for (int i = 0; i < fft_size_; ++i) {
+        window_[i] = 0.5f - 0.5f * cos(2.0f * M_PI * i / (fft_size_ - 1));
+    }
+
+    // 初始化缓冲区
+    overlap_buffer_.assign(fft_size_ / 2, 0.0f);
+    input_buffer_.assign(fft_size_, 0.0f);
+    // 输出FIFO最多积压fft_size-1个延迟样本加一帧半的输出，取2倍fft_size（2的幂，按掩码回绕）
+    output_fifo_.assign(2 * fft_size_, 0.0f);
+    convert_buffer_.assign(fft_size_, 0.0f);
+    eq_response_.assign(fft_size_ / 2 + 1, 1.0f);
+    is_initialized_ = true;
+    reset();
+    return true;
+}
+
+void Equalizer::cleanup() {
+    // 计划归注册表所有，这里只放弃引用
+    fft_plan_forward_ = nullptr;
+    fft_plan_backward_ = nullptr;
+    if (fft_spectrum_) {
+        fftwf_free(fft_spectrum_);
+        fft_spectrum_ = nullptr;
+        fft_real_ = nullptr;
+    }
+    is_initialized_ = false;
+}
+
+float Equalizer::getAmpl(int val) {
+    if (val < 0)
+        return 0.0f; //-inf
+    if (val == 50)
+        return 1.0f;
+    if (val > 50)
+        return powf(val / 50.0f, 3.33f);
+    return powf(50.0f / (100 - val), 3.33f);
+}
+
+std::vector<float> Equalizer::calculateFreqs(int count, int minFreq, int maxFreq) {
+    std::vector<float> freqs(count);
+    const float l = powf(maxFreq / minFreq, 1.0f / (count - 1));
+    for (int i = 0; i < count; ++i)
+        freqs[i] = minFreq * powf(l, i);
+    return freqs;
+}
+
+// 创建EQ预设（8个频段，直接使用dB值）
+std::vector<float> Equalizer::createPreset(const std::string& preset_name) {
+    std::vector<float> db_values(8, 0.0f); // 默认所有频段为0dB
+    
+    if (preset_name == "flat") {
+        // 平坦响应 - 所有频段为0dB
+        db_values = {0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f};
+    } else if (preset_name == "bass_boost") {
+        // 低频增强
+        db_values = {12.0f, 8.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f};
+    } else if (preset_name == "treble_boost") {
+        // 高频增强
+        db_values = {0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 8.0f, 12.0f};
+    } else if (preset_name == "vocal_boost") {
+        // 人声增强
+        db_values = {-6.0f, 0.0f, 8.0f, 12.0f, 8.0f, 0.0f, 0.0f, 0.0f};
+    } else if (preset_name == "noise_reduction") {
+        // 噪声抑制
+        db_values = {-12.0f, -6.0f, 0.0f, 0.0f, 0.0f, -6.0f, -12.0f, -18.0f};
+    } else if (preset_name == "warm") {
+        // 温暖音色
+        db_values = {8.0f, 6.0f, 0.0f, -3.0f, -6.0f, -8.0f, -12.0f, -15.0f};
+    } else if (preset_name == "bright") {
+        // 明亮音色
+        db_values = {-15.0f, -12.0f, -8.0f, -6.0f, -3.0f, 0.0f, 6.0f, 8.0f};
+    } else if (preset_name == "rock") {
+        // 摇滚音色
+        db_values = {6.0f, 0.0f, -6.0f, 0.0f, 6.0f, 12.0f, 6.0f, 0.0f};
+    } else if (preset_name == "jazz") {
+        // 爵士音色
+        db_values = {3.0f, 6.0f, 8.0f, 6.0f, 3.0f, 0.0f, -3.0f, -6.0f};
+    } else if (preset_name == "heavy_bass") {
+        // 重低音（测试用）
+        db_values = {20.0f, 15.0f, 10.0f, 5.0f, 0.0f, 0.0f, 0.0f, 0.0f};
+    } else if (preset_name == "custom_test") {
+        // 自定义测试
+        db_values = {20.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f};
+    } else {
+        // 默认平坦
+        db_values = {0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f};
+    }
+    
+    return db_values;
+}
+
+std::vector<std::string> Equalizer::getPresetNames() {
+    return {"flat", "bass_boost", "treble_boost", "vocal_boost", "noise_reduction",
+            "warm", "bright", "rock", "jazz", "heavy_bass", "custom_test"};
+}
+
+void Equalizer::setEQdB(const std::vector<float>& db_values) {
+    if (!is_initialized_ || db_values.size() < 2) {
+        return;
+    }
+
+    // 计算频率
+    auto freqs = calculateFreqs(db_values.size());
+
+    // 计算每个频率点的增益
+    for (size_t i = 0; i < eq_response_.size(); ++i) {
+        double freq = static_cast<double>(i + 1) * sample_rate_ / fft_size_;
+        eq_response_[i] = interpolateGain(freqs, db_values, freq) * preamp_;
+    }
+}
+
+float Equalizer::interpolateGain(const std::vector<float>& freqs, const std::vector<float>& db_values, double freq) {
+    // 如果频率超出范围，使用边界值
+    if (freq < freqs[0]) {
+        return powf(10.0f, db_values[0] / 20.0f);
+    }
+    if (freq > freqs.back()) {
+        return powf(10.0f, db_values.back() / 20.0f);
+    }
+
+    // 找到所在频段进行插值
+    for (size_t j = 0; j < freqs.size() - 1; ++j) {
+        if (freq >= freqs[j] && freq <= freqs[j + 1]) {
+            // 线性插值
+            float p = static_cast<float>((freq - freqs[j]) / (freqs[j + 1] - freqs[j]));
+            float g1 = powf(10.0f, db_values[j] / 20.0f);  // dB转增益
+            float g2 = powf(10.0f, db_values[j + 1] / 20.0f);
+            return g1 * (1.0f - p) + g2 * p;
+        }
+    }
+    return 1.0f;
+}
+
+void Equalizer::setPreamp(float preamp) {
+    preamp_ = preamp;
+}
+
+void Equalizer::process_hop() {
+    const int hop_size = fft_size_ / 2;  // 50%重叠
+
+    // 应用窗口函数
+    for (int j = 0; j < fft_size_; ++j) {
+        fft_real_[j] = input_buffer_[j] * window_[j];
+    }
+
+    // 执行FFT
+    fftwf_execute_dft_r2c(fft_plan_forward_, fft_real_, fft_spectrum_);
+
+    // 应用EQ响应（实信号频谱共轭对称，只需处理非负频点）
+    const int bins = fft_size_ / 2 + 1;
+    for (int j = 0; j < bins; ++j) {
+        const float coeff = eq_response_[j];
+        fft_spectrum_[j][0] *= coeff;
+        fft_spectrum_[j][1] *= coeff;
+    }
+
+    // 执行IFFT
+    fftwf_execute_dft_c2r(fft_plan_backward_, fft_spectrum_, fft_real_);
+
+    // 重叠-相加，结果追加到输出FIFO
+    const float scale = 1.0f / fft_size_;
+    const size_t mask = output_fifo_.size() - 1;
+    size_t write = fifo_read_ + fifo_count_;
+    for (int j = 0; j < hop_size; ++j) {
+        output_fifo_[(write + j) & mask] = fft_real_[j] * scale + overlap_buffer_[j];
+
+        // 保存重叠部分
+        overlap_buffer_[j] = fft_real_[j + hop_size] * scale;
+    }
+    fifo_count_ += hop_size;
+
+    // 分析帧前移半帧，后半帧作为下一帧的前半部分
+    std::copy(input_buffer_.begin() + hop_size, input_buffer_.end(), input_buffer_.begin());
+    input_fill_ = hop_size;
+}
+
+void Equalizer::push_samples(const float* input, float* output, size_t count) {
+    const size_t mask = output_fifo_.size() - 1;
+    while (count > 0) {
+        const size_t take = std::min(count, static_cast<size_t>(fft_size_) - input_fill_);
+        // 先取走输入再写输出，input和output可以是同一块内存
+        if (input) {
+            std::copy(input, input + take, &input_buffer_[input_fill_]);
+            input += take;
+        } else {
+            std::fill(&input_buffer_[input_fill_], &input_buffer_[input_fill_] + take, 0.0f);
+        }
+        input_fill_ += take;
+        if (input_fill_ == static_cast<size_t>(fft_size_)) {
+            process_hop();
+        }
+
+        // 延迟为fft_size-1时FIFO中总有足够的样本
+        for (size_t i = 0; i < take; ++i) {
+            output[i] = output_fifo_[(fifo_read_ + i) & mask];
+        }
+        fifo_read_ = (fifo_read_ + take) & mask;
+        fifo_count_ -= take;
+        output += take;
+        count -= take;
+    }
+}
+
+void Equalizer::process(const float* input, float* output, size_t count) {
+    if (!is_initialized_) {
+        std::fill(output, output + count, 0.0f);
+        return;
+    }
+    push_samples(input, output, count);
+}
+
+size_t Equalizer::flush(float* output) {
+    if (!is_initialized_) {
+        return 0;
+    }
+    const size_t latency = get_latency();
+    push_samples(nullptr, output, latency);
+    reset();
+    return latency;
+}
+
+void Equalizer::append_s16(const float* samples, size_t count, std::vector<short>& output) {
+    // 丢弃流开头的延迟样本，输出与输入对齐
+    const size_t drop = static_cast<size_t>(std::min<uint64_t>(skip_, count));
+    skip_ -= drop;
+    const size_t written = output.size();
+    output.resize(written + count - drop);
+    kernels::f32_to_s16(samples + drop, output.data() + written, count - drop, 32768.0f);
+}
+
+void Equalizer::process(const short* input, size_t count, std::vector<short>& output) {
+    if (!is_initialized_) {
+        return;
+    }
+    while (count > 0) {
+        const size_t take = std::min(count, convert_buffer_.size());
+        kernels::s16_to_f32(input, convert_buffer_.data(), take, 1.0f / 32768.0f);
+        push_samples(convert_buffer_.data(), convert_buffer_.data(), take);
+        append_s16(convert_buffer_.data(), take, output);
+        input += take;
+        count -= take;
+    }
+}
+
+void Equalizer::flush(std::vector<short>& output) {
+    if (!is_initialized_) {
+        return;
+    }
+    // 补零冲出最后get_latency()个样本（含最后半帧的重叠部分）
+    const size_t latency = get_latency();
+    push_samples(nullptr, convert_buffer_.data(), latency);
+    append_s16(convert_buffer_.data(), latency, output);
+    reset();
+}
+
+void Equalizer::reset() {
+    std::fill(overlap_buffer_.begin(), overlap_buffer_.end(), 0.0f);
+    std::fill(input_buffer_.begin(), input_buffer_.end(), 0.0f);
+    input_fill_ = 0;
+
+    // 输出FIFO预置fft_size-1个零，即固定延迟
+    std::fill(output_fifo_.begin(), output_fifo_.end(), 0.0f);
+    fifo_read_ = 0;
+    fifo_count_ = get_latency();
+    skip_ = get_latency();
+}
+
+std::vector<short> Equalizer::processAudio(const std::vector<short>& input) {
+    std::vector<short> output;
+    if (!is_initialized_) {
+        return output;
+    }
+    output.reserve(input.size());
+    reset();
+    process(input.data(), input.size(), output);
+    flush(output);
+    return output;
+}
+
+} // namespace srv
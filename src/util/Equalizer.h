@@ -0,0 +1,151 @@
+#pragma once
+#include <fftw3.h>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// 基于QMPlay2的FFT均衡器：Hann窗50%重叠-相加，频域按频段增益插值
+// 输入是实信号，用r2c/c2r实数FFT，只处理N/2+1个非负频点
+namespace srv {
+
+class Equalizer {
+private:
+    int fft_bits_;
+    int fft_size_;
+    double sample_rate_;
+    float preamp_;
+
+    // FFTW计划（r2c: fft_real_ -> fft_spectrum_，c2r: fft_spectrum_ -> fft_real_），由FFTPlanRegistry共享
+    fftwf_plan fft_plan_forward_;
+    fftwf_plan fft_plan_backward_;
+    fftwf_complex* fft_spectrum_;   // fft_size_/2+1个频点
+    float* fft_real_;               // fft_size_个实数样本，与fft_spectrum_共用内存（原位变换）
+
+    // 窗口函数
+    std::vector<float> window_;
+
+    // EQ频率响应（fft_size_/2+1个频点，含直流和奈奎斯特）
+    std::vector<float> eq_response_;
+
+    // 重叠-相加缓冲区
+    std::vector<float> overlap_buffer_;
+
+    // 输入FIFO（当前分析帧，累积到fft_size_个样本才处理）
+    std::vector<float> input_buffer_;
+    size_t input_fill_;
+
+    // 输出FIFO（环形，2*fft_size_个样本），重置时预置get_latency()个零
+    std::vector<float> output_fifo_;
+    size_t fifo_read_;
+    size_t fifo_count_;
+
+    // short接口的格式转换缓冲区，以及流开头还要丢弃的延迟样本数
+    std::vector<float> convert_buffer_;
+    uint64_t skip_;
+
+    bool is_initialized_;
+
+    void cleanup();
+    void process_hop();
+    void push_samples(const float* input, float* output, size_t count);
+    void append_s16(const float* samples, size_t count, std::vector<short>& output);
+
+public:
+    Equalizer();
+    ~Equalizer();
+
+    Equalizer(const Equalizer&) = delete;
+    Equalizer& operator=(const Equalizer&) = delete;
+
+    /**
+     * 初始化
+     * @param fft_bits FFT点数的log2（10为1024点）
+     * @param sample_rate 采样率
+     * @return 是否初始化成功
+     */
+    bool init(int fft_bits = 10, double sample_rate = 48000.0);
+
+    // QMPlay2的getAmpl函数（滑块值0-100映射为幅度，50为1.0）
+    static float getAmpl(int val);
+
+    // 计算EQ频率（基于QMPlay2的freqs函数）
+    static std::vector<float> calculateFreqs(int count, int minFreq = 200, int maxFreq = 18000);
+
+    /**
+     * 频段曲线在freq处的线性增益：相邻频段之间按线性增益插值，范围外取边界频段
+     * @param freqs calculateFreqs(db_values.size())的结果
+     * @param db_values 各频段dB值
+     */
+    static float interpolateGain(const std::vector<float>& freqs, const std::vector<float>& db_values, double freq);
+
+    // 预设EQ（8个频段的dB值），未知名称返回平坦
+    static std::vector<float> createPreset(const std::string& preset_name);
+
+    // 预设名称列表
+    static std::vector<std::string> getPresetNames();
+
+    // 设置EQ频段dB值（直接输入dB值，更直观）
+    void setEQdB(const std::vector<float>& db_values);
+
+    // 设置预放大，下一次setEQdB时生效
+    void setPreamp(float preamp);
+
+    /**
+     * 流式处理（实时接口）：任意长度的块，输出与输入等长，固定延迟get_latency()个样本
+     * 稳态不分配内存，input和output可以是同一块内存
+     * @param input 输入样本（-1.0到1.0）
+     * @param output 输出样本，第i个输出对应get_latency()个样本之前的输入
+     * @param count 样本数
+     */
+    void process(const float* input, float* output, size_t count);
+
+    /**
+     * 输入结束：补零冲出延迟中的最后get_latency()个样本，然后清空状态
+     * @param output 输出缓冲区，至少get_latency()个样本
+     * @return 写出的样本数（即get_latency()）
+     */
+    size_t flush(float* output);
+
+    /**
+     * 流式处理（short接口）：去掉开头的延迟，输出追加到output末尾
+     * 输出比输入滞后，结束时调用flush取出剩余样本，总输出与总输入等长
+     * @param input 输入样本
+     * @param count 样本数
+     * @param output 输出追加到末尾
+     */
+    void process(const short* input, size_t count, std::vector<short>& output);
+
+    /**
+     * 输入结束：补零处理完剩余样本，然后清空状态
+     * @param output 输出追加到末尾
+     */
+    void flush(std::vector<short>& output);
+
+    /**
+     * 清空流式处理状态（保留EQ设置）
+     */
+    void reset();
+
+    /**
+     * 流式处理的固定延迟（样本数）：凑满一个分析帧才能输出前半帧，为fft_size-1
+     */
+    size_t get_latency() const { return fft_size_ > 0 ? static_cast<size_t>(fft_size_ - 1) : 0; }
+
+    /**
+     * 处理整段音频（基于QMPlay2的重叠-相加法），输出与输入等长
+     * 处理前清空流式状态，不同音频之间互不影响
+     */
+    std::vector<short> processAudio(const std::vector<short>& input);
+
+    /**
+     * 获取当前每个频点的增益（fft_size/2+1个，已乘预放大）
+     */
+    const std::vector<float>& get_response() const { return eq_response_; }
+
+    bool is_initialized() const { return is_initialized_; }
+    int get_fft_size() const { return fft_size_; }
+    double get_sample_rate() const { return sample_rate_; }
+};
+
+} // namespace srv
@@ -0,0 +1,200 @@
+#include "FFTPlanRegistry.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+namespace srv {
+
+FFTPlanRegistry::FFTPlanRegistry()
+    : planner_flags_(FFTW_MEASURE),
+      wisdom_loaded_(false),
+      planning_seconds_(0.0),
+      lookups_(0) {}
+
+FFTPlanRegistry::~FFTPlanRegistry() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& item : plans_) {
+        fftwf_destroy_plan(item.second);
+    }
+    plans_.clear();
+}
+
+FFTPlanRegistry& FFTPlanRegistry::instance() {
+    static FFTPlanRegistry registry;
+    return registry;
+}
+
+bool FFTPlanRegistry::init(const std::string& wisdom_path, unsigned planner_flags) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    planner_flags_ = planner_flags;
+    wisdom_path_ = wisdom_path;
+    wisdom_loaded_ = false;
+    saved_wisdom_.clear();
+    if (wisdom_path.empty()) {
+        return true;
+    }
+    FILE* file = std::fopen(wisdom_path.c_str(), "r");
+    if (!file) {
+        return true;
+    }
+    std::fclose(file);
+    if (!fftwf_import_wisdom_from_filename(wisdom_path.c_str())) {
+        std::cerr << "FFTPlanRegistry init failed: cannot parse wisdom " << wisdom_path << std::endl;
+        return false;
+    }
+    wisdom_loaded_ = true;
+    saved_wisdom_ = export_wisdom();
+    return true;
+}
+
+std::string FFTPlanRegistry::take_wisdom_arg(int& argc, char** argv) {
+    std::string path;
+    int out = 1;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--fft-wisdom") == 0 && i + 1 < argc) {
+            path = argv[++i];
+        } else {
+            argv[out++] = argv[i];
+        }
+    }
+    argc = out;
+    return path;
+}
+
+std::string FFTPlanRegistry::export_wisdom() {
+    char* text = fftwf_export_wisdom_to_string();
+    std::string wisdom = text ? text : "";
+    fftwf_free(text);
+    return wisdom;
+}
+
+bool FFTPlanRegistry::save_wisdom() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (wisdom_path_.empty()) {
+        return true;
+    }
+    // wisdom没有变化（所有计划都来自文件）时不重写
+    std::string wisdom = export_wisdom();
+    if (wisdom == saved_wisdom_) {
+        return true;
+    }
+    // 先写临时文件再改名，多个进程同时保存时不会留下半个文件
+    const std::string temp_path = wisdom_path_ + ".tmp";
+    FILE* file = std::fopen(temp_path.c_str(), "w");
+    const bool written = file && std::fwrite(wisdom.data(), 1, wisdom.size(), file) == wisdom.size();
+    if (file && std::fclose(file) != 0) {
+        file = nullptr;
+    }
+    if (!written || !file ||
+        std::rename(temp_path.c_str(), wisdom_path_.c_str()) != 0) {
+        std::cerr << "FFTPlanRegistry save failed: " << wisdom_path_ << std::endl;
+        std::remove(temp_path.c_str());
+        return false;
+    }
+    saved_wisdom_ = wisdom;
+    return true;
+}
+
+fftwf_plan FFTPlanRegistry::get_plan(Kind kind, int size, const void* in, const void* out) {
+    if (size <= 0 || !in || !out) {
+        return nullptr;
+    }
+    // 新数组接口要求执行时的缓冲区与规划时对齐方式相同
+    const bool in_place = in == out;
+    const int in_align = fftwf_alignment_of(reinterpret_cast<float*>(const_cast<void*>(in)));
+    const int out_align = fftwf_alignment_of(reinterpret_cast<float*>(const_cast<void*>(out)));
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    const Key key(static_cast<int>(kind), size, in_place, in_align, out_align, planner_flags_);
+    ++lookups_;
+    auto it = plans_.find(key);
+    if (it != plans_.end()) {
+        return it->second;
+    }
+
+    // 在临时缓冲区上规划（MEASURE会改写数组内容），按调用方的对齐偏移放置
+    const size_t complex_count = static_cast<size_t>(size / 2 + 1);
+    const size_t in_bytes = (kind == Kind::R2C ? 2 * complex_count * sizeof(float)
+                                               : static_cast<size_t>(size) * sizeof(fftwf_complex));
+    const size_t out_bytes = (kind == Kind::C2R ? 2 * complex_count * sizeof(float)
+                                                : static_cast<size_t>(size) * sizeof(fftwf_complex));
+    const size_t padding = 64;
+    char* in_block = static_cast<char*>(fftwf_malloc((in_place ? std::max(in_bytes, out_bytes) : in_bytes) + padding));
+    char* out_block = in_place ? nullptr : static_cast<char*>(fftwf_malloc(out_bytes + padding));
+    if (!in_block || (!in_place && !out_block)) {
+        fftwf_free(in_block);
+        fftwf_free(out_block);
+        return nullptr;
+    }
+    void* plan_in = in_block + in_align;
+    void* plan_out = in_place ? plan_in : static_cast<void*>(out_block + out_align);
+
+    auto start = std::chrono::steady_clock::now();
+    fftwf_plan plan = nullptr;
+    switch (kind) {
+        case Kind::FORWARD:
+        case Kind::BACKWARD:
+            plan = fftwf_plan_dft_1d(size, static_cast<fftwf_complex*>(plan_in), static_cast<fftwf_complex*>(plan_out),
+                                     kind == Kind::FORWARD ? FFTW_FORWARD : FFTW_BACKWARD, planner_flags_);
+            break;
+        case Kind::R2C:
+            plan = fftwf_plan_dft_r2c_1d(size, static_cast<float*>(plan_in), static_cast<fftwf_complex*>(plan_out),
+                                         planner_flags_);
+            break;
+        case Kind::C2R:
+            plan = fftwf_plan_dft_c2r_1d(size, static_cast<fftwf_complex*>(plan_in), static_cast<float*>(plan_out),
+                                         planner_flags_);
+            break;
+    }
+    planning_seconds_ += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    fftwf_free(in_block);
+    fftwf_free(out_block);
+
+    if (!plan) {
+        std::cerr << "FFTPlanRegistry: cannot create plan size=" << size << std::endl;
+        return nullptr;
+    }
+    plans_[key] = plan;
+    return plan;
+}
+
+fftwf_plan FFTPlanRegistry::get_dft(int size, int sign, fftwf_complex* in, fftwf_complex* out) {
+    return get_plan(sign == FFTW_FORWARD ? Kind::FORWARD : Kind::BACKWARD, size, in, out);
+}
+
+fftwf_plan FFTPlanRegistry::get_r2c(int size, float* in, fftwf_complex* out) {
+    return get_plan(Kind::R2C, size, in, out);
+}
+
+fftwf_plan FFTPlanRegistry::get_c2r(int size, fftwf_complex* in, float* out) {
+    return get_plan(Kind::C2R, size, in, out);
+}
+
+unsigned FFTPlanRegistry::get_planner_flags() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return planner_flags_;
+}
+
+bool FFTPlanRegistry::is_wisdom_loaded() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return wisdom_loaded_;
+}
+
+size_t FFTPlanRegistry::get_plan_count() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return plans_.size();
+}
+
+size_t FFTPlanRegistry::get_lookup_count() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return lookups_;
+}
+
+double FFTPlanRegistry::get_planning_seconds() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return planning_seconds_;
+}
+
+} // namespace srv
@@ -0,0 +1,113 @@
+#pragma once
+#include <fftw3.h>
+#include <cstddef>
+#include <map>
+#include <mutex>
+#include <string>
+#include <tuple>
+
+// 进程级FFTW计划注册表：同一种变换只规划一次，所有实例共享；规划串行化，支持wisdom文件
+namespace srv {
+
+/**
+ * FFTW的规划函数（fftwf_plan_*、fftwf_destroy_plan、wisdom读写）不是线程安全的，
+ * 而fftwf_execute_dft*新数组接口对同一个计划可以多线程并发调用。
+ * 注册表按（变换类型, 长度, 是否原位, 输入/输出对齐, 规划精度）缓存计划，规划全部在一把锁内完成，
+ * 调用方用fftwf_execute_dft / fftwf_execute_dft_r2c / fftwf_execute_dft_c2r传入自己的缓冲区执行。
+ * 规划在注册表内部的临时缓冲区上进行，FFTW_MEASURE/PATIENT不会改写调用方的数据。
+ * 计划归注册表所有，调用方不要fftwf_destroy_plan。
+ */
+class FFTPlanRegistry {
+public:
+    enum class Kind {
+        FORWARD,    // 复数正变换
+        BACKWARD,   // 复数逆变换（不归一化）
+        R2C,        // 实数正变换，输出N/2+1个频点
+        C2R         // 实数逆变换（不归一化，会改写输入）
+    };
+
+private:
+    // （类型, 长度, 是否原位, 输入对齐, 输出对齐, 规划标志）
+    // init改变规划精度后不会复用按旧精度规划的计划，旧计划仍归注册表所有，已取得的调用方可以继续用
+    using Key = std::tuple<int, int, bool, int, int, unsigned>;
+
+    mutable std::mutex mutex_;
+    std::map<Key, fftwf_plan> plans_;
+    unsigned planner_flags_;
+    std::string wisdom_path_;
+    bool wisdom_loaded_;
+    std::string saved_wisdom_;  // 文件中的wisdom，用于判断是否需要写回
+    double planning_seconds_;
+    size_t lookups_;
+
+    FFTPlanRegistry();
+    ~FFTPlanRegistry();
+
+    fftwf_plan get_plan(Kind kind, int size, const void* in, const void* out);
+    static std::string export_wisdom();
+
+public:
+    static FFTPlanRegistry& instance();
+
+    FFTPlanRegistry(const FFTPlanRegistry&) = delete;
+    FFTPlanRegistry& operator=(const FFTPlanRegistry&) = delete;
+
+    /**
+     * 设置规划精度并加载wisdom文件（程序启动时调用一次，不调用时为FFTW_MEASURE、无wisdom）
+     * @param wisdom_path wisdom文件路径，为空不加载；文件不存在不算失败，save_wisdom时创建
+     * @param planner_flags FFTW_ESTIMATE / FFTW_MEASURE / FFTW_PATIENT / FFTW_EXHAUSTIVE
+     * @return wisdom文件存在但无法解析时返回false（仍可继续使用，只是要重新规划）
+     */
+    bool init(const std::string& wisdom_path, unsigned planner_flags = FFTW_MEASURE);
+
+    /**
+     * 从命令行取出"--fft-wisdom FILE"（同dspctl），并从argv中删除这两项，其余参数顺序不变
+     * 测试程序默认不读写wisdom，只有显式指定时才在该路径生成文件
+     * @return wisdom文件路径，未指定时为空
+     */
+    static std::string take_wisdom_arg(int& argc, char** argv);
+
+    /**
+     * 把累积的wisdom写回init时指定的文件（与文件内容相同时不写）
+     * @return 是否成功，未指定文件时返回true
+     */
+    bool save_wisdom();
+
+    /**
+     * 复数变换计划
+     * @param sign FFTW_FORWARD或FFTW_BACKWARD
+     * @param in/out 执行时要用的缓冲区（或同样对齐、同样是否原位的缓冲区），只用于确定计划类型
+     * @return 失败返回nullptr
+     */
+    fftwf_plan get_dft(int size, int sign, fftwf_complex* in, fftwf_complex* out);
+
+    /**
+     * 实数正变换计划，in有size个实数，out有size/2+1个频点；原位时in需要2*(size/2+1)个实数的空间
+     */
+    fftwf_plan get_r2c(int size, float* in, fftwf_complex* out);
+
+    /**
+     * 实数逆变换计划，in有size/2+1个频点，out有size个实数
+     */
+    fftwf_plan get_c2r(int size, fftwf_complex* in, float* out);
+
+    unsigned get_planner_flags() const;
+    bool is_wisdom_loaded() const;
+
+    /**
+     * 已缓存的计划数
+     */
+    size_t get_plan_count() const;
+
+    /**
+     * 计划请求次数（含命中缓存的）
+     */
+    size_t get_lookup_count() const;
+
+    /**
+     * 累计规划耗时（秒），有wisdom时接近0
+     */
+    double get_planning_seconds() const;
+};
+
+} // namespace srv
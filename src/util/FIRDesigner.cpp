@@ -0,0 +1,203 @@
+#include "FIRDesigner.h"
+#include "Equalizer.h"
+#include "FFTPlanRegistry.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+
+namespace srv {
+
+FIRDesigner::FIRDesigner()
+    : length_(0)
+    , sample_rate_(48000.0)
+    , phase_(Phase::LINEAR)
+    , design_size_(0)
+    , plan_forward_(nullptr)
+    , plan_backward_(nullptr)
+    , design_real_(nullptr)
+    , design_spectrum_(nullptr)
+    , design_count_(0)
+    , cache_hits_(0)
+    , is_initialized_(false) {
+}
+
+FIRDesigner::~FIRDesigner() {
+    cleanup();
+}
+
+bool FIRDesigner::init(int length, double sample_rate, Phase phase) {
+    cleanup();
+    if (length < 16 || length > (1 << 18) || (length & (length - 1)) != 0 || sample_rate <= 0.0) {
+        std::cerr << "FIRDesigner init failed: invalid parameters" << std::endl;
+        return false;
+    }
+    length_ = length;
+    sample_rate_ = sample_rate;
+    phase_ = phase;
+    design_size_ = 4 * length;
+
+    design_real_ = fftwf_alloc_real(design_size_);
+    design_spectrum_ = fftwf_alloc_complex(design_size_ / 2 + 1);
+    if (!design_real_ || !design_spectrum_) {
+        std::cerr << "FIRDesigner init failed: cannot allocate FFT buffer" << std::endl;
+        cleanup();
+        return false;
+    }
+    plan_forward_ = FFTPlanRegistry::instance().get_r2c(design_size_, design_real_, design_spectrum_);
+    plan_backward_ = FFTPlanRegistry::instance().get_c2r(design_size_, design_spectrum_, design_real_);
+    if (!plan_forward_ || !plan_backward_) {
+        std::cerr << "FIRDesigner init failed: cannot create FFT plan" << std::endl;
+        cleanup();
+        return false;
+    }
+
+    // 线性相位用length-1点Tukey窗：中间一半平坦，两端各1/4余弦淡出
+    // 比整段Hann窗主瓣窄，200Hz附近的频段边缘不会被抹平
+    const int taps = length_ - 1;
+    const int taper = length_ / 4;
+    window_.assign(taps, 1.0f);
+    for (int n = 0; n < taper; ++n) {
+        const float w = 0.5f - 0.5f * cosf(static_cast<float>(M_PI) * (n + 1) / (taper + 1));
+        window_[n] = w;
+        window_[taps - 1 - n] = w;
+    }
+    is_initialized_ = true;
+    return true;
+}
+
+void FIRDesigner::cleanup() {
+    // 计划归注册表所有，这里只放弃引用
+    plan_forward_ = nullptr;
+    plan_backward_ = nullptr;
+    fftwf_free(design_real_);
+    fftwf_free(design_spectrum_);
+    design_real_ = nullptr;
+    design_spectrum_ = nullptr;
+    cache_.clear();
+    design_count_ = 0;
+    cache_hits_ = 0;
+    is_initialized_ = false;
+}
+
+uint64_t FIRDesigner::hash(const std::vector<float>& db_values, float preamp) {
+    uint64_t h = 14695981039346656037ULL;
+    auto mix = [&h](float value) {
+        uint32_t bits = 0;
+        std::memcpy(&bits, &value, sizeof(bits));
+        for (int i = 0; i < 4; ++i) {
+            h ^= (bits >> (8 * i)) & 0xff;
+            h *= 1099511628211ULL;
+        }
+    };
+    for (float db : db_values) {
+        mix(db);
+    }
+    mix(preamp);
+    return h;
+}
+
+const std::vector<float>& FIRDesigner::design(const std::vector<float>& db_values, float preamp) {
+    if (!is_initialized_ || db_values.size() < 2) {
+        return empty_;
+    }
+    const uint64_t key = hash(db_values, preamp);
+    auto it = cache_.find(key);
+    if (it != cache_.end() && it->second.db_values == db_values && it->second.preamp == preamp) {
+        ++cache_hits_;
+        return it->second.taps;
+    }
+
+    // 预设数量有限，缓存满了说明曲线在连续变化（如拖动滑块），整个清掉
+    if (cache_.size() >= kMaxCacheEntries) {
+        cache_.clear();
+    }
+    CacheEntry& entry = cache_[key];
+    entry.db_values = db_values;
+    entry.preamp = preamp;
+    entry.taps.assign(length_, 0.0f);
+    sample_curve(db_values, preamp, phase_ == Phase::MINIMUM);
+    if (phase_ == Phase::LINEAR) {
+        design_linear(entry.taps);
+    } else {
+        design_minimum(entry.taps);
+    }
+    ++design_count_;
+    return entry.taps;
+}
+
+void FIRDesigner::sample_curve(const std::vector<float>& db_values, float preamp, bool log_magnitude) {
+    // 在design_size_点的频率网格上采样目标幅度（零相位），最小相位设计用对数幅度（下限-100dB）
+    const int half = design_size_ / 2;
+    const auto freqs = Equalizer::calculateFreqs(db_values.size());
+    for (int k = 0; k <= half; ++k) {
+        const double freq = static_cast<double>(k) * sample_rate_ / design_size_;
+        const float gain = Equalizer::interpolateGain(freqs, db_values, freq) * preamp;
+        design_spectrum_[k][0] = log_magnitude ? logf(std::max(gain, 1e-5f)) : gain;
+        design_spectrum_[k][1] = 0.0f;
+    }
+}
+
+void FIRDesigner::design_linear(std::vector<float>& taps) {
+    // 零相位冲激响应（以0为中心循环对称）平移到中心D，截取length-1点并加窗
+    // 频率采样比FIR长4倍，截断只由窗决定，不会出现循环卷积混叠
+    fftwf_execute_dft_c2r(plan_backward_, design_spectrum_, design_real_);
+    const float scale = 1.0f / design_size_;
+    const int center = length_ / 2 - 1;
+    const int mask = design_size_ - 1;
+    for (int n = 0; n < length_ - 1; ++n) {
+        taps[n] = design_real_[(n - center) & mask] * scale * window_[n];
+    }
+    taps[length_ - 1] = 0.0f;
+}
+
+void FIRDesigner::design_minimum(std::vector<float>& taps) {
+    // 倒谱法：对数幅度谱 -> 实倒谱 -> 折叠为因果倒谱 -> 指数 -> IFFT
+    // 能量集中在开头，截断到length点的误差小，群延迟远小于同长度的线性相位FIR
+    const int M = design_size_;
+    const int half = M / 2;
+    fftwf_execute_dft_c2r(plan_backward_, design_spectrum_, design_real_);
+
+    // 实倒谱折叠：c[0]和c[M/2]不变，正倒频率加倍，负倒频率置零（同时做1/M归一化）
+    const float scale = 1.0f / M;
+    design_real_[0] *= scale;
+    for (int n = 1; n < half; ++n) {
+        design_real_[n] *= 2.0f * scale;
+    }
+    design_real_[half] *= scale;
+    std::fill(design_real_ + half + 1, design_real_ + M, 0.0f);
+
+    // 复对数谱取指数得到最小相位频谱
+    fftwf_execute_dft_r2c(plan_forward_, design_real_, design_spectrum_);
+    for (int k = 0; k <= half; ++k) {
+        const float magnitude = expf(design_spectrum_[k][0]);
+        const float phase = design_spectrum_[k][1];
+        design_spectrum_[k][0] = magnitude * cosf(phase);
+        design_spectrum_[k][1] = magnitude * sinf(phase);
+    }
+    fftwf_execute_dft_c2r(plan_backward_, design_spectrum_, design_real_);
+
+    // 截断到length点，最后length/4点用半个Hann窗淡出
+    const int taper = length_ / 4;
+    const int taper_start = length_ - taper;
+    for (int n = 0; n < length_; ++n) {
+        float w = 1.0f;
+        if (n >= taper_start) {
+            w = 0.5f + 0.5f * cosf(static_cast<float>(M_PI) * (n - taper_start) / taper);
+        }
+        taps[n] = design_real_[n] * scale * w;
+    }
+}
+
+void FIRDesigner::clear_cache() {
+    cache_.clear();
+}
+
+size_t FIRDesigner::get_group_delay() const {
+    if (!is_initialized_ || phase_ == Phase::MINIMUM) {
+        return 0;
+    }
+    return static_cast<size_t>(length_ / 2 - 1);
+}
+
+} // namespace srv
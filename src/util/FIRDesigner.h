@@ -0,0 +1,107 @@
+#pragma once
+#include <fftw3.h>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// EQ频段曲线 -> FIR系数设计器：线性相位（加窗频率采样）或最小相位（倒谱法），按预设缓存
+namespace srv {
+
+class FIRDesigner {
+public:
+    enum class Phase {
+        LINEAR,     // 对称FIR，群延迟恒定为get_group_delay()，无相位失真
+        MINIMUM     // 最小相位FIR，能量集中在开头，群延迟小但随频率变化
+    };
+
+private:
+    // 缓存项：保存完整的曲线用于比较，哈希碰撞时不会取错
+    struct CacheEntry {
+        std::vector<float> db_values;
+        float preamp;
+        std::vector<float> taps;
+    };
+
+    static const size_t kMaxCacheEntries = 32;
+
+    int length_;
+    double sample_rate_;
+    Phase phase_;
+    int design_size_;               // 设计用的FFT点数（4*length，频率采样足够密）
+
+    // FFTW计划（由FFTPlanRegistry共享）
+    fftwf_plan plan_forward_;       // design_real_ -> design_spectrum_
+    fftwf_plan plan_backward_;      // design_spectrum_ -> design_real_
+    float* design_real_;
+    fftwf_complex* design_spectrum_;
+    std::vector<float> window_;
+
+    std::unordered_map<uint64_t, CacheEntry> cache_;
+    std::vector<float> empty_;      // 失败时返回的空结果
+    size_t design_count_;
+    size_t cache_hits_;
+
+    bool is_initialized_;
+
+    void cleanup();
+    void sample_curve(const std::vector<float>& db_values, float preamp, bool log_magnitude);
+    void design_linear(std::vector<float>& taps);
+    void design_minimum(std::vector<float>& taps);
+
+public:
+    FIRDesigner();
+    ~FIRDesigner();
+
+    FIRDesigner(const FIRDesigner&) = delete;
+    FIRDesigner& operator=(const FIRDesigner&) = delete;
+
+    /**
+     * 初始化
+     * @param length FIR长度（2的幂，16以上）；线性相位时实际只用前length-1个系数（奇数长度，整数群延迟）
+     * @param sample_rate 采样率
+     * @param phase 相位类型
+     * @return 是否初始化成功
+     */
+    bool init(int length, double sample_rate = 48000.0, Phase phase = Phase::LINEAR);
+
+    /**
+     * 按频段曲线（Equalizer::calculateFreqs布局）设计FIR，相同曲线直接返回缓存
+     * @param db_values 各频段dB值，至少2个
+     * @param preamp 预放大（线性增益）
+     * @return length个系数；引用在下一次design或clear_cache之前有效，失败返回空
+     */
+    const std::vector<float>& design(const std::vector<float>& db_values, float preamp = 1.0f);
+
+    /**
+     * 曲线哈希（FNV-1a，覆盖所有dB值和预放大的位模式）
+     */
+    static uint64_t hash(const std::vector<float>& db_values, float preamp);
+
+    /**
+     * 清空缓存（缓存满kMaxCacheEntries项时也会自动清空）
+     */
+    void clear_cache();
+
+    /**
+     * 群延迟（样本数）：线性相位为length/2-1，最小相位为0（实际延迟随频率变化，低频处最大）
+     */
+    size_t get_group_delay() const;
+
+    bool is_initialized() const { return is_initialized_; }
+    int get_length() const { return length_; }
+    Phase get_phase() const { return phase_; }
+    size_t get_cache_size() const { return cache_.size(); }
+
+    /**
+     * 实际设计次数（未命中缓存）
+     */
+    size_t get_design_count() const { return design_count_; }
+
+    /**
+     * 命中缓存的次数
+     */
+    size_t get_cache_hits() const { return cache_hits_; }
+};
+
+} // namespace srv
@@ -0,0 +1,204 @@
+#include "FusedVAD.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+namespace srv {
+
+FusedVAD::FusedVAD()
+    : sample_rate_(16000)
+    , frame_size_(160)
+    , is_initialized_(false)
+    , energy_threshold_(100)
+    , speex_low_(30)
+    , speex_high_(90)
+    , rnnoise_threshold_(0.5f)
+    , history_frames_(10)
+    , history_pos_(0)
+    , history_count_(0)
+    , pending_frames_(0)
+    , sticky_frames_(20)
+    , sticky_left_(0)
+    , rnnoise_warm_(false)
+    , last_rnnoise_prob_(0.0f)
+    , last_tier_(Tier::ENERGY)
+    , last_raw_decision_(false)
+    , total_frames_(0)
+    , tier_frames_{0, 0, 0}
+    , rnnoise_runs_(0) {
+}
+
+bool FusedVAD::init(int sample_rate, int frame_size, const std::string& model_name) {
+    is_initialized_ = false;
+
+    // 参数验证
+    if (sample_rate <= 0 || frame_size <= 0) {
+        std::cerr << "FusedVAD init failed: invalid parameters" << std::endl;
+        return false;
+    }
+
+    if (!speex_vad_.init(sample_rate, frame_size)) {
+        std::cerr << "FusedVAD init failed: cannot create speex VAD" << std::endl;
+        return false;
+    }
+    if (!rnnoise_.init(model_name)) {
+        std::cerr << "FusedVAD init failed: cannot create RNNoise" << std::endl;
+        return false;
+    }
+    // VAD只需要概率，VOIP质量的重采样足够且开销很小
+    if (!resampler_.init(sample_rate, RNNoise::get_sample_rate(), 1, SPEEX_RESAMPLER_QUALITY_VOIP)) {
+        std::cerr << "FusedVAD init failed: cannot create resampler" << std::endl;
+        return false;
+    }
+
+    sample_rate_ = sample_rate;
+    frame_size_ = frame_size;
+    speex_frame_.assign(frame_size, 0);
+    float_frame_.assign(frame_size, 0.0f);
+    set_rnnoise_warmup(100, 200);
+    is_initialized_ = true;
+
+    reset();
+    return true;
+}
+
+void FusedVAD::set_speex_thresholds(int low, int high) {
+    speex_low_ = std::max(0, std::min(100, low));
+    speex_high_ = std::max(speex_low_, std::min(100, high));
+}
+
+bool FusedVAD::set_smoothing(int onset_frames, int hangover_frames, int min_speech_frames) {
+    return smoother_.init(onset_frames, hangover_frames, min_speech_frames);
+}
+
+void FusedVAD::set_rnnoise_warmup(int history_ms, int sticky_ms) {
+    const int frame_ms = 1000 * RNNoise::FRAME_SIZE / RNNoise::get_sample_rate();
+    history_frames_ = std::max(1, (history_ms + frame_ms - 1) / frame_ms);
+    sticky_frames_ = std::max(0, (sticky_ms * sample_rate_ / 1000 + frame_size_ - 1) / frame_size_);
+    history_.assign(static_cast<size_t>(history_frames_) * RNNoise::FRAME_SIZE, 0.0f);
+    history_pos_ = 0;
+    history_count_ = 0;
+    pending_frames_ = 0;
+    rnnoise_warm_ = false;
+}
+
+void FusedVAD::reset() {
+    speex_vad_.reset();
+    rnnoise_.reset();
+    resampler_.reset();
+    smoother_.reset();
+    fifo_48k_.clear();
+    history_pos_ = 0;
+    history_count_ = 0;
+    pending_frames_ = 0;
+    sticky_left_ = 0;
+    rnnoise_warm_ = false;
+    last_rnnoise_prob_ = 0.0f;
+    last_tier_ = Tier::ENERGY;
+    last_raw_decision_ = false;
+    total_frames_ = 0;
+    tier_frames_[0] = tier_frames_[1] = tier_frames_[2] = 0;
+    rnnoise_runs_ = 0;
+}
+
+void FusedVAD::feed_resampler(const spx_int16_t* frame) {
+    // 重采样器始终运行，保证RNNoise需要时48kHz历史是连续的
+    for (int i = 0; i < frame_size_; ++i) {
+        float_frame_[i] = frame[i];
+    }
+    resampler_.process(float_frame_.data(), static_cast<size_t>(frame_size_), fifo_48k_);
+
+    size_t consumed = 0;
+    while (fifo_48k_.size() - consumed >= static_cast<size_t>(RNNoise::FRAME_SIZE)) {
+        std::memcpy(&history_[static_cast<size_t>(history_pos_) * RNNoise::FRAME_SIZE],
+                    &fifo_48k_[consumed], RNNoise::FRAME_SIZE * sizeof(float));
+        history_pos_ = (history_pos_ + 1) % history_frames_;
+        history_count_ = std::min(history_count_ + 1, history_frames_);
+        consumed += RNNoise::FRAME_SIZE;
+
+        // 未送入RNNoise的帧超出历史容量，状态已不连续，下次调用需重置并回放
+        if (++pending_frames_ > history_frames_) {
+            pending_frames_ = history_frames_;
+            rnnoise_warm_ = false;
+        }
+    }
+    if (consumed > 0) {
+        fifo_48k_.erase(fifo_48k_.begin(), fifo_48k_.begin() + consumed);
+    }
+
+    if (sticky_left_ > 0) {
+        sticky_left_--;
+        if (rnnoise_warm_) {
+            run_rnnoise_pending();
+        }
+    }
+}
+
+void FusedVAD::run_rnnoise_pending() {
+    int count = pending_frames_;
+    if (!rnnoise_warm_) {
+        // 状态过期：重置后按时间顺序回放整个历史
+        rnnoise_.reset();
+        count = history_count_;
+    }
+
+    float scratch[RNNoise::FRAME_SIZE];
+    for (int k = count - 1; k >= 0; --k) {
+        int idx = (history_pos_ - 1 - k + 2 * history_frames_) % history_frames_;
+        last_rnnoise_prob_ = rnnoise_.process_frame(scratch, &history_[static_cast<size_t>(idx) * RNNoise::FRAME_SIZE]);
+        rnnoise_runs_++;
+    }
+    pending_frames_ = 0;
+    rnnoise_warm_ = true;
+}
+
+bool FusedVAD::decide_raw(const spx_int16_t* frame) {
+    // 第一级：平均幅度，整数比较避免除法
+    int64_t sum_abs = 0;
+    for (int i = 0; i < frame_size_; ++i) {
+        sum_abs += std::abs(static_cast<int>(frame[i]));
+    }
+    if (sum_abs <= static_cast<int64_t>(energy_threshold_) * frame_size_) {
+        last_tier_ = Tier::ENERGY;
+        return false;
+    }
+
+    // 第二级：Speex概率（speex_preprocess_run会修改输入，使用副本）
+    std::memcpy(speex_frame_.data(), frame, frame_size_ * sizeof(spx_int16_t));
+    speex_vad_.detect_voice_activity(speex_frame_.data(), frame_size_);
+    int prob = speex_vad_.get_speech_probability();
+    if (prob >= speex_high_ || prob <= speex_low_) {
+        last_tier_ = Tier::SPEEX;
+        return prob >= speex_high_;
+    }
+
+    // 第三级：RNNoise，重采样器启动延迟内还没有完整的48kHz帧时退回Speex中点
+    if (history_count_ == 0) {
+        last_tier_ = Tier::SPEEX;
+        return prob >= (speex_low_ + speex_high_) / 2;
+    }
+    run_rnnoise_pending();
+    sticky_left_ = sticky_frames_;
+    last_tier_ = Tier::RNNOISE;
+    return last_rnnoise_prob_ > rnnoise_threshold_;
+}
+
+bool FusedVAD::process_frame(const spx_int16_t* frame) {
+    if (!is_initialized_) {
+        std::cerr << "FusedVAD not initialized" << std::endl;
+        return false;
+    }
+    if (!frame) {
+        std::cerr << "FusedVAD process failed: invalid audio frame" << std::endl;
+        return false;
+    }
+
+    total_frames_++;
+    feed_resampler(frame);
+    last_raw_decision_ = decide_raw(frame);
+    tier_frames_[static_cast<int>(last_tier_)]++;
+    return smoother_.update(last_raw_decision_);
+}
+
+} // namespace srv
@@ -0,0 +1,158 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "VAD.h"
+#include "RNNoise.h"
+#include "Resampler.h"
+#include "VADSmoother.h"
+
+// 分级融合VAD：能量 → Speex概率 → RNNoise，按计算代价逐级判决，只有前级无法确定的帧才进入下一级
+namespace srv {
+
+class FusedVAD {
+public:
+    // 做出判决的级别
+    enum class Tier {
+        ENERGY = 0,   // 平均幅度低于门限，直接判为静音
+        SPEEX = 1,    // Speex概率足够高或足够低
+        RNNOISE = 2   // Speex概率处于模糊区间，由RNNoise判决
+    };
+
+private:
+    VAD speex_vad_;
+    RNNoise rnnoise_;
+    Resampler resampler_;       // 输入采样率 → 48kHz
+    VADSmoother smoother_;
+
+    int sample_rate_;
+    int frame_size_;
+    bool is_initialized_;
+
+    // 判决参数
+    int energy_threshold_;      // 平均幅度门限（int16量纲）
+    int speex_low_;             // Speex概率低于等于此值判为静音 (0-100)
+    int speex_high_;            // Speex概率高于等于此值判为语音 (0-100)
+    float rnnoise_threshold_;   // RNNoise概率高于此值判为语音 (0-1)
+
+    // RNNoise输入：48kHz样本FIFO和最近若干帧的环形历史
+    std::vector<float> fifo_48k_;
+    std::vector<float> history_;
+    int history_frames_;
+    int history_pos_;
+    int history_count_;
+    int pending_frames_;        // 历史中尚未送入RNNoise的帧数
+    int sticky_frames_;         // 调用RNNoise后继续保持其状态更新的帧数
+    int sticky_left_;
+    bool rnnoise_warm_;         // RNNoise状态是否与最新输入连续
+    float last_rnnoise_prob_;
+    std::vector<spx_int16_t> speex_frame_;
+    std::vector<float> float_frame_;
+
+    Tier last_tier_;
+    bool last_raw_decision_;
+
+    // 统计
+    uint64_t total_frames_;
+    uint64_t tier_frames_[3];
+    uint64_t rnnoise_runs_;     // RNNoise实际推理的48kHz帧数（含回放和保温）
+
+    void feed_resampler(const spx_int16_t* frame);
+    void run_rnnoise_pending();
+    bool decide_raw(const spx_int16_t* frame);
+
+public:
+    FusedVAD();
+    ~FusedVAD() = default;
+
+    /**
+     * 初始化
+     * @param sample_rate 输入采样率 (Hz)
+     * @param frame_size 帧大小 (样本数，通常对应10ms)
+     * @param model_name RNNoise模型名，为空使用内置模型
+     * @return 是否初始化成功
+     */
+    bool init(int sample_rate = 16000, int frame_size = 160, const std::string& model_name = "");
+
+    /**
+     * 处理一帧音频
+     * @param frame 音频帧 (frame_size个16位样本，不会被修改)
+     * @return 平滑后的判决，true表示语音
+     */
+    bool process_frame(const spx_int16_t* frame);
+
+    /**
+     * 设置能量级门限
+     * @param mean_abs 平均幅度门限（int16量纲），低于等于此值判为静音
+     */
+    void set_energy_threshold(int mean_abs) { energy_threshold_ = mean_abs; }
+
+    /**
+     * 设置Speex级判决区间，(low, high)之间的概率交给RNNoise
+     * @param low 低于等于此值判为静音 (0-100)
+     * @param high 高于等于此值判为语音 (0-100)
+     */
+    void set_speex_thresholds(int low, int high);
+
+    /**
+     * 设置RNNoise级门限
+     * @param threshold 语音概率门限 (0-1)
+     */
+    void set_rnnoise_threshold(float threshold) { rnnoise_threshold_ = threshold; }
+
+    /**
+     * 设置判决平滑参数
+     * @param onset_frames 进入语音状态需要的连续语音帧数
+     * @param hangover_frames 语音结束后保持的帧数
+     * @param min_speech_frames 语音段最短帧数
+     * @return 是否设置成功
+     */
+    bool set_smoothing(int onset_frames, int hangover_frames, int min_speech_frames);
+
+    /**
+     * 设置RNNoise状态管理参数
+     * @param history_ms 状态过期后重新调用前回放的历史时长（毫秒）
+     * @param sticky_ms 调用RNNoise后继续保持其状态更新的时长（毫秒）
+     */
+    void set_rnnoise_warmup(int history_ms, int sticky_ms);
+
+    /**
+     * 重置状态和统计
+     */
+    void reset();
+
+    /**
+     * 检查是否已初始化
+     */
+    bool is_initialized() const { return is_initialized_; }
+
+    /**
+     * 上一帧由哪一级做出判决
+     */
+    Tier get_last_tier() const { return last_tier_; }
+
+    /**
+     * 上一帧未经平滑的判决
+     */
+    bool get_last_raw_decision() const { return last_raw_decision_; }
+
+    /**
+     * 已处理的总帧数
+     */
+    uint64_t get_total_frames() const { return total_frames_; }
+
+    /**
+     * 由指定级别做出判决的帧数
+     */
+    uint64_t get_tier_frames(Tier tier) const { return tier_frames_[static_cast<int>(tier)]; }
+
+    /**
+     * RNNoise实际推理的48kHz帧数（含回放和保温）
+     */
+    uint64_t get_rnnoise_runs() const { return rnnoise_runs_; }
+
+    int get_frame_size() const { return frame_size_; }
+    int get_sample_rate() const { return sample_rate_; }
+};
+
+} // namespace srv
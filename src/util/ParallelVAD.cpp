@@ -0,0 +1,198 @@
+#include "ParallelVAD.h"
+#include "RNNoise.h"
+#include "VAD.h"
+#include <algorithm>
+#include <iostream>
+#include <thread>
+
+namespace srv {
+
+namespace {
+
+// 一个并行块：[begin, end)为本块负责的帧，[run_begin, begin)为预热帧
+struct ChunkRange {
+    size_t run_begin;
+    size_t begin;
+    size_t end;
+};
+
+} // namespace
+
+ParallelVAD::ParallelVAD()
+    : detector_(Detector::SPEEX)
+    , sample_rate_(16000)
+    , frame_size_(160)
+    , num_threads_(1)
+    , warmup_frames_(100)
+    , merge_gap_frames_(10)
+    , rnnoise_threshold_(0.5f)
+    , is_initialized_(false) {
+}
+
+bool ParallelVAD::init(Detector detector, int sample_rate, int num_threads, int warmup_ms,
+                       int merge_gap_ms, const std::string& model_name) {
+    // 参数验证
+    if (sample_rate <= 0 || num_threads < 0 || warmup_ms < 0 || merge_gap_ms < 0) {
+        std::cerr << "ParallelVAD init failed: invalid parameters" << std::endl;
+        return false;
+    }
+    if (detector == Detector::RNNOISE && sample_rate != RNNoise::get_sample_rate()) {
+        std::cerr << "ParallelVAD init failed: RNNoise requires " << RNNoise::get_sample_rate() << " Hz input" << std::endl;
+        return false;
+    }
+
+    detector_ = detector;
+    sample_rate_ = sample_rate;
+    frame_size_ = detector == Detector::RNNOISE ? RNNoise::FRAME_SIZE : sample_rate / 100;
+    if (frame_size_ <= 0) {
+        std::cerr << "ParallelVAD init failed: sample rate too low" << std::endl;
+        return false;
+    }
+    const int frame_ms = 1000 * frame_size_ / sample_rate;
+    warmup_frames_ = (warmup_ms + frame_ms - 1) / frame_ms;
+    merge_gap_frames_ = (merge_gap_ms + frame_ms - 1) / frame_ms;
+    model_name_ = model_name;
+    is_initialized_ = true;
+    set_num_threads(num_threads);
+    return true;
+}
+
+void ParallelVAD::set_num_threads(int num_threads) {
+    if (num_threads <= 0) {
+        num_threads = static_cast<int>(std::thread::hardware_concurrency());
+        if (num_threads <= 0) {
+            num_threads = 1;
+        }
+    }
+    num_threads_ = num_threads;
+}
+
+void ParallelVAD::run_chunk(const std::vector<short>& audio, size_t run_begin, size_t begin, size_t end,
+                            std::vector<Range>& silence) const {
+    VAD speex_vad;
+    RNNoise rnnoise;
+    if (detector_ == Detector::SPEEX ? !speex_vad.init(sample_rate_, frame_size_) : !rnnoise.init(model_name_)) {
+        std::cerr << "ParallelVAD chunk failed: cannot create detector" << std::endl;
+        return;
+    }
+
+    const size_t frame_size = static_cast<size_t>(frame_size_);
+    std::vector<spx_int16_t> speex_frame(frame_size);
+    std::vector<float> float_frame(frame_size);
+    bool in_silence = false;
+    size_t silence_start = 0;
+
+    for (size_t f = run_begin; f < end; ++f) {
+        // 末尾不足一帧时补零
+        const size_t offset = f * frame_size;
+        const size_t valid = std::min(frame_size, audio.size() - offset);
+
+        bool is_silent = false;
+        if (detector_ == Detector::SPEEX) {
+            std::copy(audio.begin() + offset, audio.begin() + offset + valid, speex_frame.begin());
+            std::fill(speex_frame.begin() + valid, speex_frame.end(), 0);
+            is_silent = speex_vad.detect_voice_activity(speex_frame.data(), frame_size_) == 0;
+        } else {
+            for (size_t j = 0; j < valid; ++j) {
+                float_frame[j] = static_cast<float>(audio[offset + j]);
+            }
+            std::fill(float_frame.begin() + valid, float_frame.end(), 0.0f);
+            is_silent = rnnoise.process_frame(float_frame.data(), float_frame.data()) <= rnnoise_threshold_;
+        }
+
+        if (f < begin) {
+            // 预热段，丢弃判决
+            continue;
+        }
+        if (is_silent && !in_silence) {
+            in_silence = true;
+            silence_start = f;
+        } else if (!is_silent && in_silence) {
+            in_silence = false;
+            silence.push_back({silence_start, f});
+        }
+    }
+    if (in_silence) {
+        silence.push_back({silence_start, end});
+    }
+}
+
+std::vector<ParallelVAD::Range> ParallelVAD::detect(const std::vector<short>& audio) const {
+    std::vector<Range> result;
+    if (!is_initialized_) {
+        std::cerr << "ParallelVAD not initialized" << std::endl;
+        return result;
+    }
+
+    const size_t frame_size = static_cast<size_t>(frame_size_);
+    const size_t num_frames = (audio.size() + frame_size - 1) / frame_size;
+    if (num_frames == 0) {
+        return result;
+    }
+
+    const size_t num_chunks = std::min(static_cast<size_t>(num_threads_), num_frames);
+    std::vector<ChunkRange> chunks(num_chunks);
+    for (size_t c = 0; c < num_chunks; ++c) {
+        chunks[c].begin = num_frames * c / num_chunks;
+        chunks[c].end = num_frames * (c + 1) / num_chunks;
+        chunks[c].run_begin = chunks[c].begin > static_cast<size_t>(warmup_frames_)
+                                  ? chunks[c].begin - warmup_frames_ : 0;
+    }
+
+    // 各块的静音段（帧下标）
+    std::vector<std::vector<Range>> chunk_silence(num_chunks);
+    std::vector<std::thread> threads;
+    threads.reserve(num_chunks);
+    for (size_t c = 0; c < num_chunks; ++c) {
+        threads.emplace_back([&, c]() {
+            run_chunk(audio, chunks[c].run_begin, chunks[c].begin, chunks[c].end, chunk_silence[c]);
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    // 块边界合并：前段在边界前gap帧内结束、后段在边界后gap帧内开始时视为同一静音段，
+    // 避免两侧状态不一致造成的短暂语音把静音段切开
+    const uint64_t gap = static_cast<uint64_t>(merge_gap_frames_);
+    std::vector<Range> merged;
+    for (size_t c = 0; c < num_chunks; ++c) {
+        const uint64_t boundary = chunks[c].begin;
+        for (size_t i = 0; i < chunk_silence[c].size(); ++i) {
+            const Range& seg = chunk_silence[c][i];
+            if (c > 0 && i == 0 && !merged.empty() &&
+                merged.back().end_sample + gap >= boundary && seg.start_sample <= boundary + gap) {
+                merged.back().end_sample = seg.end_sample;
+                continue;
+            }
+            merged.push_back(seg);
+        }
+    }
+
+    result.reserve(merged.size());
+    for (const auto& seg : merged) {
+        result.push_back({seg.start_sample * frame_size,
+                          std::min<uint64_t>(seg.end_sample * frame_size, audio.size())});
+    }
+    return result;
+}
+
+std::vector<ParallelVAD::Range> ParallelVAD::detect_serial(const std::vector<short>& audio) const {
+    std::vector<Range> result;
+    if (!is_initialized_) {
+        std::cerr << "ParallelVAD not initialized" << std::endl;
+        return result;
+    }
+
+    const size_t frame_size = static_cast<size_t>(frame_size_);
+    const size_t num_frames = (audio.size() + frame_size - 1) / frame_size;
+    std::vector<Range> silence;
+    run_chunk(audio, 0, 0, num_frames, silence);
+    for (const auto& seg : silence) {
+        result.push_back({seg.start_sample * frame_size,
+                          std::min<uint64_t>(seg.end_sample * frame_size, audio.size())});
+    }
+    return result;
+}
+
+} // namespace srv
@@ -0,0 +1,88 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "SegmentIndex.h"
+
+// 长录音离线并行VAD：按块切分到多核，每块独立的检测器状态带预热段，块边界处按迟滞规则合并静音段
+namespace srv {
+
+class ParallelVAD {
+public:
+    // 检测器类型
+    enum class Detector {
+        SPEEX,    // speex预处理器VAD，任意采样率，10ms帧
+        RNNOISE   // RNNoise VAD概率，要求48kHz，480样本帧
+    };
+
+    // 静音段（样本下标，左闭右开）
+    using Range = SegmentIndex::Range;
+
+private:
+    Detector detector_;
+    int sample_rate_;
+    int frame_size_;
+    int num_threads_;
+    int warmup_frames_;      // 每块预热帧数，判决丢弃，只用于让检测器状态收敛
+    int merge_gap_frames_;   // 块边界两侧间隔不超过此帧数的静音段合并
+    float rnnoise_threshold_;
+    std::string model_name_;
+    bool is_initialized_;
+
+    void run_chunk(const std::vector<short>& audio, size_t run_begin, size_t begin, size_t end,
+                   std::vector<Range>& silence) const;
+
+public:
+    ParallelVAD();
+    ~ParallelVAD() = default;
+
+    /**
+     * 初始化
+     * @param detector 检测器类型
+     * @param sample_rate 采样率 (Hz)，RNNOISE要求48000
+     * @param num_threads 并行块数（线程数），0表示使用全部核心
+     * @param warmup_ms 每块预热时长（毫秒）
+     * @param merge_gap_ms 块边界处合并静音段的最大间隔（毫秒）
+     * @param model_name RNNoise模型名，为空使用内置模型
+     * @return 是否初始化成功
+     */
+    bool init(Detector detector = Detector::SPEEX, int sample_rate = 16000, int num_threads = 0,
+              int warmup_ms = 1000, int merge_gap_ms = 100, const std::string& model_name = "");
+
+    /**
+     * 并行检测整段单声道音频中的静音段
+     * 末尾不足一帧的样本补零成帧，与detect_silence_speex一致
+     * @param audio 输入音频
+     * @return 静音段（样本下标）
+     */
+    std::vector<Range> detect(const std::vector<short>& audio) const;
+
+    /**
+     * 单线程顺序检测，作为并行结果的参照
+     * @param audio 输入音频
+     * @return 静音段（样本下标）
+     */
+    std::vector<Range> detect_serial(const std::vector<short>& audio) const;
+
+    /**
+     * 设置线程数
+     * @param num_threads 线程数，0表示使用全部核心
+     */
+    void set_num_threads(int num_threads);
+
+    /**
+     * 设置RNNoise判决门限
+     * @param threshold 语音概率门限 (0-1)
+     */
+    void set_rnnoise_threshold(float threshold) { rnnoise_threshold_ = threshold; }
+
+    /**
+     * 检查是否已初始化
+     */
+    bool is_initialized() const { return is_initialized_; }
+
+    int get_num_threads() const { return num_threads_; }
+    int get_frame_size() const { return frame_size_; }
+    int get_warmup_frames() const { return warmup_frames_; }
+};
+
+} // namespace srv
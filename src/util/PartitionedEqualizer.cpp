@@ -0,0 +1,296 @@
+#include "PartitionedEqualizer.h"
+#include "DSPKernels.h"
+#include "FFTPlanRegistry.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace srv {
+
+PartitionedEqualizer::PartitionedEqualizer()
+    : block_size_(0)
+    , fft_size_(0)
+    , filter_length_(0)
+    , partitions_(0)
+    , bins_(0)
+    , stride_(0)
+    , sample_rate_(48000.0)
+    , preamp_(1.0f)
+    , fft_plan_forward_(nullptr)
+    , fft_plan_backward_(nullptr)
+    , frame_(nullptr)
+    , time_buffer_(nullptr)
+    , accumulator_(nullptr)
+    , kernel_spectra_(nullptr)
+    , fdl_(nullptr)
+    , fdl_pos_(0)
+    , input_fill_(0)
+    , fifo_read_(0)
+    , fifo_count_(0)
+    , skip_(0)
+    , is_initialized_(false) {
+}
+
+PartitionedEqualizer::~PartitionedEqualizer() {
+    cleanup();
+}
+
+bool PartitionedEqualizer::init(int block_bits, int filter_bits, double sample_rate, FIRDesigner::Phase phase) {
+    cleanup();
+    if (block_bits < 4 || block_bits > 14 || filter_bits < block_bits || filter_bits > 18 || sample_rate <= 0.0) {
+        std::cerr << "PartitionedEqualizer init failed: invalid parameters" << std::endl;
+        return false;
+    }
+    block_size_ = 1 << block_bits;
+    fft_size_ = 2 * block_size_;
+    filter_length_ = 1 << filter_bits;
+    partitions_ = filter_length_ / block_size_;
+    bins_ = block_size_ + 1;
+    stride_ = (bins_ + 7) & ~7;
+    sample_rate_ = sample_rate;
+
+    // 全部用fftwf_alloc分配，每段频谱按stride_（64字节的整数倍）排列，
+    // 所以各段缓冲区的对齐方式相同，可以共用一个计划
+    frame_ = fftwf_alloc_real(fft_size_);
+    time_buffer_ = fftwf_alloc_real(fft_size_);
+    accumulator_ = fftwf_alloc_complex(stride_);
+    kernel_spectra_ = fftwf_alloc_complex(static_cast<size_t>(stride_) * partitions_);
+    fdl_ = fftwf_alloc_complex(static_cast<size_t>(stride_) * partitions_);
+    if (!frame_ || !time_buffer_ || !accumulator_ || !kernel_spectra_ || !fdl_) {
+        std::cerr << "PartitionedEqualizer init failed: cannot allocate FFT buffer" << std::endl;
+        cleanup();
+        return false;
+    }
+
+    FFTPlanRegistry& registry = FFTPlanRegistry::instance();
+    fft_plan_forward_ = registry.get_r2c(fft_size_, frame_, fdl_);
+    fft_plan_backward_ = registry.get_c2r(fft_size_, accumulator_, time_buffer_);
+    if (!fft_plan_forward_ || !fft_plan_backward_) {
+        std::cerr << "PartitionedEqualizer init failed: cannot create FFT plan" << std::endl;
+        cleanup();
+        return false;
+    }
+    if (!designer_.init(filter_length_, sample_rate, phase)) {
+        cleanup();
+        return false;
+    }
+
+    // 输出FIFO最多积压B-1个延迟样本加一块输出，取2B（2的幂，按掩码回绕）
+    output_fifo_.assign(fft_size_, 0.0f);
+    convert_buffer_.assign(fft_size_, 0.0f);
+
+    // 初始为平坦（单位冲激）
+    kernel_.assign(filter_length_, 0.0f);
+    kernel_[0] = 1.0f;
+    update_partitions();
+
+    is_initialized_ = true;
+    reset();
+    return true;
+}
+
+void PartitionedEqualizer::cleanup() {
+    // 计划归注册表所有，这里只放弃引用
+    fft_plan_forward_ = nullptr;
+    fft_plan_backward_ = nullptr;
+    fftwf_free(frame_);
+    fftwf_free(time_buffer_);
+    fftwf_free(accumulator_);
+    fftwf_free(kernel_spectra_);
+    fftwf_free(fdl_);
+    frame_ = nullptr;
+    time_buffer_ = nullptr;
+    accumulator_ = nullptr;
+    kernel_spectra_ = nullptr;
+    fdl_ = nullptr;
+    spectra_cache_.clear();
+    is_initialized_ = false;
+}
+
+void PartitionedEqualizer::setEQdB(const std::vector<float>& db_values) {
+    if (!is_initialized_ || db_values.size() < 2) {
+        return;
+    }
+    const size_t spectra_size = 2 * static_cast<size_t>(stride_) * partitions_;
+    float* spectra = &kernel_spectra_[0][0];
+
+    // 设计器自己按曲线缓存系数，命中时不重新设计
+    const std::vector<float>& taps = designer_.design(db_values, preamp_);
+    if (taps.empty()) {
+        return;
+    }
+    kernel_ = taps;
+
+    const uint64_t key = FIRDesigner::hash(db_values, preamp_);
+    auto it = spectra_cache_.find(key);
+    if (it != spectra_cache_.end() && it->second.db_values == db_values && it->second.preamp == preamp_) {
+        std::copy(it->second.spectra.begin(), it->second.spectra.end(), spectra);
+        return;
+    }
+    update_partitions();
+
+    if (spectra_cache_.size() >= kMaxCachedPresets) {
+        spectra_cache_.clear();
+    }
+    SpectraEntry& entry = spectra_cache_[key];
+    entry.db_values = db_values;
+    entry.preamp = preamp_;
+    entry.spectra.assign(spectra, spectra + spectra_size);
+}
+
+void PartitionedEqualizer::setPreamp(float preamp) {
+    preamp_ = preamp;
+}
+
+void PartitionedEqualizer::update_partitions() {
+    // 每段B个系数补零到2B做FFT，1/2B的IFFT归一化并入频谱
+    const float scale = 1.0f / fft_size_;
+    for (int p = 0; p < partitions_; ++p) {
+        for (int n = 0; n < block_size_; ++n) {
+            time_buffer_[n] = kernel_[p * block_size_ + n] * scale;
+        }
+        std::fill(time_buffer_ + block_size_, time_buffer_ + fft_size_, 0.0f);
+        fftwf_execute_dft_r2c(fft_plan_forward_, time_buffer_, kernel_spectra_ + static_cast<size_t>(p) * stride_);
+    }
+}
+
+void PartitionedEqualizer::process_block() {
+    // 当前块（连同上一块）的频谱写入延迟线最新位置
+    fdl_pos_ = (fdl_pos_ + 1) % partitions_;
+    fftwf_execute_dft_r2c(fft_plan_forward_, frame_, fdl_ + static_cast<size_t>(fdl_pos_) * stride_);
+
+    // 第p段FIR乘p块之前的输入频谱，累加
+    std::fill(&accumulator_[0][0], &accumulator_[0][0] + 2 * bins_, 0.0f);
+    int slot = fdl_pos_;
+    for (int p = 0; p < partitions_; ++p) {
+        const fftwf_complex* x = fdl_ + static_cast<size_t>(slot) * stride_;
+        const fftwf_complex* h = kernel_spectra_ + static_cast<size_t>(p) * stride_;
+        for (int k = 0; k < bins_; ++k) {
+            accumulator_[k][0] += x[k][0] * h[k][0] - x[k][1] * h[k][1];
+            accumulator_[k][1] += x[k][0] * h[k][1] + x[k][1] * h[k][0];
+        }
+        slot = slot > 0 ? slot - 1 : partitions_ - 1;
+    }
+    fftwf_execute_dft_c2r(fft_plan_backward_, accumulator_, time_buffer_);
+
+    // 重叠-保留：前B个是循环卷积的混叠部分，丢弃；后B个追加到输出FIFO
+    const size_t mask = output_fifo_.size() - 1;
+    const size_t write = fifo_read_ + fifo_count_;
+    for (int j = 0; j < block_size_; ++j) {
+        output_fifo_[(write + j) & mask] = time_buffer_[block_size_ + j];
+    }
+    fifo_count_ += block_size_;
+
+    // 当前块成为下一次的"上一块"
+    std::copy(frame_ + block_size_, frame_ + fft_size_, frame_);
+    input_fill_ = 0;
+}
+
+void PartitionedEqualizer::push_samples(const float* input, float* output, size_t count) {
+    const size_t mask = output_fifo_.size() - 1;
+    float* current = frame_ + block_size_;
+    while (count > 0) {
+        const size_t take = std::min(count, static_cast<size_t>(block_size_) - input_fill_);
+        // 先取走输入再写输出，input和output可以是同一块内存
+        if (input) {
+            std::copy(input, input + take, current + input_fill_);
+            input += take;
+        } else {
+            std::fill(current + input_fill_, current + input_fill_ + take, 0.0f);
+        }
+        input_fill_ += take;
+        if (input_fill_ == static_cast<size_t>(block_size_)) {
+            process_block();
+        }
+
+        // 延迟为B-1时FIFO中总有足够的样本
+        for (size_t i = 0; i < take; ++i) {
+            output[i] = output_fifo_[(fifo_read_ + i) & mask];
+        }
+        fifo_read_ = (fifo_read_ + take) & mask;
+        fifo_count_ -= take;
+        output += take;
+        count -= take;
+    }
+}
+
+void PartitionedEqualizer::process(const float* input, float* output, size_t count) {
+    if (!is_initialized_) {
+        std::fill(output, output + count, 0.0f);
+        return;
+    }
+    push_samples(input, output, count);
+}
+
+size_t PartitionedEqualizer::flush(float* output) {
+    if (!is_initialized_) {
+        return 0;
+    }
+    const size_t latency = get_latency();
+    push_samples(nullptr, output, latency);
+    reset();
+    return latency;
+}
+
+void PartitionedEqualizer::append_s16(const float* samples, size_t count, std::vector<short>& output) {
+    // 丢弃流开头的延迟样本，输出与输入对齐
+    const size_t drop = static_cast<size_t>(std::min<uint64_t>(skip_, count));
+    skip_ -= drop;
+    const size_t written = output.size();
+    output.resize(written + count - drop);
+    kernels::f32_to_s16(samples + drop, output.data() + written, count - drop, 32768.0f);
+}
+
+void PartitionedEqualizer::process(const short* input, size_t count, std::vector<short>& output) {
+    if (!is_initialized_) {
+        return;
+    }
+    while (count > 0) {
+        const size_t take = std::min(count, convert_buffer_.size());
+        kernels::s16_to_f32(input, convert_buffer_.data(), take, 1.0f / 32768.0f);
+        push_samples(convert_buffer_.data(), convert_buffer_.data(), take);
+        append_s16(convert_buffer_.data(), take, output);
+        input += take;
+        count -= take;
+    }
+}
+
+void PartitionedEqualizer::flush(std::vector<short>& output) {
+    if (!is_initialized_) {
+        return;
+    }
+    const size_t latency = get_latency();
+    push_samples(nullptr, convert_buffer_.data(), latency);
+    append_s16(convert_buffer_.data(), latency, output);
+    reset();
+}
+
+void PartitionedEqualizer::reset() {
+    if (!is_initialized_) {
+        return;
+    }
+    std::fill(frame_, frame_ + fft_size_, 0.0f);
+    std::fill(&fdl_[0][0], &fdl_[0][0] + 2 * static_cast<size_t>(stride_) * partitions_, 0.0f);
+    fdl_pos_ = 0;
+    input_fill_ = 0;
+
+    // 输出FIFO预置B-1个零，即固定延迟
+    std::fill(output_fifo_.begin(), output_fifo_.end(), 0.0f);
+    fifo_read_ = 0;
+    fifo_count_ = get_latency();
+    skip_ = get_latency();
+}
+
+std::vector<short> PartitionedEqualizer::processAudio(const std::vector<short>& input) {
+    std::vector<short> output;
+    if (!is_initialized_) {
+        return output;
+    }
+    output.reserve(input.size());
+    reset();
+    process(input.data(), input.size(), output);
+    flush(output);
+    return output;
+}
+
+} // namespace srv
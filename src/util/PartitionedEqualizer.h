@@ -0,0 +1,154 @@
+#pragma once
+#include <fftw3.h>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "FIRDesigner.h"
+
+// 均匀分割卷积均衡器：由setEQdB的频段曲线设计FIR（默认最小相位），
+// 按块长B把FIR切成若干段，用重叠-保留法加频域延迟线(FDL)做卷积
+// 延迟只取决于块长（B-1个样本），FIR可以很长，低频分辨率与FIR长度相同的FFT均衡器一致
+namespace srv {
+
+class PartitionedEqualizer {
+private:
+    // 一个预设的各段FIR频谱，切换回用过的预设时直接拷贝，不做FFT
+    struct SpectraEntry {
+        std::vector<float> db_values;
+        float preamp;
+        std::vector<float> spectra;     // partitions_*stride_个复数（实部虚部交替）
+    };
+
+    static const size_t kMaxCachedPresets = 32;
+
+    int block_size_;        // 块长B，也是每段FIR的长度
+    int fft_size_;          // 2B
+    int filter_length_;     // FIR长度L（B的整数倍）
+    int partitions_;        // L/B
+    int bins_;              // B+1个非负频点
+    int stride_;            // 每段频谱的存储间隔（按64字节对齐，保证各段缓冲区对齐方式相同）
+    double sample_rate_;
+    float preamp_;
+
+    // 块卷积的FFTW计划（由FFTPlanRegistry共享）
+    fftwf_plan fft_plan_forward_;   // frame_ -> 频谱
+    fftwf_plan fft_plan_backward_;  // accumulator_ -> time_buffer_
+
+    float* frame_;                  // 2B个样本：上一块 + 当前块
+    float* time_buffer_;            // 2B个样本：IFFT输出，后B个是本块的卷积结果
+    fftwf_complex* accumulator_;    // 频域累加结果
+    fftwf_complex* kernel_spectra_; // partitions_段FIR的频谱（已含1/2B归一化）
+    fftwf_complex* fdl_;            // 频域延迟线：最近partitions_块输入的频谱（环形）
+    int fdl_pos_;                   // 最新一块在fdl_中的位置
+
+    // FIR设计器（按预设缓存系数），当前FIR系数，以及按预设缓存的分段频谱
+    FIRDesigner designer_;
+    std::vector<float> kernel_;
+    std::unordered_map<uint64_t, SpectraEntry> spectra_cache_;
+
+    // 当前块已累积的样本数（frame_后半部分）
+    size_t input_fill_;
+
+    // 输出FIFO（环形，2B个样本），重置时预置get_latency()个零
+    std::vector<float> output_fifo_;
+    size_t fifo_read_;
+    size_t fifo_count_;
+
+    // short接口的格式转换缓冲区，以及流开头还要丢弃的延迟样本数
+    std::vector<float> convert_buffer_;
+    uint64_t skip_;
+
+    bool is_initialized_;
+
+    void cleanup();
+    void update_partitions();
+    void process_block();
+    void push_samples(const float* input, float* output, size_t count);
+    void append_s16(const float* samples, size_t count, std::vector<short>& output);
+
+public:
+    PartitionedEqualizer();
+    ~PartitionedEqualizer();
+
+    PartitionedEqualizer(const PartitionedEqualizer&) = delete;
+    PartitionedEqualizer& operator=(const PartitionedEqualizer&) = delete;
+
+    /**
+     * 初始化（EQ为平坦）
+     * @param block_bits 块长的log2（6为64点，7为128点），决定延迟
+     * @param filter_bits FIR长度的log2（12为4096点），决定频率分辨率，不小于block_bits
+     * @param sample_rate 采样率
+     * @param phase FIR相位：最小相位延迟低；线性相位无相位失真，但多get_group_delay()个样本的延迟
+     * @return 是否初始化成功
+     */
+    bool init(int block_bits = 7, int filter_bits = 12, double sample_rate = 48000.0,
+              FIRDesigner::Phase phase = FIRDesigner::Phase::MINIMUM);
+
+    /**
+     * 设置EQ频段dB值（频段布局与Equalizer相同）
+     * 新曲线要设计FIR（几次4L点FFT）并做分段FFT；用过的曲线（如在预设之间切换）只查表拷贝
+     */
+    void setEQdB(const std::vector<float>& db_values);
+
+    // 设置预放大，下一次setEQdB时生效
+    void setPreamp(float preamp);
+
+    /**
+     * 流式处理（实时接口）：任意长度的块，输出与输入等长，固定延迟get_latency()个样本
+     * 稳态不分配内存，input和output可以是同一块内存
+     */
+    void process(const float* input, float* output, size_t count);
+
+    /**
+     * 输入结束：补零冲出延迟中的最后get_latency()个样本，然后清空状态
+     * @param output 输出缓冲区，至少get_latency()个样本
+     * @return 写出的样本数（即get_latency()）
+     */
+    size_t flush(float* output);
+
+    /**
+     * 流式处理（short接口）：去掉开头的延迟，输出追加到output末尾
+     */
+    void process(const short* input, size_t count, std::vector<short>& output);
+
+    /**
+     * 输入结束：补零处理完剩余样本，然后清空状态
+     */
+    void flush(std::vector<short>& output);
+
+    /**
+     * 清空流式处理状态（保留EQ设置）
+     */
+    void reset();
+
+    /**
+     * 流式处理的固定延迟（样本数）：凑满一块才能输出，为block_size-1
+     * 不含FIR本身的群延迟，见get_group_delay()
+     */
+    size_t get_latency() const { return block_size_ > 0 ? static_cast<size_t>(block_size_ - 1) : 0; }
+
+    /**
+     * FIR本身的群延迟（样本数）：线性相位为filter_length/2-1；
+     * 最小相位为0（实际延迟随频率变化，集中在低频，通常只有几个到几十个样本）
+     */
+    size_t get_group_delay() const { return designer_.get_group_delay(); }
+
+    /**
+     * 处理整段音频，输出与输入等长，处理前清空流式状态
+     */
+    std::vector<short> processAudio(const std::vector<short>& input);
+
+    /**
+     * 当前FIR系数（filter_length个，已乘预放大）
+     */
+    const std::vector<float>& get_kernel() const { return kernel_; }
+
+    bool is_initialized() const { return is_initialized_; }
+    int get_block_size() const { return block_size_; }
+    int get_filter_length() const { return filter_length_; }
+    const FIRDesigner& get_designer() const { return designer_; }
+    double get_sample_rate() const { return sample_rate_; }
+};
+
+} // namespace srv
@@ -0,0 +1,69 @@
+#include "ProcessStats.h"
+#include <sys/resource.h>
+#include <time.h>
+#include <unistd.h>
+#include <cstdio>
+
+#ifdef __APPLE__
+#include <mach/mach.h>
+#endif
+
+namespace srv {
+
+size_t ProcessStats::get_current_rss_bytes() {
+#ifdef __APPLE__
+    mach_task_basic_info_data_t info;
+    mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+    if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO,
+                  reinterpret_cast<task_info_t>(&info), &count) != KERN_SUCCESS) {
+        return 0;
+    }
+    return static_cast<size_t>(info.resident_size);
+#else
+    // /proc/self/statm 第二列为常驻页数
+    FILE* f = std::fopen("/proc/self/statm", "r");
+    if (!f) {
+        return 0;
+    }
+    long pages_total = 0;
+    long pages_resident = 0;
+    int n = std::fscanf(f, "%ld %ld", &pages_total, &pages_resident);
+    std::fclose(f);
+    if (n != 2) {
+        return 0;
+    }
+    return static_cast<size_t>(pages_resident) * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#endif
+}
+
+size_t ProcessStats::get_peak_rss_bytes() {
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+#ifdef __APPLE__
+    // macOS下ru_maxrss单位为字节
+    return static_cast<size_t>(usage.ru_maxrss);
+#else
+    // Linux下ru_maxrss单位为KB
+    return static_cast<size_t>(usage.ru_maxrss) * 1024;
+#endif
+}
+
+double ProcessStats::get_thread_cpu_seconds() {
+    struct timespec ts;
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) != 0) {
+        return 0.0;
+    }
+    return static_cast<double>(ts.tv_sec) + static_cast<double>(ts.tv_nsec) * 1e-9;
+}
+
+double ProcessStats::get_process_cpu_seconds() {
+    struct timespec ts;
+    if (clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts) != 0) {
+        return 0.0;
+    }
+    return static_cast<double>(ts.tv_sec) + static_cast<double>(ts.tv_nsec) * 1e-9;
+}
+
+} // namespace srv
@@ -0,0 +1,34 @@
+#pragma once
+#include <cstddef>
+
+// 进程资源统计（内存/CPU），供各测试程序输出性能报告
+namespace srv {
+
+class ProcessStats {
+public:
+    /**
+     * 获取当前进程常驻内存 (RSS)
+     * @return 字节数，获取失败返回0
+     */
+    static size_t get_current_rss_bytes();
+
+    /**
+     * 获取进程运行以来的峰值常驻内存
+     * @return 字节数，获取失败返回0
+     */
+    static size_t get_peak_rss_bytes();
+
+    /**
+     * 获取当前线程已消耗的CPU时间
+     * @return 秒
+     */
+    static double get_thread_cpu_seconds();
+
+    /**
+     * 获取当前进程(所有线程)已消耗的CPU时间
+     * @return 秒
+     */
+    static double get_process_cpu_seconds();
+};
+
+} // namespace srv
@@ -0,0 +1,110 @@
+#include "RNNoise.h"
+#include "DSPKernels.h"
+#include <iostream>
+#include <algorithm>
+#include <cmath>
+
+namespace srv {
+
+RNNoise::RNNoise()
+    : state_(nullptr)
+    , registry_generation_(0)
+    , is_initialized_(false)
+    , model_swap_count_(0) {
+}
+
+RNNoise::~RNNoise() {
+    if (state_) {
+        rnnoise_destroy(state_);
+        state_ = nullptr;
+    }
+    // model_在state_之后释放，保证rnnoise_model_free晚于rnnoise_destroy
+}
+
+bool RNNoise::create_state(const std::shared_ptr<RNNoiseModel>& model) {
+    DenoiseState* state = rnnoise_create(model ? model->get() : nullptr);
+    if (!state) {
+        std::cerr << "RNNoise init failed: cannot create denoise state" << std::endl;
+        return false;
+    }
+
+    if (state_) {
+        rnnoise_destroy(state_);
+    }
+    state_ = state;
+    model_ = model;
+    return true;
+}
+
+bool RNNoise::init(const std::string& model_name) {
+    RNNoiseModelRegistry& registry = RNNoiseModelRegistry::instance();
+    model_name_ = model_name;
+    registry_generation_ = registry.get_generation();
+
+    std::shared_ptr<RNNoiseModel> model;
+    if (!model_name_.empty()) {
+        model = registry.acquire(model_name_);
+    }
+
+    is_initialized_ = create_state(model);
+    return is_initialized_;
+}
+
+bool RNNoise::init(const std::shared_ptr<RNNoiseModel>& model) {
+    model_name_.clear();
+    is_initialized_ = create_state(model);
+    return is_initialized_;
+}
+
+void RNNoise::check_model_update() {
+    RNNoiseModelRegistry& registry = RNNoiseModelRegistry::instance();
+    uint64_t generation = registry.get_generation();
+    if (generation == registry_generation_) {
+        return;
+    }
+    registry_generation_ = generation;
+
+    std::shared_ptr<RNNoiseModel> model = registry.acquire(model_name_);
+    if (model == model_) {
+        return;
+    }
+
+    // 在帧边界切换到新版本，旧模型在最后一个引用释放后卸载
+    if (create_state(model)) {
+        model_swap_count_++;
+    }
+}
+
+float RNNoise::process_frame(float* out, const float* in) {
+    if (!is_initialized_ || !state_) {
+        std::cerr << "RNNoise not initialized" << std::endl;
+        return 0.0f;
+    }
+
+    if (!model_name_.empty()) {
+        check_model_update();
+    }
+
+    return rnnoise_process_frame(state_, out, in);
+}
+
+float RNNoise::process_frame(short* out, const short* in) {
+    float frame[FRAME_SIZE];
+    kernels::s16_to_f32(in, frame, FRAME_SIZE, 1.0f);
+
+    float vad_prob = process_frame(frame, frame);
+
+    kernels::f32_to_s16(frame, out, FRAME_SIZE, 1.0f);
+    return vad_prob;
+}
+
+void RNNoise::reset() {
+    if (!is_initialized_ || !state_) {
+        return;
+    }
+
+    // rnnoise_init会清零整个状态，权重指针重新指向当前模型
+    rnnoise_init(state_, model_ ? model_->get() : nullptr);
+}
+
+} // namespace srv
@@ -0,0 +1,95 @@
+#pragma once
+#include <rnnoise.h>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include "RNNoiseModel.h"
+
+// RNNoise降噪/VAD流封装
+namespace srv {
+
+class RNNoise {
+private:
+    DenoiseState* state_;
+    std::shared_ptr<RNNoiseModel> model_;
+    std::string model_name_;       // 非空时跟随注册表中的同名模型热更新
+    uint64_t registry_generation_;
+    bool is_initialized_;
+    int model_swap_count_;
+
+    bool create_state(const std::shared_ptr<RNNoiseModel>& model);
+    void check_model_update();
+
+public:
+    // RNNoise固定帧长：48kHz下10ms
+    static constexpr int FRAME_SIZE = 480;
+
+    RNNoise();
+    ~RNNoise();
+
+    RNNoise(const RNNoise&) = delete;
+    RNNoise& operator=(const RNNoise&) = delete;
+
+    /**
+     * 初始化RNNoise
+     * @param model_name 注册表中的模型名，为空时使用内置模型；
+     *                   模型尚未发布时先使用内置模型，发布后自动切换
+     * @return 是否初始化成功
+     */
+    bool init(const std::string& model_name = "");
+
+    /**
+     * 使用指定模型初始化（不参与热更新）
+     * @param model 模型，nullptr表示内置模型
+     * @return 是否初始化成功
+     */
+    bool init(const std::shared_ptr<RNNoiseModel>& model);
+
+    /**
+     * 处理一帧音频
+     * @param out 输出帧 (get_frame_size()个样本，int16量纲的float)
+     * @param in 输入帧，可与out相同
+     * @return VAD语音概率 (0-1)
+     */
+    float process_frame(float* out, const float* in);
+
+    /**
+     * 处理一帧16位PCM音频
+     * @param out 输出帧 (get_frame_size()个样本)
+     * @param in 输入帧，可与out相同
+     * @return VAD语音概率 (0-1)
+     */
+    float process_frame(short* out, const short* in);
+
+    /**
+     * 重置降噪状态（保留当前模型）
+     */
+    void reset();
+
+    /**
+     * 检查是否已初始化
+     */
+    bool is_initialized() const { return is_initialized_; }
+
+    /**
+     * 当前使用的模型版本，内置模型返回0
+     */
+    uint64_t get_model_version() const { return model_ ? model_->get_version() : 0; }
+
+    /**
+     * 运行期间发生的模型切换次数
+     */
+    int get_model_swap_count() const { return model_swap_count_; }
+
+    /**
+     * 获取帧大小（48kHz下10ms，480样本）
+     */
+    static int get_frame_size() { return FRAME_SIZE; }
+
+    /**
+     * 获取采样率
+     */
+    static int get_sample_rate() { return 48000; }
+};
+
+} // namespace srv
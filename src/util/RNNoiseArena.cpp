@@ -0,0 +1,203 @@
+#include "RNNoiseArena.h"
+#include <sys/mman.h>
+#include <iostream>
+
+#ifdef __APPLE__
+#include <mach/vm_statistics.h>
+#endif
+
+namespace srv {
+
+namespace {
+
+const size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+size_t round_up(size_t value, size_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+// 分配匿名内存，优先大页；返回的地址至少按页对齐
+void* map_slab(size_t bytes, bool want_huge_pages, bool* got_huge_pages) {
+    *got_huge_pages = false;
+    void* memory = MAP_FAILED;
+
+    if (want_huge_pages) {
+#if defined(__linux__) && defined(MAP_HUGETLB)
+        // 显式大页需要系统预留hugetlbfs页，失败后再尝试透明大页
+        memory = mmap(nullptr, bytes, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (memory != MAP_FAILED) {
+            *got_huge_pages = true;
+            return memory;
+        }
+#elif defined(__APPLE__) && defined(VM_FLAGS_SUPERPAGE_SIZE_2MB)
+        // macOS仅在x86_64上支持2MB超级页
+        memory = mmap(nullptr, bytes, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANON, VM_FLAGS_SUPERPAGE_SIZE_2MB, 0);
+        if (memory != MAP_FAILED) {
+            *got_huge_pages = true;
+            return memory;
+        }
+#endif
+    }
+
+    memory = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (memory == MAP_FAILED) {
+        return nullptr;
+    }
+
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+    if (want_huge_pages && madvise(memory, bytes, MADV_HUGEPAGE) == 0) {
+        *got_huge_pages = true;
+    }
+#endif
+    return memory;
+}
+
+} // namespace
+
+RNNoiseArena::RNNoiseArena()
+    : free_list_(nullptr)
+    , slot_size_(0)
+    , slots_per_slab_(0)
+    , capacity_(0)
+    , in_use_(0)
+    , use_huge_pages_(false)
+    , is_initialized_(false) {
+}
+
+RNNoiseArena::~RNNoiseArena() {
+    if (in_use_ > 0) {
+        std::cerr << "RNNoiseArena destroyed with " << in_use_ << " states still in use" << std::endl;
+    }
+    release_all_slabs();
+}
+
+void RNNoiseArena::release_all_slabs() {
+    for (const auto& slab : slabs_) {
+        munmap(slab.memory, slab.bytes);
+    }
+    slabs_.clear();
+    free_list_ = nullptr;
+    capacity_ = 0;
+    in_use_ = 0;
+}
+
+bool RNNoiseArena::init(size_t slots_per_slab, bool use_huge_pages,
+                        const std::shared_ptr<RNNoiseModel>& model) {
+    // 如果已经初始化，先清理
+    release_all_slabs();
+
+    if (slots_per_slab == 0) {
+        std::cerr << "RNNoiseArena init failed: invalid parameters" << std::endl;
+        return false;
+    }
+
+    slot_size_ = round_up(static_cast<size_t>(rnnoise_get_size()), CACHE_LINE_SIZE);
+    slots_per_slab_ = slots_per_slab;
+    use_huge_pages_ = use_huge_pages;
+    model_ = model;
+    is_initialized_ = true;
+
+    if (!grow()) {
+        is_initialized_ = false;
+        return false;
+    }
+    return true;
+}
+
+bool RNNoiseArena::grow() {
+    size_t bytes = slot_size_ * slots_per_slab_;
+    if (use_huge_pages_) {
+        bytes = round_up(bytes, HUGE_PAGE_SIZE);
+    }
+
+    bool got_huge_pages = false;
+    void* memory = map_slab(bytes, use_huge_pages_, &got_huge_pages);
+    if (!memory) {
+        std::cerr << "RNNoiseArena grow failed: cannot map " << bytes << " bytes" << std::endl;
+        return false;
+    }
+
+    // 按大页取整后多出的空间也切成槽位
+    size_t slots = bytes / slot_size_;
+    char* base = static_cast<char*>(memory);
+    // 逆序入栈，使acquire按地址递增顺序返回槽位
+    for (size_t i = slots; i > 0; --i) {
+        FreeSlot* slot = reinterpret_cast<FreeSlot*>(base + (i - 1) * slot_size_);
+        slot->next = free_list_;
+        free_list_ = slot;
+    }
+
+    slabs_.push_back({memory, bytes, got_huge_pages});
+    capacity_ += slots;
+    return true;
+}
+
+bool RNNoiseArena::reserve(size_t capacity) {
+    if (!is_initialized_) {
+        std::cerr << "RNNoiseArena not initialized" << std::endl;
+        return false;
+    }
+    while (capacity_ < capacity) {
+        if (!grow()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+DenoiseState* RNNoiseArena::acquire() {
+    if (!is_initialized_) {
+        std::cerr << "RNNoiseArena not initialized" << std::endl;
+        return nullptr;
+    }
+
+    if (!free_list_ && !grow()) {
+        return nullptr;
+    }
+
+    FreeSlot* slot = free_list_;
+    free_list_ = slot->next;
+
+    DenoiseState* state = reinterpret_cast<DenoiseState*>(slot);
+    if (rnnoise_init(state, model_ ? model_->get() : nullptr) != 0) {
+        std::cerr << "RNNoiseArena acquire failed: rnnoise_init error" << std::endl;
+        slot->next = free_list_;
+        free_list_ = slot;
+        return nullptr;
+    }
+
+    in_use_++;
+    return state;
+}
+
+void RNNoiseArena::release(DenoiseState* state) {
+    if (!state) {
+        return;
+    }
+
+    FreeSlot* slot = reinterpret_cast<FreeSlot*>(state);
+    slot->next = free_list_;
+    free_list_ = slot;
+    in_use_--;
+}
+
+void RNNoiseArena::reset(DenoiseState* state) {
+    if (!state) {
+        return;
+    }
+    rnnoise_init(state, model_ ? model_->get() : nullptr);
+}
+
+size_t RNNoiseArena::get_huge_page_slab_count() const {
+    size_t count = 0;
+    for (const auto& slab : slabs_) {
+        if (slab.huge_pages) {
+            count++;
+        }
+    }
+    return count;
+}
+
+} // namespace srv
@@ -0,0 +1,112 @@
+#pragma once
+#include <rnnoise.h>
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include "RNNoiseModel.h"
+
+// RNNoise状态内存池：大量DenoiseState连续放置在按缓存行对齐的slab中
+namespace srv {
+
+/**
+ * DenoiseState内存池
+ * 非线程安全，多线程场景下每个工作线程使用各自的内存池
+ */
+class RNNoiseArena {
+private:
+    struct Slab {
+        void* memory;
+        size_t bytes;
+        bool huge_pages;
+    };
+
+    // 空闲槽位构成侵入式单链表，next指针直接写在空闲槽位的首字节处
+    struct FreeSlot {
+        FreeSlot* next;
+    };
+
+    std::vector<Slab> slabs_;
+    FreeSlot* free_list_;
+    std::shared_ptr<RNNoiseModel> model_;
+    size_t slot_size_;
+    size_t slots_per_slab_;
+    size_t capacity_;
+    size_t in_use_;
+    bool use_huge_pages_;
+    bool is_initialized_;
+
+    bool grow();
+    void release_all_slabs();
+
+public:
+    // 槽位对齐粒度
+    static constexpr size_t CACHE_LINE_SIZE = 64;
+
+    RNNoiseArena();
+    ~RNNoiseArena();
+
+    RNNoiseArena(const RNNoiseArena&) = delete;
+    RNNoiseArena& operator=(const RNNoiseArena&) = delete;
+
+    /**
+     * 初始化内存池
+     * @param slots_per_slab 每个slab容纳的状态数，容量不足时按slab整体扩容
+     * @param use_huge_pages 是否尝试使用大页（不支持时自动退回普通页）
+     * @param model 所有状态共用的模型，nullptr表示内置模型
+     * @return 是否初始化成功
+     */
+    bool init(size_t slots_per_slab = 1024, bool use_huge_pages = false,
+              const std::shared_ptr<RNNoiseModel>& model = nullptr);
+
+    /**
+     * 获取一个已初始化的DenoiseState，O(1)
+     * @return 失败返回nullptr
+     */
+    DenoiseState* acquire();
+
+    /**
+     * 归还DenoiseState，O(1)
+     * @param state 必须来自本内存池
+     */
+    void release(DenoiseState* state);
+
+    /**
+     * 原地重置状态（重新执行rnnoise_init，不涉及内存分配）
+     * @param state 必须来自本内存池
+     */
+    void reset(DenoiseState* state);
+
+    /**
+     * 预先分配到至少指定容量
+     * @param capacity 目标状态数
+     * @return 是否成功
+     */
+    bool reserve(size_t capacity);
+
+    /**
+     * 检查是否已初始化
+     */
+    bool is_initialized() const { return is_initialized_; }
+
+    /**
+     * 每个槽位的字节数（rnnoise_get_size()按缓存行向上取整）
+     */
+    size_t get_slot_size() const { return slot_size_; }
+
+    /**
+     * 已分配的槽位总数
+     */
+    size_t get_capacity() const { return capacity_; }
+
+    /**
+     * 正在使用的槽位数
+     */
+    size_t get_in_use() const { return in_use_; }
+
+    /**
+     * 实际启用了大页的slab数
+     */
+    size_t get_huge_page_slab_count() const;
+};
+
+} // namespace srv
@@ -0,0 +1,153 @@
+#include "RNNoiseGate.h"
+#include "DSPKernels.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+
+namespace srv {
+
+namespace {
+
+float dbfs_to_amplitude(float dbfs) {
+    return 32768.0f * std::pow(10.0f, dbfs / 20.0f);
+}
+
+} // namespace
+
+RNNoiseGate::RNNoiseGate()
+    : floor_peak_(dbfs_to_amplitude(-60.0f))
+    , floor_rms_(dbfs_to_amplitude(-60.0f))
+    , comfort_noise_level_(dbfs_to_amplitude(-70.0f))
+    , bypass_output_(BypassOutput::SILENCE)
+    , hangover_frames_(10)
+    , history_frames_(10)
+    , quiet_run_(0)
+    , bypassing_(false)
+    , noise_seed_(22222)
+    , history_pos_(0)
+    , history_count_(0)
+    , total_frames_(0)
+    , bypassed_frames_(0)
+    , replayed_frames_(0) {
+}
+
+bool RNNoiseGate::init(float floor_dbfs, int history_ms, int hangover_ms, const std::string& model_name) {
+    // 参数验证
+    if (history_ms < 0 || hangover_ms < 0) {
+        std::cerr << "RNNoiseGate init failed: invalid parameters" << std::endl;
+        return false;
+    }
+
+    if (!rnnoise_.init(model_name)) {
+        std::cerr << "RNNoiseGate init failed: cannot create RNNoise" << std::endl;
+        return false;
+    }
+
+    const int frame_ms = 1000 * RNNoise::FRAME_SIZE / RNNoise::get_sample_rate();
+    set_floor(floor_dbfs);
+    history_frames_ = (history_ms + frame_ms - 1) / frame_ms;
+    // RNNoise输出有一帧延迟，至少再推理一帧才能把最后一帧有效输出送出来
+    hangover_frames_ = std::max(1, (hangover_ms + frame_ms - 1) / frame_ms);
+    history_.assign(static_cast<size_t>(history_frames_) * RNNoise::FRAME_SIZE, 0.0f);
+
+    reset();
+    return true;
+}
+
+void RNNoiseGate::set_floor(float floor_dbfs) {
+    floor_peak_ = dbfs_to_amplitude(floor_dbfs);
+    floor_rms_ = floor_peak_;
+}
+
+void RNNoiseGate::set_bypass_output(BypassOutput mode, float level_dbfs) {
+    bypass_output_ = mode;
+    comfort_noise_level_ = dbfs_to_amplitude(level_dbfs);
+}
+
+void RNNoiseGate::reset() {
+    rnnoise_.reset();
+    quiet_run_ = 0;
+    bypassing_ = false;
+    history_pos_ = 0;
+    history_count_ = 0;
+    total_frames_ = 0;
+    bypassed_frames_ = 0;
+    replayed_frames_ = 0;
+}
+
+void RNNoiseGate::push_history(const float* frame) {
+    if (history_frames_ == 0) {
+        return;
+    }
+    std::memcpy(&history_[static_cast<size_t>(history_pos_) * RNNoise::FRAME_SIZE], frame,
+                RNNoise::FRAME_SIZE * sizeof(float));
+    history_pos_ = (history_pos_ + 1) % history_frames_;
+    history_count_ = std::min(history_count_ + 1, history_frames_);
+}
+
+void RNNoiseGate::replay_history() {
+    // 按时间顺序把门限期间最近的几帧喂给RNNoise，输出丢弃
+    float scratch[RNNoise::FRAME_SIZE];
+    int start = (history_pos_ - history_count_ + history_frames_) % std::max(1, history_frames_);
+    for (int k = 0; k < history_count_; ++k) {
+        int idx = (start + k) % history_frames_;
+        rnnoise_.process_frame(scratch, &history_[static_cast<size_t>(idx) * RNNoise::FRAME_SIZE]);
+    }
+    replayed_frames_ += static_cast<uint64_t>(history_count_);
+    history_count_ = 0;
+    history_pos_ = 0;
+}
+
+void RNNoiseGate::fill_bypass_output(float* out) {
+    if (bypass_output_ == BypassOutput::SILENCE) {
+        std::memset(out, 0, RNNoise::FRAME_SIZE * sizeof(float));
+        return;
+    }
+
+    // 线性同余发生器生成均匀白噪声，足够用作舒适噪声
+    for (int i = 0; i < RNNoise::FRAME_SIZE; ++i) {
+        noise_seed_ = noise_seed_ * 1664525u + 1013904223u;
+        float u = static_cast<float>(noise_seed_ >> 8) * (1.0f / 16777216.0f) * 2.0f - 1.0f;
+        out[i] = u * comfort_noise_level_;
+    }
+}
+
+float RNNoiseGate::process_frame(float* out, const float* in) {
+    if (!rnnoise_.is_initialized()) {
+        std::cerr << "RNNoiseGate not initialized" << std::endl;
+        return 0.0f;
+    }
+
+    total_frames_++;
+
+    float peak = 0.0f;
+    float energy = 0.0f;
+    kernels::peak_and_energy(in, RNNoise::FRAME_SIZE, &peak, &energy);
+    const float floor_energy = floor_rms_ * floor_rms_ * RNNoise::FRAME_SIZE;
+    const bool quiet = peak <= floor_peak_ && energy <= floor_energy;
+
+    if (quiet) {
+        quiet_run_++;
+    } else {
+        quiet_run_ = 0;
+    }
+
+    if (quiet && quiet_run_ > hangover_frames_) {
+        // 跳过推理，只缓存输入以备重新进入时回放
+        push_history(in);
+        bypassing_ = true;
+        bypassed_frames_++;
+        fill_bypass_output(out);
+        return 0.0f;
+    }
+
+    if (bypassing_) {
+        bypassing_ = false;
+        replay_history();
+    }
+
+    return rnnoise_.process_frame(out, in);
+}
+
+} // namespace srv
@@ -0,0 +1,110 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "RNNoise.h"
+
+// 能量/峰值预门限：低于门限的帧（数字静音、闭麦、保持音）跳过RNNoise推理
+namespace srv {
+
+class RNNoiseGate {
+public:
+    // 被门限跳过的帧的输出方式
+    enum class BypassOutput {
+        SILENCE,        // 输出全零
+        COMFORT_NOISE   // 输出低电平舒适噪声
+    };
+
+private:
+    RNNoise rnnoise_;
+    float floor_peak_;          // 峰值门限（int16量纲）
+    float floor_rms_;           // RMS门限（int16量纲）
+    float comfort_noise_level_; // 舒适噪声幅度（int16量纲）
+    BypassOutput bypass_output_;
+    int hangover_frames_;       // 电平跌落后继续推理的帧数
+    int history_frames_;        // 重新进入推理前回放的历史帧数
+    int quiet_run_;             // 连续低电平帧数
+    bool bypassing_;
+    uint32_t noise_seed_;
+
+    // 门限期间最近history_frames_帧的环形缓存，用于重新进入时预热循环网络状态
+    std::vector<float> history_;
+    int history_pos_;
+    int history_count_;
+
+    uint64_t total_frames_;
+    uint64_t bypassed_frames_;
+    uint64_t replayed_frames_;
+
+    void push_history(const float* frame);
+    void replay_history();
+    void fill_bypass_output(float* out);
+
+public:
+    RNNoiseGate();
+    ~RNNoiseGate() = default;
+
+    /**
+     * 初始化
+     * @param floor_dbfs 峰值门限 (dBFS)，峰值和RMS都低于门限的帧跳过推理
+     * @param history_ms 重新进入推理时回放的历史时长（毫秒）
+     * @param hangover_ms 电平跌落后继续推理的时长（毫秒）
+     * @param model_name 注册表中的模型名，为空使用内置模型
+     * @return 是否初始化成功
+     */
+    bool init(float floor_dbfs = -60.0f, int history_ms = 100, int hangover_ms = 100,
+              const std::string& model_name = "");
+
+    /**
+     * 处理一帧音频
+     * @param out 输出帧 (RNNoise::FRAME_SIZE个样本，int16量纲的float)
+     * @param in 输入帧，可与out相同
+     * @return VAD语音概率 (0-1)，被跳过的帧返回0
+     */
+    float process_frame(float* out, const float* in);
+
+    /**
+     * 设置门限
+     * @param floor_dbfs 峰值门限 (dBFS)
+     */
+    void set_floor(float floor_dbfs);
+
+    /**
+     * 设置跳过帧的输出方式
+     * @param mode 输出方式
+     * @param level_dbfs 舒适噪声电平 (dBFS)
+     */
+    void set_bypass_output(BypassOutput mode, float level_dbfs = -70.0f);
+
+    /**
+     * 重置状态和统计
+     */
+    void reset();
+
+    /**
+     * 检查是否已初始化
+     */
+    bool is_initialized() const { return rnnoise_.is_initialized(); }
+
+    /**
+     * 当前是否处于跳过推理状态
+     */
+    bool is_bypassing() const { return bypassing_; }
+
+    /**
+     * 已处理的总帧数
+     */
+    uint64_t get_total_frames() const { return total_frames_; }
+
+    /**
+     * 跳过推理的帧数
+     */
+    uint64_t get_bypassed_frames() const { return bypassed_frames_; }
+
+    /**
+     * 为预热状态而回放的帧数
+     */
+    uint64_t get_replayed_frames() const { return replayed_frames_; }
+};
+
+} // namespace srv
@@ -0,0 +1,224 @@
+#include "RNNoiseModel.h"
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+namespace srv {
+
+namespace {
+
+// 权重文件由若干记录组成，每条记录是64字节头（"DNNw"、版本、类型、数据大小、块大小、以0结尾的名字）加块数据
+// 逐条检查头和块边界，记录必须正好铺满整个文件
+bool check_blob_layout(const unsigned char* data, size_t size) {
+    const size_t kHeadSize = 64;
+    if (size < kHeadSize) {
+        return false;
+    }
+    size_t pos = 0;
+    while (pos < size) {
+        if (size - pos < kHeadSize || std::memcmp(data + pos, "DNNw", 4) != 0) {
+            return false;
+        }
+        int32_t array_size = 0;
+        int32_t block_size = 0;
+        std::memcpy(&array_size, data + pos + 12, sizeof(array_size));
+        std::memcpy(&block_size, data + pos + 16, sizeof(block_size));
+        if (array_size <= 0 || block_size < array_size || data[pos + kHeadSize - 1] != 0 ||
+            static_cast<size_t>(block_size) > size - pos - kHeadSize) {
+            return false;
+        }
+        pos += kHeadSize + static_cast<size_t>(block_size);
+    }
+    return true;
+}
+
+} // namespace
+
+RNNoiseModel::RNNoiseModel()
+    : model_(nullptr)
+    , mapped_data_(nullptr)
+    , mapped_size_(0)
+    , is_shared_(false)
+    , version_(0) {
+}
+
+RNNoiseModel::~RNNoiseModel() {
+    // 必须先释放RNNModel，再解除映射
+    // rnnoise_model_from_buffer只malloc了结构体，不设置file字段，rnnoise_model_free会fclose未初始化的指针，
+    // 所以映射模型直接free；rnnoise_model_free只用于rnnoise_model_from_file加载的私有模型
+    if (model_) {
+        if (is_shared_) {
+            std::free(model_);
+        } else {
+            rnnoise_model_free(model_);
+        }
+        model_ = nullptr;
+    }
+    if (mapped_data_) {
+        munmap(mapped_data_, mapped_size_);
+        mapped_data_ = nullptr;
+    }
+}
+
+std::shared_ptr<RNNoiseModel> RNNoiseModel::load_mapped(const std::string& path, uint64_t version) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "RNNoiseModel load failed: cannot open " << path << std::endl;
+        return nullptr;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0 || st.st_size > INT_MAX) {
+        std::cerr << "RNNoiseModel load failed: invalid file size " << path << std::endl;
+        close(fd);
+        return nullptr;
+    }
+
+    size_t size = static_cast<size_t>(st.st_size);
+    void* data = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    // 映射建立后即可关闭文件描述符
+    close(fd);
+    if (data == MAP_FAILED) {
+        std::cerr << "RNNoiseModel load failed: mmap error " << path << std::endl;
+        return nullptr;
+    }
+
+    // 权重在推理时被随机访问
+    madvise(data, size, MADV_WILLNEED);
+
+    // rnnoise_model_from_buffer不检查内容，发布前先检查记录布局，再试建一个DenoiseState（解析并按名字/大小查找全部权重）
+    if (!check_blob_layout(static_cast<const unsigned char*>(data), size)) {
+        std::cerr << "RNNoiseModel load failed: invalid weights layout " << path << std::endl;
+        munmap(data, size);
+        return nullptr;
+    }
+    RNNModel* model = rnnoise_model_from_buffer(data, static_cast<int>(size));
+    DenoiseState* trial = model ? rnnoise_create(model) : nullptr;
+    if (!trial) {
+        std::cerr << "RNNoiseModel load failed: invalid weights " << path << std::endl;
+        std::free(model);
+        munmap(data, size);
+        return nullptr;
+    }
+    rnnoise_destroy(trial);
+
+    std::shared_ptr<RNNoiseModel> result(new RNNoiseModel());
+    result->model_ = model;
+    result->mapped_data_ = data;
+    result->mapped_size_ = size;
+    result->is_shared_ = true;
+    result->version_ = version;
+    result->path_ = path;
+    return result;
+}
+
+std::shared_ptr<RNNoiseModel> RNNoiseModel::load_private(const std::string& path) {
+    FILE* f = std::fopen(path.c_str(), "rb");
+    if (!f) {
+        std::cerr << "RNNoiseModel load failed: cannot open " << path << std::endl;
+        return nullptr;
+    }
+
+    // rnnoise_model_from_file会把整个文件读入自己的堆内存
+    RNNModel* model = rnnoise_model_from_file(f);
+    std::fseek(f, 0, SEEK_END);
+    long size = std::ftell(f);
+    std::fclose(f);
+    if (!model) {
+        std::cerr << "RNNoiseModel load failed: invalid weights " << path << std::endl;
+        return nullptr;
+    }
+
+    std::shared_ptr<RNNoiseModel> result(new RNNoiseModel());
+    result->model_ = model;
+    result->mapped_size_ = size > 0 ? static_cast<size_t>(size) : 0;
+    result->is_shared_ = false;
+    result->path_ = path;
+    return result;
+}
+
+RNNoiseModelRegistry::RNNoiseModelRegistry()
+    : generation_(0) {
+}
+
+RNNoiseModelRegistry& RNNoiseModelRegistry::instance() {
+    static RNNoiseModelRegistry registry;
+    return registry;
+}
+
+bool RNNoiseModelRegistry::publish(const std::string& name, const std::string& path) {
+    // 加载放在锁外，避免大文件映射阻塞其它流的acquire
+    uint64_t next_version = get_version(name) + 1;
+    std::shared_ptr<RNNoiseModel> model = RNNoiseModel::load_mapped(path, next_version);
+    if (!model) {
+        std::cerr << "RNNoiseModelRegistry publish failed: " << name << std::endl;
+        return false;
+    }
+
+    std::shared_ptr<RNNoiseModel> previous;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        Entry& entry = models_[name];
+        // 并发publish时以注册表内版本为准
+        if (entry.version >= next_version) {
+            next_version = entry.version + 1;
+        }
+        model->version_ = next_version;
+        previous = entry.model;
+        entry.model = model;
+        entry.version = next_version;
+        generation_.fetch_add(1, std::memory_order_acq_rel);
+    }
+
+    std::cout << "RNNoise model published: name=" << name
+              << ", version=" << next_version
+              << ", size=" << model->get_blob_size() << " bytes" << std::endl;
+
+    // previous在这里析构只会减少一次引用，仍在使用旧版本的流不受影响
+    return true;
+}
+
+std::shared_ptr<RNNoiseModel> RNNoiseModelRegistry::acquire(const std::string& name) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = models_.find(name);
+    if (it == models_.end()) {
+        return nullptr;
+    }
+    return it->second.model;
+}
+
+void RNNoiseModelRegistry::remove(const std::string& name) {
+    std::shared_ptr<RNNoiseModel> previous;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = models_.find(name);
+        if (it == models_.end()) {
+            return;
+        }
+        previous = it->second.model;
+        models_.erase(it);
+        generation_.fetch_add(1, std::memory_order_acq_rel);
+    }
+}
+
+uint64_t RNNoiseModelRegistry::get_version(const std::string& name) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = models_.find(name);
+    return it == models_.end() ? 0 : it->second.version;
+}
+
+long RNNoiseModelRegistry::get_use_count(const std::string& name) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = models_.find(name);
+    if (it == models_.end() || !it->second.model) {
+        return 0;
+    }
+    return it->second.model.use_count() - 1;
+}
+
+} // namespace srv
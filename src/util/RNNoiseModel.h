@@ -0,0 +1,141 @@
+#pragma once
+#include <rnnoise.h>
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+// RNNoise模型权重管理（只读mmap共享 + 进程内注册表）
+namespace srv {
+
+/**
+ * 一份RNNoise模型权重
+ * 共享模式下权重文件以只读方式mmap，所有DenoiseState直接引用映射页，
+ * 同一进程内N个流只占一份物理内存；私有模式下走rnnoise_model_from_filename，
+ * 每个实例各自malloc一份拷贝（仅用于对比测试）
+ */
+class RNNoiseModel {
+private:
+    RNNModel* model_;
+    void* mapped_data_;
+    size_t mapped_size_;
+    bool is_shared_;
+    uint64_t version_;
+    std::string path_;
+
+    RNNoiseModel();
+
+    friend class RNNoiseModelRegistry;
+
+public:
+    ~RNNoiseModel();
+
+    RNNoiseModel(const RNNoiseModel&) = delete;
+    RNNoiseModel& operator=(const RNNoiseModel&) = delete;
+
+    /**
+     * 以只读mmap方式加载权重文件（weights_blob.bin格式）
+     * 发布前检查记录布局并试建一个DenoiseState，损坏或不匹配的权重文件不会被发布
+     * @param path 权重文件路径
+     * @param version 模型版本号
+     * @return 加载失败或权重无效返回nullptr
+     */
+    static std::shared_ptr<RNNoiseModel> load_mapped(const std::string& path, uint64_t version = 0);
+
+    /**
+     * 以私有拷贝方式加载权重文件（每次调用都会读入一份新的拷贝）
+     * @param path 权重文件路径
+     * @return 加载失败返回nullptr
+     */
+    static std::shared_ptr<RNNoiseModel> load_private(const std::string& path);
+
+    /**
+     * 获取传给rnnoise_create/rnnoise_init的模型指针
+     */
+    RNNModel* get() const { return model_; }
+
+    /**
+     * 权重数据大小（字节）
+     */
+    size_t get_blob_size() const { return mapped_size_; }
+
+    /**
+     * 是否为共享映射
+     */
+    bool is_shared() const { return is_shared_; }
+
+    /**
+     * 模型版本号
+     */
+    uint64_t get_version() const { return version_; }
+
+    /**
+     * 权重文件路径
+     */
+    const std::string& get_path() const { return path_; }
+};
+
+/**
+ * 进程级模型注册表
+ * - 按名字管理模型，acquire返回的shared_ptr即引用计数，最后一个流释放后才真正卸载
+ * - publish同名新版本即热更新：正在运行的流继续持有旧版本，直到它们在帧边界切换
+ */
+class RNNoiseModelRegistry {
+private:
+    struct Entry {
+        std::shared_ptr<RNNoiseModel> model;
+        uint64_t version = 0;
+    };
+
+    mutable std::mutex mutex_;
+    std::map<std::string, Entry> models_;
+    // 每次publish/remove递增，流只需比较这个值即可判断是否需要重新acquire
+    std::atomic<uint64_t> generation_;
+
+    RNNoiseModelRegistry();
+
+public:
+    static RNNoiseModelRegistry& instance();
+
+    RNNoiseModelRegistry(const RNNoiseModelRegistry&) = delete;
+    RNNoiseModelRegistry& operator=(const RNNoiseModelRegistry&) = delete;
+
+    /**
+     * 发布（或热更新）一个模型
+     * @param name 模型名
+     * @param path 权重文件路径
+     * @return 是否加载成功；失败时保留原有版本
+     */
+    bool publish(const std::string& name, const std::string& path);
+
+    /**
+     * 获取模型当前版本
+     * @param name 模型名
+     * @return 未注册时返回nullptr（调用方应使用内置模型）
+     */
+    std::shared_ptr<RNNoiseModel> acquire(const std::string& name) const;
+
+    /**
+     * 注销模型，已在使用的流不受影响
+     */
+    void remove(const std::string& name);
+
+    /**
+     * 获取模型当前版本号，未注册返回0
+     */
+    uint64_t get_version(const std::string& name) const;
+
+    /**
+     * 获取模型当前被引用的次数（不含注册表自身）
+     */
+    long get_use_count(const std::string& name) const;
+
+    /**
+     * 注册表变更代数
+     */
+    uint64_t get_generation() const { return generation_.load(std::memory_order_acquire); }
+};
+
+} // namespace srv
@@ -0,0 +1,163 @@
+#include "RNNoiseParallel.h"
+#include "RNNoise.h"
+#include "DSPKernels.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <thread>
+
+namespace srv {
+
+namespace {
+
+// 单个块的处理范围（单位：帧）
+struct ChunkRange {
+    size_t begin;      // 本块负责输出的第一帧
+    size_t end;        // 本块负责输出的最后一帧之后
+    size_t run_begin;  // 实际开始推理的帧（含预热）
+    size_t run_end;    // 实际结束推理的帧（含尾部重叠）
+};
+
+// 交叉淡化逐样本计算，饱和/舍入规则与kernels::f32_to_s16一致
+short to_short(float sample) {
+    short out;
+    kernels::f32_to_s16(&sample, &out, 1, 1.0f);
+    return out;
+}
+
+} // namespace
+
+RNNoiseParallel::RNNoiseParallel()
+    : num_threads_(1)
+    , preroll_frames_(50)
+    , crossfade_frames_(1)
+    , is_initialized_(false) {
+}
+
+bool RNNoiseParallel::init(int num_threads, int preroll_ms, int crossfade_ms, const std::string& model_name) {
+    // 参数验证
+    if (num_threads < 0 || preroll_ms < 0 || crossfade_ms < 0) {
+        std::cerr << "RNNoiseParallel init failed: invalid parameters" << std::endl;
+        return false;
+    }
+
+    if (num_threads == 0) {
+        num_threads = static_cast<int>(std::thread::hardware_concurrency());
+        if (num_threads <= 0) {
+            num_threads = 1;
+        }
+    }
+
+    const int frame_ms = 1000 * RNNoise::FRAME_SIZE / RNNoise::get_sample_rate();
+    num_threads_ = num_threads;
+    preroll_frames_ = (preroll_ms + frame_ms - 1) / frame_ms;
+    crossfade_frames_ = (crossfade_ms + frame_ms - 1) / frame_ms;
+    model_name_ = model_name;
+    is_initialized_ = true;
+    return true;
+}
+
+void RNNoiseParallel::set_preroll_ms(int preroll_ms) {
+    const int frame_ms = 1000 * RNNoise::FRAME_SIZE / RNNoise::get_sample_rate();
+    preroll_frames_ = std::max(0, (preroll_ms + frame_ms - 1) / frame_ms);
+}
+
+std::vector<short> RNNoiseParallel::process(const std::vector<short>& input) const {
+    if (!is_initialized_) {
+        std::cerr << "RNNoiseParallel not initialized" << std::endl;
+        return {};
+    }
+
+    const size_t frame_size = RNNoise::FRAME_SIZE;
+    const size_t num_frames = (input.size() + frame_size - 1) / frame_size;
+    std::vector<short> output(num_frames * frame_size, 0);
+    if (num_frames == 0) {
+        return output;
+    }
+
+    const size_t num_chunks = std::min(static_cast<size_t>(num_threads_), num_frames);
+
+    std::vector<ChunkRange> chunks(num_chunks);
+    size_t min_chunk_frames = num_frames;
+    for (size_t c = 0; c < num_chunks; ++c) {
+        chunks[c].begin = num_frames * c / num_chunks;
+        chunks[c].end = num_frames * (c + 1) / num_chunks;
+        min_chunk_frames = std::min(min_chunk_frames, chunks[c].end - chunks[c].begin);
+    }
+
+    // 交叉淡化区不能超过最短的块
+    const size_t crossfade = std::min(static_cast<size_t>(crossfade_frames_), min_chunk_frames);
+    const size_t preroll = static_cast<size_t>(preroll_frames_);
+    for (size_t c = 0; c < num_chunks; ++c) {
+        chunks[c].run_begin = chunks[c].begin > preroll ? chunks[c].begin - preroll : 0;
+        chunks[c].run_end = (c + 1 < num_chunks) ? std::min(num_frames, chunks[c].end + crossfade) : num_frames;
+    }
+
+    // 重叠区的两份输出先保存为float，最后统一淡化拼接
+    std::vector<std::vector<float>> heads(num_chunks);
+    std::vector<std::vector<float>> tails(num_chunks);
+
+    auto worker = [&](size_t c) {
+        const ChunkRange& range = chunks[c];
+        RNNoise rnnoise;
+        if (!rnnoise.init(model_name_)) {
+            return;
+        }
+
+        const size_t head_end = (c > 0) ? range.begin + crossfade : range.begin;
+        if (c > 0) {
+            heads[c].resize(crossfade * frame_size);
+        }
+        if (c + 1 < num_chunks) {
+            tails[c].resize((range.run_end - range.end) * frame_size);
+        }
+
+        float frame[RNNoise::FRAME_SIZE];
+        for (size_t f = range.run_begin; f < range.run_end; ++f) {
+            const size_t offset = f * frame_size;
+            const size_t valid = std::min(frame_size, input.size() - offset);
+            kernels::s16_to_f32(&input[offset], frame, valid, 1.0f);
+            std::fill(frame + valid, frame + frame_size, 0.0f);
+
+            rnnoise.process_frame(frame, frame);
+
+            if (f < range.begin) {
+                // 预热段，丢弃输出
+                continue;
+            }
+            if (f < head_end) {
+                std::memcpy(&heads[c][(f - range.begin) * frame_size], frame, frame_size * sizeof(float));
+            } else if (f >= range.end) {
+                std::memcpy(&tails[c][(f - range.end) * frame_size], frame, frame_size * sizeof(float));
+            } else {
+                kernels::f32_to_s16(frame, &output[offset], frame_size, 1.0f);
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(num_chunks);
+    for (size_t c = 0; c < num_chunks; ++c) {
+        threads.emplace_back(worker, c);
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    // 块间线性交叉淡化：前一块的尾部淡出，后一块的头部淡入
+    for (size_t c = 1; c < num_chunks; ++c) {
+        const std::vector<float>& tail = tails[c - 1];
+        const std::vector<float>& head = heads[c];
+        const size_t length = std::min(tail.size(), head.size());
+        const size_t offset = chunks[c].begin * frame_size;
+        for (size_t j = 0; j < length; ++j) {
+            float w = (static_cast<float>(j) + 0.5f) / static_cast<float>(length);
+            output[offset + j] = to_short(tail[j] * (1.0f - w) + head[j] * w);
+        }
+    }
+
+    return output;
+}
+
+} // namespace srv
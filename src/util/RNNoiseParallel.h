@@ -0,0 +1,67 @@
+#pragma once
+#include <string>
+#include <vector>
+
+// 长录音离线并行降噪：按块切分到多核处理，每块带预热段，块间交叉淡化拼接
+namespace srv {
+
+class RNNoiseParallel {
+private:
+    int num_threads_;
+    int preroll_frames_;    // 预热帧数，输出丢弃，只用于让循环网络状态收敛
+    int crossfade_frames_;  // 相邻块重叠并交叉淡化的帧数
+    std::string model_name_;
+    bool is_initialized_;
+
+public:
+    RNNoiseParallel();
+    ~RNNoiseParallel() = default;
+
+    /**
+     * 初始化
+     * @param num_threads 并行块数（线程数），0表示使用全部核心
+     * @param preroll_ms 每块预热时长（毫秒），越长越接近顺序处理结果，速度越慢
+     * @param crossfade_ms 块间交叉淡化时长（毫秒）
+     * @param model_name 注册表中的模型名，为空使用内置模型
+     * @return 是否初始化成功
+     */
+    bool init(int num_threads = 0, int preroll_ms = 500, int crossfade_ms = 10,
+              const std::string& model_name = "");
+
+    /**
+     * 处理整段48kHz单声道音频
+     * 输出与rnnoise_process_frame逐帧输出一一对应（未跳过首帧），
+     * 长度为输入按帧长向上取整后的样本数
+     * @param input 输入音频
+     * @return 降噪后的音频
+     */
+    std::vector<short> process(const std::vector<short>& input) const;
+
+    /**
+     * 设置预热时长（质量/速度折中）
+     * @param preroll_ms 预热时长（毫秒）
+     */
+    void set_preroll_ms(int preroll_ms);
+
+    /**
+     * 检查是否已初始化
+     */
+    bool is_initialized() const { return is_initialized_; }
+
+    /**
+     * 获取线程数
+     */
+    int get_num_threads() const { return num_threads_; }
+
+    /**
+     * 获取预热帧数
+     */
+    int get_preroll_frames() const { return preroll_frames_; }
+
+    /**
+     * 获取交叉淡化帧数
+     */
+    int get_crossfade_frames() const { return crossfade_frames_; }
+};
+
+} // namespace srv
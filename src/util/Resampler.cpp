@@ -0,0 +1,124 @@
+#include "Resampler.h"
+#include <iostream>
+
+namespace srv {
+
+Resampler::Resampler()
+    : resampler_state_(nullptr)
+    , input_rate_(0)
+    , output_rate_(0)
+    , channels_(1)
+    , quality_(SPEEX_RESAMPLER_QUALITY_DEFAULT)
+    , is_initialized_(false) {
+}
+
+Resampler::~Resampler() {
+    if (resampler_state_) {
+        speex_resampler_destroy(resampler_state_);
+        resampler_state_ = nullptr;
+    }
+}
+
+bool Resampler::init(int input_rate, int output_rate, int channels, int quality) {
+    // 如果已经初始化，先清理
+    if (resampler_state_) {
+        speex_resampler_destroy(resampler_state_);
+        resampler_state_ = nullptr;
+    }
+    is_initialized_ = false;
+
+    // 参数验证
+    if (input_rate <= 0 || output_rate <= 0 || channels <= 0 ||
+        quality < SPEEX_RESAMPLER_QUALITY_MIN || quality > SPEEX_RESAMPLER_QUALITY_MAX) {
+        std::cerr << "Resampler init failed: invalid parameters" << std::endl;
+        return false;
+    }
+
+    int err = RESAMPLER_ERR_SUCCESS;
+    resampler_state_ = speex_resampler_init(channels, input_rate, output_rate, quality, &err);
+    if (!resampler_state_ || err != RESAMPLER_ERR_SUCCESS) {
+        std::cerr << "Resampler init failed: " << speex_resampler_strerror(err) << std::endl;
+        resampler_state_ = nullptr;
+        return false;
+    }
+
+    input_rate_ = input_rate;
+    output_rate_ = output_rate;
+    channels_ = channels;
+    quality_ = quality;
+    is_initialized_ = true;
+    return true;
+}
+
+size_t Resampler::process(const spx_int16_t* input, size_t input_frames, std::vector<spx_int16_t>& output) {
+    if (!is_initialized_ || !resampler_state_) {
+        std::cerr << "Resampler not initialized" << std::endl;
+        return 0;
+    }
+
+    size_t produced = 0;
+    while (input_frames > 0) {
+        // 预留足够空间，剩余的输入在下一轮继续处理
+        size_t capacity = input_frames * output_rate_ / input_rate_ + 16;
+        size_t start = output.size();
+        output.resize(start + capacity * channels_);
+
+        spx_uint32_t in_len = static_cast<spx_uint32_t>(input_frames);
+        spx_uint32_t out_len = static_cast<spx_uint32_t>(capacity);
+        speex_resampler_process_interleaved_int(resampler_state_, input, &in_len, &output[start], &out_len);
+
+        output.resize(start + static_cast<size_t>(out_len) * channels_);
+        produced += out_len;
+        input += static_cast<size_t>(in_len) * channels_;
+        input_frames -= in_len;
+        if (in_len == 0 && out_len == 0) {
+            break;
+        }
+    }
+    return produced;
+}
+
+size_t Resampler::process(const float* input, size_t input_frames, std::vector<float>& output) {
+    if (!is_initialized_ || !resampler_state_) {
+        std::cerr << "Resampler not initialized" << std::endl;
+        return 0;
+    }
+
+    size_t produced = 0;
+    while (input_frames > 0) {
+        size_t capacity = input_frames * output_rate_ / input_rate_ + 16;
+        size_t start = output.size();
+        output.resize(start + capacity * channels_);
+
+        spx_uint32_t in_len = static_cast<spx_uint32_t>(input_frames);
+        spx_uint32_t out_len = static_cast<spx_uint32_t>(capacity);
+        speex_resampler_process_interleaved_float(resampler_state_, input, &in_len, &output[start], &out_len);
+
+        output.resize(start + static_cast<size_t>(out_len) * channels_);
+        produced += out_len;
+        input += static_cast<size_t>(in_len) * channels_;
+        input_frames -= in_len;
+        if (in_len == 0 && out_len == 0) {
+            break;
+        }
+    }
+    return produced;
+}
+
+void Resampler::reset() {
+    if (!is_initialized_ || !resampler_state_) {
+        return;
+    }
+    speex_resampler_reset_mem(resampler_state_);
+    speex_resampler_skip_zeros(resampler_state_);
+}
+
+int Resampler::get_input_latency() const {
+    return resampler_state_ ? speex_resampler_get_input_latency(resampler_state_) : 0;
+}
+
+int Resampler::get_output_latency() const {
+    return resampler_state_ ? speex_resampler_get_output_latency(resampler_state_) : 0;
+}
+
+} // namespace srv
@@ -0,0 +1,79 @@
+#pragma once
+#include <speex/speex_resampler.h>
+#include <cstddef>
+#include <vector>
+
+// 重采样 (speex resampler封装，支持流式分块输入)
+namespace srv {
+
+class Resampler {
+private:
+    SpeexResamplerState* resampler_state_;
+    int input_rate_;
+    int output_rate_;
+    int channels_;
+    int quality_;
+    bool is_initialized_;
+
+public:
+    Resampler();
+    ~Resampler();
+
+    Resampler(const Resampler&) = delete;
+    Resampler& operator=(const Resampler&) = delete;
+
+    /**
+     * 初始化重采样器
+     * @param input_rate 输入采样率 (Hz)
+     * @param output_rate 输出采样率 (Hz)
+     * @param channels 声道数（交错排列）
+     * @param quality 质量 (0-10)
+     * @return 是否初始化成功
+     */
+    bool init(int input_rate, int output_rate, int channels = 1,
+              int quality = SPEEX_RESAMPLER_QUALITY_DEFAULT);
+
+    /**
+     * 处理一块16位PCM音频，输出追加到output末尾
+     * @param input 输入数据（交错排列）
+     * @param input_frames 输入帧数（每帧channels个样本）
+     * @param output 输出缓冲区
+     * @return 本次输出的帧数
+     */
+    size_t process(const spx_int16_t* input, size_t input_frames, std::vector<spx_int16_t>& output);
+
+    /**
+     * 处理一块float音频，输出追加到output末尾
+     * @param input 输入数据（交错排列）
+     * @param input_frames 输入帧数（每帧channels个样本）
+     * @param output 输出缓冲区
+     * @return 本次输出的帧数
+     */
+    size_t process(const float* input, size_t input_frames, std::vector<float>& output);
+
+    /**
+     * 重置内部滤波器状态
+     */
+    void reset();
+
+    /**
+     * 获取输入侧延迟（输入帧数）
+     */
+    int get_input_latency() const;
+
+    /**
+     * 获取输出侧延迟（输出帧数）
+     */
+    int get_output_latency() const;
+
+    /**
+     * 检查是否已初始化
+     */
+    bool is_initialized() const { return is_initialized_; }
+
+    int get_input_rate() const { return input_rate_; }
+    int get_output_rate() const { return output_rate_; }
+    int get_channels() const { return channels_; }
+};
+
+} // namespace srv
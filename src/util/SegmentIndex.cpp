@@ -0,0 +1,275 @@
+#include "SegmentIndex.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+namespace srv {
+
+namespace {
+
+const char kMagic[8] = {'S', 'R', 'V', 'S', 'E', 'G', 'I', 'X'};
+const uint32_t kVersion = 1;
+
+void put_varint(std::vector<uint8_t>& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+// 解码失败（越界或超过10字节）返回false
+bool get_varint(const uint8_t* data, size_t size, size_t& pos, uint64_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 64 && pos < size; shift += 7) {
+        uint8_t byte = data[pos++];
+        value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// 文件中的定长字段一律小端存储
+void put_u32(std::vector<uint8_t>& out, uint32_t value) {
+    for (int i = 0; i < 4; ++i) {
+        out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+    }
+}
+
+void put_u64(std::vector<uint8_t>& out, uint64_t value) {
+    for (int i = 0; i < 8; ++i) {
+        out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+    }
+}
+
+uint32_t get_u32(const uint8_t* p) {
+    uint32_t value = 0;
+    for (int i = 0; i < 4; ++i) {
+        value |= static_cast<uint32_t>(p[i]) << (8 * i);
+    }
+    return value;
+}
+
+uint64_t get_u64(const uint8_t* p) {
+    uint64_t value = 0;
+    for (int i = 0; i < 8; ++i) {
+        value |= static_cast<uint64_t>(p[i]) << (8 * i);
+    }
+    return value;
+}
+
+// 头部: magic(8) version(4) sample_rate(4) content_hash(8) config_hash(8)
+//       total_samples(8) range_count(8) skip_interval(4) skip_count(4) payload_bytes(8)
+const size_t kHeaderSize = 8 + 4 + 4 + 8 + 8 + 8 + 8 + 4 + 4 + 8;
+
+} // namespace
+
+SegmentIndex::SegmentIndex()
+    : content_hash_(0)
+    , config_hash_(0)
+    , sample_rate_(0)
+    , total_samples_(0)
+    , range_count_(0)
+    , is_loaded_(false) {
+}
+
+uint64_t SegmentIndex::hash_content(const void* data, size_t bytes, uint64_t seed) {
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    uint64_t hash = seed;
+    for (size_t i = 0; i < bytes; ++i) {
+        hash ^= p[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+bool SegmentIndex::build(const std::vector<Range>& speech, uint32_t sample_rate, uint64_t total_samples,
+                         uint64_t content_hash, uint64_t config_hash) {
+    is_loaded_ = false;
+    skip_table_.clear();
+    payload_.clear();
+
+    if (sample_rate == 0) {
+        std::cerr << "SegmentIndex build failed: invalid sample rate" << std::endl;
+        return false;
+    }
+
+    uint64_t prev_end = 0;
+    for (size_t i = 0; i < speech.size(); ++i) {
+        const Range& r = speech[i];
+        if (r.end_sample <= r.start_sample || r.start_sample < prev_end || r.end_sample > total_samples) {
+            std::cerr << "SegmentIndex build failed: ranges must be sorted, non-empty and non-overlapping" << std::endl;
+            skip_table_.clear();
+            payload_.clear();
+            return false;
+        }
+        if (i % SKIP_INTERVAL == 0) {
+            skip_table_.push_back({r.start_sample, static_cast<uint64_t>(payload_.size())});
+        }
+        put_varint(payload_, r.start_sample - prev_end);
+        put_varint(payload_, r.end_sample - r.start_sample);
+        prev_end = r.end_sample;
+    }
+
+    content_hash_ = content_hash;
+    config_hash_ = config_hash;
+    sample_rate_ = sample_rate;
+    total_samples_ = total_samples;
+    range_count_ = speech.size();
+    is_loaded_ = true;
+    return true;
+}
+
+bool SegmentIndex::save(const std::string& path) const {
+    if (!is_loaded_) {
+        std::cerr << "SegmentIndex save failed: index is empty" << std::endl;
+        return false;
+    }
+
+    std::vector<uint8_t> header;
+    header.insert(header.end(), kMagic, kMagic + sizeof(kMagic));
+    put_u32(header, kVersion);
+    put_u32(header, sample_rate_);
+    put_u64(header, content_hash_);
+    put_u64(header, config_hash_);
+    put_u64(header, total_samples_);
+    put_u64(header, range_count_);
+    put_u32(header, SKIP_INTERVAL);
+    put_u32(header, static_cast<uint32_t>(skip_table_.size()));
+    put_u64(header, payload_.size());
+    for (const auto& entry : skip_table_) {
+        put_u64(header, entry.start_sample);
+        put_u64(header, entry.byte_offset);
+    }
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        std::cerr << "SegmentIndex save failed: cannot create " << path << std::endl;
+        return false;
+    }
+    file.write(reinterpret_cast<const char*>(header.data()), header.size());
+    file.write(reinterpret_cast<const char*>(payload_.data()), payload_.size());
+    return file.good();
+}
+
+bool SegmentIndex::load(const std::string& path) {
+    is_loaded_ = false;
+
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) {
+        return false;
+    }
+    std::streamsize size = file.tellg();
+    file.seekg(0, std::ios::beg);
+    if (size < static_cast<std::streamsize>(kHeaderSize)) {
+        std::cerr << "SegmentIndex load failed: file too small" << std::endl;
+        return false;
+    }
+    std::vector<uint8_t> data(static_cast<size_t>(size));
+    file.read(reinterpret_cast<char*>(data.data()), size);
+    if (!file.good()) {
+        std::cerr << "SegmentIndex load failed: read error" << std::endl;
+        return false;
+    }
+
+    const uint8_t* p = data.data();
+    if (std::memcmp(p, kMagic, sizeof(kMagic)) != 0 || get_u32(p + 8) != kVersion) {
+        std::cerr << "SegmentIndex load failed: bad magic or version" << std::endl;
+        return false;
+    }
+    uint32_t sample_rate = get_u32(p + 12);
+    uint64_t content_hash = get_u64(p + 16);
+    uint64_t config_hash = get_u64(p + 24);
+    uint64_t total_samples = get_u64(p + 32);
+    uint64_t range_count = get_u64(p + 40);
+    uint32_t skip_interval = get_u32(p + 48);
+    uint32_t skip_count = get_u32(p + 52);
+    uint64_t payload_bytes = get_u64(p + 56);
+
+    uint64_t expected_skips = (range_count + SKIP_INTERVAL - 1) / SKIP_INTERVAL;
+    uint64_t expected_size = kHeaderSize + static_cast<uint64_t>(skip_count) * 16 + payload_bytes;
+    if (skip_interval != SKIP_INTERVAL || skip_count != expected_skips ||
+        expected_size != static_cast<uint64_t>(size)) {
+        std::cerr << "SegmentIndex load failed: corrupted header" << std::endl;
+        return false;
+    }
+
+    skip_table_.resize(skip_count);
+    const uint8_t* q = p + kHeaderSize;
+    for (uint32_t i = 0; i < skip_count; ++i, q += 16) {
+        skip_table_[i].start_sample = get_u64(q);
+        skip_table_[i].byte_offset = get_u64(q + 8);
+        if (skip_table_[i].byte_offset >= payload_bytes) {
+            std::cerr << "SegmentIndex load failed: corrupted skip table" << std::endl;
+            skip_table_.clear();
+            return false;
+        }
+    }
+    payload_.assign(q, q + payload_bytes);
+
+    content_hash_ = content_hash;
+    config_hash_ = config_hash;
+    sample_rate_ = sample_rate;
+    total_samples_ = total_samples;
+    range_count_ = range_count;
+    is_loaded_ = true;
+    return true;
+}
+
+void SegmentIndex::decode_from(size_t skip_index, uint64_t t0, uint64_t t1, std::vector<Range>& out) const {
+    uint64_t remaining = range_count_ - static_cast<uint64_t>(skip_index) * SKIP_INTERVAL;
+    size_t pos = static_cast<size_t>(skip_table_[skip_index].byte_offset);
+    // 跳转点记录的是段起点，先解出首段的差分值再用绝对起点覆盖
+    uint64_t prev_end = 0;
+    bool first = true;
+
+    while (remaining-- > 0) {
+        uint64_t gap = 0;
+        uint64_t length = 0;
+        if (!get_varint(payload_.data(), payload_.size(), pos, gap) ||
+            !get_varint(payload_.data(), payload_.size(), pos, length)) {
+            std::cerr << "SegmentIndex query failed: corrupted payload" << std::endl;
+            return;
+        }
+        uint64_t start = first ? skip_table_[skip_index].start_sample : prev_end + gap;
+        uint64_t end = start + length;
+        first = false;
+        prev_end = end;
+
+        if (start >= t1) {
+            return;
+        }
+        if (end > t0) {
+            out.push_back({start, end});
+        }
+    }
+}
+
+std::vector<SegmentIndex::Range> SegmentIndex::query(uint64_t t0, uint64_t t1) const {
+    std::vector<Range> result;
+    if (!is_loaded_ || skip_table_.empty() || t1 <= t0) {
+        return result;
+    }
+
+    // 段有序且不重叠，起点不大于t0的最后一个跳转点之前的段都在t0之前结束
+    auto it = std::upper_bound(skip_table_.begin(), skip_table_.end(), t0,
+                               [](uint64_t t, const SkipEntry& e) { return t < e.start_sample; });
+    size_t skip_index = (it == skip_table_.begin()) ? 0 : static_cast<size_t>(it - skip_table_.begin()) - 1;
+    decode_from(skip_index, t0, t1, result);
+    return result;
+}
+
+std::vector<SegmentIndex::Range> SegmentIndex::query_ms(double t0_ms, double t1_ms) const {
+    if (!is_loaded_ || t1_ms <= t0_ms) {
+        return {};
+    }
+    uint64_t t0 = static_cast<uint64_t>(std::max(0.0, t0_ms) * sample_rate_ / 1000.0);
+    uint64_t t1 = static_cast<uint64_t>(std::ceil(std::max(0.0, t1_ms) * sample_rate_ / 1000.0));
+    return query(t0, t1);
+}
+
+} // namespace srv
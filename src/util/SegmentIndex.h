@@ -0,0 +1,112 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// 语音段索引：varint差分编码的二进制段边界文件，按音频内容哈希标识，不读音频即可查询
+namespace srv {
+
+class SegmentIndex {
+public:
+    // 语音段（样本下标，左闭右开）
+    struct Range {
+        uint64_t start_sample;
+        uint64_t end_sample;
+    };
+
+    // 每隔多少段记录一个跳转点（绝对起点 + 载荷字节偏移）
+    static constexpr uint32_t SKIP_INTERVAL = 64;
+
+private:
+    // 跳转点：第k*SKIP_INTERVAL段的起点和它在载荷中的偏移
+    struct SkipEntry {
+        uint64_t start_sample;
+        uint64_t byte_offset;
+    };
+
+    uint64_t content_hash_;
+    uint64_t config_hash_;
+    uint32_t sample_rate_;
+    uint64_t total_samples_;
+    uint64_t range_count_;
+    std::vector<SkipEntry> skip_table_;
+    std::vector<uint8_t> payload_;   // 每段: varint(起点 - 上一段终点), varint(长度)
+    bool is_loaded_;
+
+    void decode_from(size_t skip_index, uint64_t t0, uint64_t t1, std::vector<Range>& out) const;
+
+public:
+    SegmentIndex();
+    ~SegmentIndex() = default;
+
+    /**
+     * 计算音频内容的FNV-1a 64位哈希
+     * @param data 数据
+     * @param bytes 字节数
+     * @param seed 初始值，可用于分块累计
+     * @return 哈希值
+     */
+    static uint64_t hash_content(const void* data, size_t bytes, uint64_t seed = 14695981039346656037ull);
+
+    /**
+     * 由有序、不重叠的语音段构建索引
+     * @param speech 语音段
+     * @param sample_rate 采样率 (Hz)
+     * @param total_samples 音频总样本数
+     * @param content_hash 音频内容哈希
+     * @param config_hash 检测参数哈希，参数不同的索引不复用
+     * @return 是否构建成功（段无序或重叠时失败）
+     */
+    bool build(const std::vector<Range>& speech, uint32_t sample_rate, uint64_t total_samples,
+               uint64_t content_hash, uint64_t config_hash = 0);
+
+    /**
+     * 保存到文件
+     * @param path 文件路径
+     * @return 是否保存成功
+     */
+    bool save(const std::string& path) const;
+
+    /**
+     * 从文件加载
+     * @param path 文件路径
+     * @return 是否加载成功
+     */
+    bool load(const std::string& path);
+
+    /**
+     * 检查索引是否对应给定的音频内容和检测参数
+     */
+    bool matches(uint64_t content_hash, uint64_t config_hash = 0) const {
+        return is_loaded_ && content_hash_ == content_hash && config_hash_ == config_hash;
+    }
+
+    /**
+     * 查询与[t0, t1)重叠的语音段，O(log n + k)
+     * @param t0 起始样本
+     * @param t1 结束样本
+     * @return 重叠的语音段（不裁剪到查询区间）
+     */
+    std::vector<Range> query(uint64_t t0, uint64_t t1) const;
+
+    /**
+     * 按毫秒查询与[t0_ms, t1_ms)重叠的语音段
+     */
+    std::vector<Range> query_ms(double t0_ms, double t1_ms) const;
+
+    /**
+     * 解码全部语音段
+     */
+    std::vector<Range> get_all() const { return query(0, UINT64_MAX); }
+
+    bool is_loaded() const { return is_loaded_; }
+    uint64_t get_content_hash() const { return content_hash_; }
+    uint64_t get_config_hash() const { return config_hash_; }
+    uint32_t get_sample_rate() const { return sample_rate_; }
+    uint64_t get_total_samples() const { return total_samples_; }
+    uint64_t get_range_count() const { return range_count_; }
+    size_t get_payload_bytes() const { return payload_.size(); }
+};
+
+} // namespace srv
@@ -0,0 +1,262 @@
+#include "SpeechTrimmer.h"
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+
+namespace srv {
+
+SpeechTrimmer::SpeechTrimmer()
+    : sample_rate_(16000)
+    , channels_(1)
+    , fade_frames_(80)
+    , data_offset_(0)
+    , use_copy_file_range_(true)
+    , is_initialized_(false)
+    , bytes_written_(0)
+    , bytes_zero_copy_(0)
+    , elapsed_seconds_(0.0) {
+}
+
+bool SpeechTrimmer::init(int sample_rate, int channels, int fade_ms, size_t data_offset) {
+    // 参数验证
+    if (sample_rate <= 0 || channels <= 0 || fade_ms < 0) {
+        std::cerr << "SpeechTrimmer init failed: invalid parameters" << std::endl;
+        return false;
+    }
+
+    sample_rate_ = sample_rate;
+    channels_ = channels;
+    fade_frames_ = sample_rate * fade_ms / 1000;
+    data_offset_ = data_offset;
+    use_copy_file_range_ = true;
+    fade_buffer_.assign(static_cast<size_t>(fade_frames_) * channels, 0);
+    is_initialized_ = true;
+    return true;
+}
+
+std::vector<SpeechTrimmer::Range> SpeechTrimmer::invert(const std::vector<Range>& silence, uint64_t total_frames) {
+    std::vector<Range> speech;
+    uint64_t cursor = 0;
+    for (const auto& seg : silence) {
+        uint64_t start = std::min(seg.start_sample, total_frames);
+        if (start > cursor) {
+            speech.push_back({cursor, start});
+        }
+        cursor = std::max(cursor, std::min(seg.end_sample, total_frames));
+    }
+    if (cursor < total_frames) {
+        speech.push_back({cursor, total_frames});
+    }
+    return speech;
+}
+
+bool SpeechTrimmer::write_faded(int out_fd, uint64_t out_offset, const int16_t* src, size_t frames, bool fade_in) {
+    // 线性淡变，增益取帧中心位置，首尾帧都不为精确的0或1
+    for (size_t k = 0; k < frames; ++k) {
+        float gain = (static_cast<float>(k) + 0.5f) / static_cast<float>(frames);
+        if (!fade_in) {
+            gain = 1.0f - gain;
+        }
+        for (int c = 0; c < channels_; ++c) {
+            size_t i = k * channels_ + c;
+            fade_buffer_[i] = static_cast<int16_t>(src[i] * gain);
+        }
+    }
+
+    const size_t bytes = frames * channels_ * sizeof(int16_t);
+    const char* p = reinterpret_cast<const char*>(fade_buffer_.data());
+    size_t done = 0;
+    while (done < bytes) {
+        ssize_t n = pwrite(out_fd, p + done, bytes - done, static_cast<off_t>(out_offset + done));
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        done += static_cast<size_t>(n);
+    }
+    bytes_written_ += bytes;
+    return true;
+}
+
+bool SpeechTrimmer::copy_range(int in_fd, const uint8_t* mapped, uint64_t in_offset,
+                               int out_fd, uint64_t out_offset, uint64_t bytes) {
+#if defined(__linux__)
+    // 文件到文件在内核内完成，同一文件系统上还可能只是共享数据块
+    if (use_copy_file_range_) {
+        loff_t in_pos = static_cast<loff_t>(in_offset);
+        loff_t out_pos = static_cast<loff_t>(out_offset);
+        while (bytes > 0) {
+            ssize_t n = copy_file_range(in_fd, &in_pos, out_fd, &out_pos, static_cast<size_t>(bytes), 0);
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n <= 0) {
+                // 跨文件系统、内核不支持等情况，剩余部分退回pwrite
+                if (n < 0 && (errno == EXDEV || errno == ENOSYS || errno == EOPNOTSUPP || errno == EINVAL)) {
+                    use_copy_file_range_ = false;
+                }
+                break;
+            }
+            bytes -= static_cast<uint64_t>(n);
+            bytes_written_ += static_cast<uint64_t>(n);
+            bytes_zero_copy_ += static_cast<uint64_t>(n);
+        }
+        in_offset = static_cast<uint64_t>(in_pos);
+        out_offset = static_cast<uint64_t>(out_pos);
+    }
+#else
+    (void)in_fd;
+#endif
+
+    // 直接从映射区做大块写入，不经过用户态缓冲
+    while (bytes > 0) {
+        ssize_t n = pwrite(out_fd, mapped + in_offset, static_cast<size_t>(bytes), static_cast<off_t>(out_offset));
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        bytes -= static_cast<uint64_t>(n);
+        in_offset += static_cast<uint64_t>(n);
+        out_offset += static_cast<uint64_t>(n);
+        bytes_written_ += static_cast<uint64_t>(n);
+    }
+    return true;
+}
+
+bool SpeechTrimmer::trim(const std::string& input_path, const std::string& output_path,
+                         const std::vector<Range>& speech) {
+    if (!is_initialized_) {
+        std::cerr << "SpeechTrimmer not initialized" << std::endl;
+        return false;
+    }
+
+    offset_map_.clear();
+    bytes_written_ = 0;
+    bytes_zero_copy_ = 0;
+    elapsed_seconds_ = 0.0;
+    auto start_time = std::chrono::steady_clock::now();
+
+    int in_fd = open(input_path.c_str(), O_RDONLY);
+    if (in_fd < 0) {
+        std::cerr << "SpeechTrimmer trim failed: cannot open " << input_path << std::endl;
+        return false;
+    }
+    struct stat st;
+    if (fstat(in_fd, &st) != 0 || st.st_size <= static_cast<off_t>(data_offset_)) {
+        std::cerr << "SpeechTrimmer trim failed: invalid file size " << input_path << std::endl;
+        close(in_fd);
+        return false;
+    }
+
+    const size_t file_size = static_cast<size_t>(st.st_size);
+    const uint64_t frame_bytes = static_cast<uint64_t>(channels_) * sizeof(int16_t);
+    const uint64_t total_frames = (file_size - data_offset_) / frame_bytes;
+
+    // 校验语音段并计算输出大小
+    uint64_t output_bytes = 0;
+    uint64_t prev_end = 0;
+    for (const auto& r : speech) {
+        if (r.end_sample <= r.start_sample || r.start_sample < prev_end || r.end_sample > total_frames) {
+            std::cerr << "SpeechTrimmer trim failed: ranges must be sorted, non-empty and inside the input" << std::endl;
+            close(in_fd);
+            return false;
+        }
+        output_bytes += (r.end_sample - r.start_sample) * frame_bytes;
+        prev_end = r.end_sample;
+    }
+
+    void* data = mmap(nullptr, file_size, PROT_READ, MAP_SHARED, in_fd, 0);
+    if (data == MAP_FAILED) {
+        std::cerr << "SpeechTrimmer trim failed: mmap error " << input_path << std::endl;
+        close(in_fd);
+        return false;
+    }
+    // 顺序读取，让内核积极预读并及时回收已读页
+    madvise(data, file_size, MADV_SEQUENTIAL);
+    const uint8_t* mapped = static_cast<const uint8_t*>(data);
+
+    int out_fd = open(output_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (out_fd < 0) {
+        std::cerr << "SpeechTrimmer trim failed: cannot create " << output_path << std::endl;
+        munmap(data, file_size);
+        close(in_fd);
+        return false;
+    }
+    // 预先设定输出长度，各段按偏移写入
+    bool ok = ftruncate(out_fd, static_cast<off_t>(output_bytes)) == 0;
+
+    uint64_t out_frame = 0;
+    for (size_t i = 0; ok && i < speech.size(); ++i) {
+        const Range& r = speech[i];
+        const uint64_t length = r.end_sample - r.start_sample;
+        const uint64_t fade = std::min<uint64_t>(static_cast<uint64_t>(fade_frames_), length / 2);
+        // 原始音频的起止处不是切点，不加淡变
+        const uint64_t fade_in = r.start_sample > 0 ? fade : 0;
+        const uint64_t fade_out = r.end_sample < total_frames ? fade : 0;
+        const uint64_t in_offset = data_offset_ + r.start_sample * frame_bytes;
+        const uint64_t out_offset = out_frame * frame_bytes;
+
+        offset_map_.push_back({out_frame, r.start_sample, length});
+
+        if (fade_in > 0) {
+            ok = write_faded(out_fd, out_offset, reinterpret_cast<const int16_t*>(mapped + in_offset),
+                             static_cast<size_t>(fade_in), true);
+        }
+        const uint64_t middle = length - fade_in - fade_out;
+        if (ok && middle > 0) {
+            ok = copy_range(in_fd, mapped, in_offset + fade_in * frame_bytes,
+                            out_fd, out_offset + fade_in * frame_bytes, middle * frame_bytes);
+        }
+        if (ok && fade_out > 0) {
+            uint64_t tail = (length - fade_out) * frame_bytes;
+            ok = write_faded(out_fd, out_offset + tail, reinterpret_cast<const int16_t*>(mapped + in_offset + tail),
+                             static_cast<size_t>(fade_out), false);
+        }
+        out_frame += length;
+    }
+
+    if (!ok) {
+        std::cerr << "SpeechTrimmer trim failed: write error " << output_path << std::endl;
+    }
+    close(out_fd);
+    munmap(data, file_size);
+    close(in_fd);
+
+    elapsed_seconds_ = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+    return ok;
+}
+
+bool SpeechTrimmer::write_offset_map(const std::string& path) const {
+    std::ofstream file(path, std::ios::trunc);
+    if (!file.is_open()) {
+        std::cerr << "SpeechTrimmer write map failed: cannot create " << path << std::endl;
+        return false;
+    }
+    file << "output_frame,input_frame,length\n";
+    for (const auto& entry : offset_map_) {
+        file << entry.output_frame << "," << entry.input_frame << "," << entry.length << "\n";
+    }
+    return file.good();
+}
+
+uint64_t SpeechTrimmer::output_to_input(uint64_t output_frame) const {
+    if (offset_map_.empty()) {
+        return output_frame;
+    }
+    auto it = std::upper_bound(offset_map_.begin(), offset_map_.end(), output_frame,
+                               [](uint64_t f, const MapEntry& e) { return f < e.output_frame; });
+    const MapEntry& entry = *(it == offset_map_.begin() ? it : it - 1);
+    return entry.input_frame + std::min(output_frame - entry.output_frame, entry.length);
+}
+
+} // namespace srv
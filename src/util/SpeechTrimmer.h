@@ -0,0 +1,103 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "SegmentIndex.h"
+
+// 只保留语音段的裁剪输出：输入内存映射，中段用copy_file_range零拷贝（不可用时直接从映射区pwrite），切点加短淡入淡出
+namespace srv {
+
+class SpeechTrimmer {
+public:
+    using Range = SegmentIndex::Range;
+
+    // 偏移映射：输出中[output_frame, output_frame+length)对应原始音频[input_frame, input_frame+length)
+    struct MapEntry {
+        uint64_t output_frame;
+        uint64_t input_frame;
+        uint64_t length;
+    };
+
+private:
+    int sample_rate_;
+    int channels_;
+    int fade_frames_;           // 切点淡入淡出长度（帧数）
+    size_t data_offset_;        // 输入文件中PCM数据的起始字节（WAV头长度，裸PCM为0）
+    bool use_copy_file_range_;  // 遇到不支持的文件系统后关闭
+    bool is_initialized_;
+
+    std::vector<MapEntry> offset_map_;
+    std::vector<int16_t> fade_buffer_;
+    uint64_t bytes_written_;
+    uint64_t bytes_zero_copy_;  // 经copy_file_range在内核内完成的字节数
+    double elapsed_seconds_;
+
+    bool write_faded(int out_fd, uint64_t out_offset, const int16_t* src, size_t frames, bool fade_in);
+    bool copy_range(int in_fd, const uint8_t* mapped, uint64_t in_offset,
+                    int out_fd, uint64_t out_offset, uint64_t bytes);
+
+public:
+    SpeechTrimmer();
+    ~SpeechTrimmer() = default;
+
+    /**
+     * 初始化
+     * @param sample_rate 采样率 (Hz)
+     * @param channels 声道数（16位交错PCM）
+     * @param fade_ms 切点淡入淡出时长（毫秒），0表示不加淡变
+     * @param data_offset 输入文件中PCM数据的起始字节
+     * @return 是否初始化成功
+     */
+    bool init(int sample_rate = 16000, int channels = 1, int fade_ms = 5, size_t data_offset = 0);
+
+    /**
+     * 把输入文件中的语音段依次拼接写到输出文件（裸PCM）
+     * @param input_path 输入文件
+     * @param output_path 输出文件
+     * @param speech 有序、不重叠的语音段（帧下标）
+     * @return 是否成功
+     */
+    bool trim(const std::string& input_path, const std::string& output_path, const std::vector<Range>& speech);
+
+    /**
+     * 静音段取反得到语音段
+     * @param silence 有序的静音段（帧下标）
+     * @param total_frames 总帧数
+     * @return 语音段
+     */
+    static std::vector<Range> invert(const std::vector<Range>& silence, uint64_t total_frames);
+
+    /**
+     * 写出偏移映射（CSV: output_frame,input_frame,length）
+     * @param path 文件路径
+     * @return 是否成功
+     */
+    bool write_offset_map(const std::string& path) const;
+
+    /**
+     * 把输出中的帧位置换算回原始音频中的帧位置
+     * @param output_frame 输出帧位置
+     * @return 原始帧位置
+     */
+    uint64_t output_to_input(uint64_t output_frame) const;
+
+    /**
+     * 检查是否已初始化
+     */
+    bool is_initialized() const { return is_initialized_; }
+
+    const std::vector<MapEntry>& get_offset_map() const { return offset_map_; }
+    uint64_t get_bytes_written() const { return bytes_written_; }
+    uint64_t get_bytes_zero_copy() const { return bytes_zero_copy_; }
+    double get_elapsed_seconds() const { return elapsed_seconds_; }
+
+    /**
+     * 上次trim的输出吞吐 (MB/s)
+     */
+    double get_throughput_mbps() const {
+        return elapsed_seconds_ > 0.0 ? bytes_written_ / (1024.0 * 1024.0) / elapsed_seconds_ : 0.0;
+    }
+};
+
+} // namespace srv
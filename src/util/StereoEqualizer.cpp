@@ -0,0 +1,250 @@
+#include "StereoEqualizer.h"
+#include "DSPKernels.h"
+#include "Equalizer.h"
+#include "FFTPlanRegistry.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace srv {
+
+StereoEqualizer::StereoEqualizer()
+    : fft_bits_(0)
+    , fft_size_(0)
+    , sample_rate_(48000.0)
+    , preamp_(1.0f)
+    , fft_plan_forward_(nullptr)
+    , fft_plan_backward_(nullptr)
+    , fft_buffer_(nullptr)
+    , input_fill_(0)
+    , fifo_read_(0)
+    , fifo_count_(0)
+    , skip_(0)
+    , is_initialized_(false) {
+}
+
+StereoEqualizer::~StereoEqualizer() {
+    cleanup();
+}
+
+bool StereoEqualizer::init(int fft_bits, double sample_rate) {
+    cleanup();
+    if (fft_bits < 4 || fft_bits > 20 || sample_rate <= 0.0) {
+        std::cerr << "StereoEqualizer init failed: invalid parameters" << std::endl;
+        return false;
+    }
+    fft_bits_ = fft_bits;
+    fft_size_ = 1 << fft_bits;
+    sample_rate_ = sample_rate;
+
+    fft_buffer_ = fftwf_alloc_complex(fft_size_);
+    if (!fft_buffer_) {
+        std::cerr << "StereoEqualizer init failed: cannot allocate FFT buffer" << std::endl;
+        cleanup();
+        return false;
+    }
+    fft_plan_forward_ = FFTPlanRegistry::instance().get_dft(fft_size_, FFTW_FORWARD, fft_buffer_, fft_buffer_);
+    fft_plan_backward_ = FFTPlanRegistry::instance().get_dft(fft_size_, FFTW_BACKWARD, fft_buffer_, fft_buffer_);
+    if (!fft_plan_forward_ || !fft_plan_backward_) {
+        std::cerr << "StereoEqualizer init failed: cannot create FFT plan" << std::endl;
+        cleanup();
+        return false;
+    }
+
+    // 与Equalizer相同的Hann窗
+    window_.resize(fft_size_);
+    for (int i = 0; i < fft_size_; ++i) {
+        window_[i] = 0.5f - 0.5f * cos(2.0f * M_PI * i / (fft_size_ - 1));
+    }
+
+    overlap_buffer_.assign(fft_size_, 0.0f);
+    input_buffer_.assign(2 * fft_size_, 0.0f);
+    output_fifo_.assign(4 * fft_size_, 0.0f);
+    convert_buffer_.assign(2 * fft_size_, 0.0f);
+    eq_response_.assign(fft_size_ / 2 + 1, 1.0f);
+    full_response_.assign(fft_size_, 1.0f);
+    is_initialized_ = true;
+    reset();
+    return true;
+}
+
+void StereoEqualizer::cleanup() {
+    // 计划归注册表所有，这里只放弃引用
+    fft_plan_forward_ = nullptr;
+    fft_plan_backward_ = nullptr;
+    if (fft_buffer_) {
+        fftwf_free(fft_buffer_);
+        fft_buffer_ = nullptr;
+    }
+    is_initialized_ = false;
+}
+
+void StereoEqualizer::setEQdB(const std::vector<float>& db_values) {
+    if (!is_initialized_ || db_values.size() < 2) {
+        return;
+    }
+    // 频点与增益的对应关系与Equalizer::setEQdB相同，保证每个声道的输出与单声道一致
+    auto freqs = Equalizer::calculateFreqs(db_values.size());
+    for (size_t i = 0; i < eq_response_.size(); ++i) {
+        double freq = static_cast<double>(i + 1) * sample_rate_ / fft_size_;
+        eq_response_[i] = Equalizer::interpolateGain(freqs, db_values, freq) * preamp_;
+    }
+    // 负频率k与正频率fft_size-k的增益相同
+    for (int k = 0; k < fft_size_; ++k) {
+        full_response_[k] = eq_response_[std::min(k, fft_size_ - k)];
+    }
+}
+
+void StereoEqualizer::setPreamp(float preamp) {
+    preamp_ = preamp;
+}
+
+void StereoEqualizer::process_hop() {
+    const int hop_size = fft_size_ / 2;  // 50%重叠
+    float* buffer = reinterpret_cast<float*>(fft_buffer_);
+
+    // 交织样本加窗即得到 L + iR
+    for (int j = 0; j < fft_size_; ++j) {
+        buffer[2 * j] = input_buffer_[2 * j] * window_[j];
+        buffer[2 * j + 1] = input_buffer_[2 * j + 1] * window_[j];
+    }
+
+    fftwf_execute_dft(fft_plan_forward_, fft_buffer_, fft_buffer_);
+
+    // 实数对称增益：两个声道的频谱同时乘上同一增益，逆变换后仍互不混叠
+    for (int k = 0; k < fft_size_; ++k) {
+        const float coeff = full_response_[k];
+        fft_buffer_[k][0] *= coeff;
+        fft_buffer_[k][1] *= coeff;
+    }
+
+    fftwf_execute_dft(fft_plan_backward_, fft_buffer_, fft_buffer_);
+
+    // 重叠-相加，结果（交织）追加到输出FIFO
+    const float scale = 1.0f / fft_size_;
+    const size_t mask = output_fifo_.size() / 2 - 1;
+    const size_t write = fifo_read_ + fifo_count_;
+    for (int j = 0; j < hop_size; ++j) {
+        float* out = &output_fifo_[2 * ((write + j) & mask)];
+        out[0] = buffer[2 * j] * scale + overlap_buffer_[2 * j];
+        out[1] = buffer[2 * j + 1] * scale + overlap_buffer_[2 * j + 1];
+
+        // 保存重叠部分
+        overlap_buffer_[2 * j] = buffer[2 * (j + hop_size)] * scale;
+        overlap_buffer_[2 * j + 1] = buffer[2 * (j + hop_size) + 1] * scale;
+    }
+    fifo_count_ += hop_size;
+
+    // 分析帧前移半帧
+    std::copy(input_buffer_.begin() + fft_size_, input_buffer_.end(), input_buffer_.begin());
+    input_fill_ = hop_size;
+}
+
+void StereoEqualizer::push_frames(const float* input, float* output, size_t frames) {
+    const size_t mask = output_fifo_.size() / 2 - 1;
+    while (frames > 0) {
+        const size_t take = std::min(frames, static_cast<size_t>(fft_size_) - input_fill_);
+        // 先取走输入再写输出，input和output可以是同一块内存
+        if (input) {
+            std::copy(input, input + 2 * take, &input_buffer_[2 * input_fill_]);
+            input += 2 * take;
+        } else {
+            std::fill(&input_buffer_[2 * input_fill_], &input_buffer_[2 * (input_fill_ + take)], 0.0f);
+        }
+        input_fill_ += take;
+        if (input_fill_ == static_cast<size_t>(fft_size_)) {
+            process_hop();
+        }
+
+        // 延迟为fft_size-1时FIFO中总有足够的帧
+        for (size_t i = 0; i < take; ++i) {
+            const float* in = &output_fifo_[2 * ((fifo_read_ + i) & mask)];
+            output[2 * i] = in[0];
+            output[2 * i + 1] = in[1];
+        }
+        fifo_read_ = (fifo_read_ + take) & mask;
+        fifo_count_ -= take;
+        output += 2 * take;
+        frames -= take;
+    }
+}
+
+void StereoEqualizer::process(const float* input, float* output, size_t frames) {
+    if (!is_initialized_) {
+        std::fill(output, output + 2 * frames, 0.0f);
+        return;
+    }
+    push_frames(input, output, frames);
+}
+
+size_t StereoEqualizer::flush(float* output) {
+    if (!is_initialized_) {
+        return 0;
+    }
+    const size_t latency = get_latency();
+    push_frames(nullptr, output, latency);
+    reset();
+    return latency;
+}
+
+void StereoEqualizer::append_s16(const float* samples, size_t frames, std::vector<short>& output) {
+    // 丢弃流开头的延迟帧，输出与输入对齐
+    const size_t drop = static_cast<size_t>(std::min<uint64_t>(skip_, frames));
+    skip_ -= drop;
+    const size_t written = output.size();
+    output.resize(written + 2 * (frames - drop));
+    kernels::f32_to_s16(samples + 2 * drop, output.data() + written, 2 * (frames - drop), 32768.0f);
+}
+
+void StereoEqualizer::process(const short* input, size_t frames, std::vector<short>& output) {
+    if (!is_initialized_) {
+        return;
+    }
+    while (frames > 0) {
+        const size_t take = std::min(frames, convert_buffer_.size() / 2);
+        kernels::s16_to_f32(input, convert_buffer_.data(), 2 * take, 1.0f / 32768.0f);
+        push_frames(convert_buffer_.data(), convert_buffer_.data(), take);
+        append_s16(convert_buffer_.data(), take, output);
+        input += 2 * take;
+        frames -= take;
+    }
+}
+
+void StereoEqualizer::flush(std::vector<short>& output) {
+    if (!is_initialized_) {
+        return;
+    }
+    const size_t latency = get_latency();
+    push_frames(nullptr, convert_buffer_.data(), latency);
+    append_s16(convert_buffer_.data(), latency, output);
+    reset();
+}
+
+void StereoEqualizer::reset() {
+    std::fill(overlap_buffer_.begin(), overlap_buffer_.end(), 0.0f);
+    std::fill(input_buffer_.begin(), input_buffer_.end(), 0.0f);
+    input_fill_ = 0;
+
+    // 输出FIFO预置fft_size-1帧零，即固定延迟
+    std::fill(output_fifo_.begin(), output_fifo_.end(), 0.0f);
+    fifo_read_ = 0;
+    fifo_count_ = get_latency();
+    skip_ = get_latency();
+}
+
+std::vector<short> StereoEqualizer::processAudio(const std::vector<short>& input) {
+    std::vector<short> output;
+    if (!is_initialized_) {
+        return output;
+    }
+    output.reserve(input.size());
+    reset();
+    const size_t frames = input.size() / 2;
+    process(input.data(), frames, output);
+    flush(output);
+    // 奇数个样本时最后半帧原样输出，保证输出与输入等长
+    output.insert(output.end(), input.begin() + 2 * frames, input.end());
+    return output;
+}
+
+} // namespace srv
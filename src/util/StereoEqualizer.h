@@ -0,0 +1,130 @@
+#pragma once
+#include <fftw3.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// 立体声FFT均衡器：左右声道分别作为一次复数FFT的实部和虚部，一次变换处理两个声道
+// EQ增益是实数且正负频率对称，乘增益后逆变换的实部、虚部仍分别是左、右声道，不需要拆分频谱
+// 交织样本(L0 R0 L1 R1 ...)的内存布局正好是fftwf_complex数组，加窗后直接变换，输出直接是交织样本
+// 重叠-相加、频段曲线和延迟与Equalizer相同，每个声道的输出与单声道Equalizer一致（浮点舍入误差内）
+namespace srv {
+
+class StereoEqualizer {
+private:
+    int fft_bits_;
+    int fft_size_;
+    double sample_rate_;
+    float preamp_;
+
+    // 复数FFT计划（原位，fft_buffer_），由FFTPlanRegistry共享
+    fftwf_plan fft_plan_forward_;
+    fftwf_plan fft_plan_backward_;
+    fftwf_complex* fft_buffer_;     // fft_size_个复数，即fft_size_帧交织样本
+
+    // 窗口函数
+    std::vector<float> window_;
+
+    // EQ频率响应：eq_response_与Equalizer::get_response()相同（fft_size_/2+1个频点），
+    // full_response_按共轭对称展开到全部fft_size_个频点
+    std::vector<float> eq_response_;
+    std::vector<float> full_response_;
+
+    // 重叠-相加缓冲区（半帧，交织）
+    std::vector<float> overlap_buffer_;
+
+    // 输入FIFO（当前分析帧，交织，累积到fft_size_帧才处理）
+    std::vector<float> input_buffer_;
+    size_t input_fill_;             // 帧数
+
+    // 输出FIFO（环形，2*fft_size_帧，交织），重置时预置get_latency()帧零
+    std::vector<float> output_fifo_;
+    size_t fifo_read_;              // 帧
+    size_t fifo_count_;             // 帧数
+
+    // short接口的格式转换缓冲区，以及流开头还要丢弃的延迟帧数
+    std::vector<float> convert_buffer_;
+    uint64_t skip_;
+
+    bool is_initialized_;
+
+    void cleanup();
+    void process_hop();
+    void push_frames(const float* input, float* output, size_t frames);
+    void append_s16(const float* samples, size_t frames, std::vector<short>& output);
+
+public:
+    StereoEqualizer();
+    ~StereoEqualizer();
+
+    StereoEqualizer(const StereoEqualizer&) = delete;
+    StereoEqualizer& operator=(const StereoEqualizer&) = delete;
+
+    /**
+     * 初始化
+     * @param fft_bits FFT点数的log2（10为1024点）
+     * @param sample_rate 采样率
+     * @return 是否初始化成功
+     */
+    bool init(int fft_bits = 10, double sample_rate = 48000.0);
+
+    // 设置EQ频段dB值（两个声道相同，频段布局同Equalizer）
+    void setEQdB(const std::vector<float>& db_values);
+
+    // 设置预放大，下一次setEQdB时生效
+    void setPreamp(float preamp);
+
+    /**
+     * 流式处理（实时接口）：任意帧数，输出与输入等长，固定延迟get_latency()帧
+     * 稳态不分配内存，input和output可以是同一块内存
+     * @param input 交织立体声输入（-1.0到1.0）
+     * @param output 交织立体声输出
+     * @param frames 帧数
+     */
+    void process(const float* input, float* output, size_t frames);
+
+    /**
+     * 输入结束：补零冲出延迟中的最后get_latency()帧，然后清空状态
+     * @param output 输出缓冲区，至少get_latency()帧
+     * @return 写出的帧数（即get_latency()）
+     */
+    size_t flush(float* output);
+
+    /**
+     * 流式处理（short接口，交织）：去掉开头的延迟，输出追加到output末尾
+     * 结束时调用flush取出剩余样本，总输出与总输入等长
+     */
+    void process(const short* input, size_t frames, std::vector<short>& output);
+
+    /**
+     * 输入结束：补零处理完剩余样本，然后清空状态
+     */
+    void flush(std::vector<short>& output);
+
+    /**
+     * 清空流式处理状态（保留EQ设置）
+     */
+    void reset();
+
+    /**
+     * 流式处理的固定延迟（帧数），为fft_size-1
+     */
+    size_t get_latency() const { return fft_size_ > 0 ? static_cast<size_t>(fft_size_ - 1) : 0; }
+
+    /**
+     * 处理整段交织立体声音频，输出与输入等长，处理前清空流式状态
+     * 样本数为奇数时，最后一个样本不经过均衡原样输出
+     */
+    std::vector<short> processAudio(const std::vector<short>& input);
+
+    /**
+     * 获取当前每个频点的增益（fft_size/2+1个，已乘预放大）
+     */
+    const std::vector<float>& get_response() const { return eq_response_; }
+
+    bool is_initialized() const { return is_initialized_; }
+    int get_fft_size() const { return fft_size_; }
+    double get_sample_rate() const { return sample_rate_; }
+};
+
+} // namespace srv
@@ -0,0 +1,215 @@
+#include "StreamPipeline.h"
+#include "Resampler.h"
+#include "WavWriter.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <thread>
+
+namespace srv {
+
+namespace {
+
+double seconds_between(std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end) {
+    return std::chrono::duration<double>(end - start).count();
+}
+
+} // namespace
+
+StreamPipeline::StreamPipeline()
+    : block_frames_(0),
+      io_frames_(0),
+      target_rate_(0),
+      mono_(false),
+      sample_rate_(0),
+      channels_(0),
+      frames_in_(0),
+      frames_out_(0),
+      reader_wait_seconds_(0.0),
+      writer_wait_seconds_(0.0),
+      process_seconds_(0.0),
+      total_seconds_(0.0),
+      is_initialized_(false) {}
+
+bool StreamPipeline::init(size_t block_frames, int target_rate, bool mono, size_t io_frames) {
+    if (block_frames == 0 || target_rate < 0 || io_frames < block_frames) {
+        std::cerr << "StreamPipeline init failed: invalid parameters" << std::endl;
+        return false;
+    }
+    block_frames_ = block_frames;
+    target_rate_ = target_rate;
+    mono_ = mono;
+    io_frames_ = io_frames;
+    is_initialized_ = true;
+    return true;
+}
+
+void StreamPipeline::reader_loop(const AudioFile& file, Resampler* resampler, uint64_t expected_frames) {
+    const int file_channels = file.get_channels();
+    const size_t out_channels = static_cast<size_t>(channels_);
+    const uint64_t num_frames = file.get_num_frames();
+    std::vector<int16_t> raw(io_frames_ * file_channels);
+    std::vector<int16_t> tail;
+    if (resampler) {
+        tail.assign(static_cast<size_t>(resampler->get_input_latency()) * out_channels, 0);
+    }
+
+    uint64_t produced = 0;
+    uint64_t start = 0;
+    while (start < num_frames) {
+        BlockQueue::Buffer* buffer = input_queue_.acquire_free();
+        if (!buffer) {
+            return;
+        }
+        size_t frames = file.read_s16(start, io_frames_, raw.data());
+        // 已转换的页不再需要，保持映射文件的常驻内存不随处理进度增长
+        file.release(start, frames);
+        start += frames;
+
+        if (mono_ && file_channels > 1) {
+            for (size_t i = 0; i < frames; ++i) {
+                int32_t sum = 0;
+                for (int c = 0; c < file_channels; ++c) {
+                    sum += raw[i * file_channels + c];
+                }
+                raw[i] = static_cast<int16_t>(sum / file_channels);
+            }
+        }
+
+        if (resampler) {
+            resampler->process(raw.data(), frames, *buffer);
+            if (start >= num_frames) {
+                // 末尾补零冲出重采样器内部缓存的样本
+                resampler->process(tail.data(), tail.size() / out_channels, *buffer);
+            }
+        } else {
+            buffer->assign(raw.begin(), raw.begin() + frames * out_channels);
+        }
+
+        size_t buffer_frames = buffer->size() / out_channels;
+        if (produced + buffer_frames > expected_frames) {
+            buffer_frames = static_cast<size_t>(expected_frames - produced);
+            buffer->resize(buffer_frames * out_channels);
+        }
+        produced += buffer_frames;
+        input_queue_.submit(buffer);
+        if (frames == 0) {
+            break;
+        }
+    }
+    input_queue_.close();
+}
+
+bool StreamPipeline::run(const std::string& input_path, const std::string& output_path,
+                         const BlockProcessor& processor, const AudioFile::Format* raw_format) {
+    if (!is_initialized_ || !processor) {
+        return false;
+    }
+    auto run_start = std::chrono::steady_clock::now();
+    frames_in_ = 0;
+    frames_out_ = 0;
+    reader_wait_seconds_ = 0.0;
+    writer_wait_seconds_ = 0.0;
+    process_seconds_ = 0.0;
+    total_seconds_ = 0.0;
+
+    AudioFile file;
+    if (!file.open(input_path, raw_format)) {
+        return false;
+    }
+    const int file_rate = file.get_sample_rate();
+    sample_rate_ = target_rate_ > 0 ? target_rate_ : file_rate;
+    channels_ = mono_ ? 1 : file.get_channels();
+    const size_t channels = static_cast<size_t>(channels_);
+    const uint64_t expected_frames = file.get_num_frames() * static_cast<uint64_t>(sample_rate_) / file_rate;
+
+    Resampler resampler;
+    Resampler* active_resampler = nullptr;
+    size_t buffer_frames = io_frames_;
+    if (sample_rate_ != file_rate) {
+        if (!resampler.init(file_rate, sample_rate_, channels_)) {
+            return false;
+        }
+        // reset跳过滤波器起始的零延迟，输出与输入对齐
+        resampler.reset();
+        active_resampler = &resampler;
+        buffer_frames = static_cast<size_t>((io_frames_ + resampler.get_input_latency() + 1) *
+                                            static_cast<uint64_t>(sample_rate_) / file_rate) + 16;
+    }
+    if (!input_queue_.init(2, buffer_frames * channels)) {
+        return false;
+    }
+
+    WavWriter writer;
+    if (!output_path.empty() && !writer.open(output_path, sample_rate_, channels_, io_frames_)) {
+        return false;
+    }
+
+    block_.assign(block_frames_ * channels, 0);
+    size_t block_fill = 0;
+    bool ok = true;
+
+    auto emit = [&](int16_t* samples, size_t frames) {
+        auto start = std::chrono::steady_clock::now();
+        size_t out = std::min(processor(samples, frames), frames);
+        process_seconds_ += seconds_between(start, std::chrono::steady_clock::now());
+        if (out > 0 && writer.is_open() && !writer.write(samples, out)) {
+            ok = false;
+        }
+        frames_out_ += out;
+    };
+
+    std::thread reader(&StreamPipeline::reader_loop, this, std::cref(file), active_resampler, expected_frames);
+    while (ok) {
+        BlockQueue::Buffer* buffer = input_queue_.acquire_full();
+        if (!buffer) {
+            break;
+        }
+        const size_t frames = buffer->size() / channels;
+        int16_t* data = buffer->data();
+        frames_in_ += frames;
+        size_t pos = 0;
+
+        // 先补齐上一个读缓冲区末尾留下的不完整块
+        if (block_fill > 0) {
+            size_t take = std::min(block_frames_ - block_fill, frames);
+            std::memcpy(block_.data() + block_fill * channels, data, take * channels * sizeof(int16_t));
+            block_fill += take;
+            pos = take;
+            if (block_fill == block_frames_) {
+                emit(block_.data(), block_frames_);
+                block_fill = 0;
+            }
+        }
+        // 完整的块直接在读缓冲区上就地处理，不再拷贝
+        while (ok && pos + block_frames_ <= frames) {
+            emit(data + pos * channels, block_frames_);
+            pos += block_frames_;
+        }
+        if (pos < frames) {
+            std::memcpy(block_.data(), data + pos * channels, (frames - pos) * channels * sizeof(int16_t));
+            block_fill = frames - pos;
+        }
+        input_queue_.recycle(buffer);
+    }
+    if (ok && block_fill > 0) {
+        emit(block_.data(), block_fill);
+    }
+    if (!ok) {
+        input_queue_.abort();
+    }
+    reader.join();
+
+    reader_wait_seconds_ = input_queue_.get_consumer_wait_seconds();
+    if (writer.is_open()) {
+        writer_wait_seconds_ = writer.get_wait_seconds();
+        if (!writer.close()) {
+            ok = false;
+        }
+    }
+    total_seconds_ = seconds_between(run_start, std::chrono::steady_clock::now());
+    return ok;
+}
+
+} // namespace srv
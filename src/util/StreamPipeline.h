@@ -0,0 +1,105 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+#include "AudioFile.h"
+#include "BlockQueue.h"
+
+// 长录音流式处理：读线程双缓冲大块读取（可选混音/重采样），调用线程按固定块长处理，写线程异步追加WAV
+// 内存占用只与块大小有关，与文件时长无关
+namespace srv {
+
+class Resampler;
+
+class StreamPipeline {
+public:
+    /**
+     * 块处理回调：就地处理一块交织int16样本
+     * @param samples 样本（frames*channels个），处理结果写回原处
+     * @param frames 本块帧数，只有最后一块可能小于块长
+     * @return 写出的帧数（从块首开始，不超过frames），例如返回0丢弃本块
+     */
+    using BlockProcessor = std::function<size_t(int16_t* samples, size_t frames)>;
+
+private:
+    size_t block_frames_;
+    size_t io_frames_;
+    int target_rate_;
+    bool mono_;
+
+    int sample_rate_;       // 处理阶段的采样率
+    int channels_;          // 处理阶段的声道数
+    uint64_t frames_in_;
+    uint64_t frames_out_;
+    double reader_wait_seconds_;
+    double writer_wait_seconds_;
+    double process_seconds_;
+    double total_seconds_;
+
+    BlockQueue input_queue_;
+    std::vector<int16_t> block_;        // 跨读缓冲区边界的块
+    bool is_initialized_;
+
+    void reader_loop(const AudioFile& file, Resampler* resampler, uint64_t expected_frames);
+
+public:
+    StreamPipeline();
+    ~StreamPipeline() = default;
+
+    StreamPipeline(const StreamPipeline&) = delete;
+    StreamPipeline& operator=(const StreamPipeline&) = delete;
+
+    /**
+     * 初始化
+     * @param block_frames 处理块长（帧），如RNNoise的480
+     * @param target_rate 处理采样率，与文件不同时在读线程重采样，0表示保持原采样率
+     * @param mono 是否在读线程混音为单声道
+     * @param io_frames 每次读/写的帧数（各两个缓冲区）
+     * @return 是否初始化成功
+     */
+    bool init(size_t block_frames, int target_rate = 0, bool mono = false, size_t io_frames = 65536);
+
+    /**
+     * 流式处理整个文件
+     * @param input_path 输入文件（WAV或原始PCM，见AudioFile::open）
+     * @param output_path 输出WAV路径，为空时只分析不写出
+     * @param processor 块处理回调，在调用线程中执行
+     * @param raw_format 原始PCM的默认格式，可为空
+     * @return 是否成功
+     */
+    bool run(const std::string& input_path, const std::string& output_path, const BlockProcessor& processor,
+             const AudioFile::Format* raw_format = nullptr);
+
+    bool is_initialized() const { return is_initialized_; }
+    size_t get_block_frames() const { return block_frames_; }
+
+    // 以下为最近一次run()的信息
+    int get_sample_rate() const { return sample_rate_; }
+    int get_channels() const { return channels_; }
+    uint64_t get_frames_in() const { return frames_in_; }
+    uint64_t get_frames_out() const { return frames_out_; }
+
+    /**
+     * 处理线程等待读线程的时间（秒），非零说明读取/解码比处理慢
+     */
+    double get_reader_wait_seconds() const { return reader_wait_seconds_; }
+
+    /**
+     * 处理线程等待写线程的时间（秒），非零说明写盘比处理慢
+     */
+    double get_writer_wait_seconds() const { return writer_wait_seconds_; }
+
+    /**
+     * 回调累计耗时（秒）
+     */
+    double get_process_seconds() const { return process_seconds_; }
+
+    /**
+     * run()总耗时（秒）
+     */
+    double get_total_seconds() const { return total_seconds_; }
+};
+
+} // namespace srv
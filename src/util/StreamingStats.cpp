@@ -0,0 +1,274 @@
+#include "StreamingStats.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
+
+namespace srv {
+
+StreamingStats::P2Quantile::P2Quantile(double quantile)
+    : p(quantile)
+    , count(0)
+    , heights{0.0, 0.0, 0.0, 0.0, 0.0}
+    , positions{1.0, 2.0, 3.0, 4.0, 5.0}
+    , desired{0.0, 0.0, 0.0, 0.0, 0.0}
+    , increments{0.0, quantile / 2.0, quantile, (1.0 + quantile) / 2.0, 1.0} {
+    reset_desired();
+}
+
+void StreamingStats::P2Quantile::reset_desired() {
+    // 理想位置 1 + (n-1) * {0, p/2, p, (1+p)/2, 1}
+    const double n = static_cast<double>(std::max<uint64_t>(count, 5));
+    for (int i = 0; i < 5; ++i) {
+        desired[i] = 1.0 + (n - 1.0) * increments[i];
+    }
+}
+
+void StreamingStats::P2Quantile::add(double x) {
+    // 前5个样本直接保存并排序
+    if (count < 5) {
+        heights[count++] = x;
+        if (count == 5) {
+            std::sort(heights, heights + 5);
+            reset_desired();
+        }
+        return;
+    }
+    count++;
+
+    // 极值标记直接更新；所在区间用比较结果求和得到，避免随机数据上的分支预测失败
+    heights[0] = std::min(heights[0], x);
+    heights[4] = std::max(heights[4], x);
+    positions[1] += static_cast<double>(x < heights[1]);
+    positions[2] += static_cast<double>(x < heights[2]);
+    positions[3] += static_cast<double>(x < heights[3]);
+    positions[4] += 1.0;
+    for (int i = 0; i < 5; ++i) {
+        desired[i] += increments[i];
+    }
+
+    // 调整中间3个标记点：先试抛物线插值，越界则退回线性插值
+    for (int i = 1; i <= 3; ++i) {
+        double d = desired[i] - positions[i];
+        if ((d >= 1.0 && positions[i + 1] - positions[i] > 1.0) ||
+            (d <= -1.0 && positions[i - 1] - positions[i] < -1.0)) {
+            const double s = d >= 0.0 ? 1.0 : -1.0;
+            const double np = positions[i + 1] - positions[i];
+            const double nm = positions[i] - positions[i - 1];
+            double h = heights[i] + s / (positions[i + 1] - positions[i - 1]) *
+                       ((nm + s) * (heights[i + 1] - heights[i]) / np +
+                        (np - s) * (heights[i] - heights[i - 1]) / nm);
+            if (h <= heights[i - 1] || h >= heights[i + 1]) {
+                const int j = i + static_cast<int>(s);
+                h = heights[i] + s * (heights[j] - heights[i]) / (positions[j] - positions[i]);
+            }
+            heights[i] = h;
+            positions[i] += s;
+        }
+    }
+}
+
+double StreamingStats::P2Quantile::get() const {
+    if (count == 0) {
+        return 0.0;
+    }
+    if (count < 5) {
+        double sorted[5];
+        std::copy(heights, heights + count, sorted);
+        std::sort(sorted, sorted + count);
+        size_t index = static_cast<size_t>(std::lround(p * static_cast<double>(count - 1)));
+        return sorted[index];
+    }
+    return heights[2];
+}
+
+void StreamingStats::P2Quantile::merge(const P2Quantile& other) {
+    if (other.count == 0) {
+        return;
+    }
+    if (other.count < 5) {
+        for (uint64_t i = 0; i < other.count; ++i) {
+            add(other.heights[i]);
+        }
+        return;
+    }
+    if (count < 5) {
+        P2Quantile merged(other);
+        for (uint64_t i = 0; i < count; ++i) {
+            merged.add(heights[i]);
+        }
+        *this = merged;
+        return;
+    }
+
+    // 两份标记点按样本数加权平均高度、位置相加，首尾标记取真实极值
+    const double wa = static_cast<double>(count);
+    const double wb = static_cast<double>(other.count);
+    for (int i = 1; i <= 3; ++i) {
+        heights[i] = (heights[i] * wa + other.heights[i] * wb) / (wa + wb);
+        positions[i] += other.positions[i];
+    }
+    heights[0] = std::min(heights[0], other.heights[0]);
+    heights[4] = std::max(heights[4], other.heights[4]);
+    count += other.count;
+    positions[0] = 1.0;
+    positions[4] = static_cast<double>(count);
+    for (int i = 1; i <= 3; ++i) {
+        positions[i] = std::max(positions[i - 1] + 1.0, std::min(positions[i], positions[4] - (4 - i)));
+    }
+    reset_desired();
+}
+
+StreamingStats::StreamingStats()
+    : count_(0)
+    , mean_(0.0)
+    , m2_(0.0)
+    , min_(std::numeric_limits<double>::infinity())
+    , max_(-std::numeric_limits<double>::infinity())
+    , hist_min_(0.0)
+    , hist_max_(1.0)
+    , bin_scale_(0.0)
+    , underflow_(0)
+    , overflow_(0)
+    , is_initialized_(false) {
+}
+
+bool StreamingStats::init(double hist_min, double hist_max, int hist_bins, const std::vector<double>& quantiles) {
+    // 参数验证
+    if (!(hist_max > hist_min) || hist_bins <= 0) {
+        std::cerr << "StreamingStats init failed: invalid histogram range" << std::endl;
+        return false;
+    }
+    for (double q : quantiles) {
+        if (!(q > 0.0 && q < 1.0)) {
+            std::cerr << "StreamingStats init failed: quantile must be in (0, 1)" << std::endl;
+            return false;
+        }
+    }
+
+    hist_min_ = hist_min;
+    hist_max_ = hist_max;
+    bin_scale_ = hist_bins / (hist_max - hist_min);
+    histogram_.assign(hist_bins, 0);
+    quantiles_.clear();
+    for (double q : quantiles) {
+        quantiles_.emplace_back(q);
+    }
+    is_initialized_ = true;
+
+    reset();
+    return true;
+}
+
+void StreamingStats::reset() {
+    count_ = 0;
+    mean_ = 0.0;
+    m2_ = 0.0;
+    min_ = std::numeric_limits<double>::infinity();
+    max_ = -std::numeric_limits<double>::infinity();
+    std::fill(histogram_.begin(), histogram_.end(), 0);
+    underflow_ = 0;
+    overflow_ = 0;
+    for (auto& q : quantiles_) {
+        q = P2Quantile(q.p);
+    }
+}
+
+void StreamingStats::add(double x) {
+    // Welford在线均值/方差
+    count_++;
+    const double delta = x - mean_;
+    mean_ += delta / static_cast<double>(count_);
+    m2_ += delta * (x - mean_);
+    min_ = std::min(min_, x);
+    max_ = std::max(max_, x);
+
+    if (x < hist_min_) {
+        underflow_++;
+    } else if (x >= hist_max_) {
+        overflow_++;
+    } else {
+        size_t bin = static_cast<size_t>((x - hist_min_) * bin_scale_);
+        histogram_[std::min(bin, histogram_.size() - 1)]++;
+    }
+
+    for (auto& q : quantiles_) {
+        q.add(x);
+    }
+}
+
+bool StreamingStats::merge(const StreamingStats& other) {
+    if (histogram_.size() != other.histogram_.size() || hist_min_ != other.hist_min_ ||
+        hist_max_ != other.hist_max_ || quantiles_.size() != other.quantiles_.size()) {
+        std::cerr << "StreamingStats merge failed: configuration mismatch" << std::endl;
+        return false;
+    }
+    for (size_t i = 0; i < quantiles_.size(); ++i) {
+        if (quantiles_[i].p != other.quantiles_[i].p) {
+            std::cerr << "StreamingStats merge failed: quantile mismatch" << std::endl;
+            return false;
+        }
+    }
+    if (other.count_ == 0) {
+        return true;
+    }
+
+    // Chan等人的并行合并公式
+    const double na = static_cast<double>(count_);
+    const double nb = static_cast<double>(other.count_);
+    const double delta = other.mean_ - mean_;
+    const double n = na + nb;
+    mean_ += delta * nb / n;
+    m2_ += other.m2_ + delta * delta * na * nb / n;
+    count_ += other.count_;
+    min_ = std::min(min_, other.min_);
+    max_ = std::max(max_, other.max_);
+
+    for (size_t i = 0; i < histogram_.size(); ++i) {
+        histogram_[i] += other.histogram_[i];
+    }
+    underflow_ += other.underflow_;
+    overflow_ += other.overflow_;
+
+    for (size_t i = 0; i < quantiles_.size(); ++i) {
+        quantiles_[i].merge(other.quantiles_[i]);
+    }
+    return true;
+}
+
+double StreamingStats::get_stddev() const {
+    return std::sqrt(get_variance());
+}
+
+double StreamingStats::get_quantile(double q) const {
+    for (const auto& estimator : quantiles_) {
+        if (std::fabs(estimator.p - q) < 1e-12) {
+            return estimator.get();
+        }
+    }
+    return get_histogram_quantile(q);
+}
+
+double StreamingStats::get_histogram_quantile(double q) const {
+    if (count_ == 0) {
+        return 0.0;
+    }
+    // 目标秩落在哪个分箱，箱内线性插值；落在下溢/上溢区时返回极值
+    const double target = q * static_cast<double>(count_);
+    double cumulative = static_cast<double>(underflow_);
+    if (target <= cumulative) {
+        return min_;
+    }
+    const double width = get_bin_width();
+    for (size_t i = 0; i < histogram_.size(); ++i) {
+        const double next = cumulative + static_cast<double>(histogram_[i]);
+        if (target <= next && histogram_[i] > 0) {
+            const double fraction = (target - cumulative) / static_cast<double>(histogram_[i]);
+            return std::min(max_, std::max(min_, hist_min_ + (i + fraction) * width));
+        }
+        cumulative = next;
+    }
+    return max_;
+}
+
+} // namespace srv
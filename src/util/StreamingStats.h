@@ -0,0 +1,116 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// 常量内存的流式统计：计数、均值/方差(Welford)、最小/最大值、定宽直方图、P²分位数，部分结果可合并
+namespace srv {
+
+class StreamingStats {
+private:
+    // P²分位数估计器（Jain & Chlamtac 1985），5个标记点，不保存样本
+    struct P2Quantile {
+        double p;
+        uint64_t count;
+        double heights[5];
+        double positions[5];
+        double desired[5];
+        double increments[5];
+
+        explicit P2Quantile(double quantile);
+        void add(double x);
+        double get() const;
+        void merge(const P2Quantile& other);
+        void reset_desired();
+    };
+
+    uint64_t count_;
+    double mean_;
+    double m2_;         // 与均值之差的平方和
+    double min_;
+    double max_;
+
+    double hist_min_;
+    double hist_max_;
+    double bin_scale_;  // bins / (hist_max - hist_min)
+    std::vector<uint64_t> histogram_;
+    uint64_t underflow_;
+    uint64_t overflow_;
+
+    std::vector<P2Quantile> quantiles_;
+    bool is_initialized_;
+
+public:
+    StreamingStats();
+    ~StreamingStats() = default;
+
+    /**
+     * 初始化
+     * @param hist_min 直方图下界
+     * @param hist_max 直方图上界（不含）
+     * @param hist_bins 直方图分箱数
+     * @param quantiles 需要P²估计的分位点 (0-1)
+     * @return 是否初始化成功
+     */
+    bool init(double hist_min = 0.0, double hist_max = 1.0, int hist_bins = 100,
+              const std::vector<double>& quantiles = {0.5, 0.9, 0.99});
+
+    /**
+     * 添加一个样本
+     */
+    void add(double x);
+
+    /**
+     * 合并另一份部分统计（需相同的直方图和分位点配置）
+     * 计数、均值、方差、极值和直方图的合并是精确的，P²分位数合并为近似
+     * @param other 另一份统计
+     * @return 是否合并成功
+     */
+    bool merge(const StreamingStats& other);
+
+    /**
+     * 清空统计（保留配置）
+     */
+    void reset();
+
+    /**
+     * 检查是否已初始化
+     */
+    bool is_initialized() const { return is_initialized_; }
+
+    uint64_t get_count() const { return count_; }
+    double get_mean() const { return mean_; }
+    double get_min() const { return min_; }
+    double get_max() const { return max_; }
+
+    /**
+     * 样本方差（n-1）
+     */
+    double get_variance() const { return count_ > 1 ? m2_ / static_cast<double>(count_ - 1) : 0.0; }
+
+    /**
+     * 样本标准差
+     */
+    double get_stddev() const;
+
+    /**
+     * 获取P²分位数估计
+     * @param q 分位点，必须是init时配置的分位点之一，否则退回直方图估计
+     * @return 分位数
+     */
+    double get_quantile(double q) const;
+
+    /**
+     * 由直方图插值得到分位数（精度为一个分箱宽度，合并后仍精确）
+     * @param q 分位点 (0-1)
+     * @return 分位数
+     */
+    double get_histogram_quantile(double q) const;
+
+    const std::vector<uint64_t>& get_histogram() const { return histogram_; }
+    uint64_t get_underflow() const { return underflow_; }
+    uint64_t get_overflow() const { return overflow_; }
+    double get_bin_width() const { return histogram_.empty() ? 0.0 : (hist_max_ - hist_min_) / histogram_.size(); }
+};
+
+} // namespace srv
@@ -93,6 +93,13 @@ public:
      * @return 采样率
      */
     int get_sample_rate() const { return sample_rate_; }
+    
+    /**
+     * 获取当前判决参数（set_vad_params限幅后的值）
+     */
+    int get_prob_start() const { return prob_start_; }
+    int get_prob_continue() const { return prob_continue_; }
+    int get_noise_suppress() const { return noise_suppress_; }
 };
 
 } // namespace srv
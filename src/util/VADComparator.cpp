@@ -0,0 +1,244 @@
+#include "VADComparator.h"
+#include "DSPKernels.h"
+#include "ProcessStats.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+namespace srv {
+
+VADComparator::VADComparator()
+    : sample_rate_(16000)
+    , frame_size_(160)
+    , energy_threshold_(100)
+    , rnnoise_threshold_(0.5f)
+    , enabled_{true, true, true}
+    , is_initialized_(false)
+    , rnnoise_frame_{}
+    , last_rnnoise_prob_(0.0f)
+    , ready_(0)
+    , frames_in_(0)
+    , frames_out_(0)
+    , rnnoise_frames_(0)
+    , total_frames_(0)
+    , speech_frames_{0, 0, 0}
+    , joint_{}
+    , cpu_seconds_{0.0, 0.0, 0.0}
+    , rnnoise_runs_(0) {
+}
+
+bool VADComparator::init(int sample_rate, int frame_size, int energy_threshold, float rnnoise_threshold,
+                         const std::string& model_name) {
+    is_initialized_ = false;
+
+    // 参数验证
+    if (sample_rate <= 0 || frame_size <= 0 || energy_threshold < 0) {
+        std::cerr << "VADComparator init failed: invalid parameters" << std::endl;
+        return false;
+    }
+
+    if (!speex_vad_.init(sample_rate, frame_size)) {
+        std::cerr << "VADComparator init failed: cannot create speex VAD" << std::endl;
+        return false;
+    }
+    if (!rnnoise_.init(model_name)) {
+        std::cerr << "VADComparator init failed: cannot create RNNoise" << std::endl;
+        return false;
+    }
+    // VAD只需要概率，VOIP质量的重采样足够且开销很小
+    if (!resampler_.init(sample_rate, RNNoise::get_sample_rate(), 1, SPEEX_RESAMPLER_QUALITY_VOIP)) {
+        std::cerr << "VADComparator init failed: cannot create resampler" << std::endl;
+        return false;
+    }
+
+    sample_rate_ = sample_rate;
+    frame_size_ = frame_size;
+    energy_threshold_ = energy_threshold;
+    rnnoise_threshold_ = rnnoise_threshold;
+    speex_frame_.assign(frame_size, 0);
+    float_frame_.assign(frame_size, 0.0f);
+    // 一个输入帧重采样后的样本数加上不足一帧的余量
+    fifo_48k_.reserve(static_cast<size_t>(frame_size) * RNNoise::get_sample_rate() / sample_rate +
+                      2 * RNNoise::FRAME_SIZE);
+    is_initialized_ = true;
+
+    reset();
+    return true;
+}
+
+void VADComparator::set_speex_params(int prob_start, int prob_continue, int noise_suppress) {
+    speex_vad_.set_vad_params(prob_start, prob_continue, noise_suppress);
+}
+
+void VADComparator::set_enabled(Detector detector, bool enabled) {
+    enabled_[detector] = enabled;
+}
+
+void VADComparator::restart() {
+    speex_vad_.reset();
+    rnnoise_.reset();
+    resampler_.reset();
+    fifo_48k_.clear();
+    last_rnnoise_prob_ = 0.0f;
+    pending_.clear();
+    ready_ = 0;
+    frames_in_ = 0;
+    frames_out_ = 0;
+    rnnoise_frames_ = 0;
+}
+
+void VADComparator::reset() {
+    restart();
+    total_frames_ = 0;
+    std::fill(speech_frames_, speech_frames_ + NUM_DETECTORS, 0);
+    std::fill(cpu_seconds_, cpu_seconds_ + NUM_DETECTORS, 0.0);
+    std::memset(joint_, 0, sizeof(joint_));
+    rnnoise_runs_ = 0;
+}
+
+void VADComparator::run_rnnoise(const spx_int16_t* frame) {
+    for (int i = 0; i < frame_size_; ++i) {
+        float_frame_[i] = frame ? frame[i] : 0.0f;
+    }
+    resampler_.process(float_frame_.data(), static_cast<size_t>(frame_size_), fifo_48k_);
+
+    // 凑满的48kHz帧全部推理，概率归到分析窗中心所在的输入帧
+    // restart时重采样器已跳过起始零延迟，48kHz第n个样本对应输入第n*sample_rate/48000个样本
+    const uint64_t rate_48k = static_cast<uint64_t>(RNNoise::get_sample_rate());
+    size_t consumed = 0;
+    while (fifo_48k_.size() - consumed >= static_cast<size_t>(RNNoise::FRAME_SIZE)) {
+        const float prob = rnnoise_.process_frame(rnnoise_frame_, &fifo_48k_[consumed]);
+        const uint64_t center = rnnoise_frames_ * RNNoise::FRAME_SIZE * sample_rate_ / rate_48k;
+        const uint64_t index = center / frame_size_;
+        // 队首ready_帧已对齐但可能还没被取出，pending_[k]是第frames_out_ - ready_ + k帧
+        const uint64_t slot = ready_ + (index - frames_out_);
+        if (index >= frames_out_ && slot < pending_.size()) {
+            PendingFrame& target = pending_[slot];
+            target.result.score[RNNOISE] = target.has_rnnoise ? std::max(target.result.score[RNNOISE], prob) : prob;
+            target.has_rnnoise = true;
+        }
+        consumed += RNNoise::FRAME_SIZE;
+        rnnoise_frames_++;
+        rnnoise_runs_++;
+    }
+    if (consumed > 0) {
+        fifo_48k_.erase(fifo_48k_.begin(), fifo_48k_.begin() + consumed);
+    }
+}
+
+void VADComparator::advance_ready() {
+    const uint64_t rate_48k = static_cast<uint64_t>(RNNoise::get_sample_rate());
+    while (ready_ < pending_.size()) {
+        // 下一个要推理的48kHz帧中心已越过本帧末尾，不会再有判决落到本帧
+        const uint64_t frame_end = (frames_out_ + 1) * static_cast<uint64_t>(frame_size_);
+        if (enabled_[RNNOISE] &&
+            rnnoise_frames_ * RNNoise::FRAME_SIZE * static_cast<uint64_t>(sample_rate_) < frame_end * rate_48k) {
+            break;
+        }
+        PendingFrame& frame = pending_[ready_];
+        if (enabled_[RNNOISE]) {
+            if (!frame.has_rnnoise) {
+                frame.result.score[RNNOISE] = last_rnnoise_prob_;
+            }
+            last_rnnoise_prob_ = frame.result.score[RNNOISE];
+            frame.result.speech[RNNOISE] = frame.result.score[RNNOISE] > rnnoise_threshold_;
+        }
+
+        total_frames_++;
+        for (int a = 0; a < NUM_DETECTORS; ++a) {
+            speech_frames_[a] += frame.result.speech[a];
+            for (int b = 0; b < NUM_DETECTORS; ++b) {
+                joint_[a][b][frame.result.speech[a]][frame.result.speech[b]]++;
+            }
+        }
+        ready_++;
+        frames_out_++;
+    }
+}
+
+void VADComparator::process_frame(const spx_int16_t* frame) {
+    if (!is_initialized_) {
+        std::cerr << "VADComparator not initialized" << std::endl;
+        return;
+    }
+
+    pending_.push_back(PendingFrame{FrameResult{}, false});
+    FrameResult& result = pending_.back().result;
+    result.frame_index = frames_in_++;
+
+    double t0 = ProcessStats::get_thread_cpu_seconds();
+    double t1 = t0;
+
+    if (enabled_[THRESHOLD]) {
+        uint64_t sum_abs = kernels::sum_abs_s16(frame, static_cast<size_t>(frame_size_));
+        result.score[THRESHOLD] = static_cast<float>(sum_abs) / frame_size_;
+        result.speech[THRESHOLD] = sum_abs > static_cast<uint64_t>(energy_threshold_) * frame_size_;
+        t1 = ProcessStats::get_thread_cpu_seconds();
+        cpu_seconds_[THRESHOLD] += t1 - t0;
+        t0 = t1;
+    }
+
+    if (enabled_[SPEEX]) {
+        // Speex预处理会原地修改帧，使用副本
+        std::memcpy(speex_frame_.data(), frame, frame_size_ * sizeof(spx_int16_t));
+        result.speech[SPEEX] = speex_vad_.detect_voice_activity(speex_frame_.data(), frame_size_) != 0;
+        result.score[SPEEX] = speex_vad_.get_speech_probability() / 100.0f;
+        t1 = ProcessStats::get_thread_cpu_seconds();
+        cpu_seconds_[SPEEX] += t1 - t0;
+        t0 = t1;
+    }
+
+    if (enabled_[RNNOISE]) {
+        run_rnnoise(frame);
+        t1 = ProcessStats::get_thread_cpu_seconds();
+        cpu_seconds_[RNNOISE] += t1 - t0;
+    }
+    advance_ready();
+}
+
+bool VADComparator::pop_result(FrameResult& result) {
+    if (ready_ == 0) {
+        return false;
+    }
+    result = pending_.front().result;
+    pending_.pop_front();
+    ready_--;
+    return true;
+}
+
+void VADComparator::finish() {
+    if (!is_initialized_) {
+        return;
+    }
+    // 补零帧只推进RNNoise，不产生新的输入帧
+    double t0 = ProcessStats::get_thread_cpu_seconds();
+    while (ready_ < pending_.size()) {
+        run_rnnoise(nullptr);
+        advance_ready();
+    }
+    if (enabled_[RNNOISE]) {
+        cpu_seconds_[RNNOISE] += ProcessStats::get_thread_cpu_seconds() - t0;
+    }
+}
+
+double VADComparator::get_agreement(Detector a, Detector b) const {
+    if (total_frames_ == 0) {
+        return 0.0;
+    }
+    return static_cast<double>(joint_[a][b][0][0] + joint_[a][b][1][1]) / total_frames_;
+}
+
+const char* VADComparator::get_detector_name(Detector detector) {
+    switch (detector) {
+    case THRESHOLD:
+        return "threshold";
+    case SPEEX:
+        return "speex";
+    case RNNOISE:
+        return "rnnoise";
+    default:
+        return "unknown";
+    }
+}
+
+} // namespace srv
@@ -0,0 +1,173 @@
+#pragma once
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <vector>
+#include "VAD.h"
+#include "RNNoise.h"
+#include "Resampler.h"
+
+// 帧同步多检测器对比：同一帧依次送入能量阈值、Speex、RNNoise（内部重采样到48kHz），一次遍历得到对齐的逐帧判决
+// RNNoise在48kHz上按自己的帧推理，其判决按分析窗位置归到对应的输入帧；重采样延迟和FIFO凑帧使判决晚于输入，
+// 所以结果按输入帧顺序延后输出（process_frame之后用pop_result取出）
+namespace srv {
+
+class VADComparator {
+public:
+    // 参与对比的检测器
+    enum Detector {
+        THRESHOLD = 0,  // 帧平均幅度阈值
+        SPEEX = 1,      // Speex预处理器VAD
+        RNNOISE = 2,    // RNNoise语音概率
+        NUM_DETECTORS = 3
+    };
+
+    // 一帧的对比结果
+    struct FrameResult {
+        uint64_t frame_index;           // 输入帧序号（restart后从0开始）
+        bool speech[NUM_DETECTORS];     // 各检测器判决，true表示语音
+        float score[NUM_DETECTORS];     // 判决依据：平均幅度、Speex概率(0-1)、RNNoise概率(0-1)
+    };
+
+private:
+    VAD speex_vad_;
+    RNNoise rnnoise_;
+    Resampler resampler_;           // 输入采样率 → 48kHz
+
+    int sample_rate_;
+    int frame_size_;
+    int energy_threshold_;          // 平均幅度门限（int16量纲）
+    float rnnoise_threshold_;       // RNNoise概率高于此值判为语音
+    bool enabled_[NUM_DETECTORS];
+    bool is_initialized_;
+
+    std::vector<spx_int16_t> speex_frame_;
+    std::vector<float> float_frame_;
+    std::vector<float> fifo_48k_;
+    float rnnoise_frame_[RNNoise::FRAME_SIZE];
+    float last_rnnoise_prob_;
+
+    // 等待RNNoise判决的帧（队首ready_帧已对齐，可以取出）
+    struct PendingFrame {
+        FrameResult result;
+        bool has_rnnoise;               // 是否有48kHz帧的分析窗中心落在本帧
+    };
+    std::deque<PendingFrame> pending_;
+    size_t ready_;
+    uint64_t frames_in_;                // restart后送入的输入帧数
+    uint64_t frames_out_;               // restart后已对齐（ready）的帧数
+    uint64_t rnnoise_frames_;           // restart后推理的48kHz帧数
+
+    // 统计
+    uint64_t total_frames_;
+    uint64_t speech_frames_[NUM_DETECTORS];
+    uint64_t joint_[NUM_DETECTORS][NUM_DETECTORS][2][2];  // [a][b][a判语音][b判语音]的帧数
+    double cpu_seconds_[NUM_DETECTORS];
+    uint64_t rnnoise_runs_;
+
+    void run_rnnoise(const spx_int16_t* frame);
+    void advance_ready();
+
+public:
+    VADComparator();
+    ~VADComparator() = default;
+
+    /**
+     * 初始化
+     * @param sample_rate 输入采样率 (Hz)
+     * @param frame_size 帧大小 (样本数，通常对应10ms)
+     * @param energy_threshold 阈值检测的平均幅度门限
+     * @param rnnoise_threshold RNNoise概率门限 (0-1)
+     * @param model_name RNNoise模型名，为空使用内置模型
+     * @return 是否初始化成功
+     */
+    bool init(int sample_rate = 16000, int frame_size = 160, int energy_threshold = 100,
+              float rnnoise_threshold = 0.5f, const std::string& model_name = "");
+
+    /**
+     * 设置Speex判决参数（同VAD::set_vad_params）
+     */
+    void set_speex_params(int prob_start = 80, int prob_continue = 80, int noise_suppress = -15);
+
+    /**
+     * 启用或停用某个检测器，停用的检测器判决恒为静音且不计CPU
+     */
+    void set_enabled(Detector detector, bool enabled);
+
+    /**
+     * 把一帧送入所有启用的检测器
+     * 第k个48kHz帧的分析窗（前一帧+当前帧）中心在48kHz第480k个样本，对应输入第480k*sample_rate/48000个样本，
+     * 其概率归到该样本所在的输入帧（多个时取最大，没有时沿用前一帧）；
+     * 一帧要等到下一个48kHz帧的中心越过它的末尾才对齐，延后约重采样延迟加一个RNNoise帧
+     * @param frame 音频帧 (frame_size个16位样本，不会被修改)
+     */
+    void process_frame(const spx_int16_t* frame);
+
+    /**
+     * 取出下一个已对齐的帧（按输入顺序），统计在帧对齐时累计
+     * @param result 输出
+     * @return 没有已对齐的帧时返回false
+     */
+    bool pop_result(FrameResult& result);
+
+    /**
+     * 输入结束：补零冲出重采样和FIFO中的样本，使所有已送入的帧对齐，之后用pop_result取完
+     */
+    void finish();
+
+    /**
+     * 重置检测器状态，保留统计（切换到下一个文件时调用，未取出的帧被丢弃）
+     */
+    void restart();
+
+    /**
+     * 重置检测器状态和统计
+     */
+    void reset();
+
+    /**
+     * 检查是否已初始化
+     */
+    bool is_initialized() const { return is_initialized_; }
+
+    bool is_enabled(Detector detector) const { return enabled_[detector]; }
+    int get_frame_size() const { return frame_size_; }
+    int get_sample_rate() const { return sample_rate_; }
+    uint64_t get_total_frames() const { return total_frames_; }
+    size_t get_pending_frames() const { return pending_.size(); }
+    uint64_t get_speech_frames(Detector detector) const { return speech_frames_[detector]; }
+
+    /**
+     * 获取两个检测器的联合判决帧数
+     * @param a 检测器a
+     * @param b 检测器b
+     * @param a_speech a是否判为语音
+     * @param b_speech b是否判为语音
+     * @return 帧数
+     */
+    uint64_t get_joint_frames(Detector a, Detector b, bool a_speech, bool b_speech) const {
+        return joint_[a][b][a_speech][b_speech];
+    }
+
+    /**
+     * 获取两个检测器判决一致的帧比例
+     */
+    double get_agreement(Detector a, Detector b) const;
+
+    /**
+     * 获取检测器累计的线程CPU时间（秒），RNNoise包含重采样
+     */
+    double get_cpu_seconds(Detector detector) const { return cpu_seconds_[detector]; }
+
+    /**
+     * RNNoise实际推理的48kHz帧数
+     */
+    uint64_t get_rnnoise_runs() const { return rnnoise_runs_; }
+
+    /**
+     * 获取检测器名称
+     */
+    static const char* get_detector_name(Detector detector);
+};
+
+} // namespace srv
@@ -0,0 +1,67 @@
+#include "VADSmoother.h"
+#include <iostream>
+
+namespace srv {
+
+VADSmoother::VADSmoother()
+    : onset_frames_(2)
+    , hangover_frames_(20)
+    , min_speech_frames_(10)
+    , is_speech_(false)
+    , speech_run_(0)
+    , silence_run_(0)
+    , segment_frames_(0)
+    , transition_lag_(0)
+    , segment_count_(0) {
+}
+
+bool VADSmoother::init(int onset_frames, int hangover_frames, int min_speech_frames) {
+    // 参数验证
+    if (onset_frames < 1 || hangover_frames < 0 || min_speech_frames < 0) {
+        std::cerr << "VADSmoother init failed: invalid parameters" << std::endl;
+        return false;
+    }
+
+    onset_frames_ = onset_frames;
+    hangover_frames_ = hangover_frames;
+    min_speech_frames_ = min_speech_frames;
+    reset();
+    return true;
+}
+
+bool VADSmoother::update(bool is_speech_frame) {
+    if (!is_speech_) {
+        speech_run_ = is_speech_frame ? speech_run_ + 1 : 0;
+        if (speech_run_ >= onset_frames_) {
+            // 起始确认期间的帧也计入语音段时长
+            is_speech_ = true;
+            segment_frames_ = speech_run_;
+            transition_lag_ = speech_run_ - 1;
+            silence_run_ = 0;
+            speech_run_ = 0;
+            segment_count_++;
+        }
+        return is_speech_;
+    }
+
+    segment_frames_++;
+    silence_run_ = is_speech_frame ? 0 : silence_run_ + 1;
+    if (silence_run_ > hangover_frames_ && segment_frames_ >= min_speech_frames_) {
+        is_speech_ = false;
+        transition_lag_ = silence_run_ - 1;
+        silence_run_ = 0;
+        segment_frames_ = 0;
+    }
+    return is_speech_;
+}
+
+void VADSmoother::reset() {
+    is_speech_ = false;
+    speech_run_ = 0;
+    silence_run_ = 0;
+    segment_frames_ = 0;
+    transition_lag_ = 0;
+    segment_count_ = 0;
+}
+
+} // namespace srv
@@ -0,0 +1,65 @@
+#pragma once
+#include <cstdint>
+
+// VAD判决平滑：起始确认、拖尾保持和最短语音段时长
+namespace srv {
+
+class VADSmoother {
+private:
+    int onset_frames_;       // 连续多少帧语音才进入语音状态
+    int hangover_frames_;    // 语音结束后继续保持的帧数
+    int min_speech_frames_;  // 语音段最短帧数，不足时不允许结束
+    bool is_speech_;
+    int speech_run_;         // 静音状态下连续语音帧数
+    int silence_run_;        // 语音状态下连续静音帧数
+    int segment_frames_;     // 当前语音段已持续的帧数
+    int transition_lag_;     // 最近一次状态切换相对实际起止点滞后的帧数
+    uint64_t segment_count_;
+
+public:
+    VADSmoother();
+    ~VADSmoother() = default;
+
+    /**
+     * 初始化平滑参数
+     * @param onset_frames 进入语音状态需要的连续语音帧数 (>=1)
+     * @param hangover_frames 语音结束后保持的帧数
+     * @param min_speech_frames 语音段最短帧数
+     * @return 是否初始化成功
+     */
+    bool init(int onset_frames = 2, int hangover_frames = 20, int min_speech_frames = 10);
+
+    /**
+     * 输入一帧原始判决，输出平滑后的判决
+     * @param is_speech_frame 原始判决
+     * @return 平滑后是否为语音
+     */
+    bool update(bool is_speech_frame);
+
+    /**
+     * 重置状态
+     */
+    void reset();
+
+    /**
+     * 当前平滑后的状态
+     */
+    bool is_speech() const { return is_speech_; }
+
+    /**
+     * 最近一次状态切换被确认时，实际起止点在当前帧之前多少帧
+     * 进入语音：起始确认期间的首个语音帧；退出语音：拖尾期间的首个静音帧
+     */
+    int get_transition_lag() const { return transition_lag_; }
+
+    /**
+     * 已开始的语音段数量
+     */
+    uint64_t get_segment_count() const { return segment_count_; }
+
+    int get_onset_frames() const { return onset_frames_; }
+    int get_hangover_frames() const { return hangover_frames_; }
+    int get_min_speech_frames() const { return min_speech_frames_; }
+};
+
+} // namespace srv
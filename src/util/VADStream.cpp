@@ -0,0 +1,190 @@
+#include "VADStream.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+namespace srv {
+
+VADStream::VADStream()
+    : detector_(Detector::SPEEX)
+    , sample_rate_(16000)
+    , frame_size_(160)
+    , rnnoise_threshold_(0.5f)
+    , is_initialized_(false)
+    , frame_fill_(0)
+    , ring_pos_(0)
+    , ring_filled_(0)
+    , preroll_samples_(0)
+    , frames_processed_(0)
+    , speech_start_sample_(0) {
+}
+
+bool VADStream::init(Detector detector, int sample_rate, int preroll_ms, int onset_ms,
+                     int hangover_ms, int min_speech_ms) {
+    is_initialized_ = false;
+
+    // 参数验证
+    if (sample_rate < 100 || preroll_ms < 0 || onset_ms < 0 || hangover_ms < 0 || min_speech_ms < 0) {
+        std::cerr << "VADStream init failed: invalid parameters" << std::endl;
+        return false;
+    }
+    if (detector == Detector::RNNOISE && sample_rate != RNNoise::get_sample_rate()) {
+        std::cerr << "VADStream init failed: RNNoise requires " << RNNoise::get_sample_rate() << " Hz input" << std::endl;
+        return false;
+    }
+
+    detector_ = detector;
+    sample_rate_ = sample_rate;
+    frame_size_ = detector == Detector::RNNOISE ? RNNoise::FRAME_SIZE : sample_rate / 100;
+
+    if (detector == Detector::SPEEX ? !speex_vad_.init(sample_rate_, frame_size_) : !rnnoise_gate_.init()) {
+        std::cerr << "VADStream init failed: cannot create detector" << std::endl;
+        return false;
+    }
+
+    // 时长统一换算为10ms帧，向上取整
+    const int onset_frames = std::max(1, (onset_ms + 9) / 10);
+    if (!smoother_.init(onset_frames, (hangover_ms + 9) / 10, (min_speech_ms + 9) / 10)) {
+        return false;
+    }
+
+    // 开始事件在起点之后onset_frames帧才被确认，环形缓存需要多留这部分
+    preroll_samples_ = static_cast<size_t>(sample_rate_) * preroll_ms / 1000;
+    const size_t ring_capacity = preroll_samples_ + static_cast<size_t>(onset_frames) * frame_size_;
+    ring_.assign(ring_capacity, 0);
+    preroll_out_.assign(ring_capacity, 0);
+    frame_buffer_.assign(frame_size_, 0);
+    speex_frame_.assign(frame_size_, 0);
+    float_frame_.assign(frame_size_, 0.0f);
+    is_initialized_ = true;
+
+    reset();
+    return true;
+}
+
+void VADStream::reset() {
+    if (!is_initialized_) {
+        return;
+    }
+    if (detector_ == Detector::SPEEX) {
+        speex_vad_.reset();
+    } else {
+        rnnoise_gate_.reset();
+    }
+    smoother_.reset();
+    frame_fill_ = 0;
+    ring_pos_ = 0;
+    ring_filled_ = 0;
+    frames_processed_ = 0;
+    speech_start_sample_ = 0;
+}
+
+void VADStream::push_ring(const int16_t* frame) {
+    const size_t capacity = ring_.size();
+    const size_t first = std::min(static_cast<size_t>(frame_size_), capacity - ring_pos_);
+    std::memcpy(&ring_[ring_pos_], frame, first * sizeof(int16_t));
+    std::memcpy(&ring_[0], frame + first, (frame_size_ - first) * sizeof(int16_t));
+    ring_pos_ = (ring_pos_ + frame_size_) % capacity;
+    ring_filled_ = std::min<uint64_t>(ring_filled_ + frame_size_, capacity);
+}
+
+size_t VADStream::copy_ring_tail(uint64_t from_sample, uint64_t to_sample) {
+    // 环形缓存中最新的样本对应to_sample - 1
+    const size_t capacity = ring_.size();
+    const size_t count = static_cast<size_t>(to_sample - from_sample);
+    const size_t start = (ring_pos_ + capacity - count) % capacity;
+    const size_t first = std::min(count, capacity - start);
+    std::memcpy(&preroll_out_[0], &ring_[start], first * sizeof(int16_t));
+    std::memcpy(&preroll_out_[first], &ring_[0], (count - first) * sizeof(int16_t));
+    return count;
+}
+
+bool VADStream::detect_frame(const int16_t* frame) {
+    if (detector_ == Detector::SPEEX) {
+        // speex_preprocess_run会修改输入，使用副本
+        std::memcpy(speex_frame_.data(), frame, frame_size_ * sizeof(int16_t));
+        return speex_vad_.detect_voice_activity(speex_frame_.data(), frame_size_) != 0;
+    }
+    for (int i = 0; i < frame_size_; ++i) {
+        float_frame_[i] = frame[i];
+    }
+    return rnnoise_gate_.process_frame(float_frame_.data(), float_frame_.data()) > rnnoise_threshold_;
+}
+
+void VADStream::process_frame(const int16_t* frame) {
+    push_ring(frame);
+    const bool is_speech_frame = detect_frame(frame);
+
+    const bool was_speech = smoother_.is_speech();
+    const bool now_speech = smoother_.update(is_speech_frame);
+    const uint64_t frame_index = frames_processed_++;
+    const uint64_t frame_start = frame_index * frame_size_;
+    const uint64_t frame_end = frame_start + frame_size_;
+
+    if (!was_speech && now_speech) {
+        speech_start_sample_ = (frame_index - smoother_.get_transition_lag()) * frame_size_;
+        const uint64_t wanted = speech_start_sample_ > preroll_samples_ ? speech_start_sample_ - preroll_samples_ : 0;
+        const uint64_t from = std::max(wanted, frame_end - ring_filled_);
+        const size_t count = copy_ring_tail(from, frame_end);
+        if (event_callback_) {
+            event_callback_({EventType::SPEECH_START, speech_start_sample_, frame_end,
+                             preroll_out_.data(), count, from});
+        }
+    } else if (was_speech && now_speech) {
+        if (audio_callback_) {
+            audio_callback_(frame, frame_size_, frame_start);
+        }
+    } else if (was_speech && !now_speech) {
+        const uint64_t end = (frame_index - smoother_.get_transition_lag()) * frame_size_;
+        if (event_callback_) {
+            event_callback_({EventType::SPEECH_END, end, frame_end, nullptr, 0, 0});
+        }
+    }
+}
+
+void VADStream::push(const int16_t* samples, size_t count) {
+    if (!is_initialized_) {
+        std::cerr << "VADStream not initialized" << std::endl;
+        return;
+    }
+
+    const size_t frame_size = static_cast<size_t>(frame_size_);
+    while (count > 0) {
+        // 没有残留样本时直接在输入上判决，避免拷贝
+        if (frame_fill_ == 0 && count >= frame_size) {
+            process_frame(samples);
+            samples += frame_size;
+            count -= frame_size;
+            continue;
+        }
+        const size_t n = std::min(count, frame_size - frame_fill_);
+        std::memcpy(&frame_buffer_[frame_fill_], samples, n * sizeof(int16_t));
+        frame_fill_ += n;
+        samples += n;
+        count -= n;
+        if (frame_fill_ == frame_size) {
+            frame_fill_ = 0;
+            process_frame(frame_buffer_.data());
+        }
+    }
+}
+
+void VADStream::flush() {
+    if (!is_initialized_) {
+        return;
+    }
+
+    const uint64_t stream_end = get_position();
+    if (frame_fill_ > 0) {
+        std::fill(frame_buffer_.begin() + frame_fill_, frame_buffer_.end(), 0);
+        frame_fill_ = 0;
+        process_frame(frame_buffer_.data());
+    }
+
+    if (smoother_.is_speech() && event_callback_) {
+        event_callback_({EventType::SPEECH_END, stream_end, stream_end, nullptr, 0, 0});
+    }
+    smoother_.reset();
+}
+
+} // namespace srv
@@ -0,0 +1,145 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include "VAD.h"
+#include "RNNoiseGate.h"
+#include "VADSmoother.h"
+
+// 流式VAD前端：逐块输入音频，按样本位置回调语音开始/结束事件，开始事件附带固定长度的预录音频，内存占用与流长度无关
+namespace srv {
+
+class VADStream {
+public:
+    // 帧判决使用的检测器
+    enum class Detector {
+        SPEEX,    // speex预处理器VAD，任意采样率，10ms帧
+        RNNOISE   // RNNoise VAD概率（带能量预门限），要求48kHz，480样本帧
+    };
+
+    enum class EventType {
+        SPEECH_START,
+        SPEECH_END
+    };
+
+    // 事件：sample为语音段实际起点/终点（流内绝对样本位置），
+    // confirmed_sample为做出判决时已输入的样本数（两者之差即判决延迟）
+    struct Event {
+        EventType type;
+        uint64_t sample;
+        uint64_t confirmed_sample;
+        // 仅SPEECH_START：从起点前preroll_ms到confirmed_sample的连续音频
+        const int16_t* audio;
+        size_t audio_size;
+        uint64_t audio_start_sample;
+    };
+
+    using EventCallback = std::function<void(const Event& event)>;
+    // 语音状态下每帧音频（开始事件之后的帧，含拖尾帧）
+    using AudioCallback = std::function<void(const int16_t* samples, size_t count, uint64_t start_sample)>;
+
+private:
+    Detector detector_;
+    VAD speex_vad_;
+    RNNoiseGate rnnoise_gate_;
+    VADSmoother smoother_;
+    int sample_rate_;
+    int frame_size_;
+    float rnnoise_threshold_;
+    bool is_initialized_;
+
+    // 未满一帧的输入
+    std::vector<int16_t> frame_buffer_;
+    size_t frame_fill_;
+    std::vector<int16_t> speex_frame_;
+    std::vector<float> float_frame_;
+
+    // 最近preroll + 起始确认时长的音频环形缓存，以及回调用的连续拷贝
+    std::vector<int16_t> ring_;
+    size_t ring_pos_;
+    uint64_t ring_filled_;
+    size_t preroll_samples_;
+    std::vector<int16_t> preroll_out_;
+
+    uint64_t frames_processed_;
+    uint64_t speech_start_sample_;
+
+    EventCallback event_callback_;
+    AudioCallback audio_callback_;
+
+    void process_frame(const int16_t* frame);
+    void push_ring(const int16_t* frame);
+    size_t copy_ring_tail(uint64_t from_sample, uint64_t to_sample);
+    bool detect_frame(const int16_t* frame);
+
+public:
+    VADStream();
+    ~VADStream() = default;
+
+    /**
+     * 初始化
+     * @param detector 检测器类型
+     * @param sample_rate 采样率 (Hz)，RNNOISE要求48000
+     * @param preroll_ms 开始事件附带的起点前音频时长（毫秒）
+     * @param onset_ms 进入语音状态需要的连续语音时长（毫秒）
+     * @param hangover_ms 语音结束后保持的时长（毫秒）
+     * @param min_speech_ms 语音段最短时长（毫秒）
+     * @return 是否初始化成功
+     */
+    bool init(Detector detector = Detector::SPEEX, int sample_rate = 16000, int preroll_ms = 300,
+              int onset_ms = 20, int hangover_ms = 200, int min_speech_ms = 100);
+
+    /**
+     * 设置事件回调
+     */
+    void set_event_callback(EventCallback callback) { event_callback_ = std::move(callback); }
+
+    /**
+     * 设置语音音频回调
+     */
+    void set_audio_callback(AudioCallback callback) { audio_callback_ = std::move(callback); }
+
+    /**
+     * 输入任意长度的音频，凑满一帧即判决，事件在本调用内同步回调
+     * @param samples 16位PCM样本
+     * @param count 样本数
+     */
+    void push(const int16_t* samples, size_t count);
+
+    /**
+     * 流结束：剩余样本补零成帧，若仍在语音状态则以流末尾为终点发出结束事件
+     */
+    void flush();
+
+    /**
+     * 重置状态（保留回调和参数）
+     */
+    void reset();
+
+    /**
+     * 设置RNNoise判决门限
+     * @param threshold 语音概率门限 (0-1)
+     */
+    void set_rnnoise_threshold(float threshold) { rnnoise_threshold_ = threshold; }
+
+    /**
+     * 检查是否已初始化
+     */
+    bool is_initialized() const { return is_initialized_; }
+
+    /**
+     * 当前是否处于语音状态
+     */
+    bool is_speech() const { return smoother_.is_speech(); }
+
+    /**
+     * 已输入的样本数
+     */
+    uint64_t get_position() const { return frames_processed_ * frame_size_ + frame_fill_; }
+
+    int get_frame_size() const { return frame_size_; }
+    int get_sample_rate() const { return sample_rate_; }
+};
+
+} // namespace srv
@@ -0,0 +1,278 @@
+#include "VADTuner.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <thread>
+
+namespace srv {
+
+VADTuner::VADTuner()
+    : sample_rate_(16000)
+    , frame_size_(160)
+    , num_threads_(1)
+    , is_initialized_(false)
+    , speech_frames_(0) {
+}
+
+bool VADTuner::init(int sample_rate, int frame_size, int num_threads, const std::string& model_name) {
+    is_initialized_ = false;
+
+    // 参数验证
+    if (sample_rate <= 0 || frame_size <= 0 || num_threads < 0) {
+        std::cerr << "VADTuner init failed: invalid parameters" << std::endl;
+        return false;
+    }
+    // 特征阶段用最宽松的判决参数，缓存的是与参数无关的概率和幅度
+    if (!comparator_.init(sample_rate, frame_size, 0, 0.5f, model_name)) {
+        std::cerr << "VADTuner init failed: cannot create detectors" << std::endl;
+        return false;
+    }
+
+    sample_rate_ = sample_rate;
+    frame_size_ = frame_size;
+    set_num_threads(num_threads);
+    mean_abs_.clear();
+    speex_prob_.clear();
+    rnnoise_prob_.clear();
+    label_.clear();
+    stream_starts_.clear();
+    speech_frames_ = 0;
+    is_initialized_ = true;
+    return true;
+}
+
+void VADTuner::set_num_threads(int num_threads) {
+    if (num_threads <= 0) {
+        num_threads = static_cast<int>(std::thread::hardware_concurrency());
+        if (num_threads <= 0) {
+            num_threads = 1;
+        }
+    }
+    num_threads_ = num_threads;
+}
+
+bool VADTuner::add_audio(const int16_t* samples, size_t count, const std::vector<Range>& speech) {
+    if (!is_initialized_) {
+        std::cerr << "VADTuner not initialized" << std::endl;
+        return false;
+    }
+    for (size_t i = 0; i < speech.size(); ++i) {
+        if (speech[i].end_sample <= speech[i].start_sample ||
+            (i > 0 && speech[i].start_sample < speech[i - 1].end_sample)) {
+            std::cerr << "VADTuner add_audio failed: labels must be sorted and non-overlapping" << std::endl;
+            return false;
+        }
+    }
+
+    comparator_.restart();
+    stream_starts_.push_back(label_.size());
+    const size_t num_frames = (count + frame_size_ - 1) / frame_size_;
+    mean_abs_.reserve(mean_abs_.size() + num_frames);
+    speex_prob_.reserve(speex_prob_.size() + num_frames);
+    rnnoise_prob_.reserve(rnnoise_prob_.size() + num_frames);
+    label_.reserve(label_.size() + num_frames);
+
+    // RNNoise判决延后对齐，结果按输入帧顺序取出
+    VADComparator::FrameResult result;
+    auto collect = [&]() {
+        while (comparator_.pop_result(result)) {
+            mean_abs_.push_back(result.score[VADComparator::THRESHOLD]);
+            speex_prob_.push_back(static_cast<uint8_t>(result.score[VADComparator::SPEEX] * 100.0f + 0.5f));
+            rnnoise_prob_.push_back(result.score[VADComparator::RNNOISE]);
+        }
+    };
+
+    std::vector<spx_int16_t> frame(frame_size_, 0);
+    size_t range_index = 0;
+    for (size_t f = 0; f < num_frames; ++f) {
+        const uint64_t begin = static_cast<uint64_t>(f) * frame_size_;
+        const uint64_t end = begin + frame_size_;
+        // 不足一帧的尾部补零
+        const size_t valid = static_cast<size_t>(std::min<uint64_t>(end, count) - begin);
+        std::copy(samples + begin, samples + begin + valid, frame.begin());
+        std::fill(frame.begin() + valid, frame.end(), 0);
+
+        comparator_.process_frame(frame.data());
+        collect();
+
+        // 参考段有序，随帧推进
+        uint64_t overlap = 0;
+        while (range_index < speech.size() && speech[range_index].end_sample <= begin) {
+            range_index++;
+        }
+        for (size_t r = range_index; r < speech.size() && speech[r].start_sample < end; ++r) {
+            overlap += std::min(end, speech[r].end_sample) - std::max(begin, speech[r].start_sample);
+        }
+        const bool is_speech = overlap * 2 >= static_cast<uint64_t>(frame_size_);
+        label_.push_back(is_speech ? 1 : 0);
+        speech_frames_ += is_speech;
+    }
+    comparator_.finish();
+    collect();
+    return true;
+}
+
+double VADTuner::get_cpu_us_per_frame(VADComparator::Detector detector) const {
+    const uint64_t frames = comparator_.get_total_frames();
+    return frames ? 1e6 * comparator_.get_cpu_seconds(detector) / frames : 0.0;
+}
+
+std::vector<VADTuner::Candidate> VADTuner::make_grid() const {
+    std::vector<Candidate> grid;
+    const int hangovers[] = {0, 5, 10, 20, 40};
+
+    // 平均幅度门限按约1.25倍等比取值
+    for (double threshold = 10.0; threshold <= 3000.0; threshold *= 1.25) {
+        for (int hangover : hangovers) {
+            grid.push_back({VADComparator::THRESHOLD, std::round(threshold), static_cast<double>(hangover)});
+        }
+    }
+    for (int start = 5; start <= 95; start += 5) {
+        for (int cont = 5; cont <= start; cont += 5) {
+            grid.push_back({VADComparator::SPEEX, static_cast<double>(start), static_cast<double>(cont)});
+        }
+    }
+    for (int t = 5; t <= 95; t += 5) {
+        for (int hangover : hangovers) {
+            grid.push_back({VADComparator::RNNOISE, t / 100.0, static_cast<double>(hangover)});
+        }
+    }
+    return grid;
+}
+
+VADTuner::Result VADTuner::evaluate(const Candidate& candidate) const {
+    Result result{candidate, 0.0, 0.0, get_cpu_us_per_frame(candidate.detector)};
+    const size_t num_frames = label_.size();
+    uint64_t misses = 0;
+    uint64_t false_alarms = 0;
+
+    size_t next_stream = 0;
+    bool was_speech = false;
+    int hang = 0;
+    const int hangover = static_cast<int>(candidate.param2);
+    for (size_t f = 0; f < num_frames; ++f) {
+        if (next_stream < stream_starts_.size() && stream_starts_[next_stream] == f) {
+            was_speech = false;
+            hang = 0;
+            next_stream++;
+        }
+
+        bool speech = false;
+        switch (candidate.detector) {
+        case VADComparator::THRESHOLD:
+        case VADComparator::RNNOISE: {
+            const bool raw = candidate.detector == VADComparator::THRESHOLD
+                ? mean_abs_[f] > candidate.param1
+                : rnnoise_prob_[f] > candidate.param1;
+            // 判为语音后保持hangover帧
+            if (raw) {
+                hang = hangover;
+                speech = true;
+            } else if (hang > 0) {
+                hang--;
+                speech = true;
+            }
+            break;
+        }
+        case VADComparator::SPEEX:
+            // 与speex预处理器相同的迟滞：超过prob_start进入语音，已是语音时超过prob_continue保持
+            speech = speex_prob_[f] > candidate.param1 || (was_speech && speex_prob_[f] > candidate.param2);
+            was_speech = speech;
+            break;
+        default:
+            break;
+        }
+
+        misses += label_[f] && !speech;
+        false_alarms += !label_[f] && speech;
+    }
+
+    const uint64_t silence_frames = num_frames - speech_frames_;
+    result.miss_rate = speech_frames_ ? static_cast<double>(misses) / speech_frames_ : 0.0;
+    result.false_alarm_rate = silence_frames ? static_cast<double>(false_alarms) / silence_frames : 0.0;
+    return result;
+}
+
+std::vector<VADTuner::Result> VADTuner::evaluate_all(const std::vector<Candidate>& candidates) const {
+    std::vector<Result> results(candidates.size());
+    if (candidates.empty()) {
+        return results;
+    }
+
+    // 参数组之间互不依赖，线程按原子计数器领取
+    std::atomic<size_t> next(0);
+    auto worker = [&]() {
+        for (size_t i = next.fetch_add(1); i < candidates.size(); i = next.fetch_add(1)) {
+            results[i] = evaluate(candidates[i]);
+        }
+    };
+
+    const size_t num_workers = std::min(static_cast<size_t>(num_threads_), candidates.size());
+    std::vector<std::thread> threads;
+    threads.reserve(num_workers);
+    for (size_t t = 1; t < num_workers; ++t) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (auto& t : threads) {
+        t.join();
+    }
+    return results;
+}
+
+std::vector<VADTuner::Result> VADTuner::pareto_front(const std::vector<Result>& results) {
+    auto dominates = [](const Result& a, const Result& b) {
+        bool no_worse = a.miss_rate <= b.miss_rate && a.false_alarm_rate <= b.false_alarm_rate &&
+                        a.cpu_us_per_frame <= b.cpu_us_per_frame;
+        bool better = a.miss_rate < b.miss_rate || a.false_alarm_rate < b.false_alarm_rate ||
+                      a.cpu_us_per_frame < b.cpu_us_per_frame;
+        return no_worse && better;
+    };
+
+    auto same = [](const Result& a, const Result& b) {
+        return a.miss_rate == b.miss_rate && a.false_alarm_rate == b.false_alarm_rate &&
+               a.cpu_us_per_frame == b.cpu_us_per_frame;
+    };
+
+    // 指标完全相同的参数组只保留第一个
+    std::vector<Result> front;
+    for (size_t i = 0; i < results.size(); ++i) {
+        bool dominated = false;
+        for (size_t j = 0; j < results.size() && !dominated; ++j) {
+            dominated = dominates(results[j], results[i]) || (j < i && same(results[j], results[i]));
+        }
+        if (!dominated) {
+            front.push_back(results[i]);
+        }
+    }
+    std::sort(front.begin(), front.end(), [](const Result& a, const Result& b) {
+        if (a.cpu_us_per_frame != b.cpu_us_per_frame) {
+            return a.cpu_us_per_frame < b.cpu_us_per_frame;
+        }
+        return a.miss_rate < b.miss_rate;
+    });
+    return front;
+}
+
+std::string VADTuner::describe(const Candidate& candidate) {
+    char buffer[96];
+    switch (candidate.detector) {
+    case VADComparator::THRESHOLD:
+        std::snprintf(buffer, sizeof(buffer), "threshold=%.0f hangover=%.0f", candidate.param1, candidate.param2);
+        break;
+    case VADComparator::SPEEX:
+        std::snprintf(buffer, sizeof(buffer), "prob_start=%.0f prob_continue=%.0f", candidate.param1, candidate.param2);
+        break;
+    case VADComparator::RNNOISE:
+        std::snprintf(buffer, sizeof(buffer), "threshold=%.2f hangover=%.0f", candidate.param1, candidate.param2);
+        break;
+    default:
+        std::snprintf(buffer, sizeof(buffer), "unknown");
+        break;
+    }
+    return std::string(VADComparator::get_detector_name(candidate.detector)) + " " + buffer;
+}
+
+} // namespace srv
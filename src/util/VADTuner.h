@@ -0,0 +1,123 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "SegmentIndex.h"
+#include "VADComparator.h"
+
+// VAD参数自动调优：逐帧特征只计算一次，之后在多核上用廉价的判决逻辑回放参数网格，输出漏检/虚警/CPU的帕累托前沿
+namespace srv {
+
+class VADTuner {
+public:
+    // 参考语音段（样本下标，左闭右开）
+    using Range = SegmentIndex::Range;
+
+    // 一组待评估的参数
+    struct Candidate {
+        VADComparator::Detector detector;
+        // THRESHOLD: param1=平均幅度门限, param2=拖尾帧数
+        // SPEEX:     param1=prob_start,   param2=prob_continue (0-100)
+        // RNNOISE:   param1=概率门限,      param2=拖尾帧数
+        double param1;
+        double param2;
+    };
+
+    // 评估结果
+    struct Result {
+        Candidate candidate;
+        double miss_rate;           // 参考语音帧中被判为静音的比例
+        double false_alarm_rate;    // 参考非语音帧中被判为语音的比例
+        double cpu_us_per_frame;    // 检测器每帧CPU耗时（微秒）
+    };
+
+private:
+    VADComparator comparator_;
+    int sample_rate_;
+    int frame_size_;
+    int num_threads_;
+    bool is_initialized_;
+
+    // 逐帧缓存的特征（结构数组）
+    std::vector<float> mean_abs_;
+    std::vector<uint8_t> speex_prob_;   // 0-100
+    std::vector<float> rnnoise_prob_;
+    std::vector<uint8_t> label_;        // 参考标签，1为语音
+    std::vector<uint64_t> stream_starts_; // 每个文件的起始帧，回放时在此重置迟滞状态
+    uint64_t speech_frames_;
+
+public:
+    VADTuner();
+    ~VADTuner() = default;
+
+    /**
+     * 初始化
+     * @param sample_rate 采样率 (Hz)
+     * @param frame_size 帧大小 (样本数，通常对应10ms)
+     * @param num_threads 评估线程数，0表示使用全部核心
+     * @param model_name RNNoise模型名，为空使用内置模型
+     * @return 是否初始化成功
+     */
+    bool init(int sample_rate = 16000, int frame_size = 160, int num_threads = 0,
+              const std::string& model_name = "");
+
+    /**
+     * 加入一段带参考标签的音频，计算并缓存所有检测器的逐帧特征
+     * 一帧中至少一半样本落在参考语音段内即视为语音帧
+     * @param samples 单声道16位样本
+     * @param count 样本数
+     * @param speech 参考语音段（有序、不重叠）
+     * @return 是否成功
+     */
+    bool add_audio(const int16_t* samples, size_t count, const std::vector<Range>& speech);
+
+    /**
+     * 生成默认参数网格
+     */
+    std::vector<Candidate> make_grid() const;
+
+    /**
+     * 评估单组参数
+     */
+    Result evaluate(const Candidate& candidate) const;
+
+    /**
+     * 并行评估一组参数
+     * @param candidates 参数列表
+     * @return 与参数顺序一致的结果
+     */
+    std::vector<Result> evaluate_all(const std::vector<Candidate>& candidates) const;
+
+    /**
+     * 提取帕累托前沿（漏检率、虚警率、CPU均不劣于其他结果），按CPU、漏检率排序
+     * @param results 评估结果
+     * @return 前沿上的结果
+     */
+    static std::vector<Result> pareto_front(const std::vector<Result>& results);
+
+    /**
+     * 参数的可读描述
+     */
+    static std::string describe(const Candidate& candidate);
+
+    /**
+     * 设置评估线程数，0表示使用全部核心
+     */
+    void set_num_threads(int num_threads);
+
+    /**
+     * 检查是否已初始化
+     */
+    bool is_initialized() const { return is_initialized_; }
+
+    uint64_t get_num_frames() const { return label_.size(); }
+    uint64_t get_speech_frames() const { return speech_frames_; }
+    int get_num_threads() const { return num_threads_; }
+
+    /**
+     * 特征计算阶段各检测器的每帧CPU耗时（微秒）
+     */
+    double get_cpu_us_per_frame(VADComparator::Detector detector) const;
+};
+
+} // namespace srv
@@ -0,0 +1,194 @@
+#include "WavWriter.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+namespace srv {
+
+namespace {
+
+// RIFF(12) + JUNK/ds64(8+28) + fmt(8+16) + data(8)
+const size_t kJunkSize = 28;
+const size_t kHeaderSize = 12 + 8 + kJunkSize + 8 + 16 + 8;
+const uint64_t kMaxRiffSize = 0xFFFFFFFFull;
+
+void put_u16(uint8_t* p, uint16_t v) {
+    p[0] = static_cast<uint8_t>(v);
+    p[1] = static_cast<uint8_t>(v >> 8);
+}
+
+void put_u32(uint8_t* p, uint32_t v) {
+    for (int i = 0; i < 4; ++i) {
+        p[i] = static_cast<uint8_t>(v >> (8 * i));
+    }
+}
+
+void put_u64(uint8_t* p, uint64_t v) {
+    for (int i = 0; i < 8; ++i) {
+        p[i] = static_cast<uint8_t>(v >> (8 * i));
+    }
+}
+
+} // namespace
+
+WavWriter::WavWriter()
+    : sample_rate_(0),
+      channels_(0),
+      buffer_frames_(0),
+      current_(nullptr),
+      failed_(false),
+      frames_written_(0),
+      is_open_(false) {}
+
+WavWriter::~WavWriter() {
+    close();
+}
+
+bool WavWriter::open(const std::string& path, int sample_rate, int channels, size_t buffer_frames) {
+    close();
+    if (sample_rate <= 0 || channels <= 0 || buffer_frames == 0) {
+        std::cerr << "WavWriter init failed: invalid parameters" << std::endl;
+        return false;
+    }
+    file_.open(path, std::ios::binary | std::ios::trunc);
+    if (!file_.is_open()) {
+        std::cerr << "WavWriter open failed: " << path << std::endl;
+        return false;
+    }
+    path_ = path;
+    sample_rate_ = sample_rate;
+    channels_ = channels;
+    buffer_frames_ = buffer_frames;
+    frames_written_ = 0;
+    failed_ = false;
+
+    // 长度先写0xFFFFFFFF（直到文件末尾），进程异常退出时已落盘的数据仍可被读出
+    uint8_t header[kHeaderSize] = {};
+    uint8_t* p = header;
+    std::memcpy(p, "RIFF", 4);
+    put_u32(p + 4, 0xFFFFFFFFu);
+    std::memcpy(p + 8, "WAVE", 4);
+    p += 12;
+    std::memcpy(p, "JUNK", 4);
+    put_u32(p + 4, static_cast<uint32_t>(kJunkSize));
+    p += 8 + kJunkSize;
+    std::memcpy(p, "fmt ", 4);
+    put_u32(p + 4, 16);
+    put_u16(p + 8, 1);      // PCM
+    put_u16(p + 10, static_cast<uint16_t>(channels));
+    put_u32(p + 12, static_cast<uint32_t>(sample_rate));
+    put_u32(p + 16, static_cast<uint32_t>(sample_rate * channels * 2));
+    put_u16(p + 20, static_cast<uint16_t>(channels * 2));
+    put_u16(p + 22, 16);
+    p += 8 + 16;
+    std::memcpy(p, "data", 4);
+    put_u32(p + 4, 0xFFFFFFFFu);
+    file_.write(reinterpret_cast<const char*>(header), sizeof(header));
+    if (!file_) {
+        std::cerr << "WavWriter open failed: cannot write header " << path << std::endl;
+        file_.close();
+        return false;
+    }
+
+    const size_t capacity = buffer_frames * static_cast<size_t>(channels);
+    if (!queue_.init(2, capacity)) {
+        file_.close();
+        return false;
+    }
+    current_ = queue_.acquire_free();
+    thread_ = std::thread(&WavWriter::writer_loop, this);
+    is_open_ = true;
+    return true;
+}
+
+void WavWriter::writer_loop() {
+    while (BlockQueue::Buffer* buffer = queue_.acquire_full()) {
+        if (!failed_) {
+            file_.write(reinterpret_cast<const char*>(buffer->data()),
+                        static_cast<std::streamsize>(buffer->size() * sizeof(int16_t)));
+            if (!file_) {
+                std::cerr << "WavWriter write failed: " << path_ << std::endl;
+                failed_ = true;
+            }
+        }
+        queue_.recycle(buffer);
+    }
+}
+
+bool WavWriter::write(const int16_t* samples, size_t frames) {
+    if (!is_open_ || failed_) {
+        return false;
+    }
+    const size_t channels = static_cast<size_t>(channels_);
+    const size_t capacity = buffer_frames_ * channels;
+    size_t remaining = frames * channels;
+    while (remaining > 0) {
+        size_t n = std::min(remaining, capacity - current_->size());
+        current_->insert(current_->end(), samples, samples + n);
+        samples += n;
+        remaining -= n;
+        if (current_->size() == capacity) {
+            queue_.submit(current_);
+            current_ = queue_.acquire_free();
+        }
+    }
+    frames_written_ += frames;
+    return !failed_;
+}
+
+bool WavWriter::patch_header(uint64_t data_bytes) {
+    // 16位样本的数据长度总是偶数，不需要补齐字节
+    const uint64_t riff_size = kHeaderSize - 8 + data_bytes;
+    const bool rf64 = riff_size > kMaxRiffSize;
+
+    uint8_t riff[8];
+    std::memcpy(riff, rf64 ? "RF64" : "RIFF", 4);
+    put_u32(riff + 4, rf64 ? 0xFFFFFFFFu : static_cast<uint32_t>(riff_size));
+    file_.seekp(0);
+    file_.write(reinterpret_cast<const char*>(riff), sizeof(riff));
+
+    if (rf64) {
+        // JUNK改为ds64: riffSize(8) dataSize(8) sampleCount(8) tableLength(4)
+        uint8_t ds64[8 + kJunkSize] = {};
+        std::memcpy(ds64, "ds64", 4);
+        put_u32(ds64 + 4, static_cast<uint32_t>(kJunkSize));
+        put_u64(ds64 + 8, riff_size);
+        put_u64(ds64 + 16, data_bytes);
+        put_u64(ds64 + 24, frames_written_);
+        file_.seekp(12);
+        file_.write(reinterpret_cast<const char*>(ds64), sizeof(ds64));
+    }
+
+    uint8_t data_size[4];
+    put_u32(data_size, rf64 ? 0xFFFFFFFFu : static_cast<uint32_t>(data_bytes));
+    file_.seekp(static_cast<std::streamoff>(kHeaderSize - 4));
+    file_.write(reinterpret_cast<const char*>(data_size), sizeof(data_size));
+    file_.flush();
+    return static_cast<bool>(file_);
+}
+
+bool WavWriter::close() {
+    if (!is_open_) {
+        return false;
+    }
+    if (current_ && !current_->empty()) {
+        queue_.submit(current_);
+    } else if (current_) {
+        queue_.recycle(current_);
+    }
+    current_ = nullptr;
+    queue_.close();
+    thread_.join();
+
+    bool ok = !failed_;
+    const uint64_t data_bytes = frames_written_ * static_cast<uint64_t>(channels_) * sizeof(int16_t);
+    if (ok && !patch_header(data_bytes)) {
+        std::cerr << "WavWriter close failed: cannot patch header " << path_ << std::endl;
+        ok = false;
+    }
+    file_.close();
+    is_open_ = false;
+    return ok;
+}
+
+} // namespace srv
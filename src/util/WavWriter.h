@@ -0,0 +1,71 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <thread>
+#include "BlockQueue.h"
+
+// 16位PCM WAV异步写出：调用方把样本拷入当前缓冲区即返回，后台线程顺序落盘，关闭时回填RIFF长度
+namespace srv {
+
+class WavWriter {
+private:
+    std::ofstream file_;
+    std::string path_;
+    int sample_rate_;
+    int channels_;
+    size_t buffer_frames_;
+    BlockQueue queue_;
+    BlockQueue::Buffer* current_;   // 调用线程正在填充的缓冲区
+    std::thread thread_;
+    std::atomic<bool> failed_;
+    uint64_t frames_written_;       // 已交给write()的帧数
+    bool is_open_;
+
+    void writer_loop();
+    bool patch_header(uint64_t data_bytes);
+
+public:
+    WavWriter();
+    ~WavWriter();
+
+    WavWriter(const WavWriter&) = delete;
+    WavWriter& operator=(const WavWriter&) = delete;
+
+    /**
+     * 创建WAV文件并启动写线程
+     * 头部预留JUNK块，数据超过4GB时关闭时改写为RF64/ds64
+     * @param path 文件路径
+     * @param sample_rate 采样率
+     * @param channels 声道数
+     * @param buffer_frames 每个缓冲区的帧数（共两个缓冲区交替写出）
+     * @return 是否成功
+     */
+    bool open(const std::string& path, int sample_rate, int channels, size_t buffer_frames = 65536);
+
+    /**
+     * 追加交织样本，当前缓冲区写满时交给写线程；写线程还在写上一个缓冲区时阻塞
+     * @param samples 样本（frames*channels个）
+     * @param frames 帧数
+     * @return 是否成功（磁盘写入失败后返回false）
+     */
+    bool write(const int16_t* samples, size_t frames);
+
+    /**
+     * 写出剩余数据，等待写线程结束并回填头部长度
+     * @return 所有数据是否都成功写入
+     */
+    bool close();
+
+    bool is_open() const { return is_open_; }
+    uint64_t get_frames_written() const { return frames_written_; }
+
+    /**
+     * 调用线程等待写线程腾出缓冲区的累计时间（秒），非零说明磁盘比处理慢
+     */
+    double get_wait_seconds() { return queue_.get_producer_wait_seconds(); }
+};
+
+} // namespace srv
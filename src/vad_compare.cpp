@@ -0,0 +1,220 @@
+// 多检测器单遍对比：每个文件只解码、分帧一次，同一帧同时送入阈值、Speex和RNNoise检测器
+// 输出对齐的逐帧判决（列式文件）、两两一致率矩阵和各检测器CPU耗时
+// RNNoise在48kHz上推理，其概率已按分析窗位置扣除重采样和凑帧延迟，与同一行的阈值、Speex判决对应同一输入帧
+// 用法: vad_compare [--rate 采样率(原始PCM)=16000] [--out 结果文件=vad_compare.cols] [输入.wav/.pcm ...]
+//       不指定输入时使用 res/sp01_car_sn15.wav 和 res/sp02_airport_sn15.wav
+#include <iostream>
+#include <vector>
+#include <string>
+#include <iomanip>
+#include <chrono>
+#include "util/AudioFile.h"
+#include "util/VADComparator.h"
+#include "util/ColumnarFile.h"
+#include "util/ProcessStats.h"
+
+// 自检：同一段音频全部送入、finish后一次取完，RNNoise的逐帧概率和判决应与每帧之后立即取出完全相同
+// （对齐只取决于输入位置，与调用方何时取结果无关）
+bool check_batched_pop(const std::vector<short>& audio, int sample_rate, int frame_size,
+                       const std::vector<srv::VADComparator::FrameResult>& streamed) {
+    srv::VADComparator batched;
+    if (!batched.init(sample_rate, frame_size)) {
+        return false;
+    }
+    batched.set_speex_params(80, 80, -15);
+    for (size_t f = 0; f < streamed.size(); ++f) {
+        batched.process_frame(&audio[f * frame_size]);
+    }
+    batched.finish();
+
+    size_t count = 0;
+    size_t mismatches = 0;
+    srv::VADComparator::FrameResult result;
+    while (batched.pop_result(result)) {
+        const auto rn = srv::VADComparator::RNNOISE;
+        if (count >= streamed.size() || result.frame_index != streamed[count].frame_index ||
+            result.score[rn] != streamed[count].score[rn] || result.speech[rn] != streamed[count].speech[rn]) {
+            mismatches++;
+        }
+        count++;
+    }
+    mismatches += count > streamed.size() ? count - streamed.size() : streamed.size() - count;
+    std::cout << "\nRNNoise对齐自检（finish后批量取出 vs 逐帧取出, " << streamed.size() << " 帧）: "
+              << (mismatches == 0 ? "一致 ✅" : std::to_string(mismatches) + " 帧不一致 ❌") << std::endl;
+    return mismatches == 0;
+}
+
+int main(int argc, char** argv) {
+    std::cout << "=== 多检测器单遍对比 ===" << std::endl;
+
+    int pcm_rate = 16000;
+    std::string out_path = "vad_compare.cols";
+    std::vector<std::string> inputs;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--rate" && i + 1 < argc) {
+            pcm_rate = std::stoi(argv[++i]);
+        } else if (arg == "--out" && i + 1 < argc) {
+            out_path = argv[++i];
+        } else {
+            inputs.push_back(arg);
+        }
+    }
+    if (inputs.empty()) {
+        inputs = {"res/sp01_car_sn15.wav", "res/sp02_airport_sn15.wav"};
+    }
+
+    const std::vector<srv::ColumnSpec> columns = {
+        {"file_index", srv::ColumnType::INT32},
+        {"threshold", srv::ColumnType::UINT8},
+        {"speex", srv::ColumnType::UINT8},
+        {"rnnoise", srv::ColumnType::UINT8},
+        {"mean_abs", srv::ColumnType::FLOAT32},
+        {"speex_prob", srv::ColumnType::FLOAT32},
+        {"rnnoise_prob", srv::ColumnType::FLOAT32},
+    };
+    srv::ColumnarWriter writer;
+    srv::VADComparator comparator;
+    int sample_rate = 0;
+    int frame_size = 0;
+    double audio_seconds = 0.0;
+    double framing_cpu = 0.0;
+    double total_cpu = 0.0;
+    // 第一个文件的音频和逐帧结果，留给自检
+    std::vector<short> check_audio;
+    std::vector<srv::VADComparator::FrameResult> check_results;
+    auto wall_start = std::chrono::steady_clock::now();
+
+    for (size_t file_index = 0; file_index < inputs.size(); ++file_index) {
+        const std::string& path = inputs[file_index];
+        double cpu_start = srv::ProcessStats::get_thread_cpu_seconds();
+        // WAV按文件头解析（多声道下混为单声道），原始PCM按--rate的16位单声道读取
+        const srv::AudioFile::Format raw_format{pcm_rate, 1, srv::AudioFile::SampleFormat::S16};
+        int rate = 0;
+        auto audio = srv::load_audio_mono_s16(path, 0, &raw_format, &rate);
+        if (audio.empty()) {
+            std::cerr << "❌ 错误：无法读取音频 " << path << std::endl;
+            continue;
+        }
+
+        // 第一个文件决定采样率和帧长，之后只接受相同采样率
+        if (sample_rate == 0) {
+            sample_rate = rate;
+            frame_size = sample_rate / 100;
+            if (!comparator.init(sample_rate, frame_size)) {
+                return 1;
+            }
+            comparator.set_speex_params(80, 80, -15);
+            if (!writer.open(out_path, columns, 100.0)) {
+                return 1;
+            }
+            std::cout << "采样率: " << sample_rate << " Hz, 帧长: " << frame_size << " 样本 (10ms)" << std::endl;
+        } else if (rate != sample_rate) {
+            std::cerr << "⚠️  跳过采样率不同的文件 " << path << std::endl;
+            continue;
+        }
+        comparator.restart();
+
+        // 不足一帧的尾部补零
+        const size_t num_frames = (audio.size() + frame_size - 1) / frame_size;
+        audio.resize(num_frames * frame_size, 0);
+        framing_cpu += srv::ProcessStats::get_thread_cpu_seconds() - cpu_start;
+
+        // RNNoise的判决按分析窗位置对齐到输入帧，比输入晚几帧才能取出；文件结束时finish冲出剩余帧
+        srv::VADComparator::FrameResult result;
+        auto write_rows = [&]() {
+            while (comparator.pop_result(result)) {
+                writer.set(0, static_cast<double>(file_index));
+                for (int d = 0; d < srv::VADComparator::NUM_DETECTORS; ++d) {
+                    writer.set(1 + d, result.speech[d] ? 1.0 : 0.0);
+                    writer.set(4 + d, result.score[d]);
+                }
+                writer.end_row();
+                if (check_audio.empty()) {
+                    check_results.push_back(result);
+                }
+            }
+        };
+        for (size_t f = 0; f < num_frames; ++f) {
+            comparator.process_frame(&audio[f * frame_size]);
+            write_rows();
+        }
+        comparator.finish();
+        write_rows();
+        total_cpu += srv::ProcessStats::get_thread_cpu_seconds() - cpu_start;
+        audio_seconds += static_cast<double>(audio.size()) / sample_rate;
+        if (check_audio.empty()) {
+            check_audio = std::move(audio);
+        }
+        std::cout << "✅ " << path << ": " << num_frames << " 帧" << std::endl;
+    }
+
+    if (comparator.get_total_frames() == 0) {
+        std::cerr << "❌ 没有可用的输入" << std::endl;
+        return 1;
+    }
+    writer.close();
+    double wall_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - wall_start).count();
+
+    const int n = srv::VADComparator::NUM_DETECTORS;
+    const auto total_frames = comparator.get_total_frames();
+    std::cout << "\n总帧数: " << total_frames << ", 音频时长: " << std::fixed << std::setprecision(1)
+              << audio_seconds << " 秒" << std::endl;
+
+    std::cout << "\n语音帧比例:" << std::endl;
+    for (int d = 0; d < n; ++d) {
+        auto det = static_cast<srv::VADComparator::Detector>(d);
+        std::cout << "  " << std::left << std::setw(10) << srv::VADComparator::get_detector_name(det) << std::right
+                  << std::setprecision(1) << (100.0 * comparator.get_speech_frames(det) / total_frames) << "%"
+                  << std::endl;
+    }
+
+    std::cout << "\n两两一致率 (%):" << std::endl;
+    std::cout << "  " << std::setw(10) << "";
+    for (int b = 0; b < n; ++b) {
+        std::cout << std::setw(10) << srv::VADComparator::get_detector_name(static_cast<srv::VADComparator::Detector>(b));
+    }
+    std::cout << std::endl;
+    for (int a = 0; a < n; ++a) {
+        auto da = static_cast<srv::VADComparator::Detector>(a);
+        std::cout << "  " << std::left << std::setw(10) << srv::VADComparator::get_detector_name(da) << std::right;
+        for (int b = 0; b < n; ++b) {
+            auto db = static_cast<srv::VADComparator::Detector>(b);
+            std::cout << std::setw(10) << std::setprecision(1) << (100.0 * comparator.get_agreement(da, db));
+        }
+        std::cout << std::endl;
+    }
+
+    std::cout << "\n联合判决 (行语音/列语音 帧数):" << std::endl;
+    for (int a = 0; a < n; ++a) {
+        for (int b = a + 1; b < n; ++b) {
+            auto da = static_cast<srv::VADComparator::Detector>(a);
+            auto db = static_cast<srv::VADComparator::Detector>(b);
+            std::cout << "  " << srv::VADComparator::get_detector_name(da) << " vs "
+                      << srv::VADComparator::get_detector_name(db) << ": 都是语音 "
+                      << comparator.get_joint_frames(da, db, true, true) << ", 只有前者 "
+                      << comparator.get_joint_frames(da, db, true, false) << ", 只有后者 "
+                      << comparator.get_joint_frames(da, db, false, true) << ", 都是静音 "
+                      << comparator.get_joint_frames(da, db, false, false) << std::endl;
+        }
+    }
+
+    std::cout << "\nCPU耗时:" << std::endl;
+    double detector_cpu = 0.0;
+    for (int d = 0; d < n; ++d) {
+        auto det = static_cast<srv::VADComparator::Detector>(d);
+        double cpu = comparator.get_cpu_seconds(det);
+        detector_cpu += cpu;
+        std::cout << "  " << std::left << std::setw(10) << srv::VADComparator::get_detector_name(det) << std::right
+                  << std::setprecision(3) << (cpu * 1000.0) << " ms (" << std::setprecision(2)
+                  << (1e6 * cpu / total_frames) << " us/帧)" << std::endl;
+    }
+    std::cout << "  读取+分帧(一次): " << std::setprecision(3) << (framing_cpu * 1000.0) << " ms" << std::endl;
+    std::cout << "  合计: " << std::setprecision(3) << (total_cpu * 1000.0) << " ms (检测器 "
+              << (detector_cpu * 1000.0) << " ms), 实时倍数 " << std::setprecision(0)
+              << (audio_seconds / std::max(1e-9, wall_seconds)) << "x" << std::endl;
+    std::cout << "  RNNoise推理: " << comparator.get_rnnoise_runs() << " 帧 (48kHz)" << std::endl;
+
+    std::cout << "\n✅ 逐帧判决已写入: " << out_path << " (可用 columnar_to_csv 转成CSV)" << std::endl;
+    return check_batched_pop(check_audio, sample_rate, frame_size, check_results) ? 0 : 1;
+}
@@ -10,7 +10,11 @@
 #include <cstring>
 #include <iomanip>
 #include <sstream>
+#include "util/AudioFile.h"
 #include "util/VAD.h"
+#include "util/EnergyVAD.h"
+#include "util/SegmentIndex.h"
+#include "util/SpeechTrimmer.h"
 
 // ==================== PCM数据生成工具 ====================
 
@@ -80,8 +84,8 @@ std::vector<spx_int16_t> generate_noisy_audio(int sample_rate, int duration_ms,
     int num_samples = (sample_rate * duration_ms) / 1000;
     std::vector<spx_int16_t> audio_data(num_samples);
     
-    std::random_device rd;
-    std::mt19937 gen(rd());
+    // 固定种子：每次运行生成相同的音频，语音段索引可以跨运行复用
+    std::mt19937 gen(static_cast<unsigned>(frequency));
     std::normal_distribution<double> noise_dist(0.0, noise_level);
     
     for (int i = 0; i < num_samples; ++i) {
@@ -134,28 +138,6 @@ bool save_pcm_file(const std::vector<spx_int16_t>& audio_data, const PCMFileInfo
     return true;
 }
 
-// 从文件读取PCM数据
-std::vector<spx_int16_t> load_pcm_file(const std::string& filename) {
-    std::ifstream file(filename, std::ios::binary | std::ios::ate);
-    if (!file.is_open()) {
-        std::cerr << "错误：无法打开文件 " << filename << std::endl;
-        return std::vector<spx_int16_t>();
-    }
-    
-    std::streamsize size = file.tellg();
-    file.seekg(0, std::ios::beg);
-    
-    std::vector<spx_int16_t> audio_data(size / sizeof(spx_int16_t));
-    file.read(reinterpret_cast<char*>(audio_data.data()), size);
-    file.close();
-    
-    std::cout << "✅ PCM文件已加载: " << filename << std::endl;
-    std::cout << "   文件大小: " << size << " 字节" << std::endl;
-    std::cout << "   样本数量: " << audio_data.size() << std::endl;
-    
-    return audio_data;
-}
-
 // ==================== 静音检测工具 ====================
 
 // 简单的静音检测（基于阈值）
@@ -173,18 +155,11 @@ struct SilenceSegment {
 };
 
 // 传统阈值检测方法（非Speex）- 改进版
+// 逐样本滑动窗口平均幅度判决，由EnergyVAD以滑动求和 + 按步判决实现，O(n)
 std::vector<SilenceSegment> detect_silence_threshold(const std::vector<spx_int16_t>& audio_data, 
                                                      const PCMFileInfo& info, 
                                                      int threshold = 100) {
     std::vector<SilenceSegment> silence_segments;
-    bool in_silence = false;
-    size_t silence_start_byte = 0;
-    size_t silence_start_sample = 0;
-    
-    // 调试统计
-    int total_samples = 0;
-    int silent_samples = 0;
-    int voice_samples = 0;
     
     // 平滑处理参数
     const int window_size = 160; // 10ms窗口 @ 16kHz
@@ -196,61 +171,25 @@ std::vector<SilenceSegment> detect_silence_threshold(const std::vector<spx_int16
     std::cout << "  平滑窗口: " << window_size << " 样本 (" << (window_size * 1000.0 / info.sample_rate) << "ms)" << std::endl;
     std::cout << "  最小静音时长: " << min_silence_duration << " 样本 (" << (min_silence_duration * 1000.0 / info.sample_rate) << "ms)" << std::endl;
     
-    for (size_t i = 0; i < audio_data.size(); ++i) {
-        // 计算滑动窗口内的平均能量
-        double window_energy = 0.0;
-        int window_count = 0;
-        
-        for (int j = 0; j < window_size && (i + j) < audio_data.size(); ++j) {
-            window_energy += std::abs(audio_data[i + j]);
-            window_count++;
-        }
-        
-        // 计算平均幅度
-        double avg_amplitude = window_energy / window_count;
-        
-        // 基于平均幅度的阈值检测
-        bool is_silent = avg_amplitude <= threshold;
-        size_t current_byte = i * sizeof(spx_int16_t);
-        double current_ms = info.samples_to_ms(i);
-        
-        // 统计
-        total_samples++;
-        if (is_silent) {
-            silent_samples++;
-        } else {
-            voice_samples++;
-        }
-        
-        if (is_silent && !in_silence) {
-            // 开始静音
-            in_silence = true;
-            silence_start_byte = current_byte;
-            silence_start_sample = i;
-        } else if (!is_silent && in_silence) {
-            // 结束静音，检查持续时间
-            size_t silence_duration = i - silence_start_sample;
-            if (silence_duration >= min_silence_duration) {
-                double silence_start_ms = info.samples_to_ms(silence_start_sample);
-                silence_segments.emplace_back(silence_start_byte, current_byte, 
-                                            silence_start_ms, current_ms);
-            }
-            in_silence = false;
-        }
+    srv::EnergyVAD detector;
+    if (!detector.init(threshold, window_size, min_silence_duration)) {
+        return silence_segments;
     }
-    
-    // 处理文件末尾的静音
-    if (in_silence) {
-        size_t silence_duration = audio_data.size() - silence_start_sample;
-        if (silence_duration >= min_silence_duration) {
-            size_t end_byte = audio_data.size() * sizeof(spx_int16_t);
-            double end_ms = info.samples_to_ms(audio_data.size());
-            double silence_start_ms = info.samples_to_ms(silence_start_sample);
-            silence_segments.emplace_back(silence_start_byte, end_byte, 
-                                        silence_start_ms, end_ms);
-        }
+    detector.process(audio_data.data(), audio_data.size());
+    detector.finish();
+    
+    for (const auto& segment : detector.get_segments()) {
+        silence_segments.emplace_back(segment.start_sample * sizeof(spx_int16_t),
+                                      segment.end_sample * sizeof(spx_int16_t),
+                                      info.samples_to_ms(segment.start_sample),
+                                      info.samples_to_ms(segment.end_sample));
     }
     
+    // 调试统计
+    size_t total_samples = audio_data.size();
+    size_t silent_samples = static_cast<size_t>(detector.get_silent_samples());
+    size_t voice_samples = total_samples - silent_samples;
+    
     // 输出统计信息
     std::cout << "阈值检测统计结果:" << std::endl;
     std::cout << "  总样本数: " << total_samples << std::endl;
@@ -367,6 +306,66 @@ void print_silence_segments(const std::vector<SilenceSegment>& segments,
     }
 }
 
+// ==================== 语音段索引 ====================
+
+// Speex VAD检测参数的哈希，任一参数变化后旧索引不再复用
+uint64_t speex_config_hash(const PCMFileInfo& info, const srv::VAD& vad) {
+    std::string config = "speex:rate=" + std::to_string(info.sample_rate) +
+                         ",frame=" + std::to_string(vad.get_frame_size()) +
+                         ",start=" + std::to_string(vad.get_prob_start()) +
+                         ",continue=" + std::to_string(vad.get_prob_continue()) +
+                         ",suppress=" + std::to_string(vad.get_noise_suppress());
+    return srv::SegmentIndex::hash_content(config.data(), config.size());
+}
+
+// 静音段取反得到语音段
+std::vector<srv::SegmentIndex::Range> silence_to_speech(const std::vector<SilenceSegment>& silence_segments,
+                                                        size_t total_samples) {
+    std::vector<srv::SegmentIndex::Range> speech;
+    uint64_t cursor = 0;
+    for (const auto& seg : silence_segments) {
+        uint64_t start = seg.start_byte / sizeof(spx_int16_t);
+        uint64_t end = std::min<uint64_t>(seg.end_byte / sizeof(spx_int16_t), total_samples);
+        if (start > cursor) {
+            speech.push_back({cursor, start});
+        }
+        cursor = std::max(cursor, end);
+    }
+    if (cursor < total_samples) {
+        speech.push_back({cursor, total_samples});
+    }
+    return speech;
+}
+
+// 加载与音频内容匹配的语音段索引；不存在或不匹配时运行Speex VAD并写入索引
+// detected非空时输出本次检测到的静音段（复用索引时不运行VAD，保持为空）
+bool load_or_build_speech_index(const std::vector<spx_int16_t>& audio_data, const PCMFileInfo& info,
+                                srv::VAD& vad, const std::string& index_path, srv::SegmentIndex& index,
+                                std::vector<SilenceSegment>* detected = nullptr) {
+    uint64_t content_hash = srv::SegmentIndex::hash_content(audio_data.data(), audio_data.size() * sizeof(spx_int16_t));
+    uint64_t config_hash = speex_config_hash(info, vad);
+
+    if (index.load(index_path) && index.matches(content_hash, config_hash)) {
+        std::cout << "✅ 复用已有索引: " << index_path << " (" << index.get_range_count() << " 个语音段)" << std::endl;
+        return true;
+    }
+
+    std::cout << "⚠️  索引不存在或与音频不匹配，重新运行VAD..." << std::endl;
+    auto silence_segments = detect_silence_speex(audio_data, info, vad);
+    auto speech = silence_to_speech(silence_segments, audio_data.size());
+    if (detected) {
+        *detected = silence_segments;
+    }
+    if (!index.build(speech, info.sample_rate, audio_data.size(), content_hash, config_hash) ||
+        !index.save(index_path)) {
+        std::cerr << "❌ 索引写入失败: " << index_path << std::endl;
+        return false;
+    }
+    std::cout << "✅ 索引已写入: " << index_path << " (" << index.get_range_count() << " 个语音段, "
+              << index.get_payload_bytes() << " 字节载荷)" << std::endl;
+    return true;
+}
+
 // ==================== 测试音频生成 ====================
 
 // 生成测试音频序列
@@ -499,7 +498,10 @@ int main() {
     
     // 步骤3: 从文件读取PCM数据
     std::cout << "\n步骤3: 从文件读取PCM数据..." << std::endl;
-    auto loaded_audio = load_pcm_file(pcm_info.filename);
+    const srv::AudioFile::Format raw_format{sample_rate, channels, srv::AudioFile::SampleFormat::S16};
+    srv::MonoAudio loaded = srv::load_audio_mono(pcm_info.filename, 0, &raw_format);
+    srv::print_audio_info(pcm_info.filename, loaded);
+    std::vector<spx_int16_t> loaded_audio = std::move(loaded.samples);
     if (loaded_audio.empty()) {
         std::cerr << "❌ PCM文件读取失败" << std::endl;
         return -1;
@@ -522,13 +524,50 @@ int main() {
     auto threshold_segments = detect_silence_threshold(loaded_audio, pcm_info, 100);
     print_silence_segments(threshold_segments, "阈值检测");
     
-    // 步骤6: Speex VAD静音检测
+    // 步骤6: Speex VAD静音检测（已有匹配的索引时直接复用，不再运行VAD）
     std::cout << "\n步骤6: Speex VAD静音检测..." << std::endl;
-    auto speex_segments = detect_silence_speex(loaded_audio, pcm_info, vad);
-    print_silence_segments(speex_segments, "Speex VAD检测");
+    const std::string index_path = pcm_info.filename + ".segidx";
+    srv::SegmentIndex speech_index;
+    std::vector<SilenceSegment> speex_segments;
+    const bool index_ready = load_or_build_speech_index(loaded_audio, pcm_info, vad, index_path, speech_index,
+                                                        &speex_segments);
+    if (!speex_segments.empty()) {
+        print_silence_segments(speex_segments, "Speex VAD检测");
+    }
+    
+    // 步骤7: 按时间查询语音段索引
+    std::cout << "\n步骤7: 查询语音段索引..." << std::endl;
+    if (index_ready) {
+        const double query_start_ms = 1000.0;
+        const double query_end_ms = 2500.0;
+        auto ranges = speech_index.query_ms(query_start_ms, query_end_ms);
+        std::cout << "与 [" << std::fixed << std::setprecision(1) << query_start_ms << "ms, "
+                  << query_end_ms << "ms) 重叠的语音段: " << ranges.size() << " 个" << std::endl;
+        for (const auto& r : ranges) {
+            std::cout << "  " << pcm_info.samples_to_ms(r.start_sample) << "ms - "
+                      << pcm_info.samples_to_ms(r.end_sample) << "ms" << std::endl;
+        }
+    }
+    
+    // 步骤8: 只保留语音段输出，供ASR使用
+    std::cout << "\n步骤8: 输出语音段..." << std::endl;
+    if (speech_index.is_loaded()) {
+        const std::string speech_path = pcm_info.filename + ".speech.pcm";
+        const std::string map_path = pcm_info.filename + ".speech.map.csv";
+        srv::SpeechTrimmer trimmer;
+        if (trimmer.init(sample_rate, channels, 5) &&
+            trimmer.trim(pcm_info.filename, speech_path, speech_index.get_all()) &&
+            trimmer.write_offset_map(map_path)) {
+            std::cout << "✅ 语音段已写入: " << speech_path << " (" << trimmer.get_bytes_written() << " 字节, "
+                      << std::fixed << std::setprecision(1) << trimmer.get_throughput_mbps() << " MB/s)" << std::endl;
+            std::cout << "   偏移映射: " << map_path << std::endl;
+        } else {
+            std::cerr << "❌ 语音段输出失败" << std::endl;
+        }
+    }
     
-    // 步骤7: 对比分析
-    std::cout << "\n步骤7: 检测方法对比分析..." << std::endl;
+    // 步骤9: 对比分析
+    std::cout << "\n步骤9: 检测方法对比分析..." << std::endl;
     std::cout << "传统阈值检测方法:" << std::endl;
     std::cout << "  - 方法: 基于滑动窗口的平均能量阈值检测" << std::endl;
     std::cout << "  - 优点: 平滑处理，更接近实际应用" << std::endl;
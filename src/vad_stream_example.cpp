@@ -0,0 +1,115 @@
+// 流式VAD事件示例：按随机大小分块输入，打印语音开始/结束事件和预录音频范围，并验证长时间运行内存不增长
+// 用法: vad_stream_example [16k单声道s16le PCM文件]
+#include <iostream>
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include <random>
+#include <string>
+#include <iomanip>
+#include "util/AudioFile.h"
+#include "util/VADStream.h"
+#include "util/ProcessStats.h"
+
+// 生成一段合成音频：静音与类语音信号交替
+std::vector<short> generate_audio(int duration_ms, int sample_rate, unsigned seed) {
+    std::vector<short> audio(static_cast<size_t>(duration_ms) * sample_rate / 1000, 0);
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<int> segment_ms(200, 2000);
+    std::normal_distribution<double> noise_dist(0.0, 1.0);
+
+    size_t i = 0;
+    bool speech = false;
+    while (i < audio.size()) {
+        size_t length = static_cast<size_t>(segment_ms(gen)) * sample_rate / 1000;
+        for (size_t k = 0; k < length && i < audio.size(); ++k, ++i) {
+            double t = static_cast<double>(i) / sample_rate;
+            double value = 20.0 * noise_dist(gen);
+            if (speech) {
+                double envelope = 0.5 + 0.5 * std::sin(2.0 * M_PI * 4.0 * t);
+                for (int h = 1; h <= 6; ++h) {
+                    value += 4000.0 * envelope * std::sin(2.0 * M_PI * 150.0 * h * t) / h;
+                }
+            }
+            audio[i] = static_cast<short>(std::max(-32768.0, std::min(32767.0, value)));
+        }
+        speech = !speech;
+    }
+    return audio;
+}
+
+int main(int argc, char** argv) {
+    std::cout << "=== 流式VAD事件示例 ===" << std::endl;
+    const int sample_rate = 16000;
+
+    std::vector<short> audio;
+    if (argc > 1) {
+        const srv::AudioFile::Format raw_format{sample_rate, 1, srv::AudioFile::SampleFormat::S16};
+        srv::MonoAudio loaded = srv::load_audio_mono(argv[1], sample_rate, &raw_format);
+        srv::print_audio_info(argv[1], loaded);
+        audio = std::move(loaded.samples);
+    }
+    if (audio.empty()) {
+        audio = generate_audio(10000, sample_rate, 1);
+    }
+
+    srv::VADStream stream;
+    if (!stream.init(srv::VADStream::Detector::SPEEX, sample_rate, 300, 20, 200, 100)) {
+        std::cerr << "❌ VADStream初始化失败" << std::endl;
+        return -1;
+    }
+
+    uint64_t speech_samples_delivered = 0;
+    stream.set_event_callback([&](const srv::VADStream::Event& event) {
+        double ms = event.sample * 1000.0 / sample_rate;
+        double delay_ms = (event.confirmed_sample - event.sample) * 1000.0 / sample_rate;
+        if (event.type == srv::VADStream::EventType::SPEECH_START) {
+            std::cout << "▶ 语音开始 @" << std::fixed << std::setprecision(1) << ms << "ms (样本 " << event.sample
+                      << ", 判决延迟 " << delay_ms << "ms), 附带音频 "
+                      << (event.audio_start_sample * 1000.0 / sample_rate) << "ms起 " << event.audio_size << " 样本" << std::endl;
+            speech_samples_delivered += event.audio_size;
+        } else {
+            std::cout << "■ 语音结束 @" << std::fixed << std::setprecision(1) << ms << "ms (样本 " << event.sample
+                      << ", 判决延迟 " << delay_ms << "ms)" << std::endl;
+        }
+    });
+    stream.set_audio_callback([&](const int16_t*, size_t count, uint64_t) {
+        speech_samples_delivered += count;
+    });
+
+    // 随机大小分块输入，模拟网络/采集回调
+    std::mt19937 gen(9);
+    std::uniform_int_distribution<size_t> chunk_dist(1, 1000);
+    for (size_t pos = 0; pos < audio.size();) {
+        size_t n = std::min(audio.size() - pos, chunk_dist(gen));
+        stream.push(audio.data() + pos, n);
+        pos += n;
+    }
+    stream.flush();
+    std::cout << "语音回调共交付 " << speech_samples_delivered << " 样本" << std::endl;
+
+    // 长时间运行：1小时流，事件只计数，检查常驻内存
+    std::cout << "\n1小时流内存测试..." << std::endl;
+    stream.set_event_callback(nullptr);
+    stream.set_audio_callback(nullptr);
+    stream.reset();
+    auto block = generate_audio(60000, sample_rate, 2);
+    size_t rss_warm = 0;
+    for (int minute = 0; minute < 60; ++minute) {
+        for (size_t pos = 0; pos < block.size(); pos += 320) {
+            stream.push(block.data() + pos, std::min<size_t>(320, block.size() - pos));
+        }
+        if (minute == 9) {
+            rss_warm = srv::ProcessStats::get_current_rss_bytes();
+        }
+    }
+    stream.flush();
+    size_t rss_end = srv::ProcessStats::get_current_rss_bytes();
+    std::cout << "RSS (10分钟后): " << std::setprecision(2) << (rss_warm / (1024.0 * 1024.0)) << " MB" << std::endl;
+    std::cout << "RSS (60分钟后): " << (rss_end / (1024.0 * 1024.0)) << " MB" << std::endl;
+    // 稳态下push不分配内存，RSS只会有统计读取等带来的少量波动
+    std::cout << (rss_end <= rss_warm + 1024 * 1024 ? "✅ 内存占用恒定" : "⚠️  内存有增长") << std::endl;
+
+    std::cout << "\n=== 测试完成 ===" << std::endl;
+    return 0;
+}
@@ -0,0 +1,217 @@
+// VAD参数自动调优：带参考标签的语料只计算一次逐帧特征，多核回放参数网格，输出漏检率/虚警率/CPU的帕累托前沿
+// 用法: vad_tune [--rate 采样率(原始PCM)=16000] [--threads N] [--out 前沿CSV=vad_tune_pareto.csv]
+//                [<音频.wav/.pcm> <标签.txt> ...]
+//       标签为Audacity格式，每行"起点秒<TAB>终点秒[<TAB>名称]"，表示一段语音
+//       不指定输入时使用带已知标签的合成语料
+#include <iostream>
+#include <vector>
+#include <fstream>
+#include <sstream>
+#include <cmath>
+#include <algorithm>
+#include <cstring>
+#include <random>
+#include <string>
+#include <iomanip>
+#include <chrono>
+#include "util/AudioFile.h"
+#include "util/VADTuner.h"
+#include "util/ProcessStats.h"
+
+// 读取Audacity格式的语音标签，转换为样本下标并排序合并
+std::vector<srv::VADTuner::Range> read_labels(const std::string& filename, int sample_rate) {
+    std::vector<srv::VADTuner::Range> ranges;
+    std::ifstream file(filename);
+    if (!file.is_open()) {
+        std::cerr << "❌ 错误：无法打开标签文件 " << filename << std::endl;
+        return ranges;
+    }
+    std::string line;
+    while (std::getline(file, line)) {
+        std::istringstream iss(line);
+        double start = 0.0;
+        double end = 0.0;
+        if (!(iss >> start >> end) || end <= start) {
+            continue;
+        }
+        ranges.push_back({static_cast<uint64_t>(std::llround(start * sample_rate)),
+                          static_cast<uint64_t>(std::llround(end * sample_rate))});
+    }
+    std::sort(ranges.begin(), ranges.end(), [](const srv::VADTuner::Range& a, const srv::VADTuner::Range& b) {
+        return a.start_sample < b.start_sample;
+    });
+    std::vector<srv::VADTuner::Range> merged;
+    for (const auto& r : ranges) {
+        if (!merged.empty() && r.start_sample <= merged.back().end_sample) {
+            merged.back().end_sample = std::max(merged.back().end_sample, r.end_sample);
+        } else {
+            merged.push_back(r);
+        }
+    }
+    return merged;
+}
+
+// 生成带已知标签的合成语料：随机长度的类语音段（音节包络调制的谐波）穿插在不同电平的背景噪声中
+std::vector<short> generate_labeled_corpus(int sample_rate, int duration_s,
+                                           std::vector<srv::VADTuner::Range>& speech) {
+    std::vector<short> audio(static_cast<size_t>(duration_s) * sample_rate, 0);
+    std::mt19937 gen(39);
+    std::normal_distribution<double> noise_dist(0.0, 1.0);
+    std::uniform_real_distribution<double> speech_s(0.3, 4.0);
+    std::uniform_real_distribution<double> pause_s(0.2, 3.0);
+    std::uniform_real_distribution<double> level_dist(0.0, 1.0);
+
+    size_t pos = 0;
+    bool in_speech = false;
+    while (pos < audio.size()) {
+        size_t length = static_cast<size_t>((in_speech ? speech_s(gen) : pause_s(gen)) * sample_rate);
+        length = std::min(length, audio.size() - pos);
+        // 每段随机的噪声电平和语音电平，覆盖高低信噪比
+        const double noise_level = 30.0 + 400.0 * level_dist(gen);
+        const double speech_level = 500.0 + 5000.0 * level_dist(gen);
+        const double f0_base = 100.0 + 150.0 * level_dist(gen);
+        for (size_t i = 0; i < length; ++i) {
+            double t = static_cast<double>(pos + i) / sample_rate;
+            double value = noise_level * noise_dist(gen);
+            if (in_speech) {
+                double envelope = 0.5 + 0.5 * std::sin(2.0 * M_PI * 4.0 * t);
+                double f0 = f0_base + 20.0 * std::sin(2.0 * M_PI * 0.7 * t);
+                double voiced = 0.0;
+                for (int h = 1; h <= 8; ++h) {
+                    voiced += std::sin(2.0 * M_PI * f0 * h * t) / h;
+                }
+                value += speech_level * envelope * voiced;
+            }
+            audio[pos + i] = static_cast<short>(std::max(-32768.0, std::min(32767.0, value)));
+        }
+        if (in_speech) {
+            speech.push_back({pos, pos + length});
+        }
+        pos += length;
+        in_speech = !in_speech;
+    }
+    return audio;
+}
+
+void print_result(const srv::VADTuner::Result& r) {
+    std::cout << "  " << std::left << std::setw(40) << srv::VADTuner::describe(r.candidate) << std::right
+              << " 漏检 " << std::fixed << std::setprecision(2) << std::setw(6) << (100.0 * r.miss_rate) << "%"
+              << " | 虚警 " << std::setw(6) << (100.0 * r.false_alarm_rate) << "%"
+              << " | CPU " << std::setw(6) << r.cpu_us_per_frame << " us/帧" << std::endl;
+}
+
+int main(int argc, char** argv) {
+    std::cout << "=== VAD参数自动调优 ===" << std::endl;
+
+    int pcm_rate = 16000;
+    int num_threads = 0;
+    std::string out_path = "vad_tune_pareto.csv";
+    std::vector<std::string> positional;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--rate" && i + 1 < argc) {
+            pcm_rate = std::stoi(argv[++i]);
+        } else if (arg == "--threads" && i + 1 < argc) {
+            num_threads = std::stoi(argv[++i]);
+        } else if (arg == "--out" && i + 1 < argc) {
+            out_path = argv[++i];
+        } else {
+            positional.push_back(arg);
+        }
+    }
+    if (positional.size() % 2 != 0) {
+        std::cerr << "❌ 输入需成对给出: <音频> <标签>" << std::endl;
+        return 1;
+    }
+
+    // 读入语料（音频 + 参考语音段）
+    struct LabeledAudio {
+        std::string name;
+        std::vector<short> audio;
+        std::vector<srv::VADTuner::Range> speech;
+    };
+    std::vector<LabeledAudio> corpus;
+    int sample_rate = 0;
+    for (size_t i = 0; i < positional.size(); i += 2) {
+        int rate = pcm_rate;
+        LabeledAudio item;
+        item.name = positional[i];
+        // WAV按文件头解析，其余按pcm_rate单声道s16原始PCM读取
+        const srv::AudioFile::Format raw_format{pcm_rate, 1, srv::AudioFile::SampleFormat::S16};
+        item.audio = srv::load_audio_mono_s16(item.name, 0, &raw_format, &rate);
+        if (item.audio.empty()) {
+            std::cerr << "❌ 错误：无法读取音频文件 " << item.name << std::endl;
+            continue;
+        }
+        if (sample_rate != 0 && rate != sample_rate) {
+            std::cerr << "⚠️  跳过采样率不同的文件 " << item.name << std::endl;
+            continue;
+        }
+        sample_rate = rate;
+        item.speech = read_labels(positional[i + 1], rate);
+        corpus.push_back(std::move(item));
+    }
+    if (positional.empty()) {
+        sample_rate = 16000;
+        LabeledAudio item;
+        item.name = "合成语料 (600s)";
+        item.audio = generate_labeled_corpus(sample_rate, 600, item.speech);
+        corpus.push_back(std::move(item));
+    }
+    if (corpus.empty()) {
+        std::cerr << "❌ 没有可用的输入" << std::endl;
+        return 1;
+    }
+
+    // 特征只计算一次
+    srv::VADTuner tuner;
+    if (!tuner.init(sample_rate, sample_rate / 100, num_threads)) {
+        return 1;
+    }
+    double cpu_start = srv::ProcessStats::get_thread_cpu_seconds();
+    for (const auto& item : corpus) {
+        if (!tuner.add_audio(item.audio.data(), item.audio.size(), item.speech)) {
+            return 1;
+        }
+        std::cout << "✅ " << item.name << ": " << item.speech.size() << " 个参考语音段" << std::endl;
+    }
+    double feature_cpu = srv::ProcessStats::get_thread_cpu_seconds() - cpu_start;
+    std::cout << "总帧数: " << tuner.get_num_frames() << " (语音帧 " << std::fixed << std::setprecision(1)
+              << (100.0 * tuner.get_speech_frames() / tuner.get_num_frames()) << "%)" << std::endl;
+    std::cout << "特征计算CPU: " << std::setprecision(3) << feature_cpu << " s" << std::endl;
+
+    // 并行回放参数网格
+    auto grid = tuner.make_grid();
+    auto wall_start = std::chrono::steady_clock::now();
+    auto results = tuner.evaluate_all(grid);
+    double eval_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - wall_start).count();
+    std::cout << "评估参数组: " << grid.size() << " 组, " << tuner.get_num_threads() << " 线程, 耗时 "
+              << std::setprecision(3) << (eval_seconds * 1000.0) << " ms (每组重新跑DSP约需 "
+              << std::setprecision(1) << (feature_cpu * grid.size()) << " s CPU)" << std::endl;
+
+    // 手工设定的现有参数作为参照
+    std::cout << "\n现有手工参数:" << std::endl;
+    print_result(tuner.evaluate({srv::VADComparator::THRESHOLD, 100, 0}));
+    print_result(tuner.evaluate({srv::VADComparator::SPEEX, 80, 80}));
+    print_result(tuner.evaluate({srv::VADComparator::RNNOISE, 0.5, 0}));
+
+    auto front = srv::VADTuner::pareto_front(results);
+    std::cout << "\n帕累托前沿 (" << front.size() << " 组):" << std::endl;
+    for (const auto& r : front) {
+        print_result(r);
+    }
+
+    std::ofstream csv(out_path);
+    if (!csv.is_open()) {
+        std::cerr << "❌ 无法创建文件 " << out_path << std::endl;
+        return 1;
+    }
+    csv << "detector,param1,param2,miss_rate,false_alarm_rate,cpu_us_per_frame" << std::endl;
+    for (const auto& r : front) {
+        csv << srv::VADComparator::get_detector_name(r.candidate.detector) << "," << r.candidate.param1 << ","
+            << r.candidate.param2 << "," << std::setprecision(6) << r.miss_rate << "," << r.false_alarm_rate << ","
+            << r.cpu_us_per_frame << std::endl;
+    }
+    std::cout << "\n✅ 帕累托前沿已写入: " << out_path << std::endl;
+    return 0;
+}